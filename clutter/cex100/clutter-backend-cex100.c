@@ -85,10 +85,9 @@ clutter_backend_cex100_get_display (ClutterBackend  *backend,
   CoglOnscreenTemplate *onscreen_template = NULL;
   CoglDisplay *display;
 
-  swap_chain = cogl_swap_chain_new ();
-
 #if defined(COGL_HAS_GDL_SUPPORT)
   cogl_swap_chain_set_length (swap_chain, gdl_n_buffers);
+  _clutter_backend_set_swap_chain_length (backend, gdl_n_buffers);
 #endif
 
   onscreen_template = cogl_onscreen_template_new (swap_chain);
@@ -217,6 +217,11 @@ struct _ClutterAnimationInfo
   AState *cur_state;
 
   GHashTable *transitions;
+
+  /* the first of the implicit transitions stored inside the
+   * transition batch of the master clock, or -1
+   */
+  gint batched_transitions;
 };
 
 const ClutterAnimationInfo *    _clutter_actor_get_animation_info_or_defaults   (ClutterActor *self);
@@ -246,6 +251,13 @@ void _clutter_actor_apply_modelview_transform           (ClutterActor *self,
 void _clutter_actor_apply_relative_transformation_matrix (ClutterActor *self,
                                                           ClutterActor *ancestor,
                                                           CoglMatrix *matrix);
+void _clutter_actor_invalidate_transform                (ClutterActor *self);
+void _clutter_actor_class_set_cacheable_transform       (ClutterActorClass *klass);
+
+/* not part of the public API, but exported for the conformance tests */
+gboolean clutter_actor_has_cached_absolute_transform    (ClutterActor *self);
+
+void _clutter_actor_invalidate_paint_node               (ClutterActor *self);
 
 void _clutter_actor_rerealize (ClutterActor    *self,
                                ClutterCallback  callback,
@@ -266,6 +278,9 @@ void _clutter_actor_set_enable_paint_unmapped (ClutterActor *self,
 void _clutter_actor_set_has_pointer (ClutterActor *self,
                                      gboolean      has_pointer);
 
+void _clutter_actor_queue_only_reallocation (ClutterActor *self);
+void _clutter_actor_allocate_relayout_root (ClutterActor *self);
+
 void _clutter_actor_queue_redraw_with_clip   (ClutterActor              *self,
                                               ClutterRedrawFlags         flags,
                                               ClutterPaintVolume        *clip_volume);
@@ -283,14 +298,29 @@ void _clutter_actor_finish_queue_redraw       (ClutterActor             *self,
 gboolean        _clutter_actor_set_default_paint_volume (ClutterActor *self,
                                                          GType         check_gtype,
                                                          ClutterPaintVolume *volume);
+gboolean        _clutter_actor_get_visible_box          (ClutterActor    *self,
+                                                         ClutterActorBox *box);
 
 const gchar *   _clutter_actor_get_debug_name (ClutterActor *self);
 
 void _clutter_actor_push_clone_paint (void);
 void _clutter_actor_pop_clone_paint  (void);
 
+void _clutter_actor_begin_spatial_traversal (ClutterActor *stage,
+                                             guint         stamp);
+void _clutter_actor_end_spatial_traversal   (void);
+void _clutter_actor_mark_spatial_candidate  (ClutterActor *self,
+                                             guint         stamp);
+
 guint32 _clutter_actor_get_pick_id (ClutterActor *self);
 
+void    _clutter_actor_push_clip_rectangle      (ClutterActor *self,
+                                                 float         x_1,
+                                                 float         y_1,
+                                                 float         x_2,
+                                                 float         y_2);
+void    _clutter_actor_pop_clip                 (ClutterActor *self);
+
 void    _clutter_actor_shader_pre_paint         (ClutterActor *actor,
                                                  gboolean      repeat);
 void    _clutter_actor_shader_post_paint        (ClutterActor *actor);
@@ -600,6 +600,7 @@
 #include "clutter-interval.h"
 #include "clutter-main.h"
 #include "clutter-marshal.h"
+#include "clutter-master-clock.h"
 #include "clutter-paint-nodes.h"
 #include "clutter-paint-node-private.h"
 #include "clutter-paint-volume-private.h"
@@ -608,6 +609,7 @@
 #include "clutter-property-transition.h"
 #include "clutter-scriptable.h"
 #include "clutter-script-private.h"
+#include "clutter-spatial-index.h"
 #include "clutter-stage-private.h"
 #include "clutter-timeline.h"
 #include "clutter-transition.h"
@@ -637,18 +639,18 @@ typedef enum {
                               */
 } MapStateChange;
 
-/* 3 entries should be a good compromise, few layout managers
- * will ask for 3 different preferred size in each allocation cycle */
-#define N_CACHED_SIZE_REQUESTS 3
-
 struct _ClutterActorPrivate
 {
   /* request mode */
   ClutterRequestMode request_mode;
 
-  /* our cached size requests for different width / height */
-  SizeRequest width_requests[N_CACHED_SIZE_REQUESTS];
-  SizeRequest height_requests[N_CACHED_SIZE_REQUESTS];
+  /* our cached size requests for different width / height; both
+   * arrays live in the same allocation, created on the first request,
+   * and hold n_cached_size_requests entries each
+   */
+  SizeRequest *width_requests;
+  SizeRequest *height_requests;
+  guint n_cached_size_requests;
 
   /* An age of 0 means the entry is not set */
   guint cached_height_age;
@@ -666,6 +668,11 @@ struct _ClutterActorPrivate
   /* the cached transformation matrix; see apply_transform() */
   CoglMatrix transform;
 
+  /* the cached transformation from our coordinate space to eye
+   * coordinates; see clutter_actor_get_absolute_transform()
+   */
+  CoglMatrix absolute_transform;
+
   guint8 opacity;
   gint opacity_override;
 
@@ -726,6 +733,13 @@ struct _ClutterActorPrivate
   ClutterScalingFilter min_filter;
   ClutterScalingFilter mag_filter;
 
+  /* the paint nodes built for the background and the content, retained
+   * across frames until the state they depend on changes, and the
+   * paint opacity they were built for
+   */
+  ClutterPaintNode *paint_node_cache;
+  guint8 paint_node_opacity;
+
   /* used when painting, to update the paint volume */
   ClutterEffect *current_effect;
 
@@ -754,6 +768,16 @@ struct _ClutterActorPrivate
 
   ClutterColor bg_color;
 
+  /* the handle of the stage paint box inside the spatial index
+   * of the stage, or -1
+   */
+  gint spatial_node;
+
+  /* the stamp of the last spatial query that hit this actor,
+   * or one of its descendants
+   */
+  guint spatial_stamp;
+
   /* bitfields */
 
   /* fixed position and sizes */
@@ -768,6 +792,10 @@ struct _ClutterActorPrivate
   guint needs_height_request        : 1;
   /* cached allocation is invalid (request has changed, probably) */
   guint needs_allocation            : 1;
+  /* the relayout being queued does not invalidate the size requests */
+  guint keep_size_requests          : 1;
+  /* the actor is a relayout boundary queued on the stage */
+  guint relayout_root_queued        : 1;
   guint show_on_set_parent          : 1;
   guint has_clip                    : 1;
   guint clip_to_allocation          : 1;
@@ -779,6 +807,8 @@ struct _ClutterActorPrivate
   guint last_paint_volume_valid     : 1;
   guint in_clone_paint              : 1;
   guint transform_valid             : 1;
+  /* if set, the absolute transforms of all our ancestors are valid */
+  guint absolute_transform_valid    : 1;
   /* This is TRUE if anything has queued a redraw since we were last
      painted. In this case effect_to_redraw will point to an effect
      the redraw was queued from or it will be NULL if the redraw was
@@ -791,6 +821,8 @@ struct _ClutterActorPrivate
   guint needs_compute_expand        : 1;
   guint needs_x_expand              : 1;
   guint needs_y_expand              : 1;
+  /* the paint box in the spatial index is out of date */
+  guint spatial_pending             : 1;
 };
 
 enum
@@ -1006,6 +1038,11 @@ static void on_layout_manager_changed (ClutterLayoutManager *manager,
 
 static inline void clutter_actor_queue_compute_expand (ClutterActor *self);
 
+static void clutter_actor_spatial_invalidate (ClutterActor *self,
+                                              ClutterActor *stage);
+static void clutter_actor_spatial_remove     (ClutterActor *self,
+                                              ClutterStage *stage);
+
 /* Helper macro which translates by the anchor coord, applies the
    given transformation and then translates back */
 #define TRANSFORM_ABOUT_ANCHOR_COORD(a,m,c,_transform)  G_STMT_START { \
@@ -1405,6 +1442,11 @@ clutter_actor_real_map (ClutterActor *self)
   stage = _clutter_actor_get_stage_internal (self);
   priv->pick_id = _clutter_stage_acquire_pick_id (CLUTTER_STAGE (stage), self);
 
+  /* we have not been painted yet, so we need to be reported by all
+   * the queries until we are
+   */
+  clutter_actor_spatial_invalidate (self, stage);
+
   CLUTTER_NOTE (ACTOR, "Pick id '%d' for actor '%s'",
                 priv->pick_id,
                 _clutter_actor_get_debug_name (self));
@@ -1492,7 +1534,10 @@ clutter_actor_real_unmap (ClutterActor *self)
       stage = CLUTTER_STAGE (_clutter_actor_get_stage_internal (self));
 
       if (stage != NULL)
-        _clutter_stage_release_pick_id (stage, priv->pick_id);
+        {
+          _clutter_stage_release_pick_id (stage, priv->pick_id);
+          clutter_actor_spatial_remove (self, stage);
+        }
 
       priv->pick_id = -1;
 
@@ -2046,19 +2091,11 @@ clutter_actor_real_pick (ClutterActor       *self,
   if (clutter_actor_should_pick_paint (self))
     {
       ClutterActorBox box = { 0, };
-      float width, height;
-
-      clutter_actor_get_allocation_box (self, &box);
 
-      width = box.x2 - box.x1;
-      height = box.y2 - box.y1;
+      box.x2 = clutter_actor_box_get_width (&self->priv->allocation);
+      box.y2 = clutter_actor_box_get_height (&self->priv->allocation);
 
-      cogl_set_source_color4ub (color->red,
-                                color->green,
-                                color->blue,
-                                color->alpha);
-
-      cogl_rectangle (0, 0, width, height);
+      clutter_actor_pick_box (self, &box);
     }
 
   /* XXX - this thoroughly sucks, but we need to maintain compatibility
@@ -2079,6 +2116,227 @@ clutter_actor_real_pick (ClutterActor       *self,
     }
 }
 
+/* Projects @vertices_in, relative to the current modelview, into
+ * stage window coordinates; this can only be used while painting
+ */
+static gboolean
+clutter_actor_project_pick_vertices (ClutterActor        *self,
+                                     const ClutterVertex *vertices_in,
+                                     ClutterVertex       *vertices_out,
+                                     guint                n_vertices,
+                                     ClutterStage       **stage_p)
+{
+  ClutterActor *stage;
+  CoglMatrix modelview;
+  CoglMatrix projection;
+  float viewport[4];
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL)
+    return FALSE;
+
+  cogl_get_modelview_matrix (&modelview);
+  _clutter_stage_get_projection_matrix (CLUTTER_STAGE (stage), &projection);
+  _clutter_stage_get_viewport (CLUTTER_STAGE (stage),
+                               &viewport[0],
+                               &viewport[1],
+                               &viewport[2],
+                               &viewport[3]);
+
+  _clutter_util_fully_transform_vertices (&modelview,
+                                          &projection,
+                                          viewport,
+                                          vertices_in,
+                                          vertices_out,
+                                          n_vertices);
+
+  *stage_p = CLUTTER_STAGE (stage);
+
+  return TRUE;
+}
+
+static void
+clutter_actor_log_pick_polygon (ClutterActor        *self,
+                                const ClutterVertex *vertices,
+                                guint                n_vertices)
+{
+  ClutterVertex *projected;
+  ClutterStage *stage;
+
+  projected = g_newa (ClutterVertex, n_vertices);
+
+  if (clutter_actor_project_pick_vertices (self, vertices, projected,
+                                           n_vertices,
+                                           &stage))
+    _clutter_stage_log_pick (stage, projected, n_vertices, self);
+}
+
+/**
+ * clutter_actor_pick_box:
+ * @self: a #ClutterActor
+ * @box: a rectangle, in the coordinate space of @self
+ *
+ * Marks @box as a pickable area of @self.
+ *
+ * This function should only be called inside the implementation of
+ * the #ClutterActorClass.pick() virtual function, after checking the
+ * result of clutter_actor_should_pick_paint(); it paints @box using
+ * the pick color of @self, or, if the #ClutterStage is using geometric
+ * picking, it logs @box without involving the GPU.
+ *
+ * Since: 1.12
+ */
+void
+clutter_actor_pick_box (ClutterActor          *self,
+                        const ClutterActorBox *box)
+{
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+  g_return_if_fail (box != NULL);
+
+  if (box->x1 >= box->x2 || box->y1 >= box->y2)
+    return;
+
+  if (_clutter_context_get_geometric_pick ())
+    {
+      ClutterVertex vertices[4];
+
+      /* polygon order, not the order used by get_allocation_vertices() */
+      clutter_vertex_init (&vertices[0], box->x1, box->y1, 0.f);
+      clutter_vertex_init (&vertices[1], box->x2, box->y1, 0.f);
+      clutter_vertex_init (&vertices[2], box->x2, box->y2, 0.f);
+      clutter_vertex_init (&vertices[3], box->x1, box->y2, 0.f);
+
+      clutter_actor_log_pick_polygon (self, vertices, 4);
+    }
+  else
+    {
+      ClutterColor color;
+
+      _clutter_id_to_color (_clutter_actor_get_pick_id (self), &color);
+
+      cogl_set_source_color4ub (color.red,
+                                color.green,
+                                color.blue,
+                                color.alpha);
+      cogl_rectangle (box->x1, box->y1, box->x2, box->y2);
+    }
+}
+
+/**
+ * clutter_actor_pick_polygon:
+ * @self: a #ClutterActor
+ * @points: (array length=n_points): the vertices of a polygon, in the
+ *   coordinate space of @self
+ * @n_points: the number of @points; must be at least 3
+ *
+ * Marks the polygon described by @points as a pickable area of @self.
+ *
+ * The polygon does not need to be convex; overlapping areas are
+ * resolved using the even-odd rule.
+ *
+ * Like clutter_actor_pick_box(), this function should only be called
+ * inside the implementation of the #ClutterActorClass.pick() virtual
+ * function.
+ *
+ * Since: 1.12
+ */
+void
+clutter_actor_pick_polygon (ClutterActor       *self,
+                            const ClutterPoint *points,
+                            guint               n_points)
+{
+  guint i;
+
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+  g_return_if_fail (points != NULL);
+  g_return_if_fail (n_points >= 3);
+
+  if (_clutter_context_get_geometric_pick ())
+    {
+      ClutterVertex *vertices = g_newa (ClutterVertex, n_points);
+
+      for (i = 0; i < n_points; i++)
+        clutter_vertex_init (&vertices[i], points[i].x, points[i].y, 0.f);
+
+      clutter_actor_log_pick_polygon (self, vertices, n_points);
+    }
+  else
+    {
+      ClutterColor color;
+      CoglPath *path;
+      float *coords;
+
+      coords = g_newa (float, n_points * 2);
+      for (i = 0; i < n_points; i++)
+        {
+          coords[i * 2] = points[i].x;
+          coords[i * 2 + 1] = points[i].y;
+        }
+
+      _clutter_id_to_color (_clutter_actor_get_pick_id (self), &color);
+
+      cogl_set_source_color4ub (color.red,
+                                color.green,
+                                color.blue,
+                                color.alpha);
+
+      path = cogl_path_new ();
+      cogl_path_set_fill_rule (path, COGL_PATH_FILL_RULE_EVEN_ODD);
+      cogl_path_polygon (path, coords, n_points);
+      cogl_path_fill (path);
+      cogl_object_unref (path);
+    }
+}
+
+/*< private >
+ * _clutter_actor_push_clip_rectangle:
+ * @self: a #ClutterActor
+ *
+ * Pushes a clip rectangle, in the coordinate space of @self, while
+ * painting; the clip is also applied to the geometry logged while
+ * the stage is using geometric picking.
+ *
+ * Each call must be matched by a call to _clutter_actor_pop_clip().
+ */
+void
+_clutter_actor_push_clip_rectangle (ClutterActor *self,
+                                    float         x_1,
+                                    float         y_1,
+                                    float         x_2,
+                                    float         y_2)
+{
+  cogl_clip_push_rectangle (x_1, y_1, x_2, y_2);
+
+  if (_clutter_context_get_geometric_pick ())
+    {
+      ClutterVertex vertices[4], projected[4];
+      ClutterStage *stage;
+
+      clutter_vertex_init (&vertices[0], x_1, y_1, 0.f);
+      clutter_vertex_init (&vertices[1], x_2, y_1, 0.f);
+      clutter_vertex_init (&vertices[2], x_2, y_2, 0.f);
+      clutter_vertex_init (&vertices[3], x_1, y_2, 0.f);
+
+      if (clutter_actor_project_pick_vertices (self, vertices, projected, 4,
+                                               &stage))
+        _clutter_stage_push_pick_clip (stage, projected, 4);
+    }
+}
+
+void
+_clutter_actor_pop_clip (ClutterActor *self)
+{
+  if (_clutter_context_get_geometric_pick ())
+    {
+      ClutterActor *stage = _clutter_actor_get_stage_internal (self);
+
+      if (stage != NULL)
+        _clutter_stage_pop_pick_clip (CLUTTER_STAGE (stage));
+    }
+
+  cogl_clip_pop ();
+}
+
 /**
  * clutter_actor_should_pick_paint:
  * @self: A #ClutterActor
@@ -2318,7 +2576,16 @@ clutter_actor_set_allocation_internal (ClutterActor           *self,
       CLUTTER_NOTE (LAYOUT, "Allocation for '%s' changed",
                     _clutter_actor_get_debug_name (self));
 
-      priv->transform_valid = FALSE;
+      _clutter_actor_invalidate_transform (self);
+
+      clutter_actor_spatial_invalidate (self, NULL);
+
+      /* the paint nodes are built using the size of the allocation */
+      if (clutter_actor_box_get_width (&old_alloc) !=
+          clutter_actor_box_get_width (&priv->allocation) ||
+          clutter_actor_box_get_height (&old_alloc) !=
+          clutter_actor_box_get_height (&priv->allocation))
+        _clutter_actor_invalidate_paint_node (self);
 
       g_object_notify_by_pspec (obj, obj_props[PROP_ALLOCATION]);
 
@@ -2537,6 +2804,79 @@ clutter_actor_real_queue_redraw (ClutterActor *self,
     }
 }
 
+/* a relayout boundary is an actor whose preferred size does not depend
+ * on the preferred size of its children: a relayout queued by one of
+ * its children can be satisfied by allocating the boundary again with
+ * its current allocation, without involving its ancestors
+ */
+static gboolean
+clutter_actor_is_relayout_boundary (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (CLUTTER_ACTOR_IS_TOPLEVEL (self))
+    return FALSE;
+
+  /* we need a valid allocation to reuse */
+  if (priv->needs_allocation && !priv->relayout_root_queued)
+    return FALSE;
+
+  /* the expand flags of the children may change the ones of the actor */
+  if (priv->needs_compute_expand &&
+      !(priv->x_expand_set && priv->y_expand_set))
+    return FALSE;
+
+  if (self->flags & CLUTTER_ACTOR_LAYOUT_BOUNDARY)
+    return TRUE;
+
+  return priv->min_width_set && priv->natural_width_set &&
+         priv->min_height_set && priv->natural_height_set;
+}
+
+/* queues a relayout on @self if it is a relayout boundary; returns
+ * %TRUE if the relayout should not be propagated any further
+ */
+static gboolean
+clutter_actor_queue_relayout_root (ClutterActor *self,
+                                   gboolean      keep_size_requests)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *stage;
+
+  if (!clutter_actor_is_relayout_boundary (self))
+    return FALSE;
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
+    return TRUE;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL)
+    return FALSE;
+
+  priv->needs_allocation = TRUE;
+
+  /* the preferred size of a boundary does not depend on its children,
+   * but its subclass may still cache something in get_preferred_*()
+   */
+  if (!keep_size_requests)
+    {
+      priv->needs_width_request  = TRUE;
+      priv->needs_height_request = TRUE;
+
+      if (priv->width_requests != NULL)
+        memset (priv->width_requests, 0,
+                2 * priv->n_cached_size_requests * sizeof (SizeRequest));
+    }
+
+  if (!priv->relayout_root_queued)
+    {
+      priv->relayout_root_queued = TRUE;
+      _clutter_stage_queue_relayout_root (CLUTTER_STAGE (stage), self);
+    }
+
+  return TRUE;
+}
+
 static void
 clutter_actor_real_queue_relayout (ClutterActor *self)
 {
@@ -2546,18 +2886,33 @@ clutter_actor_real_queue_relayout (ClutterActor *self)
   if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
     return;
 
+  priv->needs_allocation = TRUE;
+
+  /* if only the allocation changed, the size requests of the parent
+   * are still valid as well
+   */
+  if (priv->keep_size_requests)
+    {
+      if (priv->parent != NULL &&
+          !clutter_actor_queue_relayout_root (priv->parent, TRUE))
+        _clutter_actor_queue_only_reallocation (priv->parent);
+
+      return;
+    }
+
   priv->needs_width_request  = TRUE;
   priv->needs_height_request = TRUE;
-  priv->needs_allocation     = TRUE;
 
   /* reset the cached size requests */
-  memset (priv->width_requests, 0,
-          N_CACHED_SIZE_REQUESTS * sizeof (SizeRequest));
-  memset (priv->height_requests, 0,
-          N_CACHED_SIZE_REQUESTS * sizeof (SizeRequest));
+  if (priv->width_requests != NULL)
+    memset (priv->width_requests, 0,
+            2 * priv->n_cached_size_requests * sizeof (SizeRequest));
 
-  /* We need to go all the way up the hierarchy */
-  if (priv->parent != NULL)
+  /* We need to go all the way up the hierarchy, unless we hit a
+   * relayout boundary
+   */
+  if (priv->parent != NULL &&
+      !clutter_actor_queue_relayout_root (priv->parent, FALSE))
     _clutter_actor_queue_only_relayout (priv->parent);
 }
 
@@ -2702,8 +3057,6 @@ clutter_actor_apply_transform_to_point (ClutterActor        *self,
  * instead.</para></note>
  *
  */
-/* XXX: We should consider caching the stage relative modelview along with
- * the actor itself */
 static void
 _clutter_actor_get_relative_transformation_matrix (ClutterActor *self,
                                                    ClutterActor *ancestor,
@@ -2969,57 +3322,265 @@ _clutter_actor_apply_modelview_transform (ClutterActor *self,
   CLUTTER_ACTOR_GET_CLASS (self)->apply_transform (self, matrix);
 }
 
-/*
- * clutter_actor_apply_relative_transformation_matrix:
- * @self: The actor whose coordinate space you want to transform from.
- * @ancestor: The ancestor actor whose coordinate space you want to transform too
- *            or %NULL if you want to transform all the way to eye coordinates.
- * @matrix: A #CoglMatrix to apply the transformation too.
- *
- * This multiplies a transform with @matrix that will transform coordinates
- * from the coordinate space of @self into the coordinate space of @ancestor.
- *
- * For example if you need a matrix that can transform the local actor
- * coordinates of @self into stage coordinates you would pass the actor's stage
- * pointer as the @ancestor.
+/* an absolute transform is only ever computed after the ones of all the
+ * ancestors, so if the absolute transform of an actor is not valid then
+ * none of the ones of its descendants is, and we can stop there
+ */
+static void
+clutter_actor_invalidate_absolute_transform (ClutterActor *self)
+{
+  ClutterActor *iter;
+
+  if (!self->priv->absolute_transform_valid)
+    return;
+
+  self->priv->absolute_transform_valid = FALSE;
+
+  for (iter = self->priv->first_child;
+       iter != NULL;
+       iter = iter->priv->next_sibling)
+    clutter_actor_invalidate_absolute_transform (iter);
+}
+
+/*< private >
+ * _clutter_actor_invalidate_transform:
+ * @self: a #ClutterActor
  *
- * If you pass %NULL then the transformation will take you all the way through
- * to eye coordinates. This can be useful if you want to extract the entire
- * modelview transform that Clutter applies before applying the projection
- * transformation. If you want to explicitly set a modelview on a CoglFramebuffer
- * using cogl_set_modelview_matrix() for example then you would want a matrix
- * that transforms into eye coordinates.
+ * Invalidates the cached transformation of @self, as well as the cached
+ * absolute transformations of @self and of all its descendants.
  *
- * <note>This function doesn't initialize the given @matrix, it simply
- * multiplies the requested transformation matrix with the existing contents of
- * @matrix. You can use cogl_matrix_init_identity() to initialize the @matrix
- * before calling this function, or you can use
- * clutter_actor_get_relative_transformation_matrix() instead.</note>
+ * This function should be called whenever the state used by the
+ * #ClutterActorClass.apply_transform() implementation of @self changes.
  */
 void
-_clutter_actor_apply_relative_transformation_matrix (ClutterActor *self,
-                                                     ClutterActor *ancestor,
-                                                     CoglMatrix *matrix)
+_clutter_actor_invalidate_transform (ClutterActor *self)
 {
-  ClutterActor *parent;
+  self->priv->transform_valid = FALSE;
 
-  /* Note we terminate before ever calling stage->apply_transform()
-   * since that would conceptually be relative to the underlying
-   * window OpenGL coordinates so we'd need a special @ancestor
-   * value to represent the fake parent of the stage. */
-  if (self == ancestor)
-    return;
+  clutter_actor_invalidate_absolute_transform (self);
+}
 
-  parent = clutter_actor_get_parent (self);
+/* the implementations of ClutterActorClass.apply_transform() that call
+ * _clutter_actor_invalidate_transform() when their state changes
+ */
+#define N_CACHEABLE_TRANSFORMS  4
 
-  if (parent != NULL)
-    _clutter_actor_apply_relative_transformation_matrix (parent, ancestor,
-                                                         matrix);
+static void (* cacheable_transforms[N_CACHEABLE_TRANSFORMS]) (ClutterActor *actor,
+                                                              CoglMatrix   *matrix);
+static guint n_cacheable_transforms = 0;
 
-  _clutter_actor_apply_modelview_transform (self, matrix);
-}
+/*< private >
+ * _clutter_actor_class_set_cacheable_transform:
+ * @klass: a #ClutterActorClass
+ *
+ * Marks the #ClutterActorClass.apply_transform() implementation of @klass
+ * as safe to be cached in the absolute transformation of the actors;
+ * the implementation must call _clutter_actor_invalidate_transform()
+ * every time its result changes.
+ *
+ * Actors using any other implementation of apply_transform(), and their
+ * children, will always compute their absolute transformation.
+ */
+void
+_clutter_actor_class_set_cacheable_transform (ClutterActorClass *klass)
+{
+  guint i;
 
-static void
+  for (i = 0; i < n_cacheable_transforms; i++)
+    {
+      if (cacheable_transforms[i] == klass->apply_transform)
+        return;
+    }
+
+  g_assert (n_cacheable_transforms < N_CACHEABLE_TRANSFORMS);
+
+  cacheable_transforms[n_cacheable_transforms++] = klass->apply_transform;
+}
+
+static inline gboolean
+clutter_actor_has_cacheable_transform (ClutterActor *self)
+{
+  ClutterActorClass *klass = CLUTTER_ACTOR_GET_CLASS (self);
+  guint i;
+
+  if (klass->apply_transform == clutter_actor_real_apply_transform)
+    return TRUE;
+
+  for (i = 0; i < n_cacheable_transforms; i++)
+    {
+      if (cacheable_transforms[i] == klass->apply_transform)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+/*< private >
+ * clutter_actor_get_absolute_transform:
+ * @self: a #ClutterActor
+ *
+ * Retrieves the transformation from the coordinate space of @self to
+ * eye coordinates; the matrix is cached, and it is only recomputed
+ * after _clutter_actor_invalidate_transform() has been called on @self
+ * or on any of its ancestors.
+ *
+ * Each actor derives its own absolute transformation from the one of
+ * its parent, so a deep hierarchy only ever needs a single matrix
+ * multiplication per actor to be brought up to date.
+ *
+ * Return value: a pointer to the cached matrix, or %NULL if @self is
+ *   not inside a toplevel actor, or if the transformation of @self or
+ *   of any of its ancestors cannot be cached
+ */
+static const CoglMatrix *
+clutter_actor_get_absolute_transform (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (priv->absolute_transform_valid)
+    return &priv->absolute_transform;
+
+  if (!clutter_actor_has_cacheable_transform (self))
+    return NULL;
+
+  if (priv->parent != NULL)
+    {
+      const CoglMatrix *parent_transform;
+
+      parent_transform = clutter_actor_get_absolute_transform (priv->parent);
+      if (parent_transform == NULL)
+        return NULL;
+
+      priv->absolute_transform = *parent_transform;
+    }
+  else if (CLUTTER_ACTOR_IS_TOPLEVEL (self))
+    cogl_matrix_init_identity (&priv->absolute_transform);
+  else
+    return NULL;
+
+  /* applying the transformations might cause a relayout, and thus
+   * invalidate them; in that case we still return the matrix, but
+   * we let the next call recompute it
+   */
+  priv->absolute_transform_valid = TRUE;
+
+  _clutter_actor_apply_modelview_transform (self, &priv->absolute_transform);
+
+  return &priv->absolute_transform;
+}
+
+/*< private >
+ * clutter_actor_has_cached_absolute_transform:
+ * @self: a #ClutterActor
+ *
+ * Checks whether the absolute transformation of @self is cached, and
+ * will not be recomputed the next time it is needed.
+ *
+ * Return value: %TRUE if the cached absolute transformation is valid
+ */
+gboolean
+clutter_actor_has_cached_absolute_transform (ClutterActor *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), FALSE);
+
+  return self->priv->absolute_transform_valid;
+}
+
+/*< private >
+ * clutter_actor_is_painted_in_parent_space:
+ * @self: a #ClutterActor
+ * @modelview: the current modelview matrix
+ *
+ * Checks whether @self is being painted using the absolute transformation
+ * of its parent, which is not the case when painting inside a clone, or
+ * when painting using a custom modelview matrix.
+ *
+ * Return value: %TRUE if the absolute transformation of @self can be used
+ *   as its modelview matrix
+ */
+static gboolean
+clutter_actor_is_painted_in_parent_space (ClutterActor     *self,
+                                          const CoglMatrix *modelview)
+{
+  ClutterActorPrivate *parent_priv;
+
+  /* toplevels ignore the current modelview */
+  if (self->priv->parent == NULL)
+    return CLUTTER_ACTOR_IS_TOPLEVEL (self);
+
+  parent_priv = self->priv->parent->priv;
+
+  if (!parent_priv->absolute_transform_valid)
+    return FALSE;
+
+  return cogl_matrix_equal (modelview, &parent_priv->absolute_transform);
+}
+
+/*
+ * clutter_actor_apply_relative_transformation_matrix:
+ * @self: The actor whose coordinate space you want to transform from.
+ * @ancestor: The ancestor actor whose coordinate space you want to transform too
+ *            or %NULL if you want to transform all the way to eye coordinates.
+ * @matrix: A #CoglMatrix to apply the transformation too.
+ *
+ * This multiplies a transform with @matrix that will transform coordinates
+ * from the coordinate space of @self into the coordinate space of @ancestor.
+ *
+ * For example if you need a matrix that can transform the local actor
+ * coordinates of @self into stage coordinates you would pass the actor's stage
+ * pointer as the @ancestor.
+ *
+ * If you pass %NULL then the transformation will take you all the way through
+ * to eye coordinates. This can be useful if you want to extract the entire
+ * modelview transform that Clutter applies before applying the projection
+ * transformation. If you want to explicitly set a modelview on a CoglFramebuffer
+ * using cogl_set_modelview_matrix() for example then you would want a matrix
+ * that transforms into eye coordinates.
+ *
+ * <note>This function doesn't initialize the given @matrix, it simply
+ * multiplies the requested transformation matrix with the existing contents of
+ * @matrix. You can use cogl_matrix_init_identity() to initialize the @matrix
+ * before calling this function, or you can use
+ * clutter_actor_get_relative_transformation_matrix() instead.</note>
+ */
+void
+_clutter_actor_apply_relative_transformation_matrix (ClutterActor *self,
+                                                     ClutterActor *ancestor,
+                                                     CoglMatrix *matrix)
+{
+  ClutterActor *parent;
+
+  /* Note we terminate before ever calling stage->apply_transform()
+   * since that would conceptually be relative to the underlying
+   * window OpenGL coordinates so we'd need a special @ancestor
+   * value to represent the fake parent of the stage. */
+  if (self == ancestor)
+    return;
+
+  /* the transformation to eye coordinates starts from the toplevel,
+   * which resets the matrix, so we can just use the cached one
+   */
+  if (ancestor == NULL)
+    {
+      const CoglMatrix *absolute = clutter_actor_get_absolute_transform (self);
+
+      if (absolute != NULL)
+        {
+          *matrix = *absolute;
+          return;
+        }
+    }
+
+  parent = clutter_actor_get_parent (self);
+
+  if (parent != NULL)
+    _clutter_actor_apply_relative_transformation_matrix (parent, ancestor,
+                                                         matrix);
+
+  _clutter_actor_apply_modelview_transform (self, matrix);
+}
+
+static void
 _clutter_actor_draw_paint_volume_full (ClutterActor *self,
                                        ClutterPaintVolume *pv,
                                        const char *label,
@@ -3184,6 +3745,211 @@ in_clone_paint (void)
   return clone_paint_level > 0;
 }
 
+/* The state of a paint run driven by the spatial index of the stage;
+ * see _clutter_actor_begin_spatial_traversal()
+ */
+static ClutterActor *spatial_stage = NULL;
+static guint spatial_query_stamp = 0;
+static int spatial_bypass_level = 0;
+
+/*< private >
+ * _clutter_actor_begin_spatial_traversal:
+ * @stage: the #ClutterStage being painted
+ * @stamp: the stamp of the spatial query
+ *
+ * Starts a paint run in which only the actors that have been marked
+ * using _clutter_actor_mark_spatial_candidate() with the same @stamp,
+ * and the actors not tracked by the spatial index, are painted.
+ *
+ * The paint run must be terminated by calling
+ * _clutter_actor_end_spatial_traversal().
+ */
+void
+_clutter_actor_begin_spatial_traversal (ClutterActor *stage,
+                                        guint         stamp)
+{
+  g_assert (spatial_query_stamp == 0);
+  g_assert (stamp != 0);
+
+  spatial_stage = stage;
+  spatial_query_stamp = stamp;
+  spatial_bypass_level = 0;
+}
+
+void
+_clutter_actor_end_spatial_traversal (void)
+{
+  spatial_stage = NULL;
+  spatial_query_stamp = 0;
+  spatial_bypass_level = 0;
+}
+
+/*< private >
+ * _clutter_actor_mark_spatial_candidate:
+ * @self: a #ClutterActor
+ * @stamp: the stamp of the spatial query
+ *
+ * Marks @self, and all its ancestors, as hit by the spatial
+ * query identified by @stamp.
+ */
+void
+_clutter_actor_mark_spatial_candidate (ClutterActor *self,
+                                       guint         stamp)
+{
+  ClutterActor *iter;
+
+  for (iter = self;
+       iter != NULL && iter->priv->spatial_stamp != stamp;
+       iter = iter->priv->parent)
+    {
+      iter->priv->spatial_stamp = stamp;
+    }
+}
+
+/* Returns TRUE if the spatial index of the stage says that the actor
+ * is outside of the area being painted
+ */
+static inline gboolean
+clutter_actor_is_spatially_culled (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (spatial_query_stamp == 0 || spatial_bypass_level > 0)
+    return FALSE;
+
+  if (priv->spatial_node < 0 || priv->spatial_stamp == spatial_query_stamp)
+    return FALSE;
+
+  /* the paint box is the location of the actor on the stage, which
+   * is meaningless when painting through a clone, or when painting
+   * into an offscreen buffer
+   */
+  if (in_clone_paint ())
+    return FALSE;
+
+  if (cogl_get_draw_framebuffer () !=
+      _clutter_stage_get_active_framebuffer (CLUTTER_STAGE (spatial_stage)))
+    return FALSE;
+
+  return TRUE;
+}
+
+/* Marks the paint box of the actor as out of date; the actor will be
+ * reported by every query of the spatial index until it is painted
+ * again
+ */
+static void
+clutter_actor_spatial_invalidate (ClutterActor *self,
+                                  ClutterActor *stage)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterSpatialIndex *index_;
+
+  if (priv->spatial_pending)
+    return;
+
+  if (CLUTTER_ACTOR_IS_TOPLEVEL (self) || !CLUTTER_ACTOR_IS_MAPPED (self))
+    return;
+
+  if (stage == NULL)
+    stage = _clutter_actor_get_stage_internal (self);
+
+  if (stage == NULL)
+    return;
+
+  index_ = _clutter_stage_get_spatial_index (CLUTTER_STAGE (stage));
+  _clutter_spatial_index_add_pending (index_, self);
+
+  priv->spatial_pending = TRUE;
+}
+
+/* Marks the paint boxes of all the descendants of the actor as out
+ * of date; this is used when an actor that changed is culled, since
+ * its children will not be painted, and thus will not update their
+ * own paint boxes
+ */
+static void
+clutter_actor_spatial_invalidate_children (ClutterActor *self,
+                                           ClutterActor *stage)
+{
+  ClutterActor *iter;
+
+  for (iter = self->priv->first_child;
+       iter != NULL;
+       iter = iter->priv->next_sibling)
+    {
+      clutter_actor_spatial_invalidate (iter, stage);
+      clutter_actor_spatial_invalidate_children (iter, stage);
+    }
+}
+
+static void
+clutter_actor_spatial_remove (ClutterActor *self,
+                              ClutterStage *stage)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterSpatialIndex *index_;
+
+  index_ = _clutter_stage_get_spatial_index (stage);
+
+  if (priv->spatial_node >= 0)
+    {
+      _clutter_spatial_index_remove (index_, priv->spatial_node);
+      priv->spatial_node = -1;
+    }
+
+  if (priv->spatial_pending)
+    {
+      _clutter_spatial_index_remove_pending (index_, self);
+      priv->spatial_pending = FALSE;
+    }
+}
+
+/* Stores the stage paint box of the last paint volume of the actor
+ * inside the spatial index of the stage
+ */
+static void
+clutter_actor_spatial_update (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterSpatialIndex *index_;
+  ClutterActor *stage;
+  ClutterActorBox box;
+
+  if (CLUTTER_ACTOR_IS_TOPLEVEL (self))
+    return;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL)
+    return;
+
+  if (!priv->last_paint_volume_valid)
+    {
+      /* without a paint box we cannot be skipped, so we can stop
+       * reporting the actor as pending
+       */
+      clutter_actor_spatial_remove (self, CLUTTER_STAGE (stage));
+      return;
+    }
+
+  index_ = _clutter_stage_get_spatial_index (CLUTTER_STAGE (stage));
+
+  if (priv->spatial_pending)
+    {
+      _clutter_spatial_index_remove_pending (index_, self);
+      priv->spatial_pending = FALSE;
+    }
+
+  _clutter_paint_volume_get_stage_paint_box (&priv->last_paint_volume,
+                                             CLUTTER_STAGE (stage),
+                                             &box);
+
+  if (priv->spatial_node < 0)
+    priv->spatial_node = _clutter_spatial_index_insert (index_, &box, self);
+  else
+    _clutter_spatial_index_update (index_, priv->spatial_node, &box);
+}
+
 /* Returns TRUE if the actor can be ignored */
 /* FIXME: we should return a ClutterCullResult, and
  * clutter_actor_paint should understand that a CLUTTER_CULL_RESULT_IN
@@ -3249,6 +4015,7 @@ _clutter_actor_update_last_paint_volume (ClutterActor *self)
       CLUTTER_NOTE (CLIPPING, "Bail from update_last_paint_volume (%s): "
                     "Actor failed to report a paint volume",
                     _clutter_actor_get_debug_name (self));
+      clutter_actor_spatial_update (self);
       return;
     }
 
@@ -3258,6 +4025,8 @@ _clutter_actor_update_last_paint_volume (ClutterActor *self)
                                             NULL); /* eye coordinates */
 
   priv->last_paint_volume_valid = TRUE;
+
+  clutter_actor_spatial_update (self);
 }
 
 static inline gboolean
@@ -3394,11 +4163,34 @@ clutter_actor_real_paint (ClutterActor *actor)
     }
 }
 
-static gboolean
-clutter_actor_paint_node (ClutterActor     *actor,
-                          ClutterPaintNode *root)
+/*< private >
+ * _clutter_actor_invalidate_paint_node:
+ * @self: a #ClutterActor
+ *
+ * Drops the paint nodes retained by @self, so that they are rebuilt
+ * the next time @self is painted.
+ *
+ * This function should be called every time the background color, the
+ * content, or the state used by the #ClutterActorClass.paint_node()
+ * implementation of @self change.
+ */
+void
+_clutter_actor_invalidate_paint_node (ClutterActor *self)
 {
-  ClutterActorPrivate *priv = actor->priv;
+  ClutterActorPrivate *priv = self->priv;
+
+  if (priv->paint_node_cache != NULL)
+    {
+      clutter_paint_node_unref (priv->paint_node_cache);
+      priv->paint_node_cache = NULL;
+    }
+}
+
+static gboolean
+clutter_actor_paint_node (ClutterActor     *actor,
+                          ClutterPaintNode *root)
+{
+  ClutterActorPrivate *priv = actor->priv;
 
   if (root == NULL)
     return FALSE;
@@ -3433,6 +4225,69 @@ clutter_actor_paint_node (ClutterActor     *actor,
   if (CLUTTER_ACTOR_GET_CLASS (actor)->paint_node != NULL)
     CLUTTER_ACTOR_GET_CLASS (actor)->paint_node (actor, root);
 
+  return clutter_paint_node_get_n_children (root) != 0;
+}
+
+/*< private >
+ * clutter_actor_paint_retained_node:
+ * @actor: a #ClutterActor
+ *
+ * Paints the background and the content of @actor, reusing the paint
+ * nodes built by a previous paint if nothing they depend on changed in
+ * the meantime; otherwise, a new tree of paint nodes is built, and kept
+ * for the following frames.
+ *
+ * Return value: %TRUE if any paint node was painted
+ */
+static gboolean
+clutter_actor_paint_retained_node (ClutterActor *actor)
+{
+  ClutterActorPrivate *priv = actor->priv;
+  ClutterPaintNode *root;
+  guint8 paint_opacity;
+
+  CLUTTER_STATIC_COUNTER (paint_node_cache_hit_counter,
+                          "Paint node cache hits",
+                          "Number of actors painted using retained paint nodes",
+                          0 /* no application private data */);
+  CLUTTER_STATIC_COUNTER (paint_node_cache_miss_counter,
+                          "Paint node cache misses",
+                          "Number of actors that had to rebuild their paint nodes",
+                          0 /* no application private data */);
+
+  /* the nodes use the paint opacity, which depends on the ancestors
+   * of the actor, or on the clone currently painting it
+   */
+  paint_opacity = clutter_actor_get_paint_opacity_internal (actor);
+
+  if (priv->paint_node_cache != NULL &&
+      priv->paint_node_opacity != paint_opacity)
+    _clutter_actor_invalidate_paint_node (actor);
+
+  if (priv->paint_node_cache == NULL)
+    {
+      CLUTTER_COUNTER_INC (_clutter_uprof_context, paint_node_cache_miss_counter);
+
+      /* XXX - this will go away in 2.0, when we can get rid of this
+       * stuff and switch to a pure retained render tree of PaintNodes
+       * for the entire frame, starting from the Stage; the paint()
+       * virtual function can then be called directly.
+       */
+      root = _clutter_dummy_node_new (actor);
+      clutter_paint_node_set_name (root, "Root");
+
+      clutter_actor_paint_node (actor, root);
+
+      priv->paint_node_cache = root;
+      priv->paint_node_opacity = paint_opacity;
+    }
+  else
+    {
+      CLUTTER_COUNTER_INC (_clutter_uprof_context, paint_node_cache_hit_counter);
+
+      root = priv->paint_node_cache;
+    }
+
   if (clutter_paint_node_get_n_children (root) == 0)
     return FALSE;
 
@@ -3479,6 +4334,7 @@ clutter_actor_paint (ClutterActor *self)
   ClutterPickMode pick_mode;
   gboolean clip_set = FALSE;
   gboolean shader_applied = FALSE;
+  gboolean bypass_spatial_index = FALSE;
 
   CLUTTER_STATIC_COUNTER (actor_paint_counter,
                           "Actor real-paint counter",
@@ -3518,6 +4374,23 @@ clutter_actor_paint (ClutterActor *self)
   if (!CLUTTER_ACTOR_IS_MAPPED (self))
     return;
 
+  /* if the stage is painting a region using its spatial index, and
+   * neither we nor any of our children are inside the region, then
+   * we can skip the whole sub-tree without transforming anything
+   */
+  if (clutter_actor_is_spatially_culled (self))
+    return;
+
+  /* if our paint box is out of date, then the paint boxes of our
+   * children might be out of date as well, so we need to ignore the
+   * spatial index until we are done
+   */
+  if (spatial_query_stamp != 0 && priv->spatial_pending)
+    {
+      spatial_bypass_level += 1;
+      bypass_spatial_index = TRUE;
+    }
+
   /* mark that we are in the paint process */
   CLUTTER_SET_PRIVATE_FLAGS (self, CLUTTER_IN_PAINT);
 
@@ -3525,13 +4398,22 @@ clutter_actor_paint (ClutterActor *self)
 
   if (priv->enable_model_view_transform)
     {
+      const CoglMatrix *absolute = NULL;
       CoglMatrix matrix;
 
-      /* XXX: It could be better to cache the modelview with the actor
-       * instead of progressively building up the transformations on
-       * the matrix stack every time we paint. */
       cogl_get_modelview_matrix (&matrix);
-      _clutter_actor_apply_modelview_transform (self, &matrix);
+
+      /* if we are being painted using the transformation of our parent
+       * then we can use our cached transformation instead of building
+       * it up on the matrix stack
+       */
+      if (clutter_actor_is_painted_in_parent_space (self, &matrix))
+        absolute = clutter_actor_get_absolute_transform (self);
+
+      if (absolute != NULL)
+        matrix = *absolute;
+      else
+        _clutter_actor_apply_modelview_transform (self, &matrix);
 
 #ifdef CLUTTER_ENABLE_DEBUG
       /* Catch when out-of-band transforms have been made by actors not as part
@@ -3576,10 +4458,11 @@ clutter_actor_paint (ClutterActor *self)
 
   if (priv->has_clip)
     {
-      cogl_clip_push_rectangle (priv->clip.x,
-                                priv->clip.y,
-                                priv->clip.x + priv->clip.width,
-                                priv->clip.y + priv->clip.height);
+      _clutter_actor_push_clip_rectangle (self,
+                                          priv->clip.x,
+                                          priv->clip.y,
+                                          priv->clip.x + priv->clip.width,
+                                          priv->clip.y + priv->clip.height);
       clip_set = TRUE;
     }
   else if (priv->clip_to_allocation)
@@ -3589,7 +4472,7 @@ clutter_actor_paint (ClutterActor *self)
       width  = priv->allocation.x2 - priv->allocation.x1;
       height = priv->allocation.y2 - priv->allocation.y1;
 
-      cogl_clip_push_rectangle (0, 0, width, height);
+      _clutter_actor_push_clip_rectangle (self, 0, 0, width, height);
       clip_set = TRUE;
     }
 
@@ -3652,7 +4535,15 @@ clutter_actor_paint (ClutterActor *self)
       if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_REDRAWS))
         _clutter_actor_paint_cull_result (self, success, result);
       else if (result == CLUTTER_CULL_RESULT_OUT && success)
-        goto done;
+        {
+          /* our children are not going to be painted, so they will
+           * not update their paint boxes
+           */
+          if (spatial_bypass_level > 0)
+            clutter_actor_spatial_invalidate_children (self, spatial_stage);
+
+          goto done;
+        }
     }
 
   if (priv->effects == NULL)
@@ -3686,10 +4577,13 @@ done:
     priv->is_dirty = FALSE;
 
   if (clip_set)
-    cogl_clip_pop();
+    _clutter_actor_pop_clip (self);
 
   cogl_pop_matrix();
 
+  if (bypass_spatial_index)
+    spatial_bypass_level -= 1;
+
   /* paint sequence complete */
   CLUTTER_UNSET_PRIVATE_FLAGS (self, CLUTTER_IN_PAINT);
 }
@@ -3729,21 +4623,10 @@ clutter_actor_continue_paint (ClutterActor *self)
     {
       if (_clutter_context_get_pick_mode () == CLUTTER_PICK_NONE)
         {
-          ClutterPaintNode *dummy;
-
-          /* XXX - this will go away in 2.0, when we can get rid of this
-           * stuff and switch to a pure retained render tree of PaintNodes
-           * for the entire frame, starting from the Stage; the paint()
-           * virtual function can then be called directly.
-           */
-          dummy = _clutter_dummy_node_new (self);
-          clutter_paint_node_set_name (dummy, "Root");
-
           /* XXX - for 1.12, we use the return value of paint_node() to
            * decide whether we should emit the ::paint signal.
            */
-          clutter_actor_paint_node (self, dummy);
-          clutter_paint_node_unref (dummy);
+          clutter_actor_paint_retained_node (self);
 
           g_signal_emit (self, actor_signals[PAINT], 0);
         }
@@ -3842,6 +4725,9 @@ remove_child (ClutterActor *self,
   child->priv->parent = NULL;
   child->priv->prev_sibling = NULL;
   child->priv->next_sibling = NULL;
+
+  /* the absolute transformation depends on the parent */
+  _clutter_actor_invalidate_transform (child);
 }
 
 typedef enum {
@@ -4107,7 +4993,7 @@ clutter_actor_set_rotation_angle_internal (ClutterActor      *self,
       break;
     }
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
 
   g_object_thaw_notify (obj);
 
@@ -4204,7 +5090,7 @@ clutter_actor_set_rotation_center_internal (ClutterActor        *self,
       break;
     }
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
 
   g_object_thaw_notify (obj);
 
@@ -4226,7 +5112,7 @@ clutter_actor_set_scale_factor_internal (ClutterActor *self,
   else
     info->scale_y = factor;
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
   clutter_actor_queue_redraw (self);
   g_object_notify_by_pspec (obj, pspec);
 }
@@ -4310,7 +5196,7 @@ clutter_actor_set_scale_center (ClutterActor      *self,
       g_assert_not_reached ();
     }
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
 
   clutter_actor_queue_redraw (self);
 
@@ -4332,7 +5218,7 @@ clutter_actor_set_scale_gravity (ClutterActor   *self,
   else
     clutter_anchor_coord_set_gravity (&info->scale_center, gravity);
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
 
   g_object_notify_by_pspec (obj, obj_props[PROP_SCALE_CENTER_X]);
   g_object_notify_by_pspec (obj, obj_props[PROP_SCALE_CENTER_Y]);
@@ -4384,7 +5270,7 @@ clutter_actor_set_anchor_coord (ClutterActor      *self,
       g_assert_not_reached ();
     }
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
 
   clutter_actor_queue_redraw (self);
 
@@ -5222,6 +6108,8 @@ clutter_actor_dispose (GObject *object)
       g_clear_object (&priv->content);
     }
 
+  _clutter_actor_invalidate_paint_node (self);
+
   G_OBJECT_CLASS (clutter_actor_parent_class)->dispose (object);
 }
 
@@ -5238,6 +6126,7 @@ clutter_actor_finalize (GObject *object)
   _clutter_context_release_id (priv->id);
 
   g_free (priv->name);
+  g_free (priv->width_requests);
 
   G_OBJECT_CLASS (clutter_actor_parent_class)->finalize (object);
 }
@@ -7308,6 +8197,7 @@ clutter_actor_init (ClutterActor *self)
 
   priv->id = _clutter_context_acquire_id (self);
   priv->pick_id = -1;
+  priv->spatial_node = -1;
 
   priv->opacity = 0xff;
   priv->show_on_set_parent = TRUE;
@@ -7580,6 +8470,12 @@ _clutter_actor_queue_redraw_full (ClutterActor       *self,
    * paint.
    */
 
+  /* we cannot know what state the paint_node() implementation of a
+   * subclass depends on, so we assume it changed
+   */
+  if (effect == NULL && CLUTTER_ACTOR_GET_CLASS (self)->paint_node != NULL)
+    _clutter_actor_invalidate_paint_node (self);
+
   /* ignore queueing a redraw for actors being destroyed */
   if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
     return;
@@ -7594,6 +8490,11 @@ _clutter_actor_queue_redraw_full (ClutterActor       *self,
   if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
     return;
 
+  /* we are going to change, so the spatial index of the stage
+   * cannot be trusted to know where we are until we are painted
+   */
+  clutter_actor_spatial_invalidate (self, stage);
+
   if (flags & CLUTTER_REDRAW_CLIPPED_TO_ALLOCATION)
     {
       ClutterActorBox allocation_clip;
@@ -7788,6 +8689,34 @@ _clutter_actor_queue_only_relayout (ClutterActor *self)
   g_signal_emit (self, actor_signals[QUEUE_RELAYOUT], 0);
 }
 
+/*< private >
+ * _clutter_actor_queue_only_reallocation:
+ * @self: a #ClutterActor
+ *
+ * Queues a new allocation of @self, like clutter_actor_queue_relayout()
+ * does, but without invalidating the cached size requests of @self and
+ * of its parents.
+ *
+ * This function should be used when a change only affects the way @self
+ * is allocated, and not its preferred size; for instance, when the source
+ * of a #ClutterConstraint applied to @self changes.
+ *
+ * The #ClutterActor::queue-relayout signal is still emitted.
+ */
+void
+_clutter_actor_queue_only_reallocation (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  guint keep_size_requests;
+
+  keep_size_requests = priv->keep_size_requests;
+  priv->keep_size_requests = TRUE;
+
+  _clutter_actor_queue_only_relayout (self);
+
+  priv->keep_size_requests = keep_size_requests;
+}
+
 /**
  * clutter_actor_queue_redraw_with_clip:
  * @self: a #ClutterActor
@@ -8118,18 +9047,55 @@ clutter_actor_adjust_height (ClutterActor *self,
 
 }
 
+/* allocates the size request caches of the actor; the number of
+ * entries can be changed using the CLUTTER_SIZE_REQUEST_CACHE
+ * environment variable, or the SizeRequestCache key of the settings
+ * file
+ */
+static inline void
+clutter_actor_ensure_size_requests (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  guint n_requests;
+
+  if (G_LIKELY (priv->width_requests != NULL))
+    return;
+
+  n_requests = _clutter_context_get_size_request_cache_size ();
+
+  priv->width_requests = g_new0 (SizeRequest, 2 * n_requests);
+  priv->height_requests = priv->width_requests + n_requests;
+  priv->n_cached_size_requests = n_requests;
+}
+
 /* looks for a cached size request for this for_size. If not
- * found, returns the oldest entry so it can be overwritten */
+ * found, returns the least recently used entry so it can be
+ * overwritten */
 static gboolean
 _clutter_actor_get_cached_size_request (gfloat         for_size,
                                         SizeRequest   *cached_size_requests,
+                                        guint          n_cached_size_requests,
+                                        guint         *cached_age,
                                         SizeRequest  **result)
 {
   guint i;
 
+  CLUTTER_STATIC_COUNTER (size_cache_hit_counter,
+                          "Size request cache hits",
+                          "Number of size requests found in the cache",
+                          0 /* no application private data */);
+  CLUTTER_STATIC_COUNTER (size_cache_miss_counter,
+                          "Size request cache misses",
+                          "Number of size requests computed by the actor",
+                          0 /* no application private data */);
+  CLUTTER_STATIC_COUNTER (size_cache_eviction_counter,
+                          "Size request cache evictions",
+                          "Number of valid size requests dropped from the cache",
+                          0 /* no application private data */);
+
   *result = &cached_size_requests[0];
 
-  for (i = 0; i < N_CACHED_SIZE_REQUESTS; i++)
+  for (i = 0; i < n_cached_size_requests; i++)
     {
       SizeRequest *sr;
 
@@ -8139,6 +9105,12 @@ _clutter_actor_get_cached_size_request (gfloat         for_size,
           sr->for_size == for_size)
         {
           CLUTTER_NOTE (LAYOUT, "Size cache hit for size: %.2f", for_size);
+          CLUTTER_COUNTER_INC (_clutter_uprof_context, size_cache_hit_counter);
+
+          /* mark the entry as the most recently used */
+          sr->age = *cached_age;
+          *cached_age += 1;
+
           *result = sr;
           return TRUE;
         }
@@ -8149,6 +9121,10 @@ _clutter_actor_get_cached_size_request (gfloat         for_size,
     }
 
   CLUTTER_NOTE (LAYOUT, "Size cache miss for size: %.2f", for_size);
+  CLUTTER_COUNTER_INC (_clutter_uprof_context, size_cache_miss_counter);
+
+  if ((*result)->age > 0)
+    CLUTTER_COUNTER_INC (_clutter_uprof_context, size_cache_eviction_counter);
 
   return FALSE;
 }
@@ -8215,11 +9191,15 @@ clutter_actor_get_preferred_width (ClutterActor *self,
    * the *_set flags.
    */
 
+  clutter_actor_ensure_size_requests (self);
+
   if (!priv->needs_width_request)
     {
       found_in_cache =
         _clutter_actor_get_cached_size_request (for_height,
                                                 priv->width_requests,
+                                                priv->n_cached_size_requests,
+                                                &priv->cached_width_age,
                                                 &cached_size_request);
     }
   else
@@ -8232,6 +9212,7 @@ clutter_actor_get_preferred_width (ClutterActor *self,
   if (!found_in_cache)
     {
       gfloat minimum_width, natural_width;
+      gfloat for_size = for_height;
       ClutterActorClass *klass;
 
       minimum_width = natural_width = 0;
@@ -8263,7 +9244,10 @@ clutter_actor_get_preferred_width (ClutterActor *self,
 
       cached_size_request->min_size = minimum_width;
       cached_size_request->natural_size = natural_width;
-      cached_size_request->for_size = for_height;
+      /* the cache is looked up using the size before the
+       * margin adjustment
+       */
+      cached_size_request->for_size = for_size;
       cached_size_request->age = priv->cached_width_age;
 
       priv->cached_width_age += 1;
@@ -8352,11 +9336,15 @@ clutter_actor_get_preferred_height (ClutterActor *self,
    * the *_set flags.
    */
 
+  clutter_actor_ensure_size_requests (self);
+
   if (!priv->needs_height_request)
     {
       found_in_cache =
         _clutter_actor_get_cached_size_request (for_width,
                                                 priv->height_requests,
+                                                priv->n_cached_size_requests,
+                                                &priv->cached_height_age,
                                                 &cached_size_request);
     }
   else
@@ -8368,6 +9356,7 @@ clutter_actor_get_preferred_height (ClutterActor *self,
   if (!found_in_cache)
     {
       gfloat minimum_height, natural_height;
+      gfloat for_size = for_width;
       ClutterActorClass *klass;
 
       minimum_height = natural_height = 0;
@@ -8399,7 +9388,10 @@ clutter_actor_get_preferred_height (ClutterActor *self,
 
       cached_size_request->min_size = minimum_height;
       cached_size_request->natural_size = natural_height;
-      cached_size_request->for_size = for_width;
+      /* the cache is looked up using the size before the
+       * margin adjustment
+       */
+      cached_size_request->for_size = for_size;
       cached_size_request->age = priv->cached_height_age;
 
       priv->cached_height_age += 1;
@@ -8794,6 +9786,52 @@ clutter_actor_allocate (ClutterActor           *self,
                                       &real_allocation);
 }
 
+/*< private >
+ * _clutter_actor_allocate_relayout_root:
+ * @self: a #ClutterActor
+ *
+ * Allocates a relayout boundary queued with
+ * _clutter_stage_queue_relayout_root() using its current allocation.
+ *
+ * This function should only be called by the #ClutterStage, after
+ * allocating its children.
+ */
+void
+_clutter_actor_allocate_relayout_root (ClutterActor *self)
+{
+  CLUTTER_STATIC_COUNTER (relayout_root_counter,
+                          "Relayout boundaries allocated",
+                          "The number of relayout boundaries allocated "
+                          "in place",
+                          0 /* no application private data */);
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActorBox box;
+
+  priv->relayout_root_queued = FALSE;
+
+  /* the allocation of an ancestor already took care of it */
+  if (!priv->needs_allocation)
+    return;
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (self) ||
+      !CLUTTER_ACTOR_IS_VISIBLE (self) ||
+      _clutter_actor_get_stage_internal (self) == NULL)
+    return;
+
+  CLUTTER_COUNTER_INC (_clutter_uprof_context, relayout_root_counter);
+
+  CLUTTER_NOTE (LAYOUT, "Allocating relayout boundary '%s' in place",
+                _clutter_actor_get_debug_name (self));
+
+  /* the allocation is stored after the constraints and the margins
+   * have been applied, so we can bypass clutter_actor_allocate()
+   */
+  box = priv->allocation;
+  clutter_actor_allocate_internal (self, &box,
+                                   priv->allocation_flags &
+                                   ~CLUTTER_ABSOLUTE_ORIGIN_CHANGED);
+}
+
 /**
  * clutter_actor_set_allocation:
  * @self: a #ClutterActor
@@ -10651,7 +11689,7 @@ clutter_actor_set_depth_internal (ClutterActor *self,
       /* Sets Z value - XXX 2.0: should we invert? */
       info->depth = depth;
 
-      self->priv->transform_valid = FALSE;
+      _clutter_actor_invalidate_transform (self);
 
       /* FIXME - remove this crap; sadly, there are still containers
        * in Clutter that depend on this utter brain damage
@@ -11416,6 +12454,8 @@ clutter_actor_add_child_internal (ClutterActor              *self,
 
   g_assert (child->priv->parent == self);
 
+  _clutter_actor_invalidate_transform (child);
+
   self->priv->n_children += 1;
 
   self->priv->age += 1;
@@ -12554,7 +13594,7 @@ clutter_actor_set_anchor_point (ClutterActor *self,
 
   if (changed)
     {
-      priv->transform_valid = FALSE;
+      _clutter_actor_invalidate_transform (self);
       clutter_actor_queue_redraw (self);
     }
 
@@ -12712,7 +13752,7 @@ clutter_actor_set_anchor_point_from_gravity (ClutterActor   *self,
       g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_X]);
       g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_Y]);
 
-      self->priv->transform_valid = FALSE;
+      _clutter_actor_invalidate_transform (self);
 
       clutter_actor_queue_redraw (self);
 
@@ -12732,6 +13772,7 @@ clutter_actor_store_content_box (ClutterActor *self,
   else
     self->priv->content_box_valid = FALSE;
 
+  _clutter_actor_invalidate_paint_node (self);
   clutter_actor_queue_redraw (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_CONTENT_BOX]);
@@ -15169,7 +16210,7 @@ clutter_actor_add_constraint (ClutterActor      *self,
 
   _clutter_meta_group_add_meta (priv->constraints,
                                 CLUTTER_ACTOR_META (constraint));
-  clutter_actor_queue_relayout (self);
+  _clutter_actor_queue_only_reallocation (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_CONSTRAINTS]);
 }
@@ -15236,7 +16277,7 @@ clutter_actor_remove_constraint (ClutterActor      *self,
   if (_clutter_meta_group_peek_metas (priv->constraints) == NULL)
     g_clear_object (&priv->constraints);
 
-  clutter_actor_queue_relayout (self);
+  _clutter_actor_queue_only_reallocation (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_CONSTRAINTS]);
 }
@@ -15343,7 +16384,7 @@ clutter_actor_clear_constraints (ClutterActor *self)
 
   _clutter_meta_group_clear_metas_no_internal (self->priv->constraints);
 
-  clutter_actor_queue_relayout (self);
+  _clutter_actor_queue_only_reallocation (self);
 }
 
 /**
@@ -15892,6 +16933,143 @@ clutter_actor_get_paint_box (ClutterActor    *self,
   return TRUE;
 }
 
+/* Extends @box with the given point, in stage coordinates */
+static void
+stage_box_add_point (ClutterActorBox *box,
+                     gfloat           x,
+                     gfloat           y,
+                     gboolean         first)
+{
+  if (first)
+    {
+      box->x1 = box->x2 = x;
+      box->y1 = box->y2 = y;
+    }
+  else
+    {
+      box->x1 = MIN (box->x1, x);
+      box->y1 = MIN (box->y1, y);
+      box->x2 = MAX (box->x2, x);
+      box->y2 = MAX (box->y2, y);
+    }
+}
+
+/* Intersects @stage_box with the clip of @actor, if any */
+static void
+stage_box_clip_to_actor (ClutterActorBox *stage_box,
+                         ClutterActor    *actor)
+{
+  ClutterActorPrivate *priv = actor->priv;
+  ClutterActorBox clip, box;
+  int i;
+
+  if (priv->has_clip)
+    {
+      clip.x1 = priv->clip.x;
+      clip.y1 = priv->clip.y;
+      clip.x2 = priv->clip.x + priv->clip.width;
+      clip.y2 = priv->clip.y + priv->clip.height;
+    }
+  else if (priv->clip_to_allocation)
+    {
+      clip.x1 = 0;
+      clip.y1 = 0;
+      clip.x2 = priv->allocation.x2 - priv->allocation.x1;
+      clip.y2 = priv->allocation.y2 - priv->allocation.y1;
+    }
+  else
+    return;
+
+  for (i = 0; i < 4; i++)
+    {
+      ClutterVertex point, stage_point;
+
+      point.x = (i & 1) ? clip.x2 : clip.x1;
+      point.y = (i & 2) ? clip.y2 : clip.y1;
+      point.z = 0.f;
+
+      clutter_actor_apply_transform_to_point (actor, &point, &stage_point);
+      stage_box_add_point (&box, stage_point.x, stage_point.y, i == 0);
+    }
+
+  stage_box->x1 = MAX (stage_box->x1, box.x1);
+  stage_box->y1 = MAX (stage_box->y1, box.y1);
+  stage_box->x2 = MIN (stage_box->x2, box.x2);
+  stage_box->y2 = MIN (stage_box->y2, box.y2);
+}
+
+/*< private >
+ * _clutter_actor_get_visible_box:
+ * @self: a #ClutterActor
+ * @box: (out): return location for the visible box
+ *
+ * While painting, retrieves the bounding box of the part of @self that
+ * can end up on the stage, in the coordinate space of @self; the box is
+ * the stage redraw clip, intersected with the clip of @self and of each
+ * one of its ancestors.
+ *
+ * Actors painting large amounts of content, like long texts, can use
+ * this function to skip the parts that are not visible.
+ *
+ * Return value: %TRUE if the box could be determined, and %FALSE
+ *   if @self is painted through a clone or into an offscreen buffer,
+ *   or if its transformation cannot be inverted
+ */
+gboolean
+_clutter_actor_get_visible_box (ClutterActor    *self,
+                                ClutterActorBox *box)
+{
+  cairo_rectangle_int_t redraw_clip;
+  ClutterActorBox stage_box;
+  ClutterActor *stage, *iter;
+  int i;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL)
+    return FALSE;
+
+  /* the stage coordinates are meaningless when painting through a
+   * clone, or when painting into an offscreen buffer
+   */
+  if (in_clone_paint ())
+    return FALSE;
+
+  if (cogl_get_draw_framebuffer () !=
+      _clutter_stage_get_active_framebuffer (CLUTTER_STAGE (stage)))
+    return FALSE;
+
+  clutter_stage_get_redraw_clip_bounds (CLUTTER_STAGE (stage), &redraw_clip);
+  stage_box.x1 = redraw_clip.x;
+  stage_box.y1 = redraw_clip.y;
+  stage_box.x2 = redraw_clip.x + redraw_clip.width;
+  stage_box.y2 = redraw_clip.y + redraw_clip.height;
+
+  for (iter = self; iter != stage; iter = iter->priv->parent)
+    stage_box_clip_to_actor (&stage_box, iter);
+
+  if (stage_box.x2 <= stage_box.x1 || stage_box.y2 <= stage_box.y1)
+    {
+      box->x1 = box->x2 = 0.f;
+      box->y1 = box->y2 = 0.f;
+      return TRUE;
+    }
+
+  for (i = 0; i < 4; i++)
+    {
+      gfloat x, y;
+
+      if (!clutter_actor_transform_stage_point (self,
+                                                (i & 1) ? stage_box.x2 : stage_box.x1,
+                                                (i & 2) ? stage_box.y2 : stage_box.y1,
+                                                &x, &y))
+        return FALSE;
+
+      stage_box_add_point (box, x, y, i == 0);
+    }
+
+  return TRUE;
+}
+
 /**
  * clutter_actor_has_overlaps:
  * @self: A #ClutterActor
@@ -16761,6 +17939,7 @@ clutter_actor_set_background_color_internal (ClutterActor *self,
   priv->bg_color = *color;
   priv->bg_color_set = TRUE;
 
+  _clutter_actor_invalidate_paint_node (self);
   clutter_actor_queue_redraw (self);
 
   g_object_notify_by_pspec (obj, obj_props[PROP_BACKGROUND_COLOR_SET]);
@@ -16803,6 +17982,7 @@ clutter_actor_set_background_color (ClutterActor       *self,
     {
       priv->bg_color_set = FALSE;
       g_object_notify_by_pspec (obj, obj_props[PROP_BACKGROUND_COLOR_SET]);
+      _clutter_actor_invalidate_paint_node (self);
       clutter_actor_queue_redraw (self);
       return;
     }
@@ -17124,172 +18304,558 @@ clutter_actor_iter_destroy (ClutterActorIter *iter)
   RealActorIter *ri = (RealActorIter *) iter;
   ClutterActor *cur;
 
-  g_return_if_fail (iter != NULL);
-  g_return_if_fail (ri->root != NULL);
-#ifndef G_DISABLE_ASSERT
-  g_return_if_fail (ri->age == ri->root->priv->age);
-#endif
-  g_return_if_fail (ri->current != NULL);
+  g_return_if_fail (iter != NULL);
+  g_return_if_fail (ri->root != NULL);
+#ifndef G_DISABLE_ASSERT
+  g_return_if_fail (ri->age == ri->root->priv->age);
+#endif
+  g_return_if_fail (ri->current != NULL);
+
+  cur = ri->current;
+
+  if (cur != NULL)
+    {
+      ri->current = cur->priv->prev_sibling;
+
+      clutter_actor_destroy (cur);
+
+      ri->age += 1;
+    }
+}
+
+static const ClutterAnimationInfo default_animation_info = {
+  NULL,         /* transitions */
+  NULL,         /* states */
+  NULL,         /* cur_state */
+  -1,           /* batched_transitions */
+};
+
+static ClutterTransitionBatch *
+clutter_actor_get_transition_batch (void)
+{
+  ClutterMasterClock *master_clock = _clutter_master_clock_get_default ();
+
+  return _clutter_master_clock_get_transition_batch (master_clock);
+}
+
+static void
+clutter_animation_info_free (gpointer data)
+{
+  if (data != NULL)
+    {
+      ClutterAnimationInfo *info = data;
+
+      if (info->transitions != NULL)
+        g_hash_table_unref (info->transitions);
+
+      if (info->batched_transitions != -1)
+        _clutter_transition_batch_remove_all (clutter_actor_get_transition_batch (),
+                                              &info->batched_transitions);
+
+      if (info->states != NULL)
+        g_array_unref (info->states);
+
+      g_slice_free (ClutterAnimationInfo, info);
+    }
+}
+
+const ClutterAnimationInfo *
+_clutter_actor_get_animation_info_or_defaults (ClutterActor *self)
+{
+  const ClutterAnimationInfo *res;
+  GObject *obj = G_OBJECT (self);
+
+  res = g_object_get_qdata (obj, quark_actor_animation_info);
+  if (res != NULL)
+    return res;
+
+  return &default_animation_info;
+}
+
+ClutterAnimationInfo *
+_clutter_actor_get_animation_info (ClutterActor *self)
+{
+  GObject *obj = G_OBJECT (self);
+  ClutterAnimationInfo *res;
+
+  res = g_object_get_qdata (obj, quark_actor_animation_info);
+  if (res == NULL)
+    {
+      res = g_slice_new (ClutterAnimationInfo);
+
+      *res = default_animation_info;
+
+      g_object_set_qdata_full (obj, quark_actor_animation_info,
+                               res,
+                               clutter_animation_info_free);
+    }
+
+  return res;
+}
+
+ClutterTransition *
+_clutter_actor_get_transition (ClutterActor *actor,
+                               GParamSpec   *pspec)
+{
+  const ClutterAnimationInfo *info;
+
+  info = _clutter_actor_get_animation_info_or_defaults (actor);
+
+  if (info->transitions == NULL)
+    return NULL;
+
+  return g_hash_table_lookup (info->transitions, pspec->name);
+}
+
+typedef struct _TransitionClosure
+{
+  ClutterActor *actor;
+  ClutterTransition *transition;
+  gchar *name;
+  gulong completed_id;
+} TransitionClosure;
+
+static void
+transition_closure_free (gpointer data)
+{
+  if (G_LIKELY (data != NULL))
+    {
+      TransitionClosure *clos = data;
+      ClutterTimeline *timeline;
+
+      timeline = CLUTTER_TIMELINE (clos->transition);
+
+      if (clutter_timeline_is_playing (timeline))
+        clutter_timeline_stop (timeline);
+
+      g_signal_handler_disconnect (clos->transition, clos->completed_id);
+
+      g_object_unref (clos->transition);
+      g_free (clos->name);
+
+      g_slice_free (TransitionClosure, clos);
+    }
+}
+
+static void
+on_transition_completed (ClutterTransition *transition,
+                         TransitionClosure *clos)
+{
+  ClutterTimeline *timeline = CLUTTER_TIMELINE (transition);
+  ClutterActor *actor = clos->actor;
+  ClutterAnimationInfo *info;
+  gint n_repeats, cur_repeat;
+
+  info = _clutter_actor_get_animation_info (actor);
+
+  /* reset the caches used by animations */
+  clutter_actor_store_content_box (actor, NULL);
+
+  /* ensure that we remove the transition only at the end
+   * of its run; we emit ::completed for every repeat
+   */
+  n_repeats = clutter_timeline_get_repeat_count (timeline);
+  cur_repeat = clutter_timeline_get_current_repeat (timeline);
+
+  if (cur_repeat == n_repeats)
+    {
+      if (clutter_transition_get_remove_on_complete (transition))
+        {
+          /* we take a reference here because removing the closure
+           * will release the reference on the transition, and we
+           * want the transition to survive the signal emission;
+           * the master clock will release the last reference at
+           * the end of the frame processing.
+           */
+          g_object_ref (transition);
+          g_hash_table_remove (info->transitions, clos->name);
+        }
+    }
+
+  /* if it's the last transition then we clean up */
+  if (g_hash_table_size (info->transitions) == 0)
+    {
+      g_hash_table_unref (info->transitions);
+      info->transitions = NULL;
+
+      if (info->batched_transitions == -1)
+        {
+          CLUTTER_NOTE (ANIMATION, "Transitions for '%s' completed",
+                        _clutter_actor_get_debug_name (actor));
+
+          g_signal_emit (actor, actor_signals[TRANSITIONS_COMPLETED], 0);
+        }
+    }
+}
+
+/* Converts the value of an animatable property into the channels
+ * used by the transition batch; returns the number of channels, or
+ * 0 if the property cannot be batched
+ */
+static guint
+clutter_actor_value_to_channels (GParamSpec   *pspec,
+                                 const GValue *value,
+                                 float        *channels)
+{
+  if (pspec->param_id >= PROP_LAST || obj_props[pspec->param_id] != pspec)
+    return 0;
+
+  switch (pspec->param_id)
+    {
+    case PROP_X:
+    case PROP_Y:
+    case PROP_WIDTH:
+    case PROP_HEIGHT:
+    case PROP_DEPTH:
+      channels[0] = g_value_get_float (value);
+      return 1;
+
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+      channels[0] = g_value_get_double (value);
+      return 1;
+
+    case PROP_OPACITY:
+      channels[0] = g_value_get_uint (value);
+      return 1;
+
+    case PROP_POSITION:
+      {
+        const ClutterPoint *point = g_value_get_boxed (value);
+
+        if (point == NULL)
+          return 0;
+
+        channels[0] = point->x;
+        channels[1] = point->y;
+      }
+      return 2;
+
+    case PROP_SIZE:
+      {
+        const ClutterSize *size = g_value_get_boxed (value);
+
+        if (size == NULL)
+          return 0;
+
+        channels[0] = size->width;
+        channels[1] = size->height;
+      }
+      return 2;
+
+    case PROP_ALLOCATION:
+      {
+        const ClutterActorBox *box = g_value_get_boxed (value);
+
+        if (box == NULL)
+          return 0;
+
+        channels[0] = box->x1;
+        channels[1] = box->y1;
+        channels[2] = box->x2;
+        channels[3] = box->y2;
+      }
+      return 4;
+
+    case PROP_BACKGROUND_COLOR:
+      {
+        const ClutterColor *color = clutter_value_get_color (value);
+
+        if (color == NULL)
+          return 0;
+
+        channels[0] = color->red;
+        channels[1] = color->green;
+        channels[2] = color->blue;
+        channels[3] = color->alpha;
+      }
+      return 4;
+
+    default:
+      break;
+    }
+
+  return 0;
+}
+
+static inline guint8
+clutter_actor_channel_to_byte (float channel)
+{
+  /* easing modes like "back" and "elastic" overshoot */
+  return CLAMP (channel, 0.f, 255.f);
+}
+
+/* The inverse of clutter_actor_value_to_channels(); @value must be
+ * initialized to the type of @pspec
+ */
+static void
+clutter_actor_channels_to_value (GParamSpec  *pspec,
+                                 const float *channels,
+                                 GValue      *value)
+{
+  switch (pspec->param_id)
+    {
+    case PROP_X:
+    case PROP_Y:
+    case PROP_WIDTH:
+    case PROP_HEIGHT:
+    case PROP_DEPTH:
+      g_value_set_float (value, channels[0]);
+      break;
+
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+      g_value_set_double (value, channels[0]);
+      break;
+
+    case PROP_OPACITY:
+      g_value_set_uint (value, clutter_actor_channel_to_byte (channels[0]));
+      break;
+
+    case PROP_POSITION:
+      {
+        ClutterPoint point = CLUTTER_POINT_INIT (channels[0], channels[1]);
+
+        g_value_set_boxed (value, &point);
+      }
+      break;
+
+    case PROP_SIZE:
+      {
+        ClutterSize size = CLUTTER_SIZE_INIT (channels[0], channels[1]);
+
+        g_value_set_boxed (value, &size);
+      }
+      break;
+
+    case PROP_ALLOCATION:
+      {
+        ClutterActorBox box = CLUTTER_ACTOR_BOX_INIT (channels[0],
+                                                      channels[1],
+                                                      channels[2],
+                                                      channels[3]);
+
+        g_value_set_boxed (value, &box);
+      }
+      break;
 
-  cur = ri->current;
+    case PROP_BACKGROUND_COLOR:
+      {
+        ClutterColor color;
 
-  if (cur != NULL)
-    {
-      ri->current = cur->priv->prev_sibling;
+        color.red = clutter_actor_channel_to_byte (channels[0]);
+        color.green = clutter_actor_channel_to_byte (channels[1]);
+        color.blue = clutter_actor_channel_to_byte (channels[2]);
+        color.alpha = clutter_actor_channel_to_byte (channels[3]);
 
-      clutter_actor_destroy (cur);
+        clutter_value_set_color (value, &color);
+      }
+      break;
 
-      ri->age += 1;
+    default:
+      g_assert_not_reached ();
     }
 }
 
-static const ClutterAnimationInfo default_animation_info = {
-  NULL,         /* transitions */
-  NULL,         /* states */
-  NULL,         /* cur_state */
-};
-
+/* Applies the state of a batched transition directly, without going
+ * through GValue and the ClutterAnimatable interface
+ */
 static void
-clutter_animation_info_free (gpointer data)
+clutter_actor_apply_batched_transition (gpointer     target,
+                                        gpointer     key,
+                                        const float *values,
+                                        gboolean     is_complete)
 {
-  if (data != NULL)
+  ClutterActor *actor = target;
+  GParamSpec *pspec = key;
+  GObject *obj = G_OBJECT (actor);
+
+  g_object_freeze_notify (obj);
+
+  switch (pspec->param_id)
     {
-      ClutterAnimationInfo *info = data;
+    case PROP_X:
+      clutter_actor_set_x_internal (actor, values[0]);
+      break;
 
-      if (info->transitions != NULL)
-        g_hash_table_unref (info->transitions);
+    case PROP_Y:
+      clutter_actor_set_y_internal (actor, values[0]);
+      break;
 
-      if (info->states != NULL)
-        g_array_unref (info->states);
+    case PROP_POSITION:
+      {
+        ClutterPoint point = CLUTTER_POINT_INIT (values[0], values[1]);
 
-      g_slice_free (ClutterAnimationInfo, info);
-    }
-}
+        clutter_actor_set_position_internal (actor, &point);
+      }
+      break;
 
-const ClutterAnimationInfo *
-_clutter_actor_get_animation_info_or_defaults (ClutterActor *self)
-{
-  const ClutterAnimationInfo *res;
-  GObject *obj = G_OBJECT (self);
+    case PROP_WIDTH:
+      clutter_actor_set_width_internal (actor, values[0]);
+      break;
 
-  res = g_object_get_qdata (obj, quark_actor_animation_info);
-  if (res != NULL)
-    return res;
+    case PROP_HEIGHT:
+      clutter_actor_set_height_internal (actor, values[0]);
+      break;
 
-  return &default_animation_info;
-}
+    case PROP_SIZE:
+      {
+        ClutterSize size = CLUTTER_SIZE_INIT (values[0], values[1]);
 
-ClutterAnimationInfo *
-_clutter_actor_get_animation_info (ClutterActor *self)
-{
-  GObject *obj = G_OBJECT (self);
-  ClutterAnimationInfo *res;
+        clutter_actor_set_size_internal (actor, &size);
+      }
+      break;
 
-  res = g_object_get_qdata (obj, quark_actor_animation_info);
-  if (res == NULL)
-    {
-      res = g_slice_new (ClutterAnimationInfo);
+    case PROP_ALLOCATION:
+      {
+        ClutterActorBox box = CLUTTER_ACTOR_BOX_INIT (values[0], values[1],
+                                                      values[2], values[3]);
 
-      *res = default_animation_info;
+        clutter_actor_allocate_internal (actor, &box,
+                                         actor->priv->allocation_flags);
+      }
+      break;
 
-      g_object_set_qdata_full (obj, quark_actor_animation_info,
-                               res,
-                               clutter_animation_info_free);
-    }
+    case PROP_DEPTH:
+      clutter_actor_set_depth_internal (actor, values[0]);
+      break;
 
-  return res;
-}
+    case PROP_OPACITY:
+      clutter_actor_set_opacity_internal (actor,
+                                          clutter_actor_channel_to_byte (values[0]));
+      break;
 
-ClutterTransition *
-_clutter_actor_get_transition (ClutterActor *actor,
-                               GParamSpec   *pspec)
-{
-  const ClutterAnimationInfo *info;
+    case PROP_BACKGROUND_COLOR:
+      {
+        ClutterColor color;
 
-  info = _clutter_actor_get_animation_info_or_defaults (actor);
+        color.red = clutter_actor_channel_to_byte (values[0]);
+        color.green = clutter_actor_channel_to_byte (values[1]);
+        color.blue = clutter_actor_channel_to_byte (values[2]);
+        color.alpha = clutter_actor_channel_to_byte (values[3]);
 
-  if (info->transitions == NULL)
-    return NULL;
+        clutter_actor_set_background_color_internal (actor, &color);
+      }
+      break;
 
-  return g_hash_table_lookup (info->transitions, pspec->name);
-}
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+      clutter_actor_set_scale_factor_internal (actor, values[0], pspec);
+      break;
 
-typedef struct _TransitionClosure
-{
-  ClutterActor *actor;
-  ClutterTransition *transition;
-  gchar *name;
-  gulong completed_id;
-} TransitionClosure;
+    case PROP_ROTATION_ANGLE_X:
+      clutter_actor_set_rotation_angle_internal (actor, CLUTTER_X_AXIS,
+                                                 values[0]);
+      break;
 
-static void
-transition_closure_free (gpointer data)
-{
-  if (G_LIKELY (data != NULL))
-    {
-      TransitionClosure *clos = data;
-      ClutterTimeline *timeline;
+    case PROP_ROTATION_ANGLE_Y:
+      clutter_actor_set_rotation_angle_internal (actor, CLUTTER_Y_AXIS,
+                                                 values[0]);
+      break;
 
-      timeline = CLUTTER_TIMELINE (clos->transition);
+    case PROP_ROTATION_ANGLE_Z:
+      clutter_actor_set_rotation_angle_internal (actor, CLUTTER_Z_AXIS,
+                                                 values[0]);
+      break;
 
-      if (clutter_timeline_is_playing (timeline))
-        clutter_timeline_stop (timeline);
+    default:
+      g_assert_not_reached ();
+    }
 
-      g_signal_handler_disconnect (clos->transition, clos->completed_id);
+  g_object_thaw_notify (obj);
 
-      g_object_unref (clos->transition);
-      g_free (clos->name);
+  if (is_complete)
+    {
+      const ClutterAnimationInfo *info;
 
-      g_slice_free (TransitionClosure, clos);
+      /* reset the caches used by animations */
+      clutter_actor_store_content_box (actor, NULL);
+
+      info = _clutter_actor_get_animation_info_or_defaults (actor);
+      if (info->batched_transitions == -1 &&
+          (info->transitions == NULL ||
+           g_hash_table_size (info->transitions) == 0))
+        {
+          CLUTTER_NOTE (ANIMATION, "Transitions for '%s' completed",
+                        _clutter_actor_get_debug_name (actor));
+
+          g_signal_emit (actor, actor_signals[TRANSITIONS_COMPLETED], 0);
+        }
     }
 }
 
-static void
-on_transition_completed (ClutterTransition *transition,
-                         TransitionClosure *clos)
+/* Replaces a batched transition with a ClutterTransition in the
+ * same state, for the code that needs to access it
+ */
+static ClutterTransition *
+clutter_actor_unbatch_transition (ClutterActor *self,
+                                  GParamSpec   *pspec,
+                                  gint          slot)
 {
-  ClutterTimeline *timeline = CLUTTER_TIMELINE (transition);
-  ClutterActor *actor = clos->actor;
-  ClutterAnimationInfo *info;
-  gint n_repeats, cur_repeat;
+  float from[CLUTTER_TRANSITION_BATCH_MAX_CHANNELS];
+  float to[CLUTTER_TRANSITION_BATCH_MAX_CHANNELS];
+  ClutterTransitionBatch *batch;
+  ClutterAnimationMode mode;
+  ClutterTransition *res;
+  ClutterTimeline *timeline;
+  ClutterInterval *interval;
+  GValue initial = G_VALUE_INIT;
+  GValue final = G_VALUE_INIT;
+  GType ptype;
+  guint duration;
+  gint elapsed;
 
-  info = _clutter_actor_get_animation_info (actor);
+  batch = clutter_actor_get_transition_batch ();
 
-  /* reset the caches used by animations */
-  clutter_actor_store_content_box (actor, NULL);
+  _clutter_transition_batch_get_state (batch, slot,
+                                       from, to,
+                                       &elapsed,
+                                       &duration,
+                                       &mode);
+  _clutter_transition_batch_remove (batch, slot);
 
-  /* ensure that we remove the transition only at the end
-   * of its run; we emit ::completed for every repeat
-   */
-  n_repeats = clutter_timeline_get_repeat_count (timeline);
-  cur_repeat = clutter_timeline_get_current_repeat (timeline);
+  ptype = G_PARAM_SPEC_VALUE_TYPE (pspec);
 
-  if (cur_repeat == n_repeats)
-    {
-      if (clutter_transition_get_remove_on_complete (transition))
-        {
-          /* we take a reference here because removing the closure
-           * will release the reference on the transition, and we
-           * want the transition to survive the signal emission;
-           * the master clock will release the last reference at
-           * the end of the frame processing.
-           */
-          g_object_ref (transition);
-          g_hash_table_remove (info->transitions, clos->name);
-        }
-    }
+  g_value_init (&initial, ptype);
+  clutter_actor_channels_to_value (pspec, from, &initial);
 
-  /* if it's the last transition then we clean up */
-  if (g_hash_table_size (info->transitions) == 0)
-    {
-      g_hash_table_unref (info->transitions);
-      info->transitions = NULL;
+  g_value_init (&final, ptype);
+  clutter_actor_channels_to_value (pspec, to, &final);
 
-      CLUTTER_NOTE (ANIMATION, "Transitions for '%s' completed",
-                    _clutter_actor_get_debug_name (actor));
+  interval = clutter_interval_new_with_values (ptype, &initial, &final);
 
-      g_signal_emit (actor, actor_signals[TRANSITIONS_COMPLETED], 0);
-    }
+  g_value_unset (&initial);
+  g_value_unset (&final);
+
+  res = clutter_property_transition_new (pspec->name);
+
+  clutter_transition_set_interval (res, interval);
+  clutter_transition_set_remove_on_complete (res, TRUE);
+
+  timeline = CLUTTER_TIMELINE (res);
+  clutter_timeline_set_delay (timeline, elapsed < 0 ? -elapsed : 0);
+  clutter_timeline_set_duration (timeline, duration);
+  clutter_timeline_set_progress_mode (timeline, mode);
+
+  clutter_actor_add_transition (self, pspec->name, res);
+
+  if (elapsed > 0)
+    clutter_timeline_advance (timeline, elapsed);
+
+  /* the actor now owns the transition */
+  g_object_unref (res);
+
+  CLUTTER_NOTE (ANIMATION, "Unbatched transition '%s' of actor '%s'",
+                pspec->name,
+                _clutter_actor_get_debug_name (self));
+
+  return res;
 }
 
 void
@@ -17379,7 +18945,14 @@ out:
  *
  * Creates a #ClutterTransition for the property represented by @pspec.
  *
- * Return value: a #ClutterTransition
+ * Transitions of the properties that can be represented with a few
+ * floating point values, like the position or the opacity, and that
+ * use a predefined easing mode are not backed by a #ClutterTransition:
+ * they are stored inside the transition batch of the master clock, and
+ * retargeted if a transition for @pspec is already running.
+ *
+ * Return value: a #ClutterTransition, or %NULL if the transition was
+ *   batched or if the easing state has a duration of 0 milliseconds
  */
 ClutterTransition *
 _clutter_actor_create_transition (ClutterActor *actor,
@@ -17409,22 +18982,26 @@ _clutter_actor_create_transition (ClutterActor *actor,
       call_restore = TRUE;
     }
 
-  if (info->transitions == NULL)
-    info->transitions = g_hash_table_new_full (g_str_hash, g_str_equal,
-                                               NULL,
-                                               transition_closure_free);
-
   va_start (var_args, pspec);
 
-  clos = g_hash_table_lookup (info->transitions, pspec->name);
+  if (info->transitions != NULL)
+    clos = g_hash_table_lookup (info->transitions, pspec->name);
+  else
+    clos = NULL;
+
   if (clos == NULL)
     {
+      float from[CLUTTER_TRANSITION_BATCH_MAX_CHANNELS];
+      float to[CLUTTER_TRANSITION_BATCH_MAX_CHANNELS];
+      ClutterTransitionBatch *batch;
       ClutterTimeline *timeline;
       ClutterInterval *interval;
       GValue initial = G_VALUE_INIT;
       GValue final = G_VALUE_INIT;
+      guint n_channels;
       GType ptype;
       char *error;
+      gint slot;
 
       ptype = G_PARAM_SPEC_VALUE_TYPE (pspec);
 
@@ -17450,6 +19027,31 @@ _clutter_actor_create_transition (ClutterActor *actor,
           goto out;
         }
 
+      batch = clutter_actor_get_transition_batch ();
+      n_channels = clutter_actor_value_to_channels (pspec, &final, to);
+
+      /* if a batched transition is already running, we retarget it
+       * from its current state; a duration of 0 will make it jump
+       * to the final state on the next frame
+       */
+      if (info->batched_transitions != -1)
+        slot = _clutter_transition_batch_lookup (batch,
+                                                 info->batched_transitions,
+                                                 pspec);
+      else
+        slot = -1;
+
+      if (slot != -1)
+        {
+          _clutter_transition_batch_retarget (batch, slot, to,
+                                              info->cur_state->easing_duration,
+                                              info->cur_state->easing_mode);
+          g_value_unset (&initial);
+          g_value_unset (&final);
+
+          goto out;
+        }
+
       /* if the current easing state has a duration of 0, then we don't
        * bother to create the transition, and we just set the final value
        * directly on the actor; we don't go through the Animatable
@@ -17468,6 +19070,34 @@ _clutter_actor_create_transition (ClutterActor *actor,
           goto out;
         }
 
+      /* the master clock advances the transitions of simple
+       * properties in batches, which is cheaper than using a
+       * timeline and an interval for each one of them
+       */
+      if (n_channels > 0 &&
+          clutter_actor_value_to_channels (pspec, &initial, from) == n_channels)
+        {
+          _clutter_transition_batch_add (batch,
+                                         &info->batched_transitions,
+                                         actor, pspec,
+                                         clutter_actor_apply_batched_transition,
+                                         n_channels, from, to,
+                                         info->cur_state->easing_delay,
+                                         info->cur_state->easing_duration,
+                                         info->cur_state->easing_mode);
+          g_value_unset (&initial);
+          g_value_unset (&final);
+
+          CLUTTER_NOTE (ANIMATION,
+                        "Adding batched transition '%s' to actor '%s'",
+                        pspec->name,
+                        _clutter_actor_get_debug_name (actor));
+
+          _clutter_master_clock_start_running (_clutter_master_clock_get_default ());
+
+          goto out;
+        }
+
       interval = clutter_interval_new_with_values (ptype, &initial, &final);
 
       g_value_unset (&initial);
@@ -17598,6 +19228,23 @@ clutter_actor_remove_transition (ClutterActor *self,
 
   info = _clutter_actor_get_animation_info_or_defaults (self);
 
+  if (info->batched_transitions != -1)
+    {
+      ClutterTransitionBatch *batch = clutter_actor_get_transition_batch ();
+      GParamSpec *pspec;
+      gint slot;
+
+      pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (self), name);
+      slot = _clutter_transition_batch_lookup (batch,
+                                               info->batched_transitions,
+                                               pspec);
+      if (slot != -1)
+        {
+          _clutter_transition_batch_remove (batch, slot);
+          return;
+        }
+    }
+
   if (info->transitions == NULL)
     return;
 
@@ -17620,6 +19267,15 @@ clutter_actor_remove_all_transitions (ClutterActor *self)
   g_return_if_fail (CLUTTER_IS_ACTOR (self));
 
   info = _clutter_actor_get_animation_info_or_defaults (self);
+
+  if (info->batched_transitions != -1)
+    {
+      ClutterAnimationInfo *real_info = _clutter_actor_get_animation_info (self);
+
+      _clutter_transition_batch_remove_all (clutter_actor_get_transition_batch (),
+                                            &real_info->batched_transitions);
+    }
+
   if (info->transitions == NULL)
     return;
 
@@ -17840,6 +19496,21 @@ clutter_actor_get_transition (ClutterActor *self,
   g_return_val_if_fail (name != NULL, NULL);
 
   info = _clutter_actor_get_animation_info_or_defaults (self);
+
+  /* batched transitions are turned into real ones on demand */
+  if (info->batched_transitions != -1)
+    {
+      GParamSpec *pspec;
+      gint slot;
+
+      pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (self), name);
+      slot = _clutter_transition_batch_lookup (clutter_actor_get_transition_batch (),
+                                               info->batched_transitions,
+                                               pspec);
+      if (slot != -1)
+        return clutter_actor_unbatch_transition (self, pspec, slot);
+    }
+
   if (info->transitions == NULL)
     return NULL;
 
@@ -17956,6 +19627,7 @@ clutter_actor_set_content (ClutterActor   *self,
   /* given that the content is always painted within the allocation,
    * we only need to queue a redraw here
    */
+  _clutter_actor_invalidate_paint_node (self);
   clutter_actor_queue_redraw (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_CONTENT]);
@@ -18044,6 +19716,7 @@ clutter_actor_set_content_gravity (ClutterActor *self,
                                         &to_box);
     }
 
+  _clutter_actor_invalidate_paint_node (self);
   clutter_actor_queue_redraw (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_CONTENT_GRAVITY]);
@@ -18338,7 +20011,10 @@ clutter_actor_set_content_scaling_filters (ClutterActor         *self,
     }
 
   if (changed)
-    clutter_actor_queue_redraw (self);
+    {
+      _clutter_actor_invalidate_paint_node (self);
+      clutter_actor_queue_redraw (self);
+    }
 
   g_object_thaw_notify (obj);
 }
@@ -180,7 +180,8 @@ struct _ClutterActor
  *   to get the correct opacity. See
  *   clutter_actor_set_offscreen_redirect() for details.
  * @paint_node: virtual function for creating paint nodes and attaching
- *   them to the render tree
+ *   them to the render tree; the nodes are kept across frames, until
+ *   the actor queues a redraw
  *
  * Base class for actors.
  */
@@ -478,6 +479,13 @@ void                            clutter_actor_set_offscreen_redirect
                                                                                  ClutterOffscreenRedirect    redirect);
 ClutterOffscreenRedirect        clutter_actor_get_offscreen_redirect            (ClutterActor               *self);
 gboolean                        clutter_actor_should_pick_paint                 (ClutterActor               *self);
+CLUTTER_AVAILABLE_IN_1_12
+void                            clutter_actor_pick_box                          (ClutterActor               *self,
+                                                                                 const ClutterActorBox      *box);
+CLUTTER_AVAILABLE_IN_1_12
+void                            clutter_actor_pick_polygon                      (ClutterActor               *self,
+                                                                                 const ClutterPoint         *points,
+                                                                                 guint                       n_points);
 gboolean                        clutter_actor_is_in_clone_paint                 (ClutterActor               *self);
 gboolean                        clutter_actor_get_paint_box                     (ClutterActor               *self,
                                                                                  ClutterActorBox            *box);
@@ -92,7 +92,7 @@ source_position_changed (ClutterActor           *actor,
                          ClutterAlignConstraint *align)
 {
   if (align->actor != NULL)
-    clutter_actor_queue_relayout (align->actor);
+    _clutter_actor_queue_only_reallocation (align->actor);
 }
 
 static void
@@ -422,7 +422,7 @@ clutter_align_constraint_set_source (ClutterAlignConstraint *align,
                         align);
 
       if (align->actor != NULL)
-        clutter_actor_queue_relayout (align->actor);
+        _clutter_actor_queue_only_reallocation (align->actor);
     }
 
   g_object_notify_by_pspec (G_OBJECT (align), obj_props[PROP_SOURCE]);
@@ -468,7 +468,7 @@ clutter_align_constraint_set_align_axis (ClutterAlignConstraint *align,
   align->align_axis = axis;
 
   if (align->actor != NULL)
-    clutter_actor_queue_relayout (align->actor);
+    _clutter_actor_queue_only_reallocation (align->actor);
 
   g_object_notify_by_pspec (G_OBJECT (align), obj_props[PROP_ALIGN_AXIS]);
 }
@@ -520,7 +520,7 @@ clutter_align_constraint_set_factor (ClutterAlignConstraint *align,
   align->factor = CLAMP (factor, 0.0, 1.0);
 
   if (align->actor != NULL)
-    clutter_actor_queue_relayout (align->actor);
+    _clutter_actor_queue_only_reallocation (align->actor);
 
   g_object_notify_by_pspec (G_OBJECT (align), obj_props[PROP_FACTOR]);
 }
@@ -136,6 +136,10 @@ gfloat                  _clutter_backend_get_units_per_em               (Clutter
                                                                          PangoFontDescription   *font_desc);
 gint32                  _clutter_backend_get_units_serial               (ClutterBackend         *backend);
 
+void                    _clutter_backend_set_swap_chain_length          (ClutterBackend         *backend,
+                                                                         gint                    length);
+gint                    _clutter_backend_get_swap_chain_length          (ClutterBackend         *backend);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_BACKEND_PRIVATE_H__ */
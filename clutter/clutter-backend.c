@@ -107,6 +107,9 @@ struct _ClutterBackendPrivate
   gint32 units_serial;
 
   GList *event_translators;
+
+  /* the number of buffers of the swap chain of the stages */
+  gint swap_chain_length;
 };
 
 enum
@@ -259,6 +262,7 @@ clutter_backend_real_create_context (ClutterBackend  *backend,
   ClutterBackendClass *klass;
   CoglSwapChain *swap_chain;
   GError *internal_error;
+  const gchar *env_string;
 
   if (backend->cogl_context != NULL)
     return TRUE;
@@ -292,6 +296,16 @@ clutter_backend_real_create_context (ClutterBackend  *backend,
   CLUTTER_NOTE (BACKEND, "Creating Cogl swap chain");
   swap_chain = cogl_swap_chain_new ();
 
+  env_string = g_getenv ("CLUTTER_SWAP_CHAIN_LENGTH");
+  if (env_string != NULL)
+    {
+      gint length = g_ascii_strtoll (env_string, NULL, 10);
+
+      backend->priv->swap_chain_length = CLAMP (length, 1, 4);
+      cogl_swap_chain_set_length (swap_chain,
+                                  backend->priv->swap_chain_length);
+    }
+
   CLUTTER_NOTE (BACKEND, "Creating Cogl display");
   if (klass->get_display != NULL)
     {
@@ -667,6 +681,9 @@ clutter_backend_init (ClutterBackend *backend)
 
   priv->units_per_em = -1.0;
   priv->units_serial = 1;
+
+  /* assume double buffering unless told otherwise */
+  priv->swap_chain_length = 2;
 }
 
 void
@@ -1331,3 +1348,30 @@ clutter_wayland_set_compositor_display (struct wl_display *display)
   _wayland_compositor_display = display;
 }
 #endif
+
+/*< private >
+ * _clutter_backend_set_swap_chain_length:
+ * @backend: a #ClutterBackend
+ * @length: the number of buffers of the swap chain
+ *
+ * Sets the number of buffers used by the swap chain of the stages,
+ * for backends that know it; this is used to decide how many frames
+ * can be queued before waiting for a swap to complete.
+ */
+void
+_clutter_backend_set_swap_chain_length (ClutterBackend *backend,
+                                        gint            length)
+{
+  g_return_if_fail (CLUTTER_IS_BACKEND (backend));
+  g_return_if_fail (length >= 1);
+
+  backend->priv->swap_chain_length = length;
+}
+
+gint
+_clutter_backend_get_swap_chain_length (ClutterBackend *backend)
+{
+  g_return_val_if_fail (CLUTTER_IS_BACKEND (backend), 2);
+
+  return backend->priv->swap_chain_length;
+}
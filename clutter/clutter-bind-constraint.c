@@ -151,7 +151,7 @@ source_queue_relayout (ClutterActor          *source,
                        ClutterBindConstraint *bind)
 {
   if (bind->actor != NULL)
-    clutter_actor_queue_relayout (bind->actor);
+    _clutter_actor_queue_only_reallocation (bind->actor);
 }
 
 static void
@@ -490,7 +490,7 @@ clutter_bind_constraint_set_source (ClutterBindConstraint *constraint,
                         constraint);
 
       if (constraint->actor != NULL)
-        clutter_actor_queue_relayout (constraint->actor);
+        _clutter_actor_queue_only_reallocation (constraint->actor);
     }
 
   g_object_notify_by_pspec (G_OBJECT (constraint), obj_props[PROP_SOURCE]);
@@ -535,7 +535,7 @@ clutter_bind_constraint_set_coordinate (ClutterBindConstraint *constraint,
   constraint->coordinate = coordinate;
 
   if (constraint->actor != NULL)
-    clutter_actor_queue_relayout (constraint->actor);
+    _clutter_actor_queue_only_reallocation (constraint->actor);
 
   g_object_notify_by_pspec (G_OBJECT (constraint), obj_props[PROP_COORDINATE]);
 }
@@ -580,7 +580,7 @@ clutter_bind_constraint_set_offset (ClutterBindConstraint *constraint,
   constraint->offset = offset;
 
   if (constraint->actor != NULL)
-    clutter_actor_queue_relayout (constraint->actor);
+    _clutter_actor_queue_only_reallocation (constraint->actor);
 
   g_object_notify_by_pspec (G_OBJECT (constraint), obj_props[PROP_OFFSET]);
 }
@@ -36,6 +36,18 @@
  * that can be used to draw. #ClutterCanvas will emit the #ClutterCanvas::draw
  * signal when invalidated using clutter_content_invalidate().
  *
+ * If only a part of the canvas needs to be redrawn, you can use
+ * clutter_canvas_invalidate_rect() instead; the #ClutterCanvas::draw
+ * signal will be emitted with a #cairo_t clipped to the invalidated
+ * area, and only that area will be uploaded to the GPU.
+ *
+ * Drawing complex contents can take a long time; setting the
+ * #ClutterCanvas:draw-async property will move the emission of the
+ * #ClutterCanvas::draw signal to a worker thread, while the previous
+ * contents of the canvas are still used for painting. The new contents
+ * are uploaded, and the actors using the canvas are redrawn, once
+ * the drawing is complete.
+ *
  * <informalexample id="canvas-example">
  *   <programlisting>
  * <xi:include xmlns:xi="http://www.w3.org/2001/XInclude" parse="text" href="../../../../examples/canvas.c">
@@ -51,6 +63,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include <cogl/cogl.h>
 #include <cairo-gobject.h>
 
@@ -62,11 +76,15 @@
 #include "clutter-cairo.h"
 #include "clutter-color.h"
 #include "clutter-content-private.h"
+#include "clutter-debug.h"
 #include "clutter-marshal.h"
+#include "clutter-master-clock.h"
 #include "clutter-paint-node.h"
 #include "clutter-paint-nodes.h"
 #include "clutter-private.h"
 
+typedef struct _ClutterCanvasAsyncData  ClutterCanvasAsyncData;
+
 struct _ClutterCanvasPrivate
 {
   cairo_t *cr;
@@ -75,14 +93,72 @@ struct _ClutterCanvasPrivate
   int height;
 
   CoglBitmap *buffer;
+
+  /* the contents of the buffer, as seen by the GPU; the texture
+   * is only updated when painting, if the canvas has been drawn
+   * since the last paint
+   */
+  CoglTexture *texture;
+
+  /* the area of the buffer not uploaded to the texture yet */
+  cairo_rectangle_int_t dirty_area;
+
+  /* the pending asynchronous draw, if any */
+  ClutterCanvasAsyncData *async_data;
+
+  /* serializes the emissions of ::draw in the worker threads */
+  GMutex draw_lock;
+
+  guint texture_dirty : 1;
+  guint draw_async    : 1;
 };
 
+#define ASYNC_STATE_LOCKED      (1 << 0)
+#define ASYNC_STATE_CANCELLED   (1 << 1)
+
+/* the maximum number of canvases drawn at the same time */
+#define ASYNC_MAX_THREADS       4
+
+struct _ClutterCanvasAsyncData
+{
+  /* a reference on the canvas being drawn; it is only released in
+   * the main thread
+   */
+  ClutterCanvas *canvas;
+
+  /* the size of the canvas, and the area being drawn */
+  int width;
+  int height;
+  cairo_rectangle_int_t area;
+
+  /* the result of the draw, covering area; when drawing only a part
+   * of the canvas, it is created by the main thread and contains the
+   * previous contents of the area
+   */
+  cairo_surface_t *surface;
+
+  gint state;
+};
+
+static inline void
+clutter_canvas_async_data_lock (ClutterCanvasAsyncData *data)
+{
+  g_bit_lock (&data->state, 0);
+}
+
+static inline void
+clutter_canvas_async_data_unlock (ClutterCanvasAsyncData *data)
+{
+  g_bit_unlock (&data->state, 0);
+}
+
 enum
 {
   PROP_0,
 
   PROP_WIDTH,
   PROP_HEIGHT,
+  PROP_DRAW_ASYNC,
 
   LAST_PROP
 };
@@ -98,6 +174,11 @@ enum
 
 static guint canvas_signals[LAST_SIGNAL] = { 0, };
 
+static GThreadPool *async_thread_pool = NULL;
+static guint        repaint_upload_func = 0;
+static GList       *upload_list = NULL;
+static GMutex       upload_list_mutex;
+
 static void clutter_content_iface_init (ClutterContentIface *iface);
 
 G_DEFINE_TYPE_WITH_CODE (ClutterCanvas, clutter_canvas, G_TYPE_OBJECT,
@@ -131,12 +212,23 @@ clutter_canvas_finalize (GObject *gobject)
 {
   ClutterCanvasPrivate *priv = CLUTTER_CANVAS (gobject)->priv;
 
+  /* pending asynchronous draws hold a reference on the canvas */
+  g_assert (priv->async_data == NULL);
+
   if (priv->buffer != NULL)
     {
       cogl_object_unref (priv->buffer);
       priv->buffer = NULL;
     }
 
+  g_mutex_clear (&priv->draw_lock);
+
+  if (priv->texture != NULL)
+    {
+      cogl_object_unref (priv->texture);
+      priv->texture = NULL;
+    }
+
   G_OBJECT_CLASS (clutter_canvas_parent_class)->finalize (gobject);
 }
 
@@ -166,6 +258,11 @@ clutter_canvas_set_property (GObject      *gobject,
         }
       break;
 
+    case PROP_DRAW_ASYNC:
+      clutter_canvas_set_draw_async (CLUTTER_CANVAS (gobject),
+                                     g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -190,6 +287,10 @@ clutter_canvas_get_property (GObject    *gobject,
       g_value_set_int (value, priv->height);
       break;
 
+    case PROP_DRAW_ASYNC:
+      g_value_set_boolean (value, priv->draw_async);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -235,6 +336,31 @@ clutter_canvas_class_init (ClutterCanvasClass *klass)
                       G_PARAM_READWRITE |
                       G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ClutterCanvas:draw-async:
+   *
+   * Whether the #ClutterCanvas::draw signal should be emitted in a
+   * worker thread.
+   *
+   * While the canvas is being drawn, the actors using it will keep
+   * painting its previous contents; the new contents will be used
+   * once the drawing is complete. Invalidating the canvas again, or
+   * changing its size, cancels any drawing still in progress.
+   *
+   * The handlers of the #ClutterCanvas::draw signal of an asynchronous
+   * canvas must not use any Clutter API, nor access any state shared
+   * with the main thread without proper locking.
+   *
+   * Since: 1.12
+   */
+  obj_props[PROP_DRAW_ASYNC] =
+    g_param_spec_boolean ("draw-async",
+                          P_("Draw asynchronously"),
+                          P_("Whether the canvas should be drawn in a worker thread"),
+                          FALSE,
+                          G_PARAM_READWRITE |
+                          G_PARAM_STATIC_STRINGS);
+
   /**
    * ClutterCanvas::draw:
    * @canvas: the #ClutterCanvas that emitted the signal
@@ -245,6 +371,15 @@ clutter_canvas_class_init (ClutterCanvasClass *klass)
    * The #ClutterCanvas::draw signal is emitted each time a canvas is
    * invalidated.
    *
+   * If the canvas has been invalidated using
+   * clutter_canvas_invalidate_rect(), @cr will be clipped to the
+   * invalidated area, and the rest of the canvas will retain its
+   * previous contents; you can use cairo_clip_extents() to avoid
+   * drawing outside of the clip.
+   *
+   * If the #ClutterCanvas:draw-async property is set, this signal is
+   * emitted in a worker thread.
+   *
    * It is safe to connect multiple handlers to this signal: each
    * handler invocation will be automatically protected by cairo_save()
    * and cairo_restore() pairs.
@@ -281,6 +416,8 @@ clutter_canvas_init (ClutterCanvas *self)
 
   self->priv->width = -1;
   self->priv->height = -1;
+
+  g_mutex_init (&self->priv->draw_lock);
 }
 
 static void
@@ -289,21 +426,41 @@ clutter_canvas_paint_content (ClutterContent   *content,
                               ClutterPaintNode *root)
 {
   ClutterCanvas *self = CLUTTER_CANVAS (content);
+  ClutterCanvasPrivate *priv = self->priv;
   ClutterPaintNode *node;
-  CoglTexture *texture;
   ClutterActorBox box;
   ClutterColor color;
   guint8 paint_opacity;
   ClutterScalingFilter min_f, mag_f;
 
-  if (self->priv->buffer == NULL)
+  if (priv->buffer == NULL)
     return;
 
-  texture = cogl_texture_new_from_bitmap (self->priv->buffer,
-                                          COGL_TEXTURE_NO_SLICING,
-                                          CLUTTER_CAIRO_FORMAT_ARGB32);
-  if (texture == NULL)
-    return;
+  if (priv->texture == NULL)
+    {
+      priv->texture = cogl_texture_new_from_bitmap (priv->buffer,
+                                                    COGL_TEXTURE_NO_SLICING,
+                                                    CLUTTER_CAIRO_FORMAT_ARGB32);
+      if (priv->texture == NULL)
+        return;
+    }
+  else if (priv->texture_dirty)
+    {
+      cairo_rectangle_int_t *area = &priv->dirty_area;
+
+      CLUTTER_NOTE (PAINT, "Uploading canvas area: "
+                    "x=%d, y=%d, width=%d, height=%d",
+                    area->x, area->y,
+                    area->width, area->height);
+
+      cogl_texture_set_region_from_bitmap (priv->texture,
+                                           area->x, area->y,
+                                           area->x, area->y,
+                                           area->width, area->height,
+                                           priv->buffer);
+    }
+
+  priv->texture_dirty = FALSE;
 
   clutter_actor_get_content_box (actor, &box);
   paint_opacity = clutter_actor_get_paint_opacity (actor);
@@ -314,8 +471,7 @@ clutter_canvas_paint_content (ClutterContent   *content,
   color.blue = paint_opacity;
   color.alpha = paint_opacity;
 
-  node = clutter_texture_node_new (texture, &color, min_f, mag_f);
-  cogl_object_unref (texture);
+  node = clutter_texture_node_new (priv->texture, &color, min_f, mag_f);
 
   clutter_paint_node_set_name (node, "Canvas");
   clutter_paint_node_add_rectangle (node, &box);
@@ -323,10 +479,65 @@ clutter_canvas_paint_content (ClutterContent   *content,
   clutter_paint_node_unref (node);
 }
 
+/* Checks whether the buffer was allocated for a different size of
+ * the canvas; a stale buffer is kept, together with its texture,
+ * until the contents for the new size are available
+ */
+static gboolean
+clutter_canvas_buffer_is_stale (ClutterCanvas *self)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+
+  if (priv->buffer == NULL)
+    return FALSE;
+
+  return cogl_bitmap_get_width (priv->buffer) != priv->width ||
+         cogl_bitmap_get_height (priv->buffer) != priv->height;
+}
+
+static void
+clutter_canvas_release_buffer (ClutterCanvas *self)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+
+  if (priv->buffer != NULL)
+    {
+      cogl_object_unref (priv->buffer);
+      priv->buffer = NULL;
+    }
+
+  if (priv->texture != NULL)
+    {
+      cogl_object_unref (priv->texture);
+      priv->texture = NULL;
+    }
+
+  priv->texture_dirty = FALSE;
+}
+
+static void
+clutter_canvas_add_dirty_area (ClutterCanvas               *self,
+                               const cairo_rectangle_int_t *area)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+
+  if (priv->texture_dirty)
+    _clutter_util_rectangle_union (&priv->dirty_area, area, &priv->dirty_area);
+  else
+    priv->dirty_area = *area;
+
+  priv->texture_dirty = TRUE;
+}
+
+/* Draws the canvas; if @clip is not %NULL, only the given area is
+ * drawn, and the rest of the buffer is preserved
+ */
 static void
-clutter_canvas_emit_draw (ClutterCanvas *self)
+clutter_canvas_emit_draw (ClutterCanvas               *self,
+                          const cairo_rectangle_int_t *clip)
 {
   ClutterCanvasPrivate *priv = self->priv;
+  cairo_rectangle_int_t full_area;
   cairo_surface_t *surface;
   gboolean mapped_buffer;
   unsigned char *data;
@@ -336,6 +547,9 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
 
   g_assert (priv->width > 0 && priv->width > 0);
 
+  if (clutter_canvas_buffer_is_stale (self))
+    clutter_canvas_release_buffer (self);
+
   if (priv->buffer == NULL)
     {
       CoglContext *ctx;
@@ -345,6 +559,9 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
                                                 priv->width,
                                                 priv->height,
                                                 CLUTTER_CAIRO_FORMAT_ARGB32);
+
+      /* there are no contents to preserve */
+      clip = NULL;
     }
 
   buffer = COGL_BUFFER (cogl_bitmap_get_buffer (priv->buffer));
@@ -353,9 +570,12 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
 
   cogl_buffer_set_update_hint (buffer, COGL_BUFFER_UPDATE_HINT_DYNAMIC);
 
+  /* if we are going to redraw everything, we can let the driver
+   * throw away the previous contents of the buffer
+   */
   data = cogl_buffer_map (buffer,
                           COGL_BUFFER_ACCESS_READ_WRITE,
-                          COGL_BUFFER_MAP_HINT_DISCARD);
+                          clip == NULL ? COGL_BUFFER_MAP_HINT_DISCARD : 0);
 
   if (data != NULL)
     {
@@ -374,11 +594,22 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
                                             priv->width,
                                             priv->height);
 
+      /* the contents of the buffer are replaced, so we need to
+       * draw everything
+       */
+      clip = NULL;
+
       mapped_buffer = FALSE;
     }
 
   self->priv->cr = cr = cairo_create (surface);
 
+  if (clip != NULL)
+    {
+      cairo_rectangle (cr, clip->x, clip->y, clip->width, clip->height);
+      cairo_clip (cr);
+    }
+
   g_signal_emit (self, canvas_signals[DRAW], 0,
                  cr, priv->width, priv->height,
                  &res);
@@ -398,24 +629,409 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
     }
 
   cairo_surface_destroy (surface);
+
+  if (clip == NULL)
+    {
+      full_area.x = 0;
+      full_area.y = 0;
+      full_area.width = priv->width;
+      full_area.height = priv->height;
+
+      clip = &full_area;
+    }
+
+  clutter_canvas_add_dirty_area (self, clip);
 }
 
 static void
-clutter_canvas_invalidate (ClutterContent *content)
+clutter_canvas_async_data_free (ClutterCanvasAsyncData *data)
+{
+  /* this function should only be called from the main thread, since
+   * it might release the last reference on the canvas
+   */
+  if (data->surface != NULL)
+    cairo_surface_destroy (data->surface);
+
+  g_object_unref (data->canvas);
+
+  g_slice_free (ClutterCanvasAsyncData, data);
+}
+
+/* Copies the result of an asynchronous draw inside the buffer */
+static void
+clutter_canvas_async_draw_complete (ClutterCanvas          *self,
+                                    ClutterCanvasAsyncData *data)
 {
-  ClutterCanvas *self = CLUTTER_CANVAS (content);
   ClutterCanvasPrivate *priv = self->priv;
+  const cairo_rectangle_int_t *area = &data->area;
+  gboolean full_redraw;
+  unsigned char *src, *dst;
+  int src_stride, dst_stride;
+  CoglBuffer *buffer;
+  int row;
 
-  if (priv->buffer != NULL)
+  priv->async_data = NULL;
+
+  if (data->surface == NULL)
+    return;
+
+  full_redraw = area->x == 0 && area->y == 0 &&
+                area->width == priv->width &&
+                area->height == priv->height;
+
+  if (priv->buffer == NULL || clutter_canvas_buffer_is_stale (self))
     {
-      cogl_object_unref (priv->buffer);
-      priv->buffer = NULL;
+      CoglContext *ctx;
+
+      /* the draw was started without a buffer, or after a change of
+       * size, so it covers the whole canvas; the previous contents
+       * are only replaced now that the new ones are available
+       */
+      g_assert (full_redraw);
+
+      clutter_canvas_release_buffer (self);
+
+      ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+      priv->buffer = cogl_bitmap_new_with_size (ctx,
+                                                priv->width,
+                                                priv->height,
+                                                CLUTTER_CAIRO_FORMAT_ARGB32);
     }
 
-  if (priv->width <= 0 || priv->height <= 0)
+  buffer = COGL_BUFFER (cogl_bitmap_get_buffer (priv->buffer));
+  if (buffer == NULL)
     return;
 
-  clutter_canvas_emit_draw (self);
+  cairo_surface_flush (data->surface);
+
+  src = cairo_image_surface_get_data (data->surface);
+  src_stride = cairo_image_surface_get_stride (data->surface);
+  dst_stride = cogl_bitmap_get_rowstride (priv->buffer);
+
+  dst = cogl_buffer_map (buffer,
+                         COGL_BUFFER_ACCESS_WRITE,
+                         full_redraw ? COGL_BUFFER_MAP_HINT_DISCARD : 0);
+
+  for (row = 0; row < area->height; row++)
+    {
+      int offset = (area->y + row) * dst_stride + area->x * 4;
+
+      if (dst != NULL)
+        memcpy (dst + offset, src + row * src_stride, area->width * 4);
+      else
+        cogl_buffer_set_data (buffer, offset,
+                              src + row * src_stride,
+                              area->width * 4);
+    }
+
+  if (dst != NULL)
+    cogl_buffer_unmap (buffer);
+
+  clutter_canvas_add_dirty_area (self, area);
+
+  _clutter_content_queue_redraw (CLUTTER_CONTENT (self));
+}
+
+static gboolean
+canvas_repaint_upload_func (gpointer user_data)
+{
+  g_mutex_lock (&upload_list_mutex);
+
+  if (upload_list != NULL)
+    {
+      gint64 start_time = g_get_monotonic_time ();
+
+      /* continue copying canvases as long as we havent spent more
+       * then 5ms doing so this stage redraw cycle.
+       */
+      do
+        {
+          ClutterCanvasAsyncData *async_data = upload_list->data;
+
+          clutter_canvas_async_data_lock (async_data);
+
+          if (~async_data->state & ASYNC_STATE_CANCELLED)
+            {
+              CLUTTER_NOTE (PAINT, "[async] draw complete for canvas %p",
+                            async_data->canvas);
+
+              clutter_canvas_async_draw_complete (async_data->canvas,
+                                                  async_data);
+            }
+          else
+            CLUTTER_NOTE (PAINT, "[async] draw cancelled for canvas %p",
+                          async_data->canvas);
+
+          clutter_canvas_async_data_unlock (async_data);
+
+          upload_list = g_list_remove (upload_list, async_data);
+          clutter_canvas_async_data_free (async_data);
+        }
+      while (upload_list != NULL &&
+             g_get_monotonic_time () < start_time + 5 * 1000L);
+    }
+
+  if (upload_list != NULL)
+    {
+      ClutterMasterClock *master_clock;
+
+      master_clock = _clutter_master_clock_get_default ();
+      _clutter_master_clock_ensure_next_iteration (master_clock);
+    }
+
+  g_mutex_unlock (&upload_list_mutex);
+
+  return TRUE;
+}
+
+static void
+clutter_canvas_thread_draw (gpointer user_data,
+                            gpointer pool_data)
+{
+  ClutterCanvasAsyncData *async_data = user_data;
+  ClutterMasterClock *master_clock = _clutter_master_clock_get_default ();
+  ClutterCanvas *self = async_data->canvas;
+
+  clutter_canvas_async_data_lock (async_data);
+
+  if (~async_data->state & ASYNC_STATE_CANCELLED)
+    {
+      const cairo_rectangle_int_t *area = &async_data->area;
+      cairo_surface_t *surface;
+      gboolean res;
+      cairo_t *cr;
+
+      /* we don't want to block the main thread while drawing */
+      clutter_canvas_async_data_unlock (async_data);
+
+      CLUTTER_NOTE (PAINT, "[async] drawing canvas %p: "
+                    "x=%d, y=%d, width=%d, height=%d",
+                    self,
+                    area->x, area->y,
+                    area->width, area->height);
+
+      surface = async_data->surface;
+      if (surface == NULL)
+        {
+          surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                                area->width,
+                                                area->height);
+          cairo_surface_set_device_offset (surface, -area->x, -area->y);
+        }
+
+      cr = cairo_create (surface);
+
+      if (area->width != async_data->width ||
+          area->height != async_data->height)
+        {
+          cairo_rectangle (cr, area->x, area->y, area->width, area->height);
+          cairo_clip (cr);
+        }
+
+      g_mutex_lock (&self->priv->draw_lock);
+      g_signal_emit (self, canvas_signals[DRAW], 0,
+                     cr, async_data->width, async_data->height,
+                     &res);
+      g_mutex_unlock (&self->priv->draw_lock);
+
+      cairo_destroy (cr);
+
+      clutter_canvas_async_data_lock (async_data);
+
+      async_data->surface = surface;
+    }
+
+  /* the data is always released by the main thread, even if the
+   * draw has been cancelled
+   */
+  g_mutex_lock (&upload_list_mutex);
+
+  if (repaint_upload_func == 0)
+    {
+      repaint_upload_func =
+        clutter_threads_add_repaint_func (canvas_repaint_upload_func,
+                                          NULL, NULL);
+    }
+
+  upload_list = g_list_append (upload_list, async_data);
+
+  g_mutex_unlock (&upload_list_mutex);
+
+  clutter_canvas_async_data_unlock (async_data);
+
+  _clutter_master_clock_ensure_next_iteration (master_clock);
+}
+
+/* Cancels the pending asynchronous draw; returns the area that it
+ * was supposed to draw, if any
+ */
+static gboolean
+clutter_canvas_async_draw_cancel (ClutterCanvas         *self,
+                                  cairo_rectangle_int_t *area)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+  ClutterCanvasAsyncData *async_data = priv->async_data;
+
+  if (async_data == NULL)
+    return FALSE;
+
+  priv->async_data = NULL;
+
+  clutter_canvas_async_data_lock (async_data);
+
+  CLUTTER_NOTE (PAINT, "[async] cancelling draw for canvas %p", self);
+
+  async_data->state |= ASYNC_STATE_CANCELLED;
+
+  if (area != NULL)
+    *area = async_data->area;
+
+  clutter_canvas_async_data_unlock (async_data);
+
+  return TRUE;
+}
+
+/* Creates the surface used to draw @area in a worker thread, and
+ * copies the current contents of the buffer inside it, so that the
+ * ::draw handlers paint over the previous contents, like they do when
+ * drawing synchronously; returns %NULL if the buffer cannot be read
+ */
+static cairo_surface_t *
+clutter_canvas_create_async_surface (ClutterCanvas               *self,
+                                     const cairo_rectangle_int_t *area)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+  cairo_surface_t *surface;
+  unsigned char *src, *dst;
+  int src_stride, dst_stride;
+  CoglBuffer *buffer;
+  int row;
+
+  buffer = COGL_BUFFER (cogl_bitmap_get_buffer (priv->buffer));
+  if (buffer == NULL)
+    return NULL;
+
+  src = cogl_buffer_map (buffer, COGL_BUFFER_ACCESS_READ, 0);
+  if (src == NULL)
+    return NULL;
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                        area->width,
+                                        area->height);
+  if (cairo_surface_status (surface) != CAIRO_STATUS_SUCCESS)
+    {
+      cogl_buffer_unmap (buffer);
+      cairo_surface_destroy (surface);
+      return NULL;
+    }
+
+  cairo_surface_flush (surface);
+
+  dst = cairo_image_surface_get_data (surface);
+  dst_stride = cairo_image_surface_get_stride (surface);
+  src_stride = cogl_bitmap_get_rowstride (priv->buffer);
+
+  for (row = 0; row < area->height; row++)
+    {
+      int offset = (area->y + row) * src_stride + area->x * 4;
+
+      memcpy (dst + row * dst_stride, src + offset, area->width * 4);
+    }
+
+  cogl_buffer_unmap (buffer);
+
+  cairo_surface_mark_dirty (surface);
+  cairo_surface_set_device_offset (surface, -area->x, -area->y);
+
+  return surface;
+}
+
+/* Starts drawing the canvas in a worker thread; if @clip is not
+ * %NULL, only the given area is drawn
+ */
+static void
+clutter_canvas_async_draw (ClutterCanvas               *self,
+                           const cairo_rectangle_int_t *clip)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+  ClutterCanvasAsyncData *async_data;
+  cairo_rectangle_int_t full_area, area, pending_area;
+
+  full_area.x = 0;
+  full_area.y = 0;
+  full_area.width = priv->width;
+  full_area.height = priv->height;
+
+  /* without a buffer of the right size, there are no contents
+   * to preserve
+   */
+  if (clip == NULL ||
+      priv->buffer == NULL ||
+      clutter_canvas_buffer_is_stale (self))
+    area = full_area;
+  else
+    area = *clip;
+
+  /* the area of a stale draw still needs to be drawn */
+  if (clutter_canvas_async_draw_cancel (self, &pending_area))
+    {
+      _clutter_util_rectangle_union (&area, &pending_area, &area);
+      if (!_clutter_util_rectangle_intersection (&area, &full_area, &area))
+        return;
+    }
+
+  async_data = g_slice_new0 (ClutterCanvasAsyncData);
+  async_data->canvas = g_object_ref (self);
+  async_data->width = priv->width;
+  async_data->height = priv->height;
+  async_data->area = area;
+
+  /* the worker thread cannot access the buffer, so the contents that
+   * a partial draw paints over are copied beforehand
+   */
+  if (area.width != full_area.width || area.height != full_area.height)
+    {
+      async_data->surface = clutter_canvas_create_async_surface (self, &area);
+      if (async_data->surface == NULL)
+        async_data->area = full_area;
+    }
+
+  priv->async_data = async_data;
+
+  if (G_UNLIKELY (async_thread_pool == NULL))
+    {
+      /* This apparently can't fail if exclusive == FALSE */
+      async_thread_pool =
+        g_thread_pool_new (clutter_canvas_thread_draw, NULL,
+                           ASYNC_MAX_THREADS,
+                           FALSE,
+                           NULL);
+    }
+
+  g_thread_pool_push (async_thread_pool, async_data, NULL);
+}
+
+static void
+clutter_canvas_invalidate (ClutterContent *content)
+{
+  ClutterCanvas *self = CLUTTER_CANVAS (content);
+  ClutterCanvasPrivate *priv = self->priv;
+
+  if (priv->width <= 0 || priv->height <= 0)
+    {
+      clutter_canvas_async_draw_cancel (self, NULL);
+      clutter_canvas_release_buffer (self);
+      return;
+    }
+
+  /* a buffer of the wrong size is only replaced once the new contents
+   * have been drawn, so the actors keep painting the previous contents
+   * of an asynchronous canvas until then
+   */
+  if (priv->draw_async)
+    clutter_canvas_async_draw (self, NULL);
+  else
+    clutter_canvas_emit_draw (self, NULL);
 }
 
 static gboolean
@@ -514,3 +1130,122 @@ clutter_canvas_set_size (ClutterCanvas *canvas,
 
   g_object_thaw_notify (obj);
 }
+
+/**
+ * clutter_canvas_invalidate_rect:
+ * @canvas: a #ClutterCanvas
+ * @rect: the area to redraw, in pixels
+ *
+ * Invalidates the area of the @canvas inside @rect.
+ *
+ * Unlike clutter_content_invalidate(), this function will emit the
+ * #ClutterCanvas::draw signal with a #cairo_t clipped to @rect, and
+ * will preserve the contents of the rest of the @canvas; only the
+ * invalidated area will be uploaded to the GPU when painting.
+ *
+ * If the @canvas has not been drawn yet, this function is equivalent
+ * to clutter_content_invalidate().
+ *
+ * Since: 1.12
+ */
+void
+clutter_canvas_invalidate_rect (ClutterCanvas               *canvas,
+                                const cairo_rectangle_int_t *rect)
+{
+  ClutterCanvasPrivate *priv;
+  cairo_rectangle_int_t full_area, clip;
+
+  g_return_if_fail (CLUTTER_IS_CANVAS (canvas));
+  g_return_if_fail (rect != NULL);
+
+  priv = canvas->priv;
+
+  if (priv->width <= 0 || priv->height <= 0)
+    return;
+
+  if ((priv->buffer == NULL || clutter_canvas_buffer_is_stale (canvas)) &&
+      priv->async_data == NULL)
+    {
+      clutter_content_invalidate (CLUTTER_CONTENT (canvas));
+      return;
+    }
+
+  full_area.x = 0;
+  full_area.y = 0;
+  full_area.width = priv->width;
+  full_area.height = priv->height;
+
+  if (!_clutter_util_rectangle_intersection (rect, &full_area, &clip))
+    return;
+
+  /* the actors will be redrawn once the drawing is complete */
+  if (priv->draw_async)
+    {
+      clutter_canvas_async_draw (canvas, &clip);
+      return;
+    }
+
+  clutter_canvas_emit_draw (canvas, &clip);
+
+  _clutter_content_queue_redraw (CLUTTER_CONTENT (canvas));
+}
+
+/**
+ * clutter_canvas_set_draw_async:
+ * @canvas: a #ClutterCanvas
+ * @draw_async: whether the @canvas should be drawn in a worker thread
+ *
+ * Sets whether the #ClutterCanvas::draw signal of @canvas should be
+ * emitted in a worker thread.
+ *
+ * See the #ClutterCanvas:draw-async property for the constraints
+ * on the signal handlers of an asynchronous canvas.
+ *
+ * Since: 1.12
+ */
+void
+clutter_canvas_set_draw_async (ClutterCanvas *canvas,
+                               gboolean       draw_async)
+{
+  ClutterCanvasPrivate *priv;
+  cairo_rectangle_int_t pending_area;
+
+  g_return_if_fail (CLUTTER_IS_CANVAS (canvas));
+
+  priv = canvas->priv;
+
+  draw_async = !!draw_async;
+
+  if (priv->draw_async == draw_async)
+    return;
+
+  priv->draw_async = draw_async;
+
+  /* finish the pending draw in the main thread */
+  if (clutter_canvas_async_draw_cancel (canvas, &pending_area))
+    {
+      clutter_canvas_emit_draw (canvas,
+                                priv->buffer != NULL ? &pending_area : NULL);
+      _clutter_content_queue_redraw (CLUTTER_CONTENT (canvas));
+    }
+
+  g_object_notify_by_pspec (G_OBJECT (canvas), obj_props[PROP_DRAW_ASYNC]);
+}
+
+/**
+ * clutter_canvas_get_draw_async:
+ * @canvas: a #ClutterCanvas
+ *
+ * Retrieves the value set using clutter_canvas_set_draw_async().
+ *
+ * Return value: %TRUE if the @canvas is drawn in a worker thread
+ *
+ * Since: 1.12
+ */
+gboolean
+clutter_canvas_get_draw_async (ClutterCanvas *canvas)
+{
+  g_return_val_if_fail (CLUTTER_IS_CANVAS (canvas), FALSE);
+
+  return canvas->priv->draw_async;
+}
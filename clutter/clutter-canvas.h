@@ -95,6 +95,16 @@ void                    clutter_canvas_set_size         (ClutterCanvas *canvas,
                                                          int            width,
                                                          int            height);
 
+CLUTTER_AVAILABLE_IN_1_12
+void                    clutter_canvas_invalidate_rect  (ClutterCanvas               *canvas,
+                                                         const cairo_rectangle_int_t *rect);
+
+CLUTTER_AVAILABLE_IN_1_12
+void                    clutter_canvas_set_draw_async   (ClutterCanvas *canvas,
+                                                         gboolean       draw_async);
+CLUTTER_AVAILABLE_IN_1_12
+gboolean                clutter_canvas_get_draw_async   (ClutterCanvas *canvas);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_CANVAS_H__ */
@@ -321,6 +321,9 @@ clutter_clone_class_init (ClutterCloneClass *klass)
 
   g_type_class_add_private (gobject_class, sizeof (ClutterClonePrivate));
 
+  /* the transformation depends on the allocation of the source, so it
+   * cannot be cached in the absolute transformation of the clone
+   */
   actor_class->apply_transform = clutter_clone_apply_transform;
   actor_class->paint = clutter_clone_paint;
   actor_class->get_paint_volume = clutter_clone_get_paint_volume;
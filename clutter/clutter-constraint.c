@@ -145,6 +145,7 @@
 
 #include "clutter-actor.h"
 #include "clutter-actor-meta-private.h"
+#include "clutter-actor-private.h"
 #include "clutter-private.h"
 
 G_DEFINE_ABSTRACT_TYPE (ClutterConstraint,
@@ -168,7 +169,7 @@ clutter_constraint_notify (GObject    *gobject,
       ClutterActor *actor = clutter_actor_meta_get_actor (meta);
 
       if (actor != NULL)
-        clutter_actor_queue_relayout (actor);
+        _clutter_actor_queue_only_reallocation (actor);
     }
 
   if (G_OBJECT_CLASS (clutter_constraint_parent_class)->notify != NULL)
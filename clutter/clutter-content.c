@@ -42,6 +42,7 @@
 
 #include "clutter-content-private.h"
 
+#include "clutter-actor-private.h"
 #include "clutter-debug.h"
 #include "clutter-marshal.h"
 #include "clutter-private.h"
@@ -167,14 +168,31 @@ clutter_content_default_init (ClutterContentInterface *iface)
 void
 clutter_content_invalidate (ClutterContent *content)
 {
-  GHashTable *actors;
-  GHashTableIter iter;
-  gpointer key_p, value_p;
-
   g_return_if_fail (CLUTTER_IS_CONTENT (content));
 
   CLUTTER_CONTENT_GET_IFACE (content)->invalidate (content);
 
+  _clutter_content_queue_redraw (content);
+}
+
+/*< private >
+ * _clutter_content_queue_redraw:
+ * @content: a #ClutterContent
+ *
+ * Queues a redraw on all the actors using @content, without
+ * invalidating it; the paint nodes retained by the actors are
+ * rebuilt on their next paint.
+ *
+ * This function should be used by #ClutterContent implementations
+ * that can update their contents without a full invalidation.
+ */
+void
+_clutter_content_queue_redraw (ClutterContent *content)
+{
+  GHashTable *actors;
+  GHashTableIter iter;
+  gpointer key_p, value_p;
+
   actors = g_object_get_qdata (G_OBJECT (content), quark_content_actors);
   if (actors == NULL)
     return;
@@ -186,6 +204,7 @@ clutter_content_invalidate (ClutterContent *content)
 
       g_assert (actor != NULL);
 
+      _clutter_actor_invalidate_paint_node (actor);
       clutter_actor_queue_redraw (actor);
     }
 }
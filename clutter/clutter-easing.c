@@ -3,6 +3,25 @@
 #include "clutter-easing.h"
 
 #include <math.h>
+#include <string.h>
+
+/* the polynomial easing functions can be evaluated on a vector of
+ * values at a time using the GCC vector extensions, which are lowered
+ * to the SIMD instructions available on the target, or to scalar code.
+ *
+ * we use vectors of doubles, so that the results are the same as the
+ * ones of the scalar functions; vectors of 16 bytes map to a single
+ * SSE2 or NEON register without changing the ABI
+ */
+#if defined (__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+#define CLUTTER_EASING_VECTORIZED       1
+#define EASING_LANES                    2
+
+typedef double EasingVec __attribute__ ((vector_size (EASING_LANES * sizeof (double))));
+typedef gint64 EasingMask __attribute__ ((vector_size (EASING_LANES * sizeof (gint64))));
+
+#define EASING_VEC(x)   ((EasingVec) { (x), (x) })
+#endif
 
 double
 clutter_linear (double t,
@@ -454,3 +473,238 @@ clutter_easing_for_mode (ClutterAnimationMode mode,
 
   return _clutter_animation_modes[mode].func (t, d);
 }
+
+#ifdef CLUTTER_EASING_VECTORIZED
+static inline gboolean
+easing_mode_is_vectorized (ClutterAnimationMode mode)
+{
+  switch (mode)
+    {
+    case CLUTTER_LINEAR:
+    case CLUTTER_EASE_IN_QUAD:
+    case CLUTTER_EASE_OUT_QUAD:
+    case CLUTTER_EASE_IN_OUT_QUAD:
+    case CLUTTER_EASE_IN_CUBIC:
+    case CLUTTER_EASE_OUT_CUBIC:
+    case CLUTTER_EASE_IN_OUT_CUBIC:
+    case CLUTTER_EASE_IN_QUART:
+    case CLUTTER_EASE_OUT_QUART:
+    case CLUTTER_EASE_IN_OUT_QUART:
+    case CLUTTER_EASE_IN_QUINT:
+    case CLUTTER_EASE_OUT_QUINT:
+    case CLUTTER_EASE_IN_OUT_QUINT:
+    case CLUTTER_EASE_IN_BACK:
+    case CLUTTER_EASE_OUT_BACK:
+    case CLUTTER_EASE_IN_OUT_BACK:
+      return TRUE;
+
+    default:
+      return FALSE;
+    }
+}
+
+static inline EasingVec
+easing_vec_select (EasingMask mask,
+                   EasingVec  a,
+                   EasingVec  b)
+{
+  return (EasingVec) (((EasingMask) a & mask) | ((EasingMask) b & ~mask));
+}
+
+/* these mirror the scalar functions above operation by operation, so
+ * that both versions return the same values
+ */
+static inline EasingVec
+easing_vec_for_mode (ClutterAnimationMode mode,
+                     EasingVec            t,
+                     EasingVec            d)
+{
+  const EasingVec one = EASING_VEC (1.0);
+  EasingMask lower;
+  EasingVec p, q;
+
+  switch (mode)
+    {
+    case CLUTTER_LINEAR:
+      return t / d;
+
+    case CLUTTER_EASE_IN_QUAD:
+      p = t / d;
+      return p * p;
+
+    case CLUTTER_EASE_OUT_QUAD:
+      p = t / d;
+      return -1.0 * p * (p - 2);
+
+    case CLUTTER_EASE_IN_OUT_QUAD:
+      p = t / (d / 2);
+      q = p - 1;
+      lower = (EasingMask) (p < one);
+      return easing_vec_select (lower,
+                                0.5 * p * p,
+                                -0.5 * (q * (q - 2) - 1));
+
+    case CLUTTER_EASE_IN_CUBIC:
+      p = t / d;
+      return p * p * p;
+
+    case CLUTTER_EASE_OUT_CUBIC:
+      p = t / d - 1;
+      return p * p * p + 1;
+
+    case CLUTTER_EASE_IN_OUT_CUBIC:
+      p = t / (d / 2);
+      q = p - 2;
+      lower = (EasingMask) (p < one);
+      return easing_vec_select (lower,
+                                0.5 * p * p * p,
+                                0.5 * (q * q * q + 2));
+
+    case CLUTTER_EASE_IN_QUART:
+      p = t / d;
+      return p * p * p * p;
+
+    case CLUTTER_EASE_OUT_QUART:
+      p = t / d - 1;
+      return -1.0 * (p * p * p * p - 1);
+
+    case CLUTTER_EASE_IN_OUT_QUART:
+      p = t / (d / 2);
+      q = p - 2;
+      lower = (EasingMask) (p < one);
+      return easing_vec_select (lower,
+                                0.5 * p * p * p * p,
+                                -0.5 * (q * q * q * q - 2));
+
+    case CLUTTER_EASE_IN_QUINT:
+      p = t / d;
+      return p * p * p * p * p;
+
+    case CLUTTER_EASE_OUT_QUINT:
+      p = t / d - 1;
+      return p * p * p * p * p + 1;
+
+    case CLUTTER_EASE_IN_OUT_QUINT:
+      p = t / (d / 2);
+      q = p - 2;
+      lower = (EasingMask) (p < one);
+      return easing_vec_select (lower,
+                                0.5 * p * p * p * p * p,
+                                0.5 * (q * q * q * q * q + 2));
+
+    case CLUTTER_EASE_IN_BACK:
+      p = t / d;
+      return p * p * ((1.70158 + 1) * p - 1.70158);
+
+    case CLUTTER_EASE_OUT_BACK:
+      p = t / d - 1;
+      return p * p * ((1.70158 + 1) * p + 1.70158) + 1;
+
+    case CLUTTER_EASE_IN_OUT_BACK:
+      {
+        double s = 1.70158 * 1.525;
+
+        p = t / (d / 2);
+        q = p - 2;
+        lower = (EasingMask) (p < one);
+        return easing_vec_select (lower,
+                                  0.5 * (p * p * ((s + 1) * p - s)),
+                                  0.5 * (q * q * ((s + 1) * q + s) + 2));
+      }
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  return t;
+}
+#endif /* CLUTTER_EASING_VECTORIZED */
+
+/*< private >
+ * clutter_easing_for_mode_batch:
+ * @mode: an animation mode
+ * @t: (array length=n_values): the elapsed times
+ * @d: (array length=n_values): the durations
+ * @res: (array length=n_values): return location for the progress
+ * @n_values: the number of values
+ *
+ * Evaluates the easing function for @mode on an array of values.
+ *
+ * The polynomial modes are evaluated a vector of values at a time,
+ * if the compiler supports it.
+ */
+void
+clutter_easing_for_mode_batch (ClutterAnimationMode  mode,
+                               const double         *t,
+                               const double         *d,
+                               double               *res,
+                               guint                 n_values)
+{
+  ClutterEasingFunc func;
+  guint i = 0;
+
+#ifdef CLUTTER_EASING_VECTORIZED
+  if (easing_mode_is_vectorized (mode))
+    {
+      for (; i + EASING_LANES <= n_values; i += EASING_LANES)
+        {
+          EasingVec vt, vd, vres;
+
+          /* the arrays might not be aligned to the size of a vector */
+          memcpy (&vt, t + i, sizeof (EasingVec));
+          memcpy (&vd, d + i, sizeof (EasingVec));
+
+          vres = easing_vec_for_mode (mode, vt, vd);
+
+          memcpy (res + i, &vres, sizeof (EasingVec));
+        }
+    }
+#endif
+
+  if (i == n_values)
+    return;
+
+  /* the tail, and the modes without a vectorized version */
+  func = clutter_get_easing_func_for_mode (mode);
+
+  for (; i < n_values; i++)
+    res[i] = func (t[i], d[i]);
+}
+
+/*< private >
+ * clutter_easing_for_modes:
+ * @modes: (array length=n_values): the animation modes
+ * @t: (array length=n_values): the elapsed times
+ * @d: (array length=n_values): the durations
+ * @res: (array length=n_values): return location for the progress
+ * @n_values: the number of values
+ *
+ * Evaluates the easing functions for an array of values with different
+ * animation modes; the values should be sorted by mode, as each run of
+ * values with the same mode is evaluated using
+ * clutter_easing_for_mode_batch().
+ */
+void
+clutter_easing_for_modes (const ClutterAnimationMode *modes,
+                          const double               *t,
+                          const double               *d,
+                          double                     *res,
+                          guint                       n_values)
+{
+  guint start, end;
+
+  for (start = 0; start < n_values; start = end)
+    {
+      for (end = start + 1; end < n_values; end++)
+        {
+          if (modes[end] != modes[start])
+            break;
+        }
+
+      clutter_easing_for_mode_batch (modes[start],
+                                     t + start,
+                                     d + start,
+                                     res + start,
+                                     end - start);
+    }
+}
@@ -19,14 +19,25 @@ typedef double (* ClutterEasingFunc) (double t, double d);
 G_GNUC_INTERNAL
 ClutterEasingFunc       clutter_get_easing_func_for_mode        (ClutterAnimationMode mode);
 
-G_GNUC_INTERNAL
+/* not part of the public API, but exported for tests/micro-bench */
 const char *            clutter_get_easing_name_for_mode        (ClutterAnimationMode mode);
 
-G_GNUC_INTERNAL
 double                  clutter_easing_for_mode                 (ClutterAnimationMode mode,
                                                                  double               t,
                                                                  double               d);
 
+void                    clutter_easing_for_mode_batch           (ClutterAnimationMode        mode,
+                                                                 const double               *t,
+                                                                 const double               *d,
+                                                                 double                     *res,
+                                                                 guint                       n_values);
+
+void                    clutter_easing_for_modes                (const ClutterAnimationMode *modes,
+                                                                 const double               *t,
+                                                                 const double               *d,
+                                                                 double                     *res,
+                                                                 guint                       n_values);
+
 G_GNUC_INTERNAL
 double  clutter_linear                  (double t,
                                          double d);
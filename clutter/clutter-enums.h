@@ -371,15 +371,21 @@ typedef enum {
  * @CLUTTER_ACTOR_NO_LAYOUT: the actor provides an explicit layout management
  *   policy for its children; this flag will prevent Clutter from automatic
  *   queueing of relayout and will defer all layouting to the actor itself
+ * @CLUTTER_ACTOR_LAYOUT_BOUNDARY: the size of the actor does not depend
+ *   on its children; a relayout queued on one of its children will not
+ *   be propagated past the actor, which will be allocated again using its
+ *   current allocation. Actors with a fixed width and height are treated
+ *   as relayout boundaries even when this flag is not set. Since: 1.12
  *
  * Flags used to signal the state of an actor.
  */
 typedef enum { /*< prefix=CLUTTER_ACTOR >*/
-  CLUTTER_ACTOR_MAPPED    = 1 << 1,
-  CLUTTER_ACTOR_REALIZED  = 1 << 2,
-  CLUTTER_ACTOR_REACTIVE  = 1 << 3,
-  CLUTTER_ACTOR_VISIBLE   = 1 << 4,
-  CLUTTER_ACTOR_NO_LAYOUT = 1 << 5
+  CLUTTER_ACTOR_MAPPED          = 1 << 1,
+  CLUTTER_ACTOR_REALIZED        = 1 << 2,
+  CLUTTER_ACTOR_REACTIVE        = 1 << 3,
+  CLUTTER_ACTOR_VISIBLE         = 1 << 4,
+  CLUTTER_ACTOR_NO_LAYOUT       = 1 << 5,
+  CLUTTER_ACTOR_LAYOUT_BOUNDARY = 1 << 6
 } ClutterActorFlags;
 
 /**
@@ -31,9 +31,23 @@
  *
  * #ClutterListModel is a #ClutterModel implementation provided by
  * Clutter. #ClutterListModel uses a #GSequence for storing the
- * values for each row, so it's optimized for insertion and look up
+ * order of the rows, so it's optimized for insertion and look up
  * in sorted lists.
  *
+ * The values of each column are stored in a packed array of the
+ * C type used by the column, instead of a #GValue per cell; large
+ * amounts of rows can be loaded at once using
+ * clutter_list_model_append_rows().
+ *
+ * When a filter is set, #ClutterListModel keeps an index of the rows
+ * that are visible through it, so that looking up a row by its
+ * position does not need to filter the whole model; the index is
+ * updated when rows are added, changed or removed, and rebuilt when
+ * the filter or the sorting change. If the result of the filter
+ * depends on anything else than the contents of the rows, the filter
+ * should be set again using clutter_model_set_filter() whenever that
+ * changes.
+ *
  * #ClutterListModel is available since Clutter 0.6
  */
 
@@ -51,6 +65,7 @@
 #include "clutter-list-model.h"
 #include "clutter-private.h"
 #include "clutter-debug.h"
+#include "clutter-profile.h"
 
 #define CLUTTER_TYPE_LIST_MODEL_ITER                 \
         (clutter_list_model_iter_get_type())
@@ -78,11 +93,49 @@ typedef struct _ClutterModelIterClass   ClutterListModelIterClass;
 
 #define CLUTTER_LIST_MODEL_GET_PRIVATE(obj)     (G_TYPE_INSTANCE_GET_PRIVATE ((obj), CLUTTER_TYPE_LIST_MODEL, ClutterListModelPrivate))
 
+typedef struct _ListColumn              ListColumn;
+
+struct _ListColumn
+{
+  GType gtype;
+
+  /* the fundamental type used to store the cells, or G_TYPE_INVALID
+   * if the cells are stored as GValues
+   */
+  GType storage;
+
+  /* the cells of the column, indexed by row slot */
+  GArray *cells;
+  guint cell_size;
+};
+
+#define LIST_COLUMN_CELL(column,slot) \
+  ((gpointer) ((column)->cells->data + (gsize) (slot) * (column)->cell_size))
+
 struct _ClutterListModelPrivate
 {
+  /* the rows, in order; each item is the slot of the row inside
+   * the columns, stored using GUINT_TO_POINTER()
+   */
   GSequence *sequence;
 
+  ListColumn *columns;
+  guint n_columns;
+
+  /* the number of slots allocated in each column, and the slots
+   * left behind by removed rows
+   */
+  guint n_slots;
+  GArray *free_slots;
+
+  /* the rows that are visible through the filter, in order; this
+   * is only valid if visible_rows_valid is set
+   */
+  GPtrArray *visible_rows;
+
   ClutterModelIter *temp_iter;
+
+  guint visible_rows_valid : 1;
 };
 
 struct _ClutterListModelIter
@@ -96,6 +149,582 @@ struct _ClutterListModelIter
 
 GType clutter_list_model_iter_get_type (void);
 
+/*
+ * ListColumn
+ */
+
+static void
+list_column_init (ListColumn *column,
+                  GType       gtype)
+{
+  column->gtype = gtype;
+
+  /* CHAR and UCHAR are left to GValue, to avoid depending on the
+   * signed char accessors
+   */
+  switch (G_TYPE_FUNDAMENTAL (gtype))
+    {
+    case G_TYPE_BOOLEAN:
+      column->storage = G_TYPE_BOOLEAN;
+      column->cell_size = sizeof (gboolean);
+      break;
+
+    case G_TYPE_INT:
+    case G_TYPE_ENUM:
+      column->storage = G_TYPE_FUNDAMENTAL (gtype);
+      column->cell_size = sizeof (gint);
+      break;
+
+    case G_TYPE_UINT:
+    case G_TYPE_FLAGS:
+      column->storage = G_TYPE_FUNDAMENTAL (gtype);
+      column->cell_size = sizeof (guint);
+      break;
+
+    case G_TYPE_LONG:
+    case G_TYPE_ULONG:
+      column->storage = G_TYPE_FUNDAMENTAL (gtype);
+      column->cell_size = sizeof (glong);
+      break;
+
+    case G_TYPE_INT64:
+    case G_TYPE_UINT64:
+      column->storage = G_TYPE_FUNDAMENTAL (gtype);
+      column->cell_size = sizeof (gint64);
+      break;
+
+    case G_TYPE_FLOAT:
+      column->storage = G_TYPE_FLOAT;
+      column->cell_size = sizeof (gfloat);
+      break;
+
+    case G_TYPE_DOUBLE:
+      column->storage = G_TYPE_DOUBLE;
+      column->cell_size = sizeof (gdouble);
+      break;
+
+    case G_TYPE_STRING:
+    case G_TYPE_POINTER:
+    case G_TYPE_OBJECT:
+      column->storage = G_TYPE_FUNDAMENTAL (gtype);
+      column->cell_size = sizeof (gpointer);
+      break;
+
+    default:
+      column->storage = G_TYPE_INVALID;
+      column->cell_size = sizeof (GValue);
+      break;
+    }
+
+  column->cells = g_array_new (FALSE, TRUE, column->cell_size);
+}
+
+static void
+list_column_clear_cell (ListColumn *column,
+                        guint       slot)
+{
+  gpointer cell = LIST_COLUMN_CELL (column, slot);
+
+  switch (column->storage)
+    {
+    case G_TYPE_STRING:
+      g_free (*(gchar **) cell);
+      break;
+
+    case G_TYPE_OBJECT:
+      if (*(GObject **) cell != NULL)
+        g_object_unref (*(GObject **) cell);
+      break;
+
+    case G_TYPE_INVALID:
+      /* GValue cells stay initialized for the lifetime of the slot */
+      g_value_reset (cell);
+      return;
+
+    default:
+      break;
+    }
+
+  memset (cell, 0, column->cell_size);
+}
+
+static void
+list_column_resize (ListColumn *column,
+                    guint       n_slots)
+{
+  guint i, old_size = column->cells->len;
+
+  g_array_set_size (column->cells, n_slots);
+
+  if (column->storage == G_TYPE_INVALID)
+    for (i = old_size; i < n_slots; i++)
+      g_value_init (LIST_COLUMN_CELL (column, i), column->gtype);
+}
+
+static void
+list_column_free (ListColumn *column)
+{
+  guint i;
+
+  for (i = 0; i < column->cells->len; i++)
+    {
+      list_column_clear_cell (column, i);
+
+      if (column->storage == G_TYPE_INVALID)
+        g_value_unset (LIST_COLUMN_CELL (column, i));
+    }
+
+  g_array_free (column->cells, TRUE);
+}
+
+/* Stores the contents of a cell inside @value, which must be initialized
+ * to the type of @column; if @copy_string is %FALSE the string is not
+ * copied, and @value is only valid as long as the cell is not modified
+ *
+ * This function does not work for columns stored as GValues
+ */
+static void
+list_column_get_value (const ListColumn *column,
+                       guint             slot,
+                       GValue           *value,
+                       gboolean          copy_string)
+{
+  gconstpointer cell = LIST_COLUMN_CELL (column, slot);
+
+  switch (column->storage)
+    {
+    case G_TYPE_BOOLEAN:
+      g_value_set_boolean (value, *(const gboolean *) cell);
+      break;
+
+    case G_TYPE_INT:
+      g_value_set_int (value, *(const gint *) cell);
+      break;
+
+    case G_TYPE_ENUM:
+      g_value_set_enum (value, *(const gint *) cell);
+      break;
+
+    case G_TYPE_UINT:
+      g_value_set_uint (value, *(const guint *) cell);
+      break;
+
+    case G_TYPE_FLAGS:
+      g_value_set_flags (value, *(const guint *) cell);
+      break;
+
+    case G_TYPE_LONG:
+      g_value_set_long (value, *(const glong *) cell);
+      break;
+
+    case G_TYPE_ULONG:
+      g_value_set_ulong (value, *(const gulong *) cell);
+      break;
+
+    case G_TYPE_INT64:
+      g_value_set_int64 (value, *(const gint64 *) cell);
+      break;
+
+    case G_TYPE_UINT64:
+      g_value_set_uint64 (value, *(const guint64 *) cell);
+      break;
+
+    case G_TYPE_FLOAT:
+      g_value_set_float (value, *(const gfloat *) cell);
+      break;
+
+    case G_TYPE_DOUBLE:
+      g_value_set_double (value, *(const gdouble *) cell);
+      break;
+
+    case G_TYPE_STRING:
+      if (copy_string)
+        g_value_set_string (value, *(gchar * const *) cell);
+      else
+        g_value_set_static_string (value, *(gchar * const *) cell);
+      break;
+
+    case G_TYPE_POINTER:
+      g_value_set_pointer (value, *(gpointer const *) cell);
+      break;
+
+    case G_TYPE_OBJECT:
+      g_value_set_object (value, *(gpointer const *) cell);
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+}
+
+/* Stores @value, which must hold the type of @column, inside a cell */
+static void
+list_column_set_value (ListColumn   *column,
+                       guint         slot,
+                       const GValue *value)
+{
+  gpointer cell = LIST_COLUMN_CELL (column, slot);
+
+  switch (column->storage)
+    {
+    case G_TYPE_BOOLEAN:
+      *(gboolean *) cell = g_value_get_boolean (value);
+      break;
+
+    case G_TYPE_INT:
+      *(gint *) cell = g_value_get_int (value);
+      break;
+
+    case G_TYPE_ENUM:
+      *(gint *) cell = g_value_get_enum (value);
+      break;
+
+    case G_TYPE_UINT:
+      *(guint *) cell = g_value_get_uint (value);
+      break;
+
+    case G_TYPE_FLAGS:
+      *(guint *) cell = g_value_get_flags (value);
+      break;
+
+    case G_TYPE_LONG:
+      *(glong *) cell = g_value_get_long (value);
+      break;
+
+    case G_TYPE_ULONG:
+      *(gulong *) cell = g_value_get_ulong (value);
+      break;
+
+    case G_TYPE_INT64:
+      *(gint64 *) cell = g_value_get_int64 (value);
+      break;
+
+    case G_TYPE_UINT64:
+      *(guint64 *) cell = g_value_get_uint64 (value);
+      break;
+
+    case G_TYPE_FLOAT:
+      *(gfloat *) cell = g_value_get_float (value);
+      break;
+
+    case G_TYPE_DOUBLE:
+      *(gdouble *) cell = g_value_get_double (value);
+      break;
+
+    case G_TYPE_STRING:
+      {
+        gchar *old_string = *(gchar **) cell;
+
+        /* @value might hold the string being replaced */
+        *(gchar **) cell = g_value_dup_string (value);
+
+        g_free (old_string);
+      }
+      break;
+
+    case G_TYPE_POINTER:
+      *(gpointer *) cell = g_value_get_pointer (value);
+      break;
+
+    case G_TYPE_OBJECT:
+      {
+        GObject *old_object = *(GObject **) cell;
+
+        *(GObject **) cell = g_value_dup_object (value);
+
+        if (old_object != NULL)
+          g_object_unref (old_object);
+      }
+      break;
+
+    default:
+      g_value_copy (value, cell);
+      break;
+    }
+}
+
+/* Copies @n_slots elements of the C type used by @column from @data */
+static void
+list_column_set_cells (ListColumn    *column,
+                       const guint   *slots,
+                       guint          n_slots,
+                       gboolean       contiguous,
+                       gconstpointer  data)
+{
+  guint i;
+
+  switch (column->storage)
+    {
+    case G_TYPE_STRING:
+      for (i = 0; i < n_slots; i++)
+        {
+          gchar **cell = LIST_COLUMN_CELL (column, slots[i]);
+
+          g_free (*cell);
+          *cell = g_strdup (((const gchar * const *) data)[i]);
+        }
+      break;
+
+    case G_TYPE_OBJECT:
+      for (i = 0; i < n_slots; i++)
+        {
+          GObject **cell = LIST_COLUMN_CELL (column, slots[i]);
+          GObject *old_object = *cell;
+          gpointer object = ((gpointer const *) data)[i];
+
+          *cell = object != NULL ? g_object_ref (object) : NULL;
+
+          if (old_object != NULL)
+            g_object_unref (old_object);
+        }
+      break;
+
+    case G_TYPE_INVALID:
+      for (i = 0; i < n_slots; i++)
+        g_value_copy (((const GValue *) data) + i,
+                      LIST_COLUMN_CELL (column, slots[i]));
+      break;
+
+    default:
+      /* plain values can be copied as they are */
+      if (contiguous)
+        memcpy (LIST_COLUMN_CELL (column, slots[0]),
+                data,
+                (gsize) n_slots * column->cell_size);
+      else
+        {
+          for (i = 0; i < n_slots; i++)
+            memcpy (LIST_COLUMN_CELL (column, slots[i]),
+                    ((const guint8 *) data) + (gsize) i * column->cell_size,
+                    column->cell_size);
+        }
+      break;
+    }
+}
+
+/*
+ * Row slots
+ */
+
+static void
+clutter_list_model_ensure_columns (ClutterListModel *model)
+{
+  ClutterListModelPrivate *priv = model->priv;
+  guint i;
+
+  if (priv->columns != NULL)
+    return;
+
+  priv->n_columns = clutter_model_get_n_columns (CLUTTER_MODEL (model));
+  priv->columns = g_new0 (ListColumn, priv->n_columns);
+
+  for (i = 0; i < priv->n_columns; i++)
+    {
+      GType gtype;
+
+      gtype = clutter_model_get_column_type (CLUTTER_MODEL (model), i);
+      list_column_init (&priv->columns[i], gtype);
+    }
+}
+
+static guint
+clutter_list_model_alloc_slot (ClutterListModel *model)
+{
+  ClutterListModelPrivate *priv = model->priv;
+  guint i, slot;
+
+  if (priv->free_slots->len > 0)
+    {
+      slot = g_array_index (priv->free_slots, guint, priv->free_slots->len - 1);
+      g_array_set_size (priv->free_slots, priv->free_slots->len - 1);
+
+      return slot;
+    }
+
+  slot = priv->n_slots++;
+
+  for (i = 0; i < priv->n_columns; i++)
+    list_column_resize (&priv->columns[i], priv->n_slots);
+
+  return slot;
+}
+
+static void
+clutter_list_model_free_slot (ClutterListModel *model,
+                              guint             slot)
+{
+  ClutterListModelPrivate *priv = model->priv;
+  guint i;
+
+  for (i = 0; i < priv->n_columns; i++)
+    list_column_clear_cell (&priv->columns[i], slot);
+
+  g_array_append_val (priv->free_slots, slot);
+}
+
+/*
+ * Visible rows index
+ */
+
+static void
+clutter_list_model_invalidate_visible_rows (ClutterListModel *model)
+{
+  model->priv->visible_rows_valid = FALSE;
+}
+
+static gboolean
+clutter_list_model_filter_seq_iter (ClutterListModel *model,
+                                    GSequenceIter    *seq_iter,
+                                    guint             row)
+{
+  ClutterModelIter *temp_iter = model->priv->temp_iter;
+
+  CLUTTER_LIST_MODEL_ITER (temp_iter)->seq_iter = seq_iter;
+  _clutter_model_iter_set_row (temp_iter, row);
+
+  return clutter_model_filter_iter (CLUTTER_MODEL (model), temp_iter);
+}
+
+static void
+clutter_list_model_ensure_visible_rows (ClutterListModel *model)
+{
+  ClutterListModelPrivate *priv = model->priv;
+  GSequenceIter *seq_iter;
+
+  CLUTTER_STATIC_COUNTER (model_filter_rebuild_counter,
+                          "Model filter index rebuilds",
+                          "Number of times the visible rows of a list model were filtered",
+                          0);
+
+  if (priv->visible_rows_valid)
+    return;
+
+  CLUTTER_COUNTER_INC (_clutter_uprof_context, model_filter_rebuild_counter);
+
+  if (priv->visible_rows == NULL)
+    priv->visible_rows = g_ptr_array_new ();
+  else
+    g_ptr_array_set_size (priv->visible_rows, 0);
+
+  seq_iter = g_sequence_get_begin_iter (priv->sequence);
+  while (!g_sequence_iter_is_end (seq_iter))
+    {
+      if (clutter_list_model_filter_seq_iter (model, seq_iter,
+                                              priv->visible_rows->len))
+        g_ptr_array_add (priv->visible_rows, seq_iter);
+
+      seq_iter = g_sequence_iter_next (seq_iter);
+    }
+
+  priv->visible_rows_valid = TRUE;
+}
+
+/* Returns the position of @seq_iter inside the visible rows, or the
+ * position at which it would be if it were visible
+ */
+static guint
+clutter_list_model_find_visible_row (ClutterListModel *model,
+                                     GSequenceIter    *seq_iter,
+                                     gboolean         *is_visible)
+{
+  GPtrArray *visible_rows = model->priv->visible_rows;
+  guint lower = 0, upper = visible_rows->len;
+
+  while (lower < upper)
+    {
+      guint middle = lower + (upper - lower) / 2;
+      gint cmp;
+
+      cmp = g_sequence_iter_compare (g_ptr_array_index (visible_rows, middle),
+                                     seq_iter);
+      if (cmp == 0)
+        {
+          *is_visible = TRUE;
+          return middle;
+        }
+
+      if (cmp < 0)
+        lower = middle + 1;
+      else
+        upper = middle;
+    }
+
+  *is_visible = FALSE;
+
+  return lower;
+}
+
+/* Updates the visible rows after the row at @seq_iter was added or
+ * changed, without filtering the whole model again
+ */
+static void
+clutter_list_model_update_visible_row (ClutterListModel *model,
+                                       GSequenceIter    *seq_iter)
+{
+  ClutterListModelPrivate *priv = model->priv;
+  gboolean was_visible, is_visible;
+  guint pos;
+
+  if (!priv->visible_rows_valid)
+    return;
+
+  pos = clutter_list_model_find_visible_row (model, seq_iter, &was_visible);
+  is_visible = clutter_list_model_filter_seq_iter (model, seq_iter, pos);
+
+  if (was_visible && !is_visible)
+    g_ptr_array_remove_index (priv->visible_rows, pos);
+  else if (!was_visible && is_visible)
+    {
+      /* there is no g_ptr_array_insert() we can rely on */
+      g_ptr_array_add (priv->visible_rows, NULL);
+      memmove (priv->visible_rows->pdata + pos + 1,
+               priv->visible_rows->pdata + pos,
+               (priv->visible_rows->len - pos - 1) * sizeof (gpointer));
+      priv->visible_rows->pdata[pos] = seq_iter;
+    }
+}
+
+static void
+clutter_list_model_remove_visible_row (ClutterListModel *model,
+                                       GSequenceIter    *seq_iter)
+{
+  ClutterListModelPrivate *priv = model->priv;
+  gboolean is_visible;
+  guint pos;
+
+  if (!priv->visible_rows_valid)
+    return;
+
+  pos = clutter_list_model_find_visible_row (model, seq_iter, &is_visible);
+  if (is_visible)
+    g_ptr_array_remove_index (priv->visible_rows, pos);
+}
+
+/* Returns the sequence iterator of the @row-th row visible through
+ * the filter, or %NULL
+ */
+static GSequenceIter *
+clutter_list_model_get_visible_row (ClutterListModel *model,
+                                    guint             row)
+{
+  ClutterListModelPrivate *priv = model->priv;
+
+  if (!clutter_model_get_filter_set (CLUTTER_MODEL (model)))
+    {
+      if (row >= g_sequence_get_length (priv->sequence))
+        return NULL;
+
+      return g_sequence_get_iter_at_pos (priv->sequence, row);
+    }
+
+  clutter_list_model_ensure_visible_rows (model);
+
+  if (row >= priv->visible_rows->len)
+    return NULL;
+
+  return g_ptr_array_index (priv->visible_rows, row);
+}
+
 /*
  * ClutterListModel
  */
@@ -110,17 +739,35 @@ clutter_list_model_iter_get_value (ClutterModelIter *iter,
                                    GValue           *value)
 {
   ClutterListModelIter *iter_default;
-  GValue *values;
+  ClutterListModelPrivate *priv;
+  ListColumn *list_column;
+  GValue cell_value = G_VALUE_INIT;
   GValue *iter_value;
   GValue real_value = G_VALUE_INIT;
   gboolean converted = FALSE;
+  guint slot;
 
   iter_default = CLUTTER_LIST_MODEL_ITER (iter);
   g_assert (iter_default->seq_iter != NULL);
 
-  values = g_sequence_get (iter_default->seq_iter);
-  iter_value = &values[column];
-  g_assert (iter_value != NULL);
+  priv = CLUTTER_LIST_MODEL (clutter_model_iter_get_model (iter))->priv;
+  slot = GPOINTER_TO_UINT (g_sequence_get (iter_default->seq_iter));
+  list_column = &priv->columns[column];
+
+  if (list_column->storage == G_TYPE_INVALID)
+    iter_value = LIST_COLUMN_CELL (list_column, slot);
+  else if (G_VALUE_TYPE (value) == list_column->gtype)
+    {
+      /* fast path: no intermediate GValue */
+      list_column_get_value (list_column, slot, value, TRUE);
+      return;
+    }
+  else
+    {
+      g_value_init (&cell_value, list_column->gtype);
+      list_column_get_value (list_column, slot, &cell_value, FALSE);
+      iter_value = &cell_value;
+    }
 
   if (!g_type_is_a (G_VALUE_TYPE (value), G_VALUE_TYPE (iter_value)))
     {
@@ -133,9 +780,11 @@ clutter_list_model_iter_get_value (ClutterModelIter *iter,
                      G_STRLOC,
                      g_type_name (G_VALUE_TYPE (value)),
                      g_type_name (G_VALUE_TYPE (iter_value)));
-          return;
+          goto out;
         }
 
+      g_value_init (&real_value, G_VALUE_TYPE (value));
+
       if (!g_value_transform (iter_value, &real_value))
         {
           g_warning ("%s: Unable to make conversion from %s to %s",
@@ -143,6 +792,7 @@ clutter_list_model_iter_get_value (ClutterModelIter *iter,
                      g_type_name (G_VALUE_TYPE (value)),
                      g_type_name (G_VALUE_TYPE (iter_value)));
           g_value_unset (&real_value);
+          goto out;
         }
 
       converted = TRUE;
@@ -155,6 +805,10 @@ clutter_list_model_iter_get_value (ClutterModelIter *iter,
     }
   else
     g_value_copy (iter_value, value);
+
+out:
+  if (iter_value == &cell_value)
+    g_value_unset (&cell_value);
 }
 
 static void
@@ -163,39 +817,43 @@ clutter_list_model_iter_set_value (ClutterModelIter *iter,
                                    const GValue     *value)
 {
   ClutterListModelIter *iter_default;
-  GValue *values;
-  GValue *iter_value;
+  ClutterListModelPrivate *priv;
+  ListColumn *list_column;
   GValue real_value = G_VALUE_INIT;
   gboolean converted = FALSE;
+  GType column_type;
+  guint slot;
 
   iter_default = CLUTTER_LIST_MODEL_ITER (iter);
   g_assert (iter_default->seq_iter != NULL);
 
-  values = g_sequence_get (iter_default->seq_iter);
-  iter_value = &values[column];
-  g_assert (iter_value != NULL);
+  priv = CLUTTER_LIST_MODEL (clutter_model_iter_get_model (iter))->priv;
+  slot = GPOINTER_TO_UINT (g_sequence_get (iter_default->seq_iter));
+  list_column = &priv->columns[column];
+  column_type = list_column->gtype;
 
-  if (!g_type_is_a (G_VALUE_TYPE (value), G_VALUE_TYPE (iter_value)))
+  if (!g_type_is_a (G_VALUE_TYPE (value), column_type))
     {
-      if (!g_value_type_compatible (G_VALUE_TYPE (value), 
-                                    G_VALUE_TYPE (iter_value)) &&
-          !g_value_type_compatible (G_VALUE_TYPE (iter_value), 
-                                    G_VALUE_TYPE (value)))
+      if (!g_value_type_compatible (G_VALUE_TYPE (value), column_type) &&
+          !g_value_type_compatible (column_type, G_VALUE_TYPE (value)))
         {
           g_warning ("%s: Unable to convert from %s to %s\n",
                      G_STRLOC,
                      g_type_name (G_VALUE_TYPE (value)),
-                     g_type_name (G_VALUE_TYPE (iter_value)));
+                     g_type_name (column_type));
           return;
         }
 
+      g_value_init (&real_value, column_type);
+
       if (!g_value_transform (value, &real_value))
         {
           g_warning ("%s: Unable to make conversion from %s to %s\n",
                      G_STRLOC, 
                      g_type_name (G_VALUE_TYPE (value)),
-                     g_type_name (G_VALUE_TYPE (iter_value)));
+                     g_type_name (column_type));
           g_value_unset (&real_value);
+          return;
         }
 
       converted = TRUE;
@@ -203,11 +861,11 @@ clutter_list_model_iter_set_value (ClutterModelIter *iter,
  
   if (converted)
     {
-      g_value_copy (&real_value, iter_value);
+      list_column_set_value (list_column, slot, &real_value);
       g_value_unset (&real_value);
     }
   else
-    g_value_copy (value, iter_value);
+    list_column_set_value (list_column, slot, value);
 }
 
 static gboolean
@@ -440,52 +1098,20 @@ static ClutterModelIter *
 clutter_list_model_get_iter_at_row (ClutterModel *model,
                                     guint         row)
 {
-  ClutterListModel *model_default = CLUTTER_LIST_MODEL (model);
-  GSequence *sequence = model_default->priv->sequence;
-  GSequenceIter *filter_next;
-  gint seq_length = g_sequence_get_length (sequence);
   ClutterListModelIter *retval;
-  gint count = -1;
+  GSequenceIter *seq_iter;
 
-  if (row >= seq_length)
+  seq_iter = clutter_list_model_get_visible_row (CLUTTER_LIST_MODEL (model),
+                                                 row);
+  if (seq_iter == NULL)
     return NULL;
 
   retval = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
                          "model", model,
                          "row", row,
                          NULL);
+  retval->seq_iter = seq_iter;
 
-  /* short-circuit in case we don't have a filter in place */
-  if (!clutter_model_get_filter_set (model))
-    {
-      retval->seq_iter = g_sequence_get_iter_at_pos (sequence, row);
-
-      return CLUTTER_MODEL_ITER (retval);
-    }
-
-  filter_next = g_sequence_get_begin_iter (sequence);
-  g_assert (filter_next != NULL);
-
-  while (!g_sequence_iter_is_end (filter_next))
-    {
-      retval->seq_iter = filter_next;
-
-      if (clutter_model_filter_iter (model, CLUTTER_MODEL_ITER (retval)))
-        {
-          /* We've found a row that is valid under the filter */
-          count++;
-          if (count == row)
-            break;
-        }
-
-      filter_next = g_sequence_iter_next (filter_next);
-    }
-
-  if (count != row)
-    {
-      g_object_unref (retval);
-      return NULL;
-    }
   return CLUTTER_MODEL_ITER (retval);
 }
 
@@ -496,30 +1122,28 @@ clutter_list_model_insert_row (ClutterModel *model,
   ClutterListModel *model_default = CLUTTER_LIST_MODEL (model);
   GSequence *sequence = model_default->priv->sequence;
   ClutterListModelIter *retval;
-  guint n_columns, i, pos;
-  GValue *values;
+  guint pos;
+  gpointer slot;
   GSequenceIter *seq_iter;
 
-  n_columns = clutter_model_get_n_columns (model);
-  values = g_new0 (GValue, n_columns);
+  clutter_list_model_ensure_columns (model_default);
 
-  for (i = 0; i < n_columns; i++)
-    g_value_init (&values[i], clutter_model_get_column_type (model, i));
+  slot = GUINT_TO_POINTER (clutter_list_model_alloc_slot (model_default));
 
   if (index_ < 0)
     {
-      seq_iter = g_sequence_append (sequence, values);
+      seq_iter = g_sequence_append (sequence, slot);
       pos = g_sequence_get_length (sequence) - 1;
     }
   else if (index_ == 0)
     {
-      seq_iter = g_sequence_prepend (sequence, values);
+      seq_iter = g_sequence_prepend (sequence, slot);
       pos = 0;
     }
   else
     {
       seq_iter = g_sequence_get_iter_at_pos (sequence, index_);
-      seq_iter = g_sequence_insert_before (seq_iter, values);
+      seq_iter = g_sequence_insert_before (seq_iter, slot);
       pos = index_;
     }
 
@@ -536,52 +1160,42 @@ static void
 clutter_list_model_remove_row (ClutterModel *model,
                                guint         row)
 {
-  ClutterListModel *model_default = CLUTTER_LIST_MODEL (model);
-  GSequence *sequence = model_default->priv->sequence;
+  ClutterModelIter *iter;
   GSequenceIter *seq_iter;
-  guint pos = 0;
 
-  seq_iter = g_sequence_get_begin_iter (sequence);
-  while (!g_sequence_iter_is_end (seq_iter))
-    {
-      if (clutter_model_filter_row (model, pos))
-        {
-          if (pos == row)
-            {  
-              ClutterModelIter *iter;
-
-              iter = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
-                                   "model", model,
-                                   "row", pos,
-                                   NULL);
-              CLUTTER_LIST_MODEL_ITER (iter)->seq_iter = seq_iter;
-
-              /* the actual row is removed from the sequence inside
-               * the ::row-removed signal class handler, so that every
-               * handler connected to ::row-removed will still get
-               * a valid iterator, and every signal connected to
-               * ::row-removed with the AFTER flag will get an updated
-               * model
-               */
-              g_signal_emit_by_name (model, "row-removed", iter);
-
-              g_object_unref (iter);
-
-              break;
-            }
-        }
+  seq_iter = clutter_list_model_get_visible_row (CLUTTER_LIST_MODEL (model),
+                                                 row);
+  if (seq_iter == NULL)
+    return;
+
+  iter = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
+                       "model", model,
+                       "row", row,
+                       NULL);
+  CLUTTER_LIST_MODEL_ITER (iter)->seq_iter = seq_iter;
+
+  /* the actual row is removed from the sequence inside
+   * the ::row-removed signal class handler, so that every
+   * handler connected to ::row-removed will still get
+   * a valid iterator, and every signal connected to
+   * ::row-removed with the AFTER flag will get an updated
+   * model
+   */
+  g_signal_emit_by_name (model, "row-removed", iter);
 
-      pos += 1;
-      seq_iter = g_sequence_iter_next (seq_iter);
-    }
+  g_object_unref (iter);
 }
 
 typedef struct
 {
   ClutterModel *model;
-  guint column;
+  ListColumn *column;
   ClutterModelSortFunc func;
   gpointer data;
+
+  /* reused for every comparison */
+  GValue value_a;
+  GValue value_b;
 } SortClosure;
 
 static gint
@@ -589,13 +1203,22 @@ sort_model_default (gconstpointer a,
                     gconstpointer b,
                     gpointer      data)
 {
-  const GValue *row_a = a;
-  const GValue *row_b = b;
+  guint slot_a = GPOINTER_TO_UINT (a);
+  guint slot_b = GPOINTER_TO_UINT (b);
   SortClosure *clos = data;
 
+  if (clos->column->storage == G_TYPE_INVALID)
+    return clos->func (clos->model,
+                       LIST_COLUMN_CELL (clos->column, slot_a),
+                       LIST_COLUMN_CELL (clos->column, slot_b),
+                       clos->data);
+
+  list_column_get_value (clos->column, slot_a, &clos->value_a, FALSE);
+  list_column_get_value (clos->column, slot_b, &clos->value_b, FALSE);
+
   return clos->func (clos->model,
-                     &row_a[clos->column],
-                     &row_b[clos->column],
+                     &clos->value_a,
+                     &clos->value_b,
                      clos->data);
 }
 
@@ -604,16 +1227,35 @@ clutter_list_model_resort (ClutterModel         *model,
                            ClutterModelSortFunc  func,
                            gpointer              data)
 {
-  SortClosure sort_closure = { NULL, 0, NULL, NULL };
+  ClutterListModelPrivate *priv = CLUTTER_LIST_MODEL (model)->priv;
+  SortClosure sort_closure = { NULL, NULL, NULL, NULL, G_VALUE_INIT, G_VALUE_INIT };
+  gint column;
+
+  /* the visible rows have to be filtered again in their new order */
+  clutter_list_model_invalidate_visible_rows (CLUTTER_LIST_MODEL (model));
+
+  /* nothing to sort */
+  if (priv->columns == NULL)
+    return;
+
+  column = clutter_model_get_sorting_column (model);
+  if (column < 0 || column >= priv->n_columns)
+    return;
 
   sort_closure.model  = model;
-  sort_closure.column = clutter_model_get_sorting_column (model);
+  sort_closure.column = &priv->columns[column];
   sort_closure.func   = func;
   sort_closure.data   = data;
 
-  g_sequence_sort (CLUTTER_LIST_MODEL (model)->priv->sequence,
+  g_value_init (&sort_closure.value_a, sort_closure.column->gtype);
+  g_value_init (&sort_closure.value_b, sort_closure.column->gtype);
+
+  g_sequence_sort (priv->sequence,
                    sort_model_default,
                    &sort_closure);
+
+  g_value_unset (&sort_closure.value_a);
+  g_value_unset (&sort_closure.value_b);
 }
 
 static guint
@@ -625,7 +1267,9 @@ clutter_list_model_get_n_rows (ClutterModel *model)
   if (!clutter_model_get_filter_set (model))
     return g_sequence_get_length (list_model->priv->sequence);
 
-  return CLUTTER_MODEL_CLASS (clutter_list_model_parent_class)->get_n_rows (model);
+  clutter_list_model_ensure_visible_rows (list_model);
+
+  return list_model->priv->visible_rows->len;
 }
 
 static void
@@ -633,19 +1277,15 @@ clutter_list_model_row_removed (ClutterModel     *model,
                                 ClutterModelIter *iter)
 {
   ClutterListModelIter *iter_default;
-  guint i, n_columns;
-  GValue *values;
-
-  n_columns = clutter_model_get_n_columns (model);
+  guint slot;
 
   iter_default = CLUTTER_LIST_MODEL_ITER (iter);
 
-  values = g_sequence_get (iter_default->seq_iter);
-
-  for (i = 0; i < n_columns; i++)
-    g_value_unset (&values[i]);
+  clutter_list_model_remove_visible_row (CLUTTER_LIST_MODEL (model),
+                                         iter_default->seq_iter);
 
-  g_free (values);
+  slot = GPOINTER_TO_UINT (g_sequence_get (iter_default->seq_iter));
+  clutter_list_model_free_slot (CLUTTER_LIST_MODEL (model), slot);
 
   g_sequence_remove (iter_default->seq_iter);
   iter_default->seq_iter = NULL;
@@ -654,26 +1294,19 @@ clutter_list_model_row_removed (ClutterModel     *model,
 static void
 clutter_list_model_finalize (GObject *gobject)
 {
-  ClutterListModel *model = CLUTTER_LIST_MODEL (gobject);
-  GSequence *sequence = model->priv->sequence;
-  GSequenceIter *iter;
-  guint n_columns, i;
-
-  n_columns = clutter_model_get_n_columns (CLUTTER_MODEL (gobject));
+  ClutterListModelPrivate *priv = CLUTTER_LIST_MODEL (gobject)->priv;
+  guint i;
 
-  iter = g_sequence_get_begin_iter (sequence);
-  while (!g_sequence_iter_is_end (iter))
-    {
-      GValue *values = g_sequence_get (iter);
+  g_sequence_free (priv->sequence);
 
-      for (i = 0; i < n_columns; i++)
-        g_value_unset (&values[i]);
+  for (i = 0; i < priv->n_columns; i++)
+    list_column_free (&priv->columns[i]);
 
-      g_free (values);
+  g_free (priv->columns);
+  g_array_free (priv->free_slots, TRUE);
 
-      iter = g_sequence_iter_next (iter);
-    }
-  g_sequence_free (sequence);
+  if (priv->visible_rows != NULL)
+    g_ptr_array_free (priv->visible_rows, TRUE);
 
   G_OBJECT_CLASS (clutter_list_model_parent_class)->finalize (gobject);
 }
@@ -692,6 +1325,68 @@ clutter_list_model_dispose (GObject *gobject)
   G_OBJECT_CLASS (clutter_list_model_parent_class)->dispose (gobject);
 }
 
+static gboolean
+clutter_list_model_cursor_next (ClutterModel       *model,
+                                ClutterModelCursor *cursor)
+{
+  ClutterListModel *list_model = CLUTTER_LIST_MODEL (model);
+  RealModelCursor *rc = (RealModelCursor *) cursor;
+  GSequenceIter *seq_iter;
+
+  if (clutter_model_get_filter_set (model))
+    seq_iter = clutter_list_model_get_visible_row (list_model, rc->row + 1);
+  else if (rc->position == NULL)
+    seq_iter = g_sequence_get_begin_iter (list_model->priv->sequence);
+  else
+    seq_iter = g_sequence_iter_next (rc->position);
+
+  if (seq_iter == NULL || g_sequence_iter_is_end (seq_iter))
+    return FALSE;
+
+  rc->position = seq_iter;
+  rc->row += 1;
+
+  return TRUE;
+}
+
+static gconstpointer
+clutter_list_model_cursor_peek (ClutterModel       *model,
+                                ClutterModelCursor *cursor,
+                                guint               column)
+{
+  ClutterListModelPrivate *priv = CLUTTER_LIST_MODEL (model)->priv;
+  RealModelCursor *rc = (RealModelCursor *) cursor;
+  guint slot;
+
+  /* the cells are stored using the C type of the column, so
+   * we can return a pointer to the storage directly
+   */
+  slot = GPOINTER_TO_UINT (g_sequence_get (rc->position));
+
+  return LIST_COLUMN_CELL (&priv->columns[column], slot);
+}
+
+static void
+clutter_list_model_cursor_clear (ClutterModel       *model,
+                                 ClutterModelCursor *cursor)
+{
+  /* the cursor only points to the sequence; nothing to release */
+}
+
+static void
+clutter_list_model_on_row_changed (ClutterModel     *model,
+                                   ClutterModelIter *iter)
+{
+  clutter_list_model_update_visible_row (CLUTTER_LIST_MODEL (model),
+                                         CLUTTER_LIST_MODEL_ITER (iter)->seq_iter);
+}
+
+static void
+clutter_list_model_on_filter_changed (ClutterModel *model)
+{
+  clutter_list_model_invalidate_visible_rows (CLUTTER_LIST_MODEL (model));
+}
+
 static void
 clutter_list_model_class_init (ClutterListModelClass *klass)
 {
@@ -708,6 +1403,9 @@ clutter_list_model_class_init (ClutterListModelClass *klass)
   model_class->remove_row      = clutter_list_model_remove_row;
   model_class->resort          = clutter_list_model_resort;
   model_class->get_n_rows      = clutter_list_model_get_n_rows;
+  model_class->cursor_next     = clutter_list_model_cursor_next;
+  model_class->cursor_peek     = clutter_list_model_cursor_peek;
+  model_class->cursor_clear    = clutter_list_model_cursor_clear;
 
   model_class->row_removed     = clutter_list_model_row_removed;
 }
@@ -718,10 +1416,25 @@ clutter_list_model_init (ClutterListModel *model)
   model->priv = CLUTTER_LIST_MODEL_GET_PRIVATE (model);
 
   model->priv->sequence = g_sequence_new (NULL);
+  model->priv->free_slots = g_array_new (FALSE, FALSE, sizeof (guint));
   model->priv->temp_iter = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
                                          "model",
                                          model,
                                          NULL);
+
+  /* the index of the visible rows must be up to date before any
+   * other handler gets to query the model, so we cannot rely on
+   * the class handlers, which are run last
+   */
+  g_signal_connect (model, "row-added",
+                    G_CALLBACK (clutter_list_model_on_row_changed),
+                    NULL);
+  g_signal_connect (model, "row-changed",
+                    G_CALLBACK (clutter_list_model_on_row_changed),
+                    NULL);
+  g_signal_connect (model, "filter-changed",
+                    G_CALLBACK (clutter_list_model_on_filter_changed),
+                    NULL);
 }
 
 /**
@@ -829,3 +1542,132 @@ clutter_list_model_newv (guint                n_columns,
 
   return model;
 }
+
+/**
+ * clutter_list_model_append_rows:
+ * @model: a #ClutterListModel
+ * @n_rows: the number of rows to append
+ * @n_columns: the number of columns to set
+ * @columns: (array length=n_columns): the columns to set
+ * @column_data: (array length=n_columns): for each column in @columns,
+ *   an array of @n_rows values
+ *
+ * Appends @n_rows rows to @model in one go, setting the values of the
+ * given @columns; the columns not listed in @columns will hold the
+ * default value of their type.
+ *
+ * Each array inside @column_data contains @n_rows elements of the C
+ * type used by the corresponding column:
+ *
+ * <itemizedlist>
+ *   <listitem><simpara>#gboolean, #gint, #guint, #glong, #gulong,
+ *   #gint64, #guint64, #gfloat and #gdouble for the respective
+ *   fundamental types;</simpara></listitem>
+ *   <listitem><simpara>#gint for enumerations and #guint for
+ *   flags;</simpara></listitem>
+ *   <listitem><simpara>a string pointer for %G_TYPE_STRING; the strings
+ *   are copied;</simpara></listitem>
+ *   <listitem><simpara>a pointer for %G_TYPE_POINTER and for #GObject
+ *   types; objects are referenced;</simpara></listitem>
+ *   <listitem><simpara>a #GValue initialized to the column type for every
+ *   other type; the values are copied.</simpara></listitem>
+ * </itemizedlist>
+ *
+ * Unlike clutter_model_appendv(), this function does not emit the
+ * #ClutterModel::row-added signal for each new row: the
+ * #ClutterModel::rows-added signal is emitted once, for the range of
+ * rows that are visible through the filter of @model. If @model is
+ * sorted on one of @columns, the #ClutterModel::sort-changed signal
+ * is emitted afterwards.
+ *
+ * Since: 1.12
+ */
+void
+clutter_list_model_append_rows (ClutterListModel *model,
+                                guint             n_rows,
+                                guint             n_columns,
+                                const guint      *columns,
+                                gconstpointer    *column_data)
+{
+  ClutterListModelPrivate *priv;
+  guint first_row, n_visible_rows;
+  gboolean contiguous, resort;
+  guint *slots;
+  guint i;
+
+  g_return_if_fail (CLUTTER_IS_LIST_MODEL (model));
+  g_return_if_fail (n_columns == 0 || (columns != NULL && column_data != NULL));
+
+  if (n_rows == 0)
+    return;
+
+  priv = model->priv;
+
+  clutter_list_model_ensure_columns (model);
+
+  for (i = 0; i < n_columns; i++)
+    g_return_if_fail (columns[i] < priv->n_columns);
+
+  first_row = clutter_model_get_n_rows (CLUTTER_MODEL (model));
+
+  slots = g_new (guint, n_rows);
+
+  /* reuse the slots of removed rows first, then grow each column once */
+  for (i = 0; i < n_rows && priv->free_slots->len > 0; i++)
+    slots[i] = clutter_list_model_alloc_slot (model);
+
+  if (i < n_rows)
+    {
+      guint j;
+
+      for (j = 0; j < priv->n_columns; j++)
+        list_column_resize (&priv->columns[j], priv->n_slots + (n_rows - i));
+
+      for (; i < n_rows; i++)
+        slots[i] = priv->n_slots++;
+    }
+
+  contiguous = slots[n_rows - 1] - slots[0] == n_rows - 1;
+  for (i = 1; contiguous && i < n_rows; i++)
+    contiguous = slots[i] == slots[i - 1] + 1;
+
+  resort = FALSE;
+  for (i = 0; i < n_columns; i++)
+    {
+      list_column_set_cells (&priv->columns[columns[i]],
+                             slots, n_rows,
+                             contiguous,
+                             column_data[i]);
+
+      if (clutter_model_get_sorting_column (CLUTTER_MODEL (model)) == columns[i])
+        resort = TRUE;
+    }
+
+  for (i = 0; i < n_rows; i++)
+    {
+      GSequenceIter *seq_iter;
+
+      seq_iter = g_sequence_append (priv->sequence, GUINT_TO_POINTER (slots[i]));
+
+      /* the new rows are at the end, so the index stays sorted */
+      if (priv->visible_rows_valid &&
+          clutter_list_model_filter_seq_iter (model, seq_iter,
+                                              priv->visible_rows->len))
+        g_ptr_array_add (priv->visible_rows, seq_iter);
+    }
+
+  g_free (slots);
+
+  n_visible_rows = clutter_model_get_n_rows (CLUTTER_MODEL (model)) - first_row;
+
+  CLUTTER_NOTE (MISC, "Appended %u rows (%u visible) to model %p",
+                n_rows, n_visible_rows, model);
+
+  if (n_visible_rows > 0)
+    _clutter_model_emit_rows_added (CLUTTER_MODEL (model),
+                                    first_row,
+                                    n_visible_rows);
+
+  if (resort)
+    clutter_model_resort (CLUTTER_MODEL (model));
+}
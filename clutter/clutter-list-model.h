@@ -32,6 +32,7 @@
 #ifndef __CLUTTER_LIST_MODEL_H__
 #define __CLUTTER_LIST_MODEL_H__
 
+#include <clutter/clutter-types.h>
 #include <clutter/clutter-model.h>
 
 G_BEGIN_DECLS
@@ -83,6 +84,13 @@ ClutterModel *clutter_list_model_newv     (guint                n_columns,
                                            GType               *types,
                                            const gchar * const  names[]);
 
+CLUTTER_AVAILABLE_IN_1_12
+void          clutter_list_model_append_rows (ClutterListModel *model,
+                                              guint             n_rows,
+                                              guint             n_columns,
+                                              const guint      *columns,
+                                              gconstpointer    *column_data);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_LIST_MODEL_H__ */
@@ -0,0 +1,1083 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2012  Intel Corporation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:clutter-list-view
+ * @Title: ClutterListView
+ * @Short_Description: A scrollable view of the rows of a ClutterModel
+ *
+ * #ClutterListView is a #ClutterScrollActor that displays the rows of
+ * a #ClutterModel, either as a list or, if the #ClutterListView:columns
+ * property is bigger than one, as a grid.
+ *
+ * Instead of creating an actor for each row of the model, a
+ * #ClutterListView only creates enough actors to fill its visible
+ * region, using the #ClutterListViewCreateFunc passed to
+ * clutter_list_view_set_item_factory(); as the view is scrolled, the
+ * actors that fall outside of the visible region are recycled and bound
+ * to the rows that became visible, using the #ClutterListViewBindFunc.
+ * The number of actors is thus proportional to the size of the view,
+ * and not to the size of the model.
+ *
+ * All the items of a #ClutterListView are allocated the same size: the
+ * width of the view divided by the number of columns, and an estimate of
+ * the height of a row, computed by sampling the preferred height of the
+ * first bound items. The preferred height of the view is the estimated
+ * height of all the rows of the model, and it can be used to compute the
+ * extent of the scrolling region.
+ *
+ * The view tracks the #ClutterModel::row-added, #ClutterModel::row-removed
+ * and #ClutterModel::row-changed signals, and only rebinds the items
+ * affected by each change.
+ *
+ * #ClutterListView is available since Clutter 1.12.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include <string.h>
+
+#include "clutter-list-view.h"
+
+#include "clutter-actor-private.h"
+#include "clutter-debug.h"
+#include "clutter-main.h"
+#include "clutter-private.h"
+#include "clutter-profile.h"
+
+/* the number of bound items used to estimate the height of a row */
+#define N_ROW_SAMPLES   8
+
+struct _ClutterListViewPrivate
+{
+  ClutterModel *model;
+
+  ClutterListViewCreateFunc create_func;
+  ClutterListViewBindFunc bind_func;
+  gpointer factory_data;
+  GDestroyNotify factory_notify;
+
+  guint n_columns;
+
+  /* the items bound to the rows in the [first_row, first_row + items->len)
+   * range; a NULL slot marks a row that still needs to be bound
+   */
+  GPtrArray *items;
+  guint first_row;
+
+  /* swapped with items when the visible range moves */
+  GPtrArray *scratch;
+
+  /* unbound, hidden items ready to be reused */
+  GPtrArray *pool;
+
+  gfloat viewport_width;
+  gfloat viewport_height;
+  ClutterPoint scroll_to;
+
+  /* running estimate of the size of an item */
+  gfloat row_height;
+  gfloat item_width;
+  gfloat samples_height;
+  gfloat samples_width;
+  guint n_samples;
+
+  guint update_id;
+
+  gulong row_added_id;
+  gulong row_removed_id;
+  gulong row_changed_id;
+  gulong rows_added_id;
+  gulong sort_changed_id;
+  gulong filter_changed_id;
+};
+
+enum
+{
+  PROP_0,
+
+  PROP_MODEL,
+  PROP_COLUMNS,
+
+  PROP_LAST
+};
+
+static GParamSpec *obj_props[PROP_LAST] = { NULL, };
+
+G_DEFINE_TYPE (ClutterListView, clutter_list_view, CLUTTER_TYPE_SCROLL_ACTOR)
+
+static gboolean
+clutter_list_view_update_items (gpointer data);
+
+static void
+clutter_list_view_queue_update (ClutterListView *view)
+{
+  ClutterListViewPrivate *priv = view->priv;
+
+  if (priv->update_id != 0)
+    return;
+
+  /* binding items may change their preferred size, so we update the
+   * visible range before the stage relayout instead of doing it from
+   * within ClutterActor::allocate()
+   */
+  priv->update_id =
+    clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_PRE_PAINT |
+                                           CLUTTER_REPAINT_FLAGS_QUEUE_REDRAW_ON_ADD,
+                                           clutter_list_view_update_items,
+                                           view,
+                                           NULL);
+}
+
+static void
+clutter_list_view_reset_estimate (ClutterListView *view)
+{
+  ClutterListViewPrivate *priv = view->priv;
+
+  priv->row_height = 0.f;
+  priv->item_width = 0.f;
+  priv->samples_height = 0.f;
+  priv->samples_width = 0.f;
+  priv->n_samples = 0;
+}
+
+static void
+clutter_list_view_sample_item (ClutterListView *view,
+                               ClutterActor    *item)
+{
+  ClutterListViewPrivate *priv = view->priv;
+  gfloat nat_width, nat_height, for_width;
+  gfloat old_height, old_width;
+
+  if (priv->n_samples >= N_ROW_SAMPLES)
+    return;
+
+  clutter_actor_get_preferred_width (item, -1, NULL, &nat_width);
+
+  if (priv->viewport_width > 0)
+    for_width = priv->viewport_width / priv->n_columns;
+  else
+    for_width = nat_width;
+
+  clutter_actor_get_preferred_height (item, for_width, NULL, &nat_height);
+
+  old_height = priv->row_height;
+  old_width = priv->item_width;
+
+  priv->samples_width += nat_width;
+  priv->samples_height += nat_height;
+  priv->n_samples += 1;
+
+  priv->item_width = priv->samples_width / priv->n_samples;
+  priv->row_height = priv->samples_height / priv->n_samples;
+
+  CLUTTER_NOTE (LAYOUT, "ListView '%s' estimated row height: %.2f (%d samples)",
+                _clutter_actor_get_debug_name (CLUTTER_ACTOR (view)),
+                priv->row_height,
+                priv->n_samples);
+
+  /* the extent of the view depends on the estimate */
+  if (old_height != priv->row_height || old_width != priv->item_width)
+    clutter_actor_queue_relayout (CLUTTER_ACTOR (view));
+}
+
+static ClutterActor *
+clutter_list_view_acquire_item (ClutterListView *view)
+{
+  ClutterListViewPrivate *priv = view->priv;
+  ClutterActor *item;
+
+  CLUTTER_STATIC_COUNTER (list_view_items_counter,
+                          "ListView items created",
+                          "Number of item actors created by list views",
+                          0);
+
+  if (priv->pool->len > 0)
+    {
+      item = g_ptr_array_remove_index_fast (priv->pool, priv->pool->len - 1);
+      clutter_actor_show (item);
+
+      return item;
+    }
+
+  item = priv->create_func (view, priv->factory_data);
+  if (item == NULL)
+    {
+      g_critical ("The item factory of the ClutterListView '%s' did "
+                  "not return a valid actor",
+                  _clutter_actor_get_debug_name (CLUTTER_ACTOR (view)));
+      return NULL;
+    }
+
+  CLUTTER_COUNTER_INC (_clutter_uprof_context, list_view_items_counter);
+
+  clutter_actor_add_child (CLUTTER_ACTOR (view), item);
+
+  return item;
+}
+
+static void
+clutter_list_view_release_item (ClutterListView *view,
+                                ClutterActor    *item)
+{
+  clutter_actor_hide (item);
+  g_ptr_array_add (view->priv->pool, item);
+}
+
+static void
+clutter_list_view_bind_item (ClutterListView  *view,
+                             ClutterActor     *item,
+                             ClutterModelIter *iter)
+{
+  ClutterListViewPrivate *priv = view->priv;
+
+  priv->bind_func (view, item, iter, priv->factory_data);
+
+  clutter_list_view_sample_item (view, item);
+}
+
+/* unbinds all the items, so that they are bound again by the next
+ * update; the actors themselves are kept around for reuse
+ */
+static void
+clutter_list_view_release_items (ClutterListView *view)
+{
+  ClutterListViewPrivate *priv = view->priv;
+  guint i;
+
+  for (i = 0; i < priv->items->len; i++)
+    {
+      ClutterActor *item = g_ptr_array_index (priv->items, i);
+
+      if (item != NULL)
+        clutter_list_view_release_item (view, item);
+    }
+
+  g_ptr_array_set_size (priv->items, 0);
+  priv->first_row = 0;
+}
+
+static void
+clutter_list_view_invalidate (ClutterListView *view)
+{
+  clutter_list_view_release_items (view);
+  clutter_list_view_queue_update (view);
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (view));
+}
+
+/* destroys all the items; used when the factory changes */
+static void
+clutter_list_view_destroy_items (ClutterListView *view)
+{
+  ClutterListViewPrivate *priv = view->priv;
+  guint i;
+
+  clutter_list_view_release_items (view);
+
+  for (i = 0; i < priv->pool->len; i++)
+    clutter_actor_destroy (g_ptr_array_index (priv->pool, i));
+
+  g_ptr_array_set_size (priv->pool, 0);
+}
+
+static inline guint
+clutter_list_view_clamp_line (gfloat line,
+                              guint  n_lines)
+{
+  if (line <= 0.f)
+    return 0;
+
+  if (line >= (gfloat) n_lines)
+    return n_lines;
+
+  return (guint) line;
+}
+
+/* moves the visible range to [first_row, last_row), keeping the items
+ * that are bound to rows inside the new range and recycling the others
+ */
+static void
+clutter_list_view_set_range (ClutterListView *view,
+                             guint            first_row,
+                             guint            last_row)
+{
+  ClutterListViewPrivate *priv = view->priv;
+  GPtrArray *items = priv->scratch;
+  guint i;
+
+  if (first_row == priv->first_row &&
+      last_row == priv->first_row + priv->items->len)
+    return;
+
+  g_ptr_array_set_size (items, 0);
+  g_ptr_array_set_size (items, last_row - first_row);
+
+  for (i = 0; i < priv->items->len; i++)
+    {
+      ClutterActor *item = g_ptr_array_index (priv->items, i);
+      guint row = priv->first_row + i;
+
+      if (item == NULL)
+        continue;
+
+      if (row >= first_row && row < last_row)
+        g_ptr_array_index (items, row - first_row) = item;
+      else
+        clutter_list_view_release_item (view, item);
+    }
+
+  g_ptr_array_set_size (priv->items, 0);
+
+  priv->scratch = priv->items;
+  priv->items = items;
+  priv->first_row = first_row;
+}
+
+static gboolean
+clutter_list_view_update_items (gpointer data)
+{
+  ClutterListView *view = data;
+  ClutterListViewPrivate *priv = view->priv;
+  ClutterModelIter *iter;
+  guint n_rows, n_lines, iter_row;
+  guint first_row, last_row;
+  gboolean has_estimate;
+  guint i;
+
+  priv->update_id = 0;
+
+  if (priv->model == NULL ||
+      priv->create_func == NULL ||
+      priv->bind_func == NULL)
+    {
+      clutter_list_view_release_items (view);
+      return FALSE;
+    }
+
+  n_rows = clutter_model_get_n_rows (priv->model);
+  n_lines = (n_rows + priv->n_columns - 1) / priv->n_columns;
+
+again:
+  has_estimate = priv->n_samples > 0;
+
+  if (has_estimate)
+    {
+      ClutterScrollMode mode;
+      gfloat offset, row_height;
+
+      mode = clutter_scroll_actor_get_scroll_mode (CLUTTER_SCROLL_ACTOR (view));
+      if (mode & CLUTTER_SCROLL_VERTICALLY)
+        offset = priv->scroll_to.y;
+      else
+        offset = 0.f;
+
+      row_height = MAX (priv->row_height, 1.f);
+
+      first_row = clutter_list_view_clamp_line (floorf (offset / row_height),
+                                                n_lines);
+      last_row = clutter_list_view_clamp_line (ceilf ((offset + priv->viewport_height)
+                                                      / row_height),
+                                               n_lines);
+
+      first_row = MIN (first_row * priv->n_columns, n_rows);
+      last_row = MIN (last_row * priv->n_columns, n_rows);
+    }
+  else
+    {
+      /* bind the first line, to get an initial estimate */
+      first_row = 0;
+      last_row = MIN (priv->n_columns, n_rows);
+    }
+
+  clutter_list_view_set_range (view, first_row, last_row);
+
+  iter = NULL;
+  iter_row = 0;
+
+  for (i = 0; i < priv->items->len; i++)
+    {
+      guint row = priv->first_row + i;
+      ClutterActor *item;
+
+      if (g_ptr_array_index (priv->items, i) != NULL)
+        continue;
+
+      /* advancing an iterator is cheaper than a random access */
+      if (iter != NULL && iter_row + 1 == row)
+        iter = clutter_model_iter_next (iter);
+      else
+        {
+          if (iter != NULL)
+            g_object_unref (iter);
+
+          iter = clutter_model_get_iter_at_row (priv->model, row);
+        }
+
+      iter_row = row;
+
+      if (iter == NULL || clutter_model_iter_is_last (iter))
+        break;
+
+      item = clutter_list_view_acquire_item (view);
+      if (item == NULL)
+        break;
+
+      clutter_list_view_bind_item (view, item, iter);
+
+      g_ptr_array_index (priv->items, i) = item;
+    }
+
+  if (iter != NULL)
+    g_object_unref (iter);
+
+  if (!has_estimate && priv->n_samples > 0)
+    goto again;
+
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (view));
+
+  return FALSE;
+}
+
+static void
+clutter_list_view_scroll_changed (ClutterScrollActor *actor,
+                                  const ClutterPoint *point)
+{
+  ClutterListView *view = CLUTTER_LIST_VIEW (actor);
+
+  view->priv->scroll_to = *point;
+
+  clutter_list_view_queue_update (view);
+}
+
+/* inserts an unbound slot at the given index */
+static void
+clutter_list_view_insert_slot (GPtrArray *items,
+                               guint      index_)
+{
+  g_ptr_array_add (items, NULL);
+
+  memmove (items->pdata + index_ + 1,
+           items->pdata + index_,
+           (items->len - index_ - 1) * sizeof (gpointer));
+
+  g_ptr_array_index (items, index_) = NULL;
+}
+
+static void
+clutter_list_view_row_added (ClutterModel     *model,
+                             ClutterModelIter *iter,
+                             ClutterListView  *view)
+{
+  ClutterListViewPrivate *priv = view->priv;
+  guint row;
+
+  /* the row of an iterator on a filtered model does not tell us where
+   * the new row ends up, so we just bind the whole range again
+   */
+  if (clutter_model_get_filter_set (model))
+    {
+      clutter_list_view_invalidate (view);
+      return;
+    }
+
+  row = clutter_model_iter_get_row (iter);
+
+  /* the items keep showing the same rows, shifted by one */
+  if (row < priv->first_row)
+    priv->first_row += 1;
+  else if (row < priv->first_row + priv->items->len)
+    clutter_list_view_insert_slot (priv->items, row - priv->first_row);
+
+  clutter_list_view_queue_update (view);
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (view));
+}
+
+static void
+clutter_list_view_row_removed (ClutterModel     *model,
+                               ClutterModelIter *iter,
+                               ClutterListView  *view)
+{
+  ClutterListViewPrivate *priv = view->priv;
+  guint row;
+
+  if (clutter_model_get_filter_set (model))
+    {
+      clutter_list_view_invalidate (view);
+      return;
+    }
+
+  row = clutter_model_iter_get_row (iter);
+
+  if (row < priv->first_row)
+    priv->first_row -= 1;
+  else if (row < priv->first_row + priv->items->len)
+    {
+      ClutterActor *item;
+
+      item = g_ptr_array_remove_index (priv->items, row - priv->first_row);
+      if (item != NULL)
+        clutter_list_view_release_item (view, item);
+    }
+
+  clutter_list_view_queue_update (view);
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (view));
+}
+
+static void
+clutter_list_view_row_changed (ClutterModel     *model,
+                               ClutterModelIter *iter,
+                               ClutterListView  *view)
+{
+  ClutterListViewPrivate *priv = view->priv;
+  ClutterActor *item;
+  guint row;
+
+  /* the change may have moved the row in or out of the filter */
+  if (clutter_model_get_filter_set (model))
+    {
+      clutter_list_view_invalidate (view);
+      return;
+    }
+
+  row = clutter_model_iter_get_row (iter);
+
+  if (row < priv->first_row || row >= priv->first_row + priv->items->len)
+    return;
+
+  item = g_ptr_array_index (priv->items, row - priv->first_row);
+  if (item != NULL)
+    priv->bind_func (view, item, iter, priv->factory_data);
+}
+
+static void
+clutter_list_view_rows_added (ClutterModel    *model,
+                              guint            first_row,
+                              guint            n_rows,
+                              ClutterListView *view)
+{
+  ClutterListViewPrivate *priv = view->priv;
+
+  /* rows appended past the visible range only change the extent */
+  if (!clutter_model_get_filter_set (model) &&
+      first_row >= priv->first_row + priv->items->len)
+    {
+      clutter_list_view_queue_update (view);
+      clutter_actor_queue_relayout (CLUTTER_ACTOR (view));
+      return;
+    }
+
+  clutter_list_view_invalidate (view);
+}
+
+static void
+clutter_list_view_model_changed (ClutterModel    *model,
+                                 ClutterListView *view)
+{
+  clutter_list_view_invalidate (view);
+}
+
+static void
+clutter_list_view_disconnect_model (ClutterListView *view)
+{
+  ClutterListViewPrivate *priv = view->priv;
+
+  if (priv->model == NULL)
+    return;
+
+  g_signal_handler_disconnect (priv->model, priv->row_added_id);
+  g_signal_handler_disconnect (priv->model, priv->row_removed_id);
+  g_signal_handler_disconnect (priv->model, priv->row_changed_id);
+  g_signal_handler_disconnect (priv->model, priv->rows_added_id);
+  g_signal_handler_disconnect (priv->model, priv->sort_changed_id);
+  g_signal_handler_disconnect (priv->model, priv->filter_changed_id);
+
+  priv->row_added_id = 0;
+  priv->row_removed_id = 0;
+  priv->row_changed_id = 0;
+  priv->rows_added_id = 0;
+  priv->sort_changed_id = 0;
+  priv->filter_changed_id = 0;
+
+  g_object_unref (priv->model);
+  priv->model = NULL;
+}
+
+static void
+clutter_list_view_get_preferred_width (ClutterActor *actor,
+                                       gfloat        for_height,
+                                       gfloat       *min_width_p,
+                                       gfloat       *nat_width_p)
+{
+  ClutterListViewPrivate *priv = CLUTTER_LIST_VIEW (actor)->priv;
+
+  if (min_width_p)
+    *min_width_p = 0.f;
+
+  if (nat_width_p)
+    *nat_width_p = priv->item_width * priv->n_columns;
+}
+
+static void
+clutter_list_view_get_preferred_height (ClutterActor *actor,
+                                        gfloat        for_width,
+                                        gfloat       *min_height_p,
+                                        gfloat       *nat_height_p)
+{
+  ClutterListViewPrivate *priv = CLUTTER_LIST_VIEW (actor)->priv;
+  guint n_rows, n_lines;
+
+  if (priv->model != NULL)
+    n_rows = clutter_model_get_n_rows (priv->model);
+  else
+    n_rows = 0;
+
+  n_lines = (n_rows + priv->n_columns - 1) / priv->n_columns;
+
+  if (min_height_p)
+    *min_height_p = 0.f;
+
+  /* the extent of the scrolling region */
+  if (nat_height_p)
+    *nat_height_p = n_lines * priv->row_height;
+}
+
+static void
+clutter_list_view_allocate (ClutterActor           *actor,
+                            const ClutterActorBox  *box,
+                            ClutterAllocationFlags  flags)
+{
+  ClutterListView *view = CLUTTER_LIST_VIEW (actor);
+  ClutterListViewPrivate *priv = view->priv;
+  gfloat width, height, item_width;
+  guint i;
+
+  clutter_actor_set_allocation (actor, box, flags);
+
+  clutter_actor_box_get_size (box, &width, &height);
+
+  if (width != priv->viewport_width || height != priv->viewport_height)
+    {
+      priv->viewport_width = width;
+      priv->viewport_height = height;
+
+      clutter_list_view_queue_update (view);
+    }
+
+  item_width = width / priv->n_columns;
+
+  for (i = 0; i < priv->items->len; i++)
+    {
+      ClutterActor *item = g_ptr_array_index (priv->items, i);
+      guint row = priv->first_row + i;
+      ClutterActorBox item_box;
+
+      if (item == NULL)
+        continue;
+
+      item_box.x1 = (row % priv->n_columns) * item_width;
+      item_box.y1 = (row / priv->n_columns) * priv->row_height;
+      item_box.x2 = item_box.x1 + item_width;
+      item_box.y2 = item_box.y1 + priv->row_height;
+
+      clutter_actor_allocate (item, &item_box, flags);
+    }
+}
+
+static void
+clutter_list_view_dispose (GObject *gobject)
+{
+  ClutterListView *view = CLUTTER_LIST_VIEW (gobject);
+  ClutterListViewPrivate *priv = view->priv;
+
+  if (priv->update_id != 0)
+    {
+      clutter_threads_remove_repaint_func (priv->update_id);
+      priv->update_id = 0;
+    }
+
+  clutter_list_view_disconnect_model (view);
+
+  /* the items are destroyed along with the rest of the children */
+  g_ptr_array_set_size (priv->items, 0);
+  g_ptr_array_set_size (priv->pool, 0);
+
+  if (priv->factory_notify != NULL)
+    {
+      priv->factory_notify (priv->factory_data);
+      priv->factory_notify = NULL;
+    }
+
+  priv->create_func = NULL;
+  priv->bind_func = NULL;
+  priv->factory_data = NULL;
+
+  G_OBJECT_CLASS (clutter_list_view_parent_class)->dispose (gobject);
+}
+
+static void
+clutter_list_view_finalize (GObject *gobject)
+{
+  ClutterListViewPrivate *priv = CLUTTER_LIST_VIEW (gobject)->priv;
+
+  g_ptr_array_free (priv->items, TRUE);
+  g_ptr_array_free (priv->scratch, TRUE);
+  g_ptr_array_free (priv->pool, TRUE);
+
+  G_OBJECT_CLASS (clutter_list_view_parent_class)->finalize (gobject);
+}
+
+static void
+clutter_list_view_set_property (GObject      *gobject,
+                                guint         prop_id,
+                                const GValue *value,
+                                GParamSpec   *pspec)
+{
+  ClutterListView *view = CLUTTER_LIST_VIEW (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_MODEL:
+      clutter_list_view_set_model (view, g_value_get_object (value));
+      break;
+
+    case PROP_COLUMNS:
+      clutter_list_view_set_columns (view, g_value_get_uint (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+clutter_list_view_get_property (GObject    *gobject,
+                                guint       prop_id,
+                                GValue     *value,
+                                GParamSpec *pspec)
+{
+  ClutterListViewPrivate *priv = CLUTTER_LIST_VIEW (gobject)->priv;
+
+  switch (prop_id)
+    {
+    case PROP_MODEL:
+      g_value_set_object (value, priv->model);
+      break;
+
+    case PROP_COLUMNS:
+      g_value_set_uint (value, priv->n_columns);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+clutter_list_view_class_init (ClutterListViewClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  ClutterActorClass *actor_class = CLUTTER_ACTOR_CLASS (klass);
+  ClutterScrollActorClass *scroll_class = CLUTTER_SCROLL_ACTOR_CLASS (klass);
+
+  g_type_class_add_private (klass, sizeof (ClutterListViewPrivate));
+
+  gobject_class->set_property = clutter_list_view_set_property;
+  gobject_class->get_property = clutter_list_view_get_property;
+  gobject_class->dispose = clutter_list_view_dispose;
+  gobject_class->finalize = clutter_list_view_finalize;
+
+  actor_class->get_preferred_width = clutter_list_view_get_preferred_width;
+  actor_class->get_preferred_height = clutter_list_view_get_preferred_height;
+  actor_class->allocate = clutter_list_view_allocate;
+
+  scroll_class->scroll_changed = clutter_list_view_scroll_changed;
+
+  /**
+   * ClutterListView:model:
+   *
+   * The #ClutterModel displayed by the view.
+   *
+   * Since: 1.12
+   */
+  obj_props[PROP_MODEL] =
+    g_param_spec_object ("model",
+                         P_("Model"),
+                         P_("The model displayed by the view"),
+                         CLUTTER_TYPE_MODEL,
+                         G_PARAM_READWRITE |
+                         G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClutterListView:columns:
+   *
+   * The number of items on each line of the view; if bigger than
+   * one, the rows of the model are laid out as a grid.
+   *
+   * Since: 1.12
+   */
+  obj_props[PROP_COLUMNS] =
+    g_param_spec_uint ("columns",
+                       P_("Columns"),
+                       P_("The number of items on each line of the view"),
+                       1, G_MAXUINT,
+                       1,
+                       G_PARAM_READWRITE |
+                       G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
+}
+
+static void
+clutter_list_view_init (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv;
+
+  self->priv = priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
+                                                   CLUTTER_TYPE_LIST_VIEW,
+                                                   ClutterListViewPrivate);
+
+  priv->n_columns = 1;
+
+  priv->items = g_ptr_array_new ();
+  priv->scratch = g_ptr_array_new ();
+  priv->pool = g_ptr_array_new ();
+}
+
+/**
+ * clutter_list_view_new:
+ *
+ * Creates a new #ClutterListView.
+ *
+ * Return value: (transfer full): the newly created #ClutterListView
+ *   instance.
+ *
+ * Since: 1.12
+ */
+ClutterActor *
+clutter_list_view_new (void)
+{
+  return g_object_new (CLUTTER_TYPE_LIST_VIEW, NULL);
+}
+
+/**
+ * clutter_list_view_set_model:
+ * @view: a #ClutterListView
+ * @model: (allow-none): a #ClutterModel, or %NULL
+ *
+ * Sets the #ClutterModel displayed by @view.
+ *
+ * The #ClutterListView will take a reference on @model.
+ *
+ * Since: 1.12
+ */
+void
+clutter_list_view_set_model (ClutterListView *view,
+                             ClutterModel    *model)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+  g_return_if_fail (model == NULL || CLUTTER_IS_MODEL (model));
+
+  priv = view->priv;
+
+  if (priv->model == model)
+    return;
+
+  clutter_list_view_disconnect_model (view);
+
+  if (model != NULL)
+    {
+      priv->model = g_object_ref (model);
+
+      priv->row_added_id =
+        g_signal_connect (model, "row-added",
+                          G_CALLBACK (clutter_list_view_row_added),
+                          view);
+      priv->row_removed_id =
+        g_signal_connect (model, "row-removed",
+                          G_CALLBACK (clutter_list_view_row_removed),
+                          view);
+      priv->row_changed_id =
+        g_signal_connect (model, "row-changed",
+                          G_CALLBACK (clutter_list_view_row_changed),
+                          view);
+      priv->rows_added_id =
+        g_signal_connect (model, "rows-added",
+                          G_CALLBACK (clutter_list_view_rows_added),
+                          view);
+      priv->sort_changed_id =
+        g_signal_connect (model, "sort-changed",
+                          G_CALLBACK (clutter_list_view_model_changed),
+                          view);
+      priv->filter_changed_id =
+        g_signal_connect (model, "filter-changed",
+                          G_CALLBACK (clutter_list_view_model_changed),
+                          view);
+    }
+
+  clutter_list_view_invalidate (view);
+
+  g_object_notify_by_pspec (G_OBJECT (view), obj_props[PROP_MODEL]);
+}
+
+/**
+ * clutter_list_view_get_model:
+ * @view: a #ClutterListView
+ *
+ * Retrieves the #ClutterModel displayed by @view.
+ *
+ * Return value: (transfer none): a #ClutterModel, or %NULL
+ *
+ * Since: 1.12
+ */
+ClutterModel *
+clutter_list_view_get_model (ClutterListView *view)
+{
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), NULL);
+
+  return view->priv->model;
+}
+
+/**
+ * clutter_list_view_set_columns:
+ * @view: a #ClutterListView
+ * @n_columns: the number of items on each line, greater than zero
+ *
+ * Sets the number of items on each line of @view.
+ *
+ * Since: 1.12
+ */
+void
+clutter_list_view_set_columns (ClutterListView *view,
+                               guint            n_columns)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+  g_return_if_fail (n_columns > 0);
+
+  priv = view->priv;
+
+  if (priv->n_columns == n_columns)
+    return;
+
+  priv->n_columns = n_columns;
+
+  /* the height of the items depends on their width */
+  clutter_list_view_reset_estimate (view);
+  clutter_list_view_invalidate (view);
+
+  g_object_notify_by_pspec (G_OBJECT (view), obj_props[PROP_COLUMNS]);
+}
+
+/**
+ * clutter_list_view_get_columns:
+ * @view: a #ClutterListView
+ *
+ * Retrieves the number of items on each line of @view.
+ *
+ * Return value: the number of columns
+ *
+ * Since: 1.12
+ */
+guint
+clutter_list_view_get_columns (ClutterListView *view)
+{
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), 1);
+
+  return view->priv->n_columns;
+}
+
+/**
+ * clutter_list_view_set_item_factory:
+ * @view: a #ClutterListView
+ * @create_func: (allow-none): a function creating the item actors
+ * @bind_func: (allow-none): a function binding an item to a row
+ * @user_data: data to pass to @create_func and @bind_func
+ * @notify: (allow-none): function called when @user_data is not
+ *   needed any more
+ *
+ * Sets the functions used by @view to create the actors displaying
+ * the rows of its model, and to update them when they are bound to
+ * a different row.
+ *
+ * Any item created by a previously set factory is destroyed.
+ *
+ * Since: 1.12
+ */
+void
+clutter_list_view_set_item_factory (ClutterListView           *view,
+                                    ClutterListViewCreateFunc  create_func,
+                                    ClutterListViewBindFunc    bind_func,
+                                    gpointer                   user_data,
+                                    GDestroyNotify             notify)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+
+  priv = view->priv;
+
+  clutter_list_view_destroy_items (view);
+
+  if (priv->factory_notify != NULL)
+    priv->factory_notify (priv->factory_data);
+
+  priv->create_func = create_func;
+  priv->bind_func = bind_func;
+  priv->factory_data = user_data;
+  priv->factory_notify = notify;
+
+  clutter_list_view_reset_estimate (view);
+  clutter_list_view_invalidate (view);
+}
+
+/**
+ * clutter_list_view_get_item_for_row:
+ * @view: a #ClutterListView
+ * @row: a row of the model displayed by @view
+ *
+ * Retrieves the actor currently bound to @row, if the row is
+ * inside the visible region of @view.
+ *
+ * Return value: (transfer none): a #ClutterActor, or %NULL
+ *
+ * Since: 1.12
+ */
+ClutterActor *
+clutter_list_view_get_item_for_row (ClutterListView *view,
+                                    guint            row)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), NULL);
+
+  priv = view->priv;
+
+  if (row < priv->first_row || row >= priv->first_row + priv->items->len)
+    return NULL;
+
+  return g_ptr_array_index (priv->items, row - priv->first_row);
+}
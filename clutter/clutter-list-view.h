@@ -0,0 +1,146 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2012  Intel Corporation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if !defined(__CLUTTER_H_INSIDE__) && !defined(CLUTTER_COMPILATION)
+#error "Only <clutter/clutter.h> can be included directly."
+#endif
+
+#ifndef __CLUTTER_LIST_VIEW_H__
+#define __CLUTTER_LIST_VIEW_H__
+
+#include <clutter/clutter-types.h>
+#include <clutter/clutter-model.h>
+#include <clutter/clutter-scroll-actor.h>
+
+G_BEGIN_DECLS
+
+#define CLUTTER_TYPE_LIST_VIEW                  (clutter_list_view_get_type ())
+#define CLUTTER_LIST_VIEW(obj)                  (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_LIST_VIEW, ClutterListView))
+#define CLUTTER_IS_LIST_VIEW(obj)               (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_LIST_VIEW))
+#define CLUTTER_LIST_VIEW_CLASS(klass)          (G_TYPE_CHECK_CLASS_CAST ((klass), CLUTTER_TYPE_LIST_VIEW, ClutterListViewClass))
+#define CLUTTER_IS_LIST_VIEW_CLASS(klass)       (G_TYPE_CHECK_CLASS_TYPE ((klass), CLUTTER_TYPE_LIST_VIEW))
+#define CLUTTER_LIST_VIEW_GET_CLASS(obj)        (G_TYPE_INSTANCE_GET_CLASS ((obj), CLUTTER_TYPE_LIST_VIEW, ClutterListViewClass))
+
+typedef struct _ClutterListView                 ClutterListView;
+typedef struct _ClutterListViewPrivate          ClutterListViewPrivate;
+typedef struct _ClutterListViewClass            ClutterListViewClass;
+
+/**
+ * ClutterListViewCreateFunc:
+ * @view: the #ClutterListView that needs a new item
+ * @user_data: data passed to clutter_list_view_set_item_factory()
+ *
+ * Creates a new actor that will be used by @view to display the
+ * rows of its #ClutterModel.
+ *
+ * The returned actor will be added to @view, and it will be bound
+ * to a row using the #ClutterListViewBindFunc passed alongside this
+ * function to clutter_list_view_set_item_factory(); the same actor
+ * can be bound to different rows over its lifetime.
+ *
+ * Return value: (transfer full): a newly created #ClutterActor
+ *
+ * Since: 1.12
+ */
+typedef ClutterActor *(* ClutterListViewCreateFunc) (ClutterListView *view,
+                                                     gpointer         user_data);
+
+/**
+ * ClutterListViewBindFunc:
+ * @view: the #ClutterListView that owns the item
+ * @item: a #ClutterActor created by the #ClutterListViewCreateFunc
+ * @iter: a #ClutterModelIter pointing to the row to display
+ * @user_data: data passed to clutter_list_view_set_item_factory()
+ *
+ * Updates @item so that it displays the contents of the row
+ * pointed by @iter.
+ *
+ * The @iter is owned by @view and it is only valid for the
+ * duration of the call.
+ *
+ * Since: 1.12
+ */
+typedef void (* ClutterListViewBindFunc) (ClutterListView  *view,
+                                          ClutterActor     *item,
+                                          ClutterModelIter *iter,
+                                          gpointer          user_data);
+
+/**
+ * ClutterListView:
+ *
+ * The <structname>ClutterListView</structname> structure contains only
+ * private data, and should be accessed using the provided API.
+ *
+ * Since: 1.12
+ */
+struct _ClutterListView
+{
+  /*< private >*/
+  ClutterScrollActor parent_instance;
+
+  ClutterListViewPrivate *priv;
+};
+
+/**
+ * ClutterListViewClass:
+ *
+ * The <structname>ClutterListViewClass</structname> structure contains
+ * only private data.
+ *
+ * Since: 1.12
+ */
+struct _ClutterListViewClass
+{
+  /*< private >*/
+  ClutterScrollActorClass parent_class;
+
+  gpointer _padding[8];
+};
+
+CLUTTER_AVAILABLE_IN_1_12
+GType clutter_list_view_get_type (void) G_GNUC_CONST;
+
+CLUTTER_AVAILABLE_IN_1_12
+ClutterActor *          clutter_list_view_new                   (void);
+
+CLUTTER_AVAILABLE_IN_1_12
+void                    clutter_list_view_set_model             (ClutterListView           *view,
+                                                                 ClutterModel              *model);
+CLUTTER_AVAILABLE_IN_1_12
+ClutterModel *          clutter_list_view_get_model             (ClutterListView           *view);
+CLUTTER_AVAILABLE_IN_1_12
+void                    clutter_list_view_set_columns           (ClutterListView           *view,
+                                                                 guint                      n_columns);
+CLUTTER_AVAILABLE_IN_1_12
+guint                   clutter_list_view_get_columns           (ClutterListView           *view);
+CLUTTER_AVAILABLE_IN_1_12
+void                    clutter_list_view_set_item_factory      (ClutterListView           *view,
+                                                                 ClutterListViewCreateFunc  create_func,
+                                                                 ClutterListViewBindFunc    bind_func,
+                                                                 gpointer                   user_data,
+                                                                 GDestroyNotify             notify);
+CLUTTER_AVAILABLE_IN_1_12
+ClutterActor *          clutter_list_view_get_item_for_row      (ClutterListView           *view,
+                                                                 guint                      row);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_LIST_VIEW_H__ */
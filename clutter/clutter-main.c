@@ -158,6 +158,12 @@ static gboolean clutter_sync_to_vblank       = TRUE;
 
 static guint clutter_default_fps             = 60;
 
+/* the number of size requests cached by each actor, for each direction;
+ * layout managers like ClutterFlowLayout and ClutterTableLayout query
+ * their children for more than a couple of sizes per allocation
+ */
+static guint clutter_size_request_cache      = 4;
+
 static ClutterTextDirection clutter_text_direction = CLUTTER_TEXT_DIRECTION_LTR;
 
 static guint clutter_main_loop_level         = 0;
@@ -322,6 +328,16 @@ clutter_config_read_from_key_file (GKeyFile *keyfile)
   else
     clutter_default_fps = int_value;
 
+  int_value =
+    g_key_file_get_integer (keyfile, ENVIRONMENT_GROUP,
+                            "SizeRequestCache",
+                            &key_error);
+
+  if (key_error != NULL)
+    g_clear_error (&key_error);
+  else
+    clutter_size_request_cache = CLAMP (int_value, 1, 64);
+
   str_value =
     g_key_file_get_string (keyfile, ENVIRONMENT_GROUP,
                            "TextDirection",
@@ -480,6 +496,12 @@ _clutter_context_get_show_fps (void)
   return context->show_fps;
 }
 
+guint
+_clutter_context_get_size_request_cache_size (void)
+{
+  return clutter_size_request_cache;
+}
+
 /**
  * clutter_get_accessibility_enabled:
  *
@@ -1696,6 +1718,10 @@ pre_parse_hook (GOptionContext  *context,
     }
 #endif /* CLUTTER_ENABLE_PROFILE */
 
+  env_string = g_getenv ("CLUTTER_TRACE");
+  if (env_string != NULL && *env_string != '\0')
+    _clutter_trace_init (env_string);
+
   env_string = g_getenv ("CLUTTER_PICK");
   if (env_string != NULL)
     {
@@ -1728,6 +1754,14 @@ pre_parse_hook (GOptionContext  *context,
       clutter_default_fps = CLAMP (default_fps, 1, 1000);
     }
 
+  env_string = g_getenv ("CLUTTER_SIZE_REQUEST_CACHE");
+  if (env_string)
+    {
+      gint cache_size = g_ascii_strtoll (env_string, NULL, 10);
+
+      clutter_size_request_cache = CLAMP (cache_size, 1, 64);
+    }
+
   env_string = g_getenv ("CLUTTER_DISABLE_MIPMAPPED_TEXT");
   if (env_string)
     clutter_disable_mipmap_text = TRUE;
@@ -3685,6 +3719,14 @@ _clutter_context_get_pick_mode (void)
   return context->pick_mode;
 }
 
+gboolean
+_clutter_context_get_geometric_pick (void)
+{
+  ClutterMainContext *context = _clutter_context_get_default ();
+
+  return context->geometric_pick;
+}
+
 void
 _clutter_context_push_shader_stack (ClutterActor *actor)
 {
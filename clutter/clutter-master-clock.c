@@ -37,15 +37,23 @@
 
 #include "clutter-master-clock.h"
 #include "clutter-debug.h"
+#include "clutter-easing.h"
 #include "clutter-private.h"
 #include "clutter-profile.h"
 #include "clutter-stage-manager-private.h"
 #include "clutter-stage-private.h"
+#include "clutter-transition-batch.h"
 
 #define CLUTTER_MASTER_CLOCK_CLASS(klass)       (G_TYPE_CHECK_CLASS_CAST ((klass), CLUTTER_TYPE_MASTER_CLOCK, ClutterMasterClockClass))
 #define CLUTTER_IS_MASTER_CLOCK_CLASS(klass)    (G_TYPE_CHECK_CLASS_TYPE ((klass), CLUTTER_TYPE_MASTER_CLOCK))
 #define CLUTTER_MASTER_CLASS_GET_CLASS(obj)     (G_TYPE_INSTANCE_GET_CLASS ((obj), CLUTTER_TYPE_MASTER_CLOCK, ClutterMasterClockClass))
 
+/* the time left between the end of a frame and the vblank it should
+ * be presented at, in usecs, to absorb small variations in the time
+ * needed to produce the frame
+ */
+#define FRAME_DEADLINE_MARGIN   2000
+
 #ifdef CLUTTER_ENABLE_DEBUG
 #define clutter_warn_if_over_budget(master_clock,start_time,section)    G_STMT_START  { \
   gint64 __delta = g_get_monotonic_time () - start_time;                                \
@@ -61,6 +69,7 @@
 
 typedef struct _ClutterClockSource              ClutterClockSource;
 typedef struct _ClutterMasterClockClass         ClutterMasterClockClass;
+typedef struct _TimelineProgress                TimelineProgress;
 
 struct _ClutterMasterClock
 {
@@ -69,12 +78,29 @@ struct _ClutterMasterClock
   /* the list of timelines handled by the clock */
   GSList *timelines;
 
+  /* the implicit transitions that do not need a timeline */
+  ClutterTransitionBatch *transition_batch;
+
+  /* scratch arrays used to compute the progress of the timelines */
+  GArray *progress_items;
+  GArray *progress_modes;
+  GArray *progress_values;
+
   /* the current state of the clock, in usecs */
   gint64 cur_tick;
 
   /* the previous state of the clock, in usecs, used to compute the delta */
   gint64 prev_tick;
 
+  /* the time spent advancing the timelines in the current frame */
+  gint64 timelines_duration;
+
+  /* the monotonic time of the last presented frame, in usecs, or 0 */
+  gint64 presentation_time;
+
+  /* an estimate of the time needed to produce a frame, in usecs */
+  gint64 frame_duration;
+
 #ifdef CLUTTER_ENABLE_DEBUG
   gint64 frame_budget;
   gint64 remaining_budget;
@@ -99,6 +125,14 @@ struct _ClutterMasterClockClass
   GObjectClass parent_class;
 };
 
+struct _TimelineProgress
+{
+  ClutterTimeline *timeline;
+  gint64 elapsed;
+  guint duration;
+  ClutterAnimationMode mode;
+};
+
 struct _ClutterClockSource
 {
   GSource source;
@@ -124,6 +158,26 @@ static GSourceFuncs clock_funcs = {
 
 G_DEFINE_TYPE (ClutterMasterClock, clutter_master_clock, G_TYPE_OBJECT);
 
+/*
+ * master_clock_stage_can_draw:
+ * @stage: a #ClutterStage
+ *
+ * Checks whether @stage can produce a new frame, or if its swap chain
+ * is full and it needs to wait for a swap-buffers to complete.
+ *
+ * Return value: %TRUE if the stage can be drawn
+ */
+static inline gboolean
+master_clock_stage_can_draw (ClutterStage *stage)
+{
+  int pending_swaps = _clutter_stage_get_pending_swaps (stage);
+
+  if (pending_swaps == 0)
+    return TRUE;
+
+  return pending_swaps < _clutter_stage_get_max_pending_swaps (stage);
+}
+
 /*
  * master_clock_is_running:
  * @master_clock: a #ClutterMasterClock
@@ -147,7 +201,7 @@ master_clock_is_running (ClutterMasterClock *master_clock)
    * then we stop the master clock... */
   for (l = stages; l != NULL; l = l->next)
     {
-      if (_clutter_stage_get_pending_swaps (l->data) == 0)
+      if (master_clock_stage_can_draw (l->data))
         {
           stage_free = TRUE;
           break;
@@ -160,6 +214,9 @@ master_clock_is_running (ClutterMasterClock *master_clock)
   if (master_clock->timelines)
     return TRUE;
 
+  if (_clutter_transition_batch_is_running (master_clock->transition_batch))
+    return TRUE;
+
   for (l = stages; l; l = l->next)
     {
       if (_clutter_stage_has_queued_events (l->data) ||
@@ -176,6 +233,43 @@ master_clock_is_running (ClutterMasterClock *master_clock)
   return FALSE;
 }
 
+/*
+ * master_clock_get_frame_deadline:
+ * @master_clock: a #ClutterMasterClock
+ * @now: the current time, in usecs
+ *
+ * Computes the latest time at which the next frame can be started
+ * while still being presented at the next refresh of the display.
+ *
+ * Return value: the deadline of the next frame, in usecs, or 0 if
+ *   the next frame should be started immediately
+ */
+static gint64
+master_clock_get_frame_deadline (ClutterMasterClock *master_clock,
+                                 gint64              now)
+{
+  gint64 refresh_interval, deadline;
+
+  if (master_clock->presentation_time == 0 ||
+      master_clock->presentation_time > now)
+    return 0;
+
+  refresh_interval = G_USEC_PER_SEC / clutter_get_default_frame_rate ();
+
+  /* if we did not present a frame during the last refresh cycles then
+   * there is no frame to keep up with
+   */
+  if (now - master_clock->presentation_time > 2 * refresh_interval)
+    return 0;
+
+  deadline = master_clock->presentation_time
+           + refresh_interval
+           - master_clock->frame_duration
+           - FRAME_DEADLINE_MARGIN;
+
+  return deadline > now ? deadline : 0;
+}
+
 /*
  * master_clock_next_frame_delay:
  * @master_clock: a #ClutterMasterClock
@@ -188,7 +282,7 @@ master_clock_is_running (ClutterMasterClock *master_clock)
 static gint
 master_clock_next_frame_delay (ClutterMasterClock *master_clock)
 {
-  gint64 now, next;
+  gint64 now, next, deadline;
 
   if (!master_clock_is_running (master_clock))
     return -1;
@@ -204,10 +298,26 @@ master_clock_next_frame_delay (ClutterMasterClock *master_clock)
    *
    * (NB: if there aren't even any timelines running then the master clock will
    * be completely stopped in master_clock_is_running())
+   *
+   * If the backend tells us when the frames are presented then we delay
+   * the next frame as much as we can while still hitting the next vblank,
+   * so that the events are processed as late as possible.
    */
   if (clutter_feature_available (CLUTTER_FEATURE_SYNC_TO_VBLANK) &&
       !master_clock->idle)
     {
+      now = g_source_get_time (master_clock->source);
+      deadline = master_clock_get_frame_deadline (master_clock, now);
+
+      if (deadline != 0)
+        {
+          CLUTTER_NOTE (SCHEDULER, "Waiting %" G_GINT64_FORMAT " usecs "
+                        "for the frame deadline",
+                        deadline - now);
+
+          return (deadline - now) / 1000;
+        }
+
       CLUTTER_NOTE (SCHEDULER, "vblank available and updated stages");
       return 0;
     }
@@ -279,7 +389,7 @@ master_clock_process_events (ClutterMasterClock *master_clock,
        * we don't process its events so we can maximize the benefits of
        * motion compression, and avoid multiple picks per frame.
        */
-      if (_clutter_stage_get_pending_swaps (l->data) == 0)
+      if (master_clock_stage_can_draw (l->data))
         _clutter_stage_process_queued_events (l->data);
     }
 
@@ -293,6 +403,93 @@ master_clock_process_events (ClutterMasterClock *master_clock,
 #endif
 }
 
+static gint
+timeline_progress_compare (gconstpointer a,
+                           gconstpointer b)
+{
+  const TimelineProgress *progress_a = a;
+  const TimelineProgress *progress_b = b;
+
+  return (gint) progress_a->mode - (gint) progress_b->mode;
+}
+
+/*
+ * master_clock_compute_progress:
+ * @master_clock: a #ClutterMasterClock
+ * @timelines: the timelines to advance
+ *
+ * Computes the progress of the next frame of all the @timelines using
+ * a non-linear progress mode, grouping them by mode so that each group
+ * is evaluated in a single batch; the timelines will use the result if
+ * their state does not change before they emit the new frame.
+ */
+static void
+master_clock_compute_progress (ClutterMasterClock *master_clock,
+                               GSList             *timelines)
+{
+  gint64 tick_time = master_clock->cur_tick / 1000;
+  ClutterAnimationMode *modes;
+  double *elapsed, *duration, *progress;
+  GArray *items;
+  GSList *l;
+  guint i;
+
+  items = master_clock->progress_items;
+  g_array_set_size (items, 0);
+
+  for (l = timelines; l != NULL; l = l->next)
+    {
+      TimelineProgress item;
+
+      item.timeline = l->data;
+
+      if (_clutter_timeline_get_next_frame (item.timeline, tick_time,
+                                            &item.elapsed,
+                                            &item.duration,
+                                            &item.mode))
+        g_array_append_val (items, item);
+    }
+
+  if (items->len == 0)
+    return;
+
+  g_array_sort (items, timeline_progress_compare);
+
+  g_array_set_size (master_clock->progress_modes, items->len);
+  g_array_set_size (master_clock->progress_values, items->len * 3);
+
+  modes = (ClutterAnimationMode *) master_clock->progress_modes->data;
+  elapsed = (double *) master_clock->progress_values->data;
+  duration = elapsed + items->len;
+  progress = duration + items->len;
+
+  for (i = 0; i < items->len; i++)
+    {
+      const TimelineProgress *item;
+
+      item = &g_array_index (items, TimelineProgress, i);
+
+      modes[i] = item->mode;
+      elapsed[i] = item->elapsed;
+      duration[i] = item->duration;
+    }
+
+  clutter_easing_for_modes (modes, elapsed, duration, progress, items->len);
+
+  for (i = 0; i < items->len; i++)
+    {
+      const TimelineProgress *item;
+
+      item = &g_array_index (items, TimelineProgress, i);
+
+      _clutter_timeline_set_cached_progress (item->timeline,
+                                             item->elapsed,
+                                             item->duration,
+                                             item->mode,
+                                             progress[i]);
+    }
+}
+
 /*
  * master_clock_advance_timelines:
  * @master_clock: a #ClutterMasterClock
@@ -305,9 +502,7 @@ static void
 master_clock_advance_timelines (ClutterMasterClock *master_clock)
 {
   GSList *timelines, *l;
-#ifdef CLUTTER_ENABLE_DEBUG
   gint64 start = g_get_monotonic_time ();
-#endif
 
   CLUTTER_STATIC_TIMER (master_timeline_advance,
                         "Master Clock",
@@ -340,22 +535,49 @@ master_clock_advance_timelines (ClutterMasterClock *master_clock)
 
   CLUTTER_TIMER_START (_clutter_uprof_context, master_timeline_advance);
 
+  master_clock_compute_progress (master_clock, timelines);
+
   for (l = timelines; l != NULL; l = l->next)
     _clutter_timeline_do_tick (l->data, master_clock->cur_tick / 1000);
 
+  _clutter_transition_batch_advance (master_clock->transition_batch,
+                                     master_clock->cur_tick / 1000);
+
   CLUTTER_TIMER_STOP (_clutter_uprof_context, master_timeline_advance);
 
   g_slist_foreach (timelines, (GFunc) g_object_unref, NULL);
   g_slist_free (timelines);
 
+  master_clock->timelines_duration = g_get_monotonic_time () - start;
+
 #ifdef CLUTTER_ENABLE_DEBUG
   if (_clutter_diagnostic_enabled ())
     clutter_warn_if_over_budget (master_clock, start, "Animations");
 
-  master_clock->remaining_budget -= (g_get_monotonic_time () - start);
+  master_clock->remaining_budget -= master_clock->timelines_duration;
 #endif
 }
 
+/*
+ * master_clock_update_frame_duration:
+ * @master_clock: a #ClutterMasterClock
+ * @duration: the time spent producing the last frame, in usecs
+ *
+ * Updates the estimate of the time needed to produce a frame; the
+ * estimate grows immediately, so that a slow frame does not make us
+ * miss the following deadlines as well, and shrinks slowly.
+ */
+static void
+master_clock_update_frame_duration (ClutterMasterClock *master_clock,
+                                    gint64              duration)
+{
+  if (duration > master_clock->frame_duration)
+    master_clock->frame_duration = duration;
+  else
+    master_clock->frame_duration =
+      (master_clock->frame_duration * 7 + duration) / 8;
+}
+
 static gboolean
 master_clock_update_stages (ClutterMasterClock *master_clock,
                             GSList             *stages)
@@ -373,17 +595,22 @@ master_clock_update_stages (ClutterMasterClock *master_clock,
    */
   for (l = stages; l != NULL; l = l->next)
     {
-      /* If a stage has a swap-buffers pending we don't want to draw to it
+      /* If the swap chain of a stage is full we don't want to draw to it
        * in case the driver may block the CPU while it waits for the next
        * backbuffer to become available.
        *
-       * TODO: We should be able to identify if we are running triple or N
-       * buffered and in these cases we can still draw if there is 1 swap
-       * pending so we can hopefully always be ready to swap for the next
-       * vblank and really match the vsync frequency.
+       * If we are running triple or N buffered we can still draw while
+       * N - 2 swaps are pending, so we can hopefully always be ready to
+       * swap for the next vblank and really match the vsync frequency.
        */
-      if (_clutter_stage_get_pending_swaps (l->data) == 0)
-        stages_updated |= _clutter_stage_do_update (l->data);
+      if (master_clock_stage_can_draw (l->data))
+        {
+          _clutter_stage_begin_frame (l->data,
+                                      master_clock->cur_tick,
+                                      master_clock->timelines_duration);
+
+          stages_updated |= _clutter_stage_do_update (l->data);
+        }
     }
 
   _clutter_run_repaint_functions (CLUTTER_REPAINT_FLAGS_POST_PAINT);
@@ -476,6 +703,7 @@ clutter_clock_dispatch (GSource     *source,
   ClutterStageManager *stage_manager = clutter_stage_manager_get_default ();
   gboolean stages_updated = FALSE;
   GSList *stages;
+  gint64 start;
 
   CLUTTER_STATIC_TIMER (master_dispatch_timer,
                         "Mainloop",
@@ -489,6 +717,8 @@ clutter_clock_dispatch (GSource     *source,
 
   clutter_threads_enter ();
 
+  start = g_get_monotonic_time ();
+
   /* Get the time to use for this frame */
   master_clock->cur_tick = g_source_get_time (source);
 
@@ -522,6 +752,9 @@ clutter_clock_dispatch (GSource     *source,
    * to polling for timeline progressions... */
   if (!stages_updated)
     master_clock->idle = TRUE;
+  else
+    master_clock_update_frame_duration (master_clock,
+                                        g_get_monotonic_time () - start);
 
   g_slist_foreach (stages, (GFunc) g_object_unref, NULL);
   g_slist_free (stages);
@@ -542,6 +775,12 @@ clutter_master_clock_finalize (GObject *gobject)
 
   g_slist_free (master_clock->timelines);
 
+  _clutter_transition_batch_free (master_clock->transition_batch);
+
+  g_array_free (master_clock->progress_items, TRUE);
+  g_array_free (master_clock->progress_modes, TRUE);
+  g_array_free (master_clock->progress_values, TRUE);
+
   G_OBJECT_CLASS (clutter_master_clock_parent_class)->finalize (gobject);
 }
 
@@ -561,6 +800,12 @@ clutter_master_clock_init (ClutterMasterClock *self)
   source = clutter_clock_source_new (self);
   self->source = source;
 
+  self->transition_batch = _clutter_transition_batch_new ();
+
+  self->progress_items = g_array_new (FALSE, FALSE, sizeof (TimelineProgress));
+  self->progress_modes = g_array_new (FALSE, FALSE, sizeof (ClutterAnimationMode));
+  self->progress_values = g_array_new (FALSE, FALSE, sizeof (double));
+
   self->idle = FALSE;
   self->ensure_next_iteration = FALSE;
 
@@ -635,6 +880,24 @@ _clutter_master_clock_remove_timeline (ClutterMasterClock *master_clock,
                                             timeline);
 }
 
+/*
+ * _clutter_master_clock_get_transition_batch:
+ * @master_clock: a #ClutterMasterClock
+ *
+ * Retrieves the batch of implicit transitions advanced by the
+ * master clock.
+ *
+ * Once a transition has been added to the batch, the clock should
+ * be woken up using _clutter_master_clock_start_running().
+ *
+ * Return value: the #ClutterTransitionBatch owned by the clock
+ */
+ClutterTransitionBatch *
+_clutter_master_clock_get_transition_batch (ClutterMasterClock *master_clock)
+{
+  return master_clock->transition_batch;
+}
+
 /*
  * _clutter_master_clock_start_running:
  * @master_clock: a #ClutterMasterClock
@@ -651,6 +914,23 @@ _clutter_master_clock_start_running (ClutterMasterClock *master_clock)
   g_main_context_wakeup (NULL);
 }
 
+/*
+ * _clutter_master_clock_presented:
+ * @master_clock: a #ClutterMasterClock
+ * @presentation_time: the monotonic time at which a frame was
+ *   presented, in usecs
+ *
+ * Notifies @master_clock that a stage frame has been presented, so
+ * that the next frame can be scheduled relative to the refresh of
+ * the display.
+ */
+void
+_clutter_master_clock_presented (ClutterMasterClock *master_clock,
+                                 gint64              presentation_time)
+{
+  master_clock->presentation_time = presentation_time;
+}
+
 /**
  * _clutter_master_clock_ensure_next_iteration:
  * @master_clock: a #ClutterMasterClock
@@ -25,6 +25,7 @@
 #define __CLUTTER_MASTER_CLOCK_H__
 
 #include <clutter/clutter-timeline.h>
+#include <clutter/clutter-transition-batch.h>
 
 G_BEGIN_DECLS
 
@@ -42,13 +43,26 @@ void                    _clutter_master_clock_add_timeline              (Clutter
 void                    _clutter_master_clock_remove_timeline           (ClutterMasterClock *master_clock,
                                                                          ClutterTimeline    *timeline);
 void                    _clutter_master_clock_start_running             (ClutterMasterClock *master_clock);
+ClutterTransitionBatch *_clutter_master_clock_get_transition_batch      (ClutterMasterClock *master_clock);
 void                    _clutter_master_clock_ensure_next_iteration     (ClutterMasterClock *master_clock);
+void                    _clutter_master_clock_presented                 (ClutterMasterClock *master_clock,
+                                                                         gint64              presentation_time);
 
 void                    _clutter_timeline_advance                       (ClutterTimeline    *timeline,
                                                                          gint64              tick_time);
 gint64                  _clutter_timeline_get_delta                     (ClutterTimeline    *timeline);
 void                    _clutter_timeline_do_tick                       (ClutterTimeline    *timeline,
                                                                          gint64              tick_time);
+gboolean                _clutter_timeline_get_next_frame                (ClutterTimeline      *timeline,
+                                                                         gint64                tick_time,
+                                                                         gint64               *elapsed,
+                                                                         guint                *duration,
+                                                                         ClutterAnimationMode *mode);
+void                    _clutter_timeline_set_cached_progress           (ClutterTimeline      *timeline,
+                                                                         gint64                elapsed,
+                                                                         guint                 duration,
+                                                                         ClutterAnimationMode  mode,
+                                                                         gdouble               progress);
 
 G_END_DECLS
 
@@ -31,6 +31,18 @@
 
 G_BEGIN_DECLS
 
+/* easy way to have properly named fields instead of the dummy ones
+ * we use in the public structure
+ */
+typedef struct _RealModelCursor
+{
+  ClutterModel *model;          /* dummy1 */
+  gint row;                     /* dummy2 */
+  gpointer position;            /* dummy3 */
+  gpointer data;                /* dummy4 */
+  gpointer padding;             /* dummy5 */
+} RealModelCursor;
+
 void            _clutter_model_set_n_columns    (ClutterModel *model,
                                                  gint          n_columns,
                                                  gboolean      set_types,
@@ -44,6 +56,10 @@ void            _clutter_model_set_column_name  (ClutterModel *model,
                                                  gint          column,
                                                  const gchar  *name);
 
+void            _clutter_model_emit_rows_added  (ClutterModel *model,
+                                                 guint         first_row,
+                                                 guint         n_rows);
+
 void            _clutter_model_iter_set_row     (ClutterModelIter *iter,
                                                  guint             row);
 
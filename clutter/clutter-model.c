@@ -192,6 +192,8 @@ enum
 
   SORT_CHANGED,
   FILTER_CHANGED,
+
+  ROWS_ADDED,
   
   LAST_SIGNAL
 };
@@ -290,6 +292,183 @@ clutter_model_real_get_n_rows (ClutterModel *model)
   return row_count;
 }
 
+/* the cells of the current row of a cursor on a model that does not
+ * implement cursors; see clutter_model_real_cursor_peek()
+ */
+typedef union _CursorCell
+{
+  gboolean v_boolean;
+  gint v_int;
+  guint v_uint;
+  glong v_long;
+  gulong v_ulong;
+  gint64 v_int64;
+  guint64 v_uint64;
+  gfloat v_float;
+  gdouble v_double;
+  gpointer v_pointer;
+} CursorCell;
+
+typedef struct _CursorRow
+{
+  guint n_columns;
+  GValue *values;
+  CursorCell *cells;
+} CursorRow;
+
+static gboolean
+clutter_model_real_cursor_next (ClutterModel       *model,
+                                ClutterModelCursor *cursor)
+{
+  RealModelCursor *rc = (RealModelCursor *) cursor;
+  ClutterModelIter *iter = rc->position;
+
+  if (iter == NULL)
+    {
+      iter = clutter_model_get_first_iter (model);
+      if (iter == NULL)
+        return FALSE;
+
+      rc->position = iter;
+    }
+  else
+    {
+      if (clutter_model_iter_is_last (iter))
+        return FALSE;
+
+      iter = clutter_model_iter_next (iter);
+    }
+
+  if (clutter_model_iter_is_last (iter))
+    return FALSE;
+
+  rc->row = clutter_model_iter_get_row (iter);
+
+  return TRUE;
+}
+
+/* the generic implementation still has to copy the contents of the
+ * cell out of the iterator, but it reuses the same storage for every
+ * row instead of allocating a GValue each time
+ */
+static gconstpointer
+clutter_model_real_cursor_peek (ClutterModel       *model,
+                                ClutterModelCursor *cursor,
+                                guint               column)
+{
+  RealModelCursor *rc = (RealModelCursor *) cursor;
+  ClutterModelIter *iter = rc->position;
+  CursorRow *row = rc->data;
+  CursorCell *cell;
+  GValue *value;
+
+  if (row == NULL)
+    {
+      row = g_slice_new (CursorRow);
+      row->n_columns = clutter_model_get_n_columns (model);
+      row->values = g_new0 (GValue, row->n_columns);
+      row->cells = g_new0 (CursorCell, row->n_columns);
+
+      rc->data = row;
+    }
+
+  value = &row->values[column];
+  if (G_VALUE_TYPE (value) == G_TYPE_INVALID)
+    g_value_init (value, clutter_model_get_column_type (model, column));
+
+  CLUTTER_MODEL_ITER_GET_CLASS (iter)->get_value (iter, column, value);
+
+  cell = &row->cells[column];
+
+  switch (G_TYPE_FUNDAMENTAL (G_VALUE_TYPE (value)))
+    {
+    case G_TYPE_BOOLEAN:
+      cell->v_boolean = g_value_get_boolean (value);
+      break;
+
+    case G_TYPE_INT:
+      cell->v_int = g_value_get_int (value);
+      break;
+
+    case G_TYPE_ENUM:
+      cell->v_int = g_value_get_enum (value);
+      break;
+
+    case G_TYPE_UINT:
+      cell->v_uint = g_value_get_uint (value);
+      break;
+
+    case G_TYPE_FLAGS:
+      cell->v_uint = g_value_get_flags (value);
+      break;
+
+    case G_TYPE_LONG:
+      cell->v_long = g_value_get_long (value);
+      break;
+
+    case G_TYPE_ULONG:
+      cell->v_ulong = g_value_get_ulong (value);
+      break;
+
+    case G_TYPE_INT64:
+      cell->v_int64 = g_value_get_int64 (value);
+      break;
+
+    case G_TYPE_UINT64:
+      cell->v_uint64 = g_value_get_uint64 (value);
+      break;
+
+    case G_TYPE_FLOAT:
+      cell->v_float = g_value_get_float (value);
+      break;
+
+    case G_TYPE_DOUBLE:
+      cell->v_double = g_value_get_double (value);
+      break;
+
+    case G_TYPE_STRING:
+      cell->v_pointer = (gpointer) g_value_get_string (value);
+      break;
+
+    case G_TYPE_POINTER:
+      cell->v_pointer = g_value_get_pointer (value);
+      break;
+
+    case G_TYPE_OBJECT:
+      cell->v_pointer = g_value_get_object (value);
+      break;
+
+    default:
+      return value;
+    }
+
+  return cell;
+}
+
+static void
+clutter_model_real_cursor_clear (ClutterModel       *model,
+                                 ClutterModelCursor *cursor)
+{
+  RealModelCursor *rc = (RealModelCursor *) cursor;
+  CursorRow *row = rc->data;
+
+  if (rc->position != NULL)
+    g_object_unref (rc->position);
+
+  if (row != NULL)
+    {
+      guint i;
+
+      for (i = 0; i < row->n_columns; i++)
+        if (G_VALUE_TYPE (&row->values[i]) != G_TYPE_INVALID)
+          g_value_unset (&row->values[i]);
+
+      g_free (row->values);
+      g_free (row->cells);
+      g_slice_free (CursorRow, row);
+    }
+}
+
 static void 
 clutter_model_finalize (GObject *object)
 {
@@ -353,6 +532,9 @@ clutter_model_class_init (ClutterModelClass *klass)
   klass->get_column_type  = clutter_model_real_get_column_type;
   klass->get_n_columns    = clutter_model_real_get_n_columns;
   klass->get_n_rows       = clutter_model_real_get_n_rows;
+  klass->cursor_next      = clutter_model_real_cursor_next;
+  klass->cursor_peek      = clutter_model_real_cursor_peek;
+  klass->cursor_clear     = clutter_model_real_cursor_clear;
 
   /**
    * ClutterModel:filter-set:
@@ -463,6 +645,30 @@ clutter_model_class_init (ClutterModelClass *klass)
                   NULL, NULL,
                   _clutter_marshal_VOID__VOID,
                   G_TYPE_NONE, 0);
+  /**
+   * ClutterModel::rows-added:
+   * @model: the #ClutterModel on which the signal is emitted
+   * @first_row: the position of the first new row
+   * @n_rows: the number of new rows
+   *
+   * The ::rows-added signal is emitted when a range of rows has been
+   * added at once, instead of emitting #ClutterModel::row-added for
+   * each row; for instance, by clutter_list_model_append_rows().
+   * The data on the rows has already been set when the ::rows-added
+   * signal has been emitted.
+   *
+   * Since: 1.12
+   */
+  model_signals[ROWS_ADDED] =
+    g_signal_new ("rows-added",
+                  G_TYPE_FROM_CLASS (gobject_class),
+                  G_SIGNAL_RUN_LAST,
+                  G_STRUCT_OFFSET (ClutterModelClass, rows_added),
+                  NULL, NULL,
+                  _clutter_marshal_VOID__UINT_UINT,
+                  G_TYPE_NONE, 2,
+                  G_TYPE_UINT,
+                  G_TYPE_UINT);
 }
 
 static void
@@ -858,6 +1064,172 @@ clutter_model_filter_iter (ClutterModel     *model,
   return priv->filter_func (model, iter, priv->filter_data);
 }
 
+/**
+ * clutter_model_cursor_init:
+ * @cursor: a #ClutterModelCursor
+ * @model: a #ClutterModel
+ *
+ * Initializes a #ClutterModelCursor, which can then be used to iterate
+ * efficiently over the rows of @model that are visible through its
+ * filter, without creating a #ClutterModelIter for each row.
+ *
+ * Modifying @model invalidates the cursor. The cursor does not hold a
+ * reference on @model, and must be released using
+ * clutter_model_cursor_clear() once done.
+ *
+ * |[
+ *   ClutterModelCursor cursor;
+ *
+ *   clutter_model_cursor_init (&cursor, model);
+ *   while (clutter_model_cursor_next (&cursor))
+ *     {
+ *       const gint *score = clutter_model_cursor_peek_column (&cursor, 0);
+ *       const gchar * const *team = clutter_model_cursor_peek_column (&cursor, 1);
+ *
+ *       g_print ("%s: %d\n", *team, *score);
+ *     }
+ *   clutter_model_cursor_clear (&cursor);
+ * ]|
+ *
+ * Since: 1.12
+ */
+void
+clutter_model_cursor_init (ClutterModelCursor *cursor,
+                           ClutterModel       *model)
+{
+  RealModelCursor *rc = (RealModelCursor *) cursor;
+
+  g_return_if_fail (cursor != NULL);
+  g_return_if_fail (CLUTTER_IS_MODEL (model));
+
+  rc->model = model;
+  rc->row = -1;
+  rc->position = NULL;
+  rc->data = NULL;
+}
+
+/**
+ * clutter_model_cursor_next:
+ * @cursor: a #ClutterModelCursor
+ *
+ * Advances @cursor to the next row of the model that is visible
+ * through its filter.
+ *
+ * Return value: %TRUE if the cursor could advance, and %FALSE if
+ *   there are no more rows
+ *
+ * Since: 1.12
+ */
+gboolean
+clutter_model_cursor_next (ClutterModelCursor *cursor)
+{
+  RealModelCursor *rc = (RealModelCursor *) cursor;
+
+  g_return_val_if_fail (cursor != NULL, FALSE);
+  g_return_val_if_fail (rc->model != NULL, FALSE);
+
+  return CLUTTER_MODEL_GET_CLASS (rc->model)->cursor_next (rc->model, cursor);
+}
+
+/**
+ * clutter_model_cursor_get_row:
+ * @cursor: a #ClutterModelCursor
+ *
+ * Retrieves the position of the current row of @cursor, as
+ * clutter_model_iter_get_row() would.
+ *
+ * Return value: the position of the row
+ *
+ * Since: 1.12
+ */
+guint
+clutter_model_cursor_get_row (ClutterModelCursor *cursor)
+{
+  RealModelCursor *rc = (RealModelCursor *) cursor;
+
+  g_return_val_if_fail (cursor != NULL, 0);
+  g_return_val_if_fail (rc->row >= 0, 0);
+
+  return rc->row;
+}
+
+/**
+ * clutter_model_cursor_peek_column:
+ * @cursor: a #ClutterModelCursor
+ * @column: the column to peek
+ *
+ * Retrieves a pointer to the contents of @column in the current row
+ * of @cursor, without copying it.
+ *
+ * The returned pointer points to a value of the C type used by the
+ * column, as documented in clutter_list_model_append_rows(): for
+ * instance, a #gint for a %G_TYPE_INT column, a string pointer for a
+ * %G_TYPE_STRING column, and a #GValue for boxed types.
+ *
+ * Return value: (transfer none): a pointer to the contents of the
+ *   cell, valid until the cursor is advanced or the model changes
+ *
+ * Since: 1.12
+ */
+gconstpointer
+clutter_model_cursor_peek_column (ClutterModelCursor *cursor,
+                                  guint               column)
+{
+  RealModelCursor *rc = (RealModelCursor *) cursor;
+
+  g_return_val_if_fail (cursor != NULL, NULL);
+  g_return_val_if_fail (rc->row >= 0, NULL);
+  g_return_val_if_fail (column < clutter_model_get_n_columns (rc->model), NULL);
+
+  return CLUTTER_MODEL_GET_CLASS (rc->model)->cursor_peek (rc->model,
+                                                           cursor,
+                                                           column);
+}
+
+/**
+ * clutter_model_cursor_clear:
+ * @cursor: a #ClutterModelCursor
+ *
+ * Releases the resources held by @cursor. The cursor can be used
+ * again after calling clutter_model_cursor_init().
+ *
+ * Since: 1.12
+ */
+void
+clutter_model_cursor_clear (ClutterModelCursor *cursor)
+{
+  RealModelCursor *rc = (RealModelCursor *) cursor;
+
+  g_return_if_fail (cursor != NULL);
+
+  if (rc->model == NULL)
+    return;
+
+  CLUTTER_MODEL_GET_CLASS (rc->model)->cursor_clear (rc->model, cursor);
+
+  rc->model = NULL;
+  rc->row = -1;
+  rc->position = NULL;
+  rc->data = NULL;
+}
+
+/*< private >
+ * _clutter_model_emit_rows_added:
+ * @model: a #ClutterModel
+ * @first_row: the position of the first new row
+ * @n_rows: the number of new rows
+ *
+ * Emits the #ClutterModel::rows-added signal; this function should
+ * be used only by subclasses of #ClutterModel.
+ */
+void
+_clutter_model_emit_rows_added (ClutterModel *model,
+                                guint         first_row,
+                                guint         n_rows)
+{
+  g_signal_emit (model, model_signals[ROWS_ADDED], 0, first_row, n_rows);
+}
+
 /*< private >
  * clutter_model_set_n_columns:
  * @model: a #ClutterModel
@@ -30,7 +30,7 @@
 #ifndef __CLUTTER_MODEL_H__
 #define __CLUTTER_MODEL_H__
 
-#include <glib-object.h>
+#include <clutter/clutter-types.h>
 
 G_BEGIN_DECLS
 
@@ -47,6 +47,7 @@ typedef struct _ClutterModelPrivate     ClutterModelPrivate;
 typedef struct _ClutterModelIter        ClutterModelIter;
 typedef struct _ClutterModelIterClass   ClutterModelIterClass;
 typedef struct _ClutterModelIterPrivate ClutterModelIterPrivate;
+typedef struct _ClutterModelCursor      ClutterModelCursor;
 
 
 /**
@@ -117,6 +118,26 @@ struct _ClutterModel
   ClutterModelPrivate *priv;
 };
 
+/**
+ * ClutterModelCursor:
+ *
+ * A lightweight, stack-allocated iterator over the rows of a
+ * #ClutterModel that are visible through its filter. The
+ * #ClutterModelCursor structure contains only private data and
+ * should be initialized with clutter_model_cursor_init().
+ *
+ * Since: 1.12
+ */
+struct _ClutterModelCursor
+{
+  /*< private >*/
+  gpointer CLUTTER_PRIVATE_FIELD (dummy1);
+  gint     CLUTTER_PRIVATE_FIELD (dummy2);
+  gpointer CLUTTER_PRIVATE_FIELD (dummy3);
+  gpointer CLUTTER_PRIVATE_FIELD (dummy4);
+  gpointer CLUTTER_PRIVATE_FIELD (dummy5);
+};
+
 /**
  * ClutterModelClass:
  * @row_added: signal class handler for ClutterModel::row-added
@@ -124,6 +145,13 @@ struct _ClutterModel
  * @row_changed: signal class handler for ClutterModel::row-changed
  * @sort_changed: signal class handler for ClutterModel::sort-changed
  * @filter_changed: signal class handler for ClutterModel::filter-changed
+ * @rows_added: signal class handler for ClutterModel::rows-added
+ * @cursor_next: virtual function for advancing a #ClutterModelCursor
+ *   to the next visible row
+ * @cursor_peek: virtual function for returning a pointer to the
+ *   contents of a cell in the row of a #ClutterModelCursor
+ * @cursor_clear: virtual function for releasing the resources
+ *   held by a #ClutterModelCursor
  * @get_column_name: virtual function for returning the name of a column
  * @get_column_type: virtual function for returning the type of a column
  * @get_iter_at_row: virtual function for returning an iterator for the
@@ -175,13 +203,21 @@ struct _ClutterModelClass
                                          ClutterModelIter *iter);
   void              (* sort_changed)    (ClutterModel     *model);
   void              (* filter_changed)  (ClutterModel     *model);
+  void              (* rows_added)      (ClutterModel     *model,
+                                         guint             first_row,
+                                         guint             n_rows);
+
+  /* cursors */
+  gboolean          (* cursor_next)     (ClutterModel       *model,
+                                         ClutterModelCursor *cursor);
+  gconstpointer     (* cursor_peek)     (ClutterModel       *model,
+                                         ClutterModelCursor *cursor,
+                                         guint               column);
+  void              (* cursor_clear)    (ClutterModel       *model,
+                                         ClutterModelCursor *cursor);
 
   /*< private >*/
   /* padding for future expansion */
-  void (*_clutter_model_1) (void);
-  void (*_clutter_model_2) (void);
-  void (*_clutter_model_3) (void);
-  void (*_clutter_model_4) (void);
   void (*_clutter_model_5) (void);
   void (*_clutter_model_6) (void);
   void (*_clutter_model_7) (void);
@@ -260,6 +296,19 @@ gboolean              clutter_model_filter_row         (ClutterModel     *model,
 gboolean              clutter_model_filter_iter        (ClutterModel     *model,
                                                         ClutterModelIter *iter);
 
+CLUTTER_AVAILABLE_IN_1_12
+void                  clutter_model_cursor_init        (ClutterModelCursor *cursor,
+                                                        ClutterModel       *model);
+CLUTTER_AVAILABLE_IN_1_12
+gboolean              clutter_model_cursor_next        (ClutterModelCursor *cursor);
+CLUTTER_AVAILABLE_IN_1_12
+guint                 clutter_model_cursor_get_row     (ClutterModelCursor *cursor);
+CLUTTER_AVAILABLE_IN_1_12
+gconstpointer         clutter_model_cursor_peek_column (ClutterModelCursor *cursor,
+                                                        guint               column);
+CLUTTER_AVAILABLE_IN_1_12
+void                  clutter_model_cursor_clear       (ClutterModelCursor *cursor);
+
 /*
  * ClutterModelIter 
  */
@@ -42,6 +42,7 @@
 
 #include "clutter-path-constraint.h"
 
+#include "clutter-actor-private.h"
 #include "clutter-debug.h"
 #include "clutter-marshal.h"
 #include "clutter-private.h"
@@ -326,7 +327,7 @@ clutter_path_constraint_set_path (ClutterPathConstraint *constraint,
     constraint->path = g_object_ref_sink (path);
 
   if (constraint->actor != NULL)
-    clutter_actor_queue_relayout (constraint->actor);
+    _clutter_actor_queue_only_reallocation (constraint->actor);
 
   g_object_notify_by_pspec (G_OBJECT (constraint), path_properties[PROP_PATH]);
 }
@@ -372,7 +373,7 @@ clutter_path_constraint_set_offset (ClutterPathConstraint *constraint,
   constraint->offset = offset;
 
   if (constraint->actor != NULL)
-    clutter_actor_queue_relayout (constraint->actor);
+    _clutter_actor_queue_only_reallocation (constraint->actor);
 
   g_object_notify_by_pspec (G_OBJECT (constraint), path_properties[PROP_OFFSET]);
 }
@@ -180,6 +180,7 @@ struct _ClutterMainContext
   guint defer_display_setup     : 1;
   guint options_parsed          : 1;
   guint show_fps                : 1;
+  guint geometric_pick          : 1;
 };
 
 /* shared between clutter-main.c and clutter-frame-source.c */
@@ -200,6 +201,7 @@ gboolean                _clutter_context_is_initialized                 (void);
 PangoContext *          _clutter_context_create_pango_context           (void);
 PangoContext *          _clutter_context_get_pango_context              (void);
 ClutterPickMode         _clutter_context_get_pick_mode                  (void);
+gboolean                _clutter_context_get_geometric_pick             (void);
 void                    _clutter_context_push_shader_stack              (ClutterActor *actor);
 ClutterActor *          _clutter_context_pop_shader_stack               (ClutterActor *actor);
 ClutterActor *          _clutter_context_peek_shader_stack              (void);
@@ -207,6 +209,7 @@ guint32                 _clutter_context_acquire_id                     (gpointe
 void                    _clutter_context_release_id                     (guint32       id_);
 gboolean                _clutter_context_get_motion_events_enabled      (void);
 gboolean                _clutter_context_get_show_fps                   (void);
+guint                   _clutter_context_get_size_request_cache_size    (void);
 
 const gchar *_clutter_gettext (const gchar *str);
 
@@ -252,6 +255,9 @@ void  _clutter_util_fully_transform_vertices (const CoglMatrix    *modelview,
 void _clutter_util_rectangle_union (const cairo_rectangle_int_t *src1,
                                     const cairo_rectangle_int_t *src2,
                                     cairo_rectangle_int_t       *dest);
+gboolean _clutter_util_rectangle_intersection (const cairo_rectangle_int_t *src1,
+                                               const cairo_rectangle_int_t *src2,
+                                               cairo_rectangle_int_t       *dest);
 
 typedef struct _ClutterPlane
 {
@@ -1,4 +1,6 @@
-#ifdef CLUTTER_ENABLE_PROFILE
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
 
 #include <stdlib.h>
 
@@ -6,6 +8,236 @@
 #define G_DISABLE_DEPRECATION_WARNINGS
 #include "clutter-profile.h"
 
+#ifdef G_OS_UNIX
+#include <signal.h>
+#include <unistd.h>
+#include <glib-unix.h>
+#endif
+
+/* the number of events kept by the trace recorder; once the buffer
+ * is full, the oldest events are overwritten. Must be a power of 2
+ */
+#define TRACE_BUFFER_SIZE       (1 << 16)
+
+typedef struct _TraceEvent
+{
+  gint64 timestamp;
+  const char *name;
+  const char *category;
+  gpointer thread;
+  glong value;
+  char phase;
+} TraceEvent;
+
+gboolean _clutter_trace_enabled = FALSE;
+
+G_LOCK_DEFINE_STATIC (trace_events);
+
+static TraceEvent *trace_events = NULL;
+static guint trace_events_index = 0;
+static guint trace_events_len = 0;
+static char *trace_filename = NULL;
+
+static void
+trace_record (char        phase,
+              const char *category,
+              const char *name,
+              glong       value)
+{
+  gint64 timestamp = g_get_monotonic_time ();
+  TraceEvent *event;
+
+  G_LOCK (trace_events);
+
+  event = &trace_events[trace_events_index];
+  event->timestamp = timestamp;
+  event->name = name;
+  event->category = category;
+  event->thread = g_thread_self ();
+  event->value = value;
+  event->phase = phase;
+
+  trace_events_index = (trace_events_index + 1) & (TRACE_BUFFER_SIZE - 1);
+  trace_events_len = MIN (trace_events_len + 1, TRACE_BUFFER_SIZE);
+
+  G_UNLOCK (trace_events);
+}
+
+void
+_clutter_trace_begin (const ClutterTraceTimer *timer)
+{
+  trace_record ('B', timer->parent, timer->name, 0);
+}
+
+void
+_clutter_trace_end (const ClutterTraceTimer *timer)
+{
+  trace_record ('E', timer->parent, timer->name, 0);
+}
+
+void
+_clutter_trace_counter (ClutterTraceCounter *counter,
+                        gint                 delta)
+{
+  gint value;
+
+  value = g_atomic_int_add (&counter->count, delta) + delta;
+
+  trace_record ('C', NULL, counter->name, value);
+}
+
+static void
+append_json_string (GString    *json,
+                    const char *str)
+{
+  const char *p;
+
+  g_string_append_c (json, '"');
+
+  for (p = str; p != NULL && *p != '\0'; p++)
+    {
+      if (*p == '"' || *p == '\\')
+        {
+          g_string_append_c (json, '\\');
+          g_string_append_c (json, *p);
+        }
+      else if ((guchar) *p < 0x20)
+        g_string_append_printf (json, "\\u%04x", (guint) *p);
+      else
+        g_string_append_c (json, *p);
+    }
+
+  g_string_append_c (json, '"');
+}
+
+/*< private >
+ * _clutter_trace_dump:
+ * @filename: the file to write
+ * @error: return location for a #GError, or %NULL
+ *
+ * Writes the events held by the trace recorder to @filename, using
+ * the JSON format of the Chrome trace event profiler, which can be
+ * loaded in chrome://tracing or in the Perfetto UI.
+ *
+ * Return value: %TRUE if the file was written
+ */
+gboolean
+_clutter_trace_dump (const char  *filename,
+                     GError     **error)
+{
+  GString *json;
+  gboolean res;
+  guint i, first;
+  int pid;
+
+#ifdef G_OS_UNIX
+  pid = getpid ();
+#else
+  pid = 0;
+#endif
+
+  G_LOCK (trace_events);
+
+  json = g_string_sized_new (trace_events_len * 96 + 64);
+  g_string_append (json, "{\"traceEvents\":[");
+
+  first = (trace_events_index - trace_events_len) & (TRACE_BUFFER_SIZE - 1);
+
+  for (i = 0; i < trace_events_len; i++)
+    {
+      const TraceEvent *event;
+
+      event = &trace_events[(first + i) & (TRACE_BUFFER_SIZE - 1)];
+
+      g_string_append (json, i == 0 ? "\n{\"name\":" : ",\n{\"name\":");
+      append_json_string (json, event->name);
+
+      if (event->category != NULL)
+        {
+          g_string_append (json, ",\"cat\":");
+          append_json_string (json, event->category);
+        }
+
+      g_string_append_printf (json,
+                              ",\"ph\":\"%c\""
+                              ",\"ts\":%" G_GINT64_FORMAT
+                              ",\"pid\":%d"
+                              ",\"tid\":%" G_GSIZE_FORMAT,
+                              event->phase,
+                              event->timestamp,
+                              pid,
+                              (gsize) GPOINTER_TO_SIZE (event->thread));
+
+      if (event->phase == 'C')
+        g_string_append_printf (json, ",\"args\":{\"value\":%ld}",
+                                event->value);
+
+      g_string_append_c (json, '}');
+    }
+
+  G_UNLOCK (trace_events);
+
+  g_string_append (json, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+  res = g_file_set_contents (filename, json->str, json->len, error);
+
+  g_string_free (json, TRUE);
+
+  return res;
+}
+
+static void
+trace_dump_default (void)
+{
+  GError *error = NULL;
+
+  if (!_clutter_trace_dump (trace_filename, &error))
+    {
+      g_warning ("Unable to write the Clutter trace to '%s': %s",
+                 trace_filename,
+                 error->message);
+      g_error_free (error);
+    }
+}
+
+#ifdef G_OS_UNIX
+static gboolean
+trace_dump_on_signal (gpointer data)
+{
+  trace_dump_default ();
+
+  return TRUE;
+}
+#endif
+
+/*< private >
+ * _clutter_trace_init:
+ * @filename: the file used to dump the trace
+ *
+ * Starts recording the timers and the counters of Clutter into a
+ * ring buffer; the recorded events are written to @filename when
+ * the process receives SIGUSR1, and when it exits.
+ */
+void
+_clutter_trace_init (const char *filename)
+{
+  if (_clutter_trace_enabled)
+    return;
+
+  trace_filename = g_strdup (filename);
+  trace_events = g_new0 (TraceEvent, TRACE_BUFFER_SIZE);
+
+  g_atexit (trace_dump_default);
+
+#ifdef G_OS_UNIX
+  g_unix_signal_add (SIGUSR1, trace_dump_on_signal, NULL);
+#endif
+
+  _clutter_trace_enabled = TRUE;
+}
+
+#ifdef CLUTTER_ENABLE_PROFILE
+
 UProfContext *_clutter_uprof_context;
 
 static UProfReport *clutter_uprof_report;
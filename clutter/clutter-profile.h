@@ -31,6 +31,41 @@ typedef enum {
   CLUTTER_PROFILE_DISABLE_REPORT  = 1 << 1
 } ClutterProfileFlag;
 
+/* the trace recorder does not depend on uprof, so that the timers and
+ * counters can be recorded without a profiling build; see CLUTTER_TRACE
+ */
+typedef struct _ClutterTraceTimer
+{
+  const char *name;
+  const char *parent;
+} ClutterTraceTimer;
+
+typedef struct _ClutterTraceCounter
+{
+  const char *name;
+  volatile gint count;
+} ClutterTraceCounter;
+
+extern gboolean _clutter_trace_enabled;
+
+void            _clutter_trace_init             (const char                *filename);
+void            _clutter_trace_begin            (const ClutterTraceTimer   *timer);
+void            _clutter_trace_end              (const ClutterTraceTimer   *timer);
+void            _clutter_trace_counter          (ClutterTraceCounter       *counter,
+                                                 gint                       delta);
+gboolean        _clutter_trace_dump             (const char                *filename,
+                                                 GError                   **error);
+
+#define CLUTTER_TRACE_BEGIN(T)          G_STMT_START {                  \
+  if (G_UNLIKELY (_clutter_trace_enabled))                              \
+    _clutter_trace_begin (&(T));                        } G_STMT_END
+#define CLUTTER_TRACE_END(T)            G_STMT_START {                  \
+  if (G_UNLIKELY (_clutter_trace_enabled))                              \
+    _clutter_trace_end (&(T));                          } G_STMT_END
+#define CLUTTER_TRACE_COUNTER(C,D)      G_STMT_START {                  \
+  if (G_UNLIKELY (_clutter_trace_enabled))                              \
+    _clutter_trace_counter (&(C), (D));                 } G_STMT_END
+
 #ifdef CLUTTER_ENABLE_PROFILE
 
 #include <uprof.h>
@@ -38,12 +73,24 @@ typedef enum {
 extern UProfContext *   _clutter_uprof_context;
 extern guint            clutter_profile_flags;
 
-#define CLUTTER_STATIC_TIMER    UPROF_STATIC_TIMER
-#define CLUTTER_STATIC_COUNTER  UPROF_STATIC_COUNTER
-#define CLUTTER_COUNTER_INC     UPROF_COUNTER_INC
-#define CLUTTER_COUNTER_DEC     UPROF_COUNTER_DEC
-#define CLUTTER_TIMER_START     UPROF_TIMER_START
-#define CLUTTER_TIMER_STOP      UPROF_TIMER_STOP
+#define CLUTTER_STATIC_TIMER(A,B,C,D,E) \
+  UPROF_STATIC_TIMER (A, B, C, D, E); \
+  static const ClutterTraceTimer G_PASTE (A, _trace) = { C, B }
+#define CLUTTER_STATIC_COUNTER(A,B,C,D) \
+  UPROF_STATIC_COUNTER (A, B, C, D); \
+  static ClutterTraceCounter G_PASTE (A, _trace) = { B, 0 }
+#define CLUTTER_COUNTER_INC(A,B)        G_STMT_START {  \
+  UPROF_COUNTER_INC (A, B);                             \
+  CLUTTER_TRACE_COUNTER (G_PASTE (B, _trace), 1);       } G_STMT_END
+#define CLUTTER_COUNTER_DEC(A,B)        G_STMT_START {  \
+  UPROF_COUNTER_DEC (A, B);                             \
+  CLUTTER_TRACE_COUNTER (G_PASTE (B, _trace), -1);      } G_STMT_END
+#define CLUTTER_TIMER_START(A,B)        G_STMT_START {  \
+  UPROF_TIMER_START (A, B);                             \
+  CLUTTER_TRACE_BEGIN (G_PASTE (B, _trace));            } G_STMT_END
+#define CLUTTER_TIMER_STOP(A,B)         G_STMT_START {  \
+  CLUTTER_TRACE_END (G_PASTE (B, _trace));              \
+  UPROF_TIMER_STOP (A, B);                              } G_STMT_END
 
 void    _clutter_uprof_init             (void);
 void    _clutter_profile_suspend        (void);
@@ -51,17 +98,12 @@ void    _clutter_profile_resume         (void);
 
 #else /* CLUTTER_ENABLE_PROFILE */
 
-#ifdef __COUNTER__
-#define CLUTTER_STATIC_TIMER(A,B,C,D,E) extern void G_PASTE (_clutter_dummy_decl, __COUNTER__) (void)
-#define CLUTTER_STATIC_COUNTER(A,B,C,D) extern void G_PASTE (_clutter_dummy_decl, __COUNTER__) (void)
-#else
-#define CLUTTER_STATIC_TIMER(A,B,C,D,E) extern void G_PASTE (_clutter_dummy_decl, __LINE__) (void)
-#define CLUTTER_STATIC_COUNTER(A,B,C,D) extern void G_PASTE (_clutter_dummy_decl, __LINE__) (void)
-#endif
-#define CLUTTER_COUNTER_INC(A,B)        G_STMT_START { } G_STMT_END
-#define CLUTTER_COUNTER_DEC(A,B)        G_STMT_START { } G_STMT_END
-#define CLUTTER_TIMER_START(A,B)        G_STMT_START { } G_STMT_END
-#define CLUTTER_TIMER_STOP(A,B)         G_STMT_START { } G_STMT_END
+#define CLUTTER_STATIC_TIMER(A,B,C,D,E) static const ClutterTraceTimer A = { C, B }
+#define CLUTTER_STATIC_COUNTER(A,B,C,D) static ClutterTraceCounter A = { B, 0 }
+#define CLUTTER_COUNTER_INC(A,B)        CLUTTER_TRACE_COUNTER (B, 1)
+#define CLUTTER_COUNTER_DEC(A,B)        CLUTTER_TRACE_COUNTER (B, -1)
+#define CLUTTER_TIMER_START(A,B)        CLUTTER_TRACE_BEGIN (B)
+#define CLUTTER_TIMER_STOP(A,B)         CLUTTER_TRACE_END (B)
 
 #define _clutter_uprof_init             G_STMT_START { } G_STMT_END
 #define _clutter_profile_suspend        G_STMT_START { } G_STMT_END
@@ -143,10 +143,11 @@ clutter_scroll_actor_push_clip (ClutterActor *actor)
     y = 0.f;
 
   /* offset the clip so that we keep it at the right place */
-  cogl_clip_push_rectangle (x,
-                            y,
-                            x + width,
-                            y + height);
+  _clutter_actor_push_clip_rectangle (actor,
+                                      x,
+                                      y,
+                                      x + width,
+                                      y + height);
 }
 
 static void
@@ -156,7 +157,7 @@ clutter_scroll_actor_paint (ClutterActor *actor)
 
   CLUTTER_ACTOR_CLASS (clutter_scroll_actor_parent_class)->paint (actor);
 
-  cogl_clip_pop ();
+  _clutter_actor_pop_clip (actor);
 }
 
 static void
@@ -177,7 +178,7 @@ clutter_scroll_actor_pick (ClutterActor       *actor,
   while (clutter_actor_iter_next (&iter, &child))
     clutter_actor_paint (child);
 
-  cogl_clip_pop ();
+  _clutter_actor_pop_clip (actor);
 }
 
 static void
@@ -186,6 +187,7 @@ clutter_scroll_actor_set_scroll_to_internal (ClutterScrollActor *self,
 {
   ClutterScrollActorPrivate *priv = self->priv;
   ClutterActor *actor = CLUTTER_ACTOR (self);
+  ClutterScrollActorClass *klass;
 
   if (clutter_point_equals (&priv->scroll_to, point))
     return;
@@ -195,7 +197,12 @@ clutter_scroll_actor_set_scroll_to_internal (ClutterScrollActor *self,
   else
     priv->scroll_to = *point;
 
+  _clutter_actor_invalidate_transform (actor);
   clutter_actor_queue_redraw (actor);
+
+  klass = CLUTTER_SCROLL_ACTOR_GET_CLASS (self);
+  if (klass->scroll_changed != NULL)
+    klass->scroll_changed (self, &priv->scroll_to);
 }
 
 static void
@@ -248,6 +255,7 @@ clutter_scroll_actor_class_init (ClutterScrollActorClass *klass)
   gobject_class->get_property = clutter_scroll_actor_get_property;
 
   actor_class->apply_transform = clutter_scroll_actor_apply_transform;
+  _clutter_actor_class_set_cacheable_transform (actor_class);
   actor_class->paint = clutter_scroll_actor_paint;
   actor_class->pick = clutter_scroll_actor_pick;
 
@@ -379,6 +387,8 @@ clutter_scroll_actor_set_scroll_mode (ClutterScrollActor *actor,
 
   priv->scroll_mode = mode;
 
+  _clutter_actor_invalidate_transform (CLUTTER_ACTOR (actor));
+
   g_object_notify_by_pspec (G_OBJECT (actor), obj_props[PROP_SCROLL_MODE]);
 }
 
@@ -59,9 +59,9 @@ struct _ClutterScrollActor
 
 /**
  * ClutterScrollActorClass:
- *
- * The <structname>ClutterScrollActor</structname> structure contains only
- * private data.
+ * @scroll_changed: virtual function, called each time the origin of the
+ *   visible region of the actor changes, either directly or while the
+ *   scrolling is being animated
  *
  * Since: 1.12
  */
@@ -70,7 +70,12 @@ struct _ClutterScrollActorClass
   /*< private >*/
   ClutterActorClass parent_instance;
 
-  gpointer _padding[8];
+  /*< public >*/
+  void (* scroll_changed) (ClutterScrollActor *actor,
+                           const ClutterPoint *point);
+
+  /*< private >*/
+  gpointer _padding[7];
 };
 
 CLUTTER_AVAILABLE_IN_1_12
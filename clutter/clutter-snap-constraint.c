@@ -94,7 +94,7 @@ source_queue_relayout (ClutterActor          *source,
                        ClutterSnapConstraint *constraint)
 {
   if (constraint->actor != NULL)
-    clutter_actor_queue_relayout (constraint->actor);
+    _clutter_actor_queue_only_reallocation (constraint->actor);
 }
 
 static void
@@ -461,7 +461,7 @@ clutter_snap_constraint_set_source (ClutterSnapConstraint *constraint,
                         constraint);
 
       if (constraint->actor != NULL)
-        clutter_actor_queue_relayout (constraint->actor);
+        _clutter_actor_queue_only_reallocation (constraint->actor);
     }
 
   g_object_notify_by_pspec (G_OBJECT (constraint), obj_props[PROP_SOURCE]);
@@ -529,7 +529,7 @@ clutter_snap_constraint_set_edges (ClutterSnapConstraint *constraint,
   if ((from_changed || to_changed) &&
       constraint->actor != NULL)
     {
-      clutter_actor_queue_relayout (constraint->actor);
+      _clutter_actor_queue_only_reallocation (constraint->actor);
     }
 
   g_object_thaw_notify (G_OBJECT (constraint));
@@ -580,7 +580,7 @@ clutter_snap_constraint_set_offset (ClutterSnapConstraint *constraint,
   constraint->offset = offset;
 
   if (constraint->actor != NULL)
-    clutter_actor_queue_relayout (constraint->actor);
+    _clutter_actor_queue_only_reallocation (constraint->actor);
 
   g_object_notify_by_pspec (G_OBJECT (constraint), obj_props[PROP_OFFSET]);
 }
@@ -0,0 +1,660 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2012  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterSpatialIndex: bounding volume hierarchy of 2D boxes.
+ *
+ * The index is a dynamic AABB tree: every leaf stores a box, slightly
+ * enlarged so that small movements do not require restructuring the
+ * tree, and every inner node stores the union of the boxes of its two
+ * children. Insertions pick the sibling that minimizes the growth of
+ * the perimeter of the ancestors, and the tree is kept balanced using
+ * rotations, so both updates and queries are O(log n).
+ *
+ * Besides the boxes, the index keeps a set of "pending" items, whose
+ * box is not known yet, or is known to be out of date; those items
+ * are reported by every query.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-spatial-index.h"
+
+#include "clutter-debug.h"
+
+#define NULL_NODE       (-1)
+
+/* how much the box of a leaf is enlarged, in pixels */
+#define BOX_MARGIN      (8.f)
+
+typedef struct _IndexNode
+{
+  /* for leaves, this is the enlarged box */
+  ClutterActorBox box;
+
+  gpointer data;
+
+  /* for free nodes, this is the next free node */
+  gint parent;
+
+  gint child1;
+  gint child2;
+
+  /* 0 for leaves, -1 for free nodes */
+  gint height;
+} IndexNode;
+
+struct _ClutterSpatialIndex
+{
+  GArray *nodes;
+
+  gint root;
+  gint free_list;
+
+  guint n_leaves;
+
+  GHashTable *pending;
+
+  /* reused across queries */
+  GArray *stack;
+};
+
+#define INDEX_NODE(i,n)         (&g_array_index ((i)->nodes, IndexNode, (n)))
+#define NODE_IS_LEAF(node)      ((node)->child1 == NULL_NODE)
+
+static inline void
+box_union (const ClutterActorBox *a,
+           const ClutterActorBox *b,
+           ClutterActorBox       *res)
+{
+  res->x1 = MIN (a->x1, b->x1);
+  res->y1 = MIN (a->y1, b->y1);
+  res->x2 = MAX (a->x2, b->x2);
+  res->y2 = MAX (a->y2, b->y2);
+}
+
+static inline float
+box_perimeter (const ClutterActorBox *box)
+{
+  return 2.f * ((box->x2 - box->x1) + (box->y2 - box->y1));
+}
+
+static inline gboolean
+box_contains (const ClutterActorBox *outer,
+              const ClutterActorBox *inner)
+{
+  return outer->x1 <= inner->x1 && outer->y1 <= inner->y1 &&
+         outer->x2 >= inner->x2 && outer->y2 >= inner->y2;
+}
+
+static inline gboolean
+box_overlaps (const ClutterActorBox *a,
+              const ClutterActorBox *b)
+{
+  return a->x1 < b->x2 && a->x2 > b->x1 &&
+         a->y1 < b->y2 && a->y2 > b->y1;
+}
+
+static gint
+index_alloc_node (ClutterSpatialIndex *index_)
+{
+  IndexNode *node;
+  gint retval;
+
+  if (index_->free_list != NULL_NODE)
+    {
+      retval = index_->free_list;
+      node = INDEX_NODE (index_, retval);
+      index_->free_list = node->parent;
+    }
+  else
+    {
+      retval = index_->nodes->len;
+      g_array_set_size (index_->nodes, retval + 1);
+      node = INDEX_NODE (index_, retval);
+    }
+
+  node->data = NULL;
+  node->parent = NULL_NODE;
+  node->child1 = NULL_NODE;
+  node->child2 = NULL_NODE;
+  node->height = 0;
+
+  return retval;
+}
+
+static void
+index_free_node (ClutterSpatialIndex *index_,
+                 gint                 node_id)
+{
+  IndexNode *node = INDEX_NODE (index_, node_id);
+
+  node->data = NULL;
+  node->height = -1;
+  node->parent = index_->free_list;
+  index_->free_list = node_id;
+}
+
+/* rotates the subtree rooted at @a_id if it is imbalanced, and returns
+ * the index of the new root of the subtree
+ */
+static gint
+index_balance (ClutterSpatialIndex *index_,
+               gint                 a_id)
+{
+  IndexNode *a, *b, *c;
+  gint b_id, c_id;
+  gint balance;
+
+  a = INDEX_NODE (index_, a_id);
+  if (NODE_IS_LEAF (a) || a->height < 2)
+    return a_id;
+
+  b_id = a->child1;
+  c_id = a->child2;
+  b = INDEX_NODE (index_, b_id);
+  c = INDEX_NODE (index_, c_id);
+
+  balance = c->height - b->height;
+
+  if (balance > 1)
+    {
+      /* rotate c up */
+      gint f_id = c->child1;
+      gint g_id = c->child2;
+      IndexNode *f = INDEX_NODE (index_, f_id);
+      IndexNode *g = INDEX_NODE (index_, g_id);
+
+      c->child1 = a_id;
+      c->parent = a->parent;
+      a->parent = c_id;
+
+      if (c->parent != NULL_NODE)
+        {
+          IndexNode *parent = INDEX_NODE (index_, c->parent);
+
+          if (parent->child1 == a_id)
+            parent->child1 = c_id;
+          else
+            parent->child2 = c_id;
+        }
+      else
+        index_->root = c_id;
+
+      if (f->height > g->height)
+        {
+          c->child2 = f_id;
+          a->child2 = g_id;
+          g->parent = a_id;
+
+          box_union (&b->box, &g->box, &a->box);
+          box_union (&a->box, &f->box, &c->box);
+
+          a->height = 1 + MAX (b->height, g->height);
+          c->height = 1 + MAX (a->height, f->height);
+        }
+      else
+        {
+          c->child2 = g_id;
+          a->child2 = f_id;
+          f->parent = a_id;
+
+          box_union (&b->box, &f->box, &a->box);
+          box_union (&a->box, &g->box, &c->box);
+
+          a->height = 1 + MAX (b->height, f->height);
+          c->height = 1 + MAX (a->height, g->height);
+        }
+
+      return c_id;
+    }
+
+  if (balance < -1)
+    {
+      /* rotate b up */
+      gint d_id = b->child1;
+      gint e_id = b->child2;
+      IndexNode *d = INDEX_NODE (index_, d_id);
+      IndexNode *e = INDEX_NODE (index_, e_id);
+
+      b->child1 = a_id;
+      b->parent = a->parent;
+      a->parent = b_id;
+
+      if (b->parent != NULL_NODE)
+        {
+          IndexNode *parent = INDEX_NODE (index_, b->parent);
+
+          if (parent->child1 == a_id)
+            parent->child1 = b_id;
+          else
+            parent->child2 = b_id;
+        }
+      else
+        index_->root = b_id;
+
+      if (d->height > e->height)
+        {
+          b->child2 = d_id;
+          a->child1 = e_id;
+          e->parent = a_id;
+
+          box_union (&c->box, &e->box, &a->box);
+          box_union (&a->box, &d->box, &b->box);
+
+          a->height = 1 + MAX (c->height, e->height);
+          b->height = 1 + MAX (a->height, d->height);
+        }
+      else
+        {
+          b->child2 = e_id;
+          a->child1 = d_id;
+          d->parent = a_id;
+
+          box_union (&c->box, &d->box, &a->box);
+          box_union (&a->box, &e->box, &b->box);
+
+          a->height = 1 + MAX (c->height, d->height);
+          b->height = 1 + MAX (a->height, e->height);
+        }
+
+      return b_id;
+    }
+
+  return a_id;
+}
+
+/* walks back to the root from @node_id, fixing boxes and heights */
+static void
+index_refit (ClutterSpatialIndex *index_,
+             gint                 node_id)
+{
+  while (node_id != NULL_NODE)
+    {
+      IndexNode *node, *child1, *child2;
+
+      node_id = index_balance (index_, node_id);
+
+      node = INDEX_NODE (index_, node_id);
+      child1 = INDEX_NODE (index_, node->child1);
+      child2 = INDEX_NODE (index_, node->child2);
+
+      node->height = 1 + MAX (child1->height, child2->height);
+      box_union (&child1->box, &child2->box, &node->box);
+
+      node_id = node->parent;
+    }
+}
+
+static void
+index_insert_leaf (ClutterSpatialIndex *index_,
+                   gint                 leaf_id)
+{
+  ClutterActorBox leaf_box;
+  IndexNode *node, *sibling;
+  gint sibling_id, old_parent_id, new_parent_id;
+
+  if (index_->root == NULL_NODE)
+    {
+      index_->root = leaf_id;
+      INDEX_NODE (index_, leaf_id)->parent = NULL_NODE;
+      return;
+    }
+
+  leaf_box = INDEX_NODE (index_, leaf_id)->box;
+
+  /* find the best sibling */
+  sibling_id = index_->root;
+  node = INDEX_NODE (index_, sibling_id);
+  while (!NODE_IS_LEAF (node))
+    {
+      IndexNode *child1 = INDEX_NODE (index_, node->child1);
+      IndexNode *child2 = INDEX_NODE (index_, node->child2);
+      ClutterActorBox combined;
+      float area, combined_area;
+      float cost, inheritance_cost, cost1, cost2;
+
+      area = box_perimeter (&node->box);
+      box_union (&node->box, &leaf_box, &combined);
+      combined_area = box_perimeter (&combined);
+
+      /* cost of creating a new parent for this node and the leaf */
+      cost = 2.f * combined_area;
+
+      /* minimum cost of pushing the leaf further down the tree */
+      inheritance_cost = 2.f * (combined_area - area);
+
+      box_union (&child1->box, &leaf_box, &combined);
+      if (NODE_IS_LEAF (child1))
+        cost1 = box_perimeter (&combined) + inheritance_cost;
+      else
+        cost1 = box_perimeter (&combined) - box_perimeter (&child1->box)
+              + inheritance_cost;
+
+      box_union (&child2->box, &leaf_box, &combined);
+      if (NODE_IS_LEAF (child2))
+        cost2 = box_perimeter (&combined) + inheritance_cost;
+      else
+        cost2 = box_perimeter (&combined) - box_perimeter (&child2->box)
+              + inheritance_cost;
+
+      if (cost < cost1 && cost < cost2)
+        break;
+
+      sibling_id = cost1 < cost2 ? node->child1 : node->child2;
+      node = INDEX_NODE (index_, sibling_id);
+    }
+
+  /* this might reallocate the nodes array, so we need to look up
+   * the nodes again afterwards
+   */
+  new_parent_id = index_alloc_node (index_);
+
+  sibling = INDEX_NODE (index_, sibling_id);
+  old_parent_id = sibling->parent;
+
+  node = INDEX_NODE (index_, new_parent_id);
+  node->parent = old_parent_id;
+  node->height = sibling->height + 1;
+  node->child1 = sibling_id;
+  node->child2 = leaf_id;
+  box_union (&leaf_box, &sibling->box, &node->box);
+
+  if (old_parent_id != NULL_NODE)
+    {
+      IndexNode *old_parent = INDEX_NODE (index_, old_parent_id);
+
+      if (old_parent->child1 == sibling_id)
+        old_parent->child1 = new_parent_id;
+      else
+        old_parent->child2 = new_parent_id;
+    }
+  else
+    index_->root = new_parent_id;
+
+  sibling->parent = new_parent_id;
+  INDEX_NODE (index_, leaf_id)->parent = new_parent_id;
+
+  index_refit (index_, new_parent_id);
+}
+
+static void
+index_remove_leaf (ClutterSpatialIndex *index_,
+                   gint                 leaf_id)
+{
+  IndexNode *parent;
+  gint parent_id, grand_parent_id, sibling_id;
+
+  if (leaf_id == index_->root)
+    {
+      index_->root = NULL_NODE;
+      return;
+    }
+
+  parent_id = INDEX_NODE (index_, leaf_id)->parent;
+  parent = INDEX_NODE (index_, parent_id);
+  grand_parent_id = parent->parent;
+
+  if (parent->child1 == leaf_id)
+    sibling_id = parent->child2;
+  else
+    sibling_id = parent->child1;
+
+  if (grand_parent_id != NULL_NODE)
+    {
+      IndexNode *grand_parent = INDEX_NODE (index_, grand_parent_id);
+
+      if (grand_parent->child1 == parent_id)
+        grand_parent->child1 = sibling_id;
+      else
+        grand_parent->child2 = sibling_id;
+
+      INDEX_NODE (index_, sibling_id)->parent = grand_parent_id;
+      index_free_node (index_, parent_id);
+
+      index_refit (index_, grand_parent_id);
+    }
+  else
+    {
+      index_->root = sibling_id;
+      INDEX_NODE (index_, sibling_id)->parent = NULL_NODE;
+      index_free_node (index_, parent_id);
+    }
+}
+
+static inline void
+index_enlarge_box (const ClutterActorBox *box,
+                   ClutterActorBox       *res)
+{
+  res->x1 = box->x1 - BOX_MARGIN;
+  res->y1 = box->y1 - BOX_MARGIN;
+  res->x2 = box->x2 + BOX_MARGIN;
+  res->y2 = box->y2 + BOX_MARGIN;
+}
+
+ClutterSpatialIndex *
+_clutter_spatial_index_new (void)
+{
+  ClutterSpatialIndex *index_;
+
+  index_ = g_slice_new (ClutterSpatialIndex);
+
+  index_->nodes = g_array_new (FALSE, FALSE, sizeof (IndexNode));
+  index_->root = NULL_NODE;
+  index_->free_list = NULL_NODE;
+  index_->n_leaves = 0;
+  index_->pending = g_hash_table_new (NULL, NULL);
+  index_->stack = g_array_new (FALSE, FALSE, sizeof (gint));
+
+  return index_;
+}
+
+void
+_clutter_spatial_index_free (ClutterSpatialIndex *index_)
+{
+  g_return_if_fail (index_ != NULL);
+
+  g_array_free (index_->nodes, TRUE);
+  g_array_free (index_->stack, TRUE);
+  g_hash_table_destroy (index_->pending);
+
+  g_slice_free (ClutterSpatialIndex, index_);
+}
+
+/*< private >
+ * _clutter_spatial_index_insert:
+ * @index_: a #ClutterSpatialIndex
+ * @box: the box of the item
+ * @data: the item
+ *
+ * Adds @data to the index.
+ *
+ * Return value: a handle for @data, to be used with
+ *   _clutter_spatial_index_update() and _clutter_spatial_index_remove()
+ */
+gint
+_clutter_spatial_index_insert (ClutterSpatialIndex   *index_,
+                               const ClutterActorBox *box,
+                               gpointer               data)
+{
+  IndexNode *node;
+  gint node_id;
+
+  g_return_val_if_fail (index_ != NULL, NULL_NODE);
+  g_return_val_if_fail (box != NULL, NULL_NODE);
+
+  node_id = index_alloc_node (index_);
+
+  node = INDEX_NODE (index_, node_id);
+  node->data = data;
+  index_enlarge_box (box, &node->box);
+
+  index_insert_leaf (index_, node_id);
+  index_->n_leaves += 1;
+
+  return node_id;
+}
+
+/*< private >
+ * _clutter_spatial_index_update:
+ * @index_: a #ClutterSpatialIndex
+ * @node: a handle returned by _clutter_spatial_index_insert()
+ * @box: the new box of the item
+ *
+ * Updates the box of an item; the tree is only modified if @box
+ * is not contained by the enlarged box stored by the index.
+ */
+void
+_clutter_spatial_index_update (ClutterSpatialIndex   *index_,
+                               gint                   node,
+                               const ClutterActorBox *box)
+{
+  IndexNode *leaf;
+
+  g_return_if_fail (index_ != NULL);
+  g_return_if_fail (node >= 0 && node < index_->nodes->len);
+
+  leaf = INDEX_NODE (index_, node);
+
+  g_assert (NODE_IS_LEAF (leaf) && leaf->height == 0);
+
+  if (box_contains (&leaf->box, box))
+    return;
+
+  index_remove_leaf (index_, node);
+
+  /* removing the leaf does not reallocate the array */
+  index_enlarge_box (box, &leaf->box);
+
+  index_insert_leaf (index_, node);
+}
+
+void
+_clutter_spatial_index_remove (ClutterSpatialIndex *index_,
+                               gint                 node)
+{
+  g_return_if_fail (index_ != NULL);
+  g_return_if_fail (node >= 0 && node < index_->nodes->len);
+
+  index_remove_leaf (index_, node);
+  index_free_node (index_, node);
+
+  index_->n_leaves -= 1;
+}
+
+/*< private >
+ * _clutter_spatial_index_add_pending:
+ * @index_: a #ClutterSpatialIndex
+ * @data: an item
+ *
+ * Marks @data as pending: until _clutter_spatial_index_remove_pending()
+ * is called, every query will report @data, regardless of its box.
+ */
+void
+_clutter_spatial_index_add_pending (ClutterSpatialIndex *index_,
+                                    gpointer             data)
+{
+  g_return_if_fail (index_ != NULL);
+
+  g_hash_table_insert (index_->pending, data, data);
+}
+
+void
+_clutter_spatial_index_remove_pending (ClutterSpatialIndex *index_,
+                                       gpointer             data)
+{
+  g_return_if_fail (index_ != NULL);
+
+  g_hash_table_remove (index_->pending, data);
+}
+
+/*< private >
+ * _clutter_spatial_index_query_box:
+ * @index_: a #ClutterSpatialIndex
+ * @box: the area to query
+ * @func: a function to be called for each item overlapping @box
+ * @user_data: data to be passed to @func
+ *
+ * Calls @func for each pending item, and for each item whose box
+ * might overlap @box; since the index stores enlarged boxes, some of
+ * the items might be just outside of @box.
+ */
+void
+_clutter_spatial_index_query_box (ClutterSpatialIndex     *index_,
+                                  const ClutterActorBox   *box,
+                                  ClutterSpatialIndexFunc  func,
+                                  gpointer                 user_data)
+{
+  GHashTableIter iter;
+  gpointer data;
+  GArray *stack;
+
+  g_return_if_fail (index_ != NULL);
+  g_return_if_fail (box != NULL);
+  g_return_if_fail (func != NULL);
+
+  g_hash_table_iter_init (&iter, index_->pending);
+  while (g_hash_table_iter_next (&iter, &data, NULL))
+    {
+      if (!func (data, user_data))
+        return;
+    }
+
+  if (index_->root == NULL_NODE)
+    return;
+
+  stack = index_->stack;
+  g_array_set_size (stack, 0);
+  g_array_append_val (stack, index_->root);
+
+  while (stack->len > 0)
+    {
+      const IndexNode *node;
+      gint node_id;
+
+      node_id = g_array_index (stack, gint, stack->len - 1);
+      g_array_set_size (stack, stack->len - 1);
+
+      node = INDEX_NODE (index_, node_id);
+
+      if (!box_overlaps (&node->box, box))
+        continue;
+
+      if (NODE_IS_LEAF (node))
+        {
+          if (!func (node->data, user_data))
+            return;
+        }
+      else
+        {
+          g_array_append_val (stack, node->child1);
+          g_array_append_val (stack, node->child2);
+        }
+    }
+}
+
+guint
+_clutter_spatial_index_get_n_items (ClutterSpatialIndex *index_)
+{
+  g_return_val_if_fail (index_ != NULL, 0);
+
+  return index_->n_leaves;
+}
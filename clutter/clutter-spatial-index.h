@@ -0,0 +1,69 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2012  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterSpatialIndex: bounding volume hierarchy of 2D boxes.
+ */
+
+#ifndef __CLUTTER_SPATIAL_INDEX_H__
+#define __CLUTTER_SPATIAL_INDEX_H__
+
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterSpatialIndex     ClutterSpatialIndex;
+
+/*< private >
+ * ClutterSpatialIndexFunc:
+ * @data: the data associated to a box overlapping the query
+ * @user_data: the data passed to the query
+ *
+ * Return value: %FALSE to stop the query
+ */
+typedef gboolean (* ClutterSpatialIndexFunc) (gpointer data,
+                                              gpointer user_data);
+
+ClutterSpatialIndex *   _clutter_spatial_index_new              (void);
+void                    _clutter_spatial_index_free             (ClutterSpatialIndex     *index_);
+
+gint                    _clutter_spatial_index_insert           (ClutterSpatialIndex     *index_,
+                                                                 const ClutterActorBox   *box,
+                                                                 gpointer                 data);
+void                    _clutter_spatial_index_update           (ClutterSpatialIndex     *index_,
+                                                                 gint                     node,
+                                                                 const ClutterActorBox   *box);
+void                    _clutter_spatial_index_remove           (ClutterSpatialIndex     *index_,
+                                                                 gint                     node);
+
+void                    _clutter_spatial_index_add_pending      (ClutterSpatialIndex     *index_,
+                                                                 gpointer                 data);
+void                    _clutter_spatial_index_remove_pending   (ClutterSpatialIndex     *index_,
+                                                                 gpointer                 data);
+
+void                    _clutter_spatial_index_query_box        (ClutterSpatialIndex     *index_,
+                                                                 const ClutterActorBox   *box,
+                                                                 ClutterSpatialIndexFunc  func,
+                                                                 gpointer                 user_data);
+
+guint                   _clutter_spatial_index_get_n_items      (ClutterSpatialIndex     *index_);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_SPATIAL_INDEX_H__ */
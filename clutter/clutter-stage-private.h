@@ -26,6 +26,7 @@
 #include <clutter/clutter-stage.h>
 #include <clutter/clutter-input-device.h>
 #include <clutter/clutter-private.h>
+#include <clutter/clutter-spatial-index.h>
 
 #include <cogl/cogl.h>
 
@@ -58,8 +59,13 @@ void                _clutter_stage_get_viewport          (ClutterStage
 void                _clutter_stage_dirty_viewport        (ClutterStage          *stage);
 void                _clutter_stage_maybe_setup_viewport  (ClutterStage          *stage);
 void                _clutter_stage_maybe_relayout        (ClutterActor          *stage);
+void                _clutter_stage_queue_relayout_root   (ClutterStage          *stage,
+                                                          ClutterActor          *actor);
 gboolean            _clutter_stage_needs_update          (ClutterStage          *stage);
 gboolean            _clutter_stage_do_update             (ClutterStage          *stage);
+void                _clutter_stage_begin_frame           (ClutterStage          *stage,
+                                                          gint64                 frame_time,
+                                                          gint64                 timelines_duration);
 
 void     _clutter_stage_queue_event                       (ClutterStage *stage,
 					                   ClutterEvent *event);
@@ -67,6 +73,9 @@ gboolean _clutter_stage_has_queued_events                 (ClutterStage *stage);
 void     _clutter_stage_process_queued_events             (ClutterStage *stage);
 void     _clutter_stage_update_input_devices              (ClutterStage *stage);
 int      _clutter_stage_get_pending_swaps                 (ClutterStage *stage);
+int      _clutter_stage_get_max_pending_swaps             (ClutterStage *stage);
+void     _clutter_stage_presented                         (ClutterStage *stage,
+                                                           gint64        presentation_time);
 gboolean _clutter_stage_has_full_redraw_queued            (ClutterStage *stage);
 
 ClutterActor *_clutter_stage_do_pick (ClutterStage    *stage,
@@ -74,6 +83,15 @@ ClutterActor *_clutter_stage_do_pick (ClutterStage    *stage,
                                       gint             y,
                                       ClutterPickMode  mode);
 
+void          _clutter_stage_log_pick        (ClutterStage        *stage,
+                                              const ClutterVertex *vertices,
+                                              guint                n_vertices,
+                                              ClutterActor        *actor);
+void          _clutter_stage_push_pick_clip  (ClutterStage        *stage,
+                                              const ClutterVertex *vertices,
+                                              guint                n_vertices);
+void          _clutter_stage_pop_pick_clip   (ClutterStage        *stage);
+
 ClutterPaintVolume *_clutter_stage_paint_volume_stack_allocate (ClutterStage *stage);
 void                _clutter_stage_paint_volume_stack_free_all (ClutterStage *stage);
 
@@ -101,6 +119,8 @@ void            _clutter_stage_release_pick_id          (ClutterStage *stage,
 ClutterActor *  _clutter_stage_get_actor_by_pick_id     (ClutterStage *stage,
                                                          gint32        pick_id);
 
+ClutterSpatialIndex *_clutter_stage_get_spatial_index   (ClutterStage *stage);
+
 void            _clutter_stage_add_drag_actor           (ClutterStage       *stage,
                                                          ClutterInputDevice *device,
                                                          ClutterActor       *actor);
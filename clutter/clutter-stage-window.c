@@ -139,6 +139,23 @@ _clutter_stage_window_get_pending_swaps (ClutterStageWindow *window)
   return iface->get_pending_swaps (window);
 }
 
+/* Returns the number of buffers the stage window can swap between;
+ * stage windows that do not know it are assumed to be double buffered
+ */
+int
+_clutter_stage_window_get_swap_chain_length (ClutterStageWindow *window)
+{
+  ClutterStageWindowIface *iface;
+
+  g_return_val_if_fail (CLUTTER_IS_STAGE_WINDOW (window), 2);
+
+  iface = CLUTTER_STAGE_WINDOW_GET_IFACE (window);
+  if (iface->get_swap_chain_length == NULL)
+    return 2;
+
+  return iface->get_swap_chain_length (window);
+}
+
 void
 _clutter_stage_window_add_redraw_clip (ClutterStageWindow    *window,
                                        cairo_rectangle_int_t *stage_clip)
@@ -269,3 +286,19 @@ _clutter_stage_window_can_clip_redraws (ClutterStageWindow *window)
 
   return FALSE;
 }
+
+/* Notifies the stage window that the back buffer was drawn to by
+ * something other than a paint of the stage, like a pick render, so
+ * the next redraw cannot reuse its contents.
+ */
+void
+_clutter_stage_window_dirty_back_buffer (ClutterStageWindow *window)
+{
+  ClutterStageWindowIface *iface;
+
+  g_return_if_fail (CLUTTER_IS_STAGE_WINDOW (window));
+
+  iface = CLUTTER_STAGE_WINDOW_GET_IFACE (window);
+  if (iface->dirty_back_buffer != NULL)
+    iface->dirty_back_buffer (window);
+}
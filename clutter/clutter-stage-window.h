@@ -59,6 +59,7 @@ struct _ClutterStageWindowIface
                                                  cairo_rectangle_int_t *geometry);
 
   int               (* get_pending_swaps)       (ClutterStageWindow *stage_window);
+  int               (* get_swap_chain_length)   (ClutterStageWindow *stage_window);
 
   void              (* add_redraw_clip)         (ClutterStageWindow    *stage_window,
                                                  cairo_rectangle_int_t *stage_rectangle);
@@ -76,6 +77,8 @@ struct _ClutterStageWindowIface
   CoglFramebuffer  *(* get_active_framebuffer)  (ClutterStageWindow *stage_window);
 
   gboolean          (* can_clip_redraws)        (ClutterStageWindow *stage_window);
+
+  void              (* dirty_back_buffer)       (ClutterStageWindow *stage_window);
 };
 
 GType _clutter_stage_window_get_type (void) G_GNUC_CONST;
@@ -104,6 +107,7 @@ void              _clutter_stage_window_resize                  (ClutterStageWin
 void              _clutter_stage_window_get_geometry            (ClutterStageWindow *window,
                                                                  cairo_rectangle_int_t *geometry);
 int               _clutter_stage_window_get_pending_swaps       (ClutterStageWindow *window);
+int               _clutter_stage_window_get_swap_chain_length   (ClutterStageWindow *window);
 
 void              _clutter_stage_window_add_redraw_clip         (ClutterStageWindow    *window,
                                                                  cairo_rectangle_int_t *stage_clip);
@@ -121,6 +125,8 @@ CoglFramebuffer  *_clutter_stage_window_get_active_framebuffer  (ClutterStageWin
 
 gboolean          _clutter_stage_window_can_clip_redraws        (ClutterStageWindow *window);
 
+void              _clutter_stage_window_dirty_back_buffer       (ClutterStageWindow *window);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_STAGE_WINDOW_H__ */
@@ -116,6 +116,43 @@ struct _ClutterStageQueueRedrawEntry
   ClutterPaintVolume clip;
 };
 
+/* A shape logged by an actor during a geometric pick run; the vertices
+ * are stored in stage window coordinates inside the pick_vertices array
+ */
+typedef struct _PickRecord
+{
+  gint32 pick_id;
+
+  /* index of the innermost clip in effect, or -1 */
+  gint clip_index;
+
+  guint first_vertex;
+  guint n_vertices;
+} PickRecord;
+
+typedef struct _PickClipRecord
+{
+  /* index of the enclosing clip, or -1 */
+  gint prev;
+
+  guint first_vertex;
+  guint n_vertices;
+} PickClipRecord;
+
+/* the number of frames remembered for clutter_stage_get_frame_stats() */
+#define N_FRAME_STATS   64
+
+typedef struct _FrameRecord
+{
+  ClutterFrameStats stats;
+
+  /* the time at which the frame was submitted */
+  gint64 swap_time;
+
+  /* the frame is waiting for its swap to complete */
+  guint awaiting_presentation : 1;
+} FrameRecord;
+
 struct _ClutterStagePrivate
 {
   /* the stage implementation */
@@ -144,8 +181,28 @@ struct _ClutterStagePrivate
 
   GList *pending_queue_redraws;
 
+  /* relayout boundaries with a relayout queued by their children;
+   * they are allocated again in place, after the stage relayout
+   */
+  GSList *pending_relayout_roots;
+
   ClutterPickMode pick_buffer_mode;
 
+  /* geometric picking */
+  GArray *pick_records;
+  GArray *pick_clip_records;
+  GArray *pick_vertices;
+  gint pick_clip_top;
+
+  /* the stage paint boxes of the actors */
+  ClutterSpatialIndex *spatial_index;
+  guint spatial_stamp;
+
+  /* the pixel being picked, if the pick paint can be restricted
+   * to the actors around it
+   */
+  ClutterActorBox pick_region;
+
   CoglFramebuffer *active_framebuffer;
 
   GHashTable *devices;
@@ -153,6 +210,16 @@ struct _ClutterStagePrivate
   GTimer *fps_timer;
   gint32 timer_n_frames;
 
+  /* the timings of the last frames, as a ring buffer; frame_index is
+   * the slot of the next frame, and n_frames the number of valid slots
+   */
+  FrameRecord frames[N_FRAME_STATS];
+  guint frame_index;
+  guint n_frames;
+
+  /* the timings of the frame being produced */
+  ClutterFrameStats current_frame;
+
   ClutterIDPool *pick_id_pool;
 
 #ifdef CLUTTER_ENABLE_DEBUG
@@ -176,6 +243,8 @@ struct _ClutterStagePrivate
   guint accept_focus           : 1;
   guint motion_events_enabled  : 1;
   guint has_custom_perspective : 1;
+  guint use_geometric_picking  : 1;
+  guint has_pick_region        : 1;
 };
 
 enum
@@ -194,7 +263,8 @@ enum
   PROP_USE_ALPHA,
   PROP_KEY_FOCUS,
   PROP_NO_CLEAR_HINT,
-  PROP_ACCEPT_FOCUS
+  PROP_ACCEPT_FOCUS,
+  PROP_GEOMETRIC_PICKING
 };
 
 enum
@@ -608,6 +678,54 @@ _clutter_stage_update_active_framebuffer (ClutterStage *stage)
     priv->active_framebuffer = cogl_get_draw_framebuffer ();
 }
 
+static gboolean
+clutter_stage_mark_spatial_candidate (gpointer data,
+                                      gpointer user_data)
+{
+  _clutter_actor_mark_spatial_candidate (data, GPOINTER_TO_UINT (user_data));
+
+  return TRUE;
+}
+
+/* Marks all the actors that might intersect @region, and starts a
+ * paint run that only traverses the marked actors
+ */
+static void
+clutter_stage_begin_spatial_traversal (ClutterStage          *stage,
+                                       const ClutterActorBox *region)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  CLUTTER_STATIC_TIMER (spatial_query_timer,
+                        "Painting actors", /* parent */
+                        "Spatial query",
+                        "The time spent querying the spatial index",
+                        0 /* no application private data */);
+
+  CLUTTER_TIMER_START (_clutter_uprof_context, spatial_query_timer);
+
+  /* 0 is reserved for "no query" */
+  priv->spatial_stamp += 1;
+  if (priv->spatial_stamp == 0)
+    priv->spatial_stamp = 1;
+
+  CLUTTER_NOTE (CLIPPING, "Querying %u actors in the spatial index: "
+                "x=%.2f, y=%.2f, width=%.2f, height=%.2f",
+                _clutter_spatial_index_get_n_items (priv->spatial_index),
+                region->x1, region->y1,
+                region->x2 - region->x1,
+                region->y2 - region->y1);
+
+  _clutter_spatial_index_query_box (priv->spatial_index, region,
+                                    clutter_stage_mark_spatial_candidate,
+                                    GUINT_TO_POINTER (priv->spatial_stamp));
+
+  _clutter_actor_begin_spatial_traversal (CLUTTER_ACTOR (stage),
+                                          priv->spatial_stamp);
+
+  CLUTTER_TIMER_STOP (_clutter_uprof_context, spatial_query_timer);
+}
+
 /* This provides a common point of entry for painting the scenegraph
  * for picking or painting...
  *
@@ -623,6 +741,8 @@ _clutter_stage_do_paint (ClutterStage                *stage,
   ClutterStagePrivate *priv = stage->priv;
   float clip_poly[8];
   cairo_rectangle_int_t geom;
+  ClutterActorBox region;
+  gboolean use_spatial_index;
 
   _clutter_stage_window_get_geometry (priv->impl, &geom);
 
@@ -662,9 +782,41 @@ _clutter_stage_do_paint (ClutterStage                *stage,
                                              &priv->inverse_projection,
                                              priv->current_clip_planes);
 
+  /* a full paint has to visit every actor anyway, while a clipped
+   * paint, or a pick around a single pixel, can use the spatial index
+   * to avoid traversing the actors outside of the region
+   */
+  use_spatial_index = FALSE;
+  if (G_LIKELY (!(clutter_paint_debug_flags & CLUTTER_DEBUG_DISABLE_CULLING)))
+    {
+      if (_clutter_context_get_pick_mode () != CLUTTER_PICK_NONE)
+        {
+          if (priv->has_pick_region)
+            {
+              region = priv->pick_region;
+              use_spatial_index = TRUE;
+            }
+        }
+      else if (clip != NULL)
+        {
+          region.x1 = clip_poly[0];
+          region.y1 = clip_poly[1];
+          region.x2 = clip_poly[2];
+          region.y2 = clip_poly[5];
+          use_spatial_index = TRUE;
+        }
+    }
+
   _clutter_stage_paint_volume_stack_free_all (stage);
   _clutter_stage_update_active_framebuffer (stage);
+
+  if (use_spatial_index)
+    clutter_stage_begin_spatial_traversal (stage, &region);
+
   clutter_actor_paint (CLUTTER_ACTOR (stage));
+
+  if (use_spatial_index)
+    _clutter_actor_end_spatial_traversal ();
 }
 
 static void
@@ -966,6 +1118,7 @@ _clutter_stage_process_queued_events (ClutterStage *stage)
 {
   ClutterStagePrivate *priv;
   GList *events, *l;
+  gint64 start;
 
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
@@ -974,6 +1127,8 @@ _clutter_stage_process_queued_events (ClutterStage *stage)
   if (priv->event_queue->length == 0)
     return;
 
+  start = g_get_monotonic_time ();
+
   /* In case the stage gets destroyed during event processing */
   g_object_ref (stage);
 
@@ -1028,6 +1183,8 @@ _clutter_stage_process_queued_events (ClutterStage *stage)
 
   g_list_free (events);
 
+  priv->current_frame.events_duration += g_get_monotonic_time () - start;
+
   g_object_unref (stage);
 }
 
@@ -1094,11 +1251,50 @@ _clutter_stage_maybe_relayout (ClutterActor *actor)
       clutter_actor_allocate (CLUTTER_ACTOR (stage),
                               &box, CLUTTER_ALLOCATION_NONE);
 
+      /* the boundaries that were not reached by the allocation of
+       * their parents are allocated again using their current box
+       */
+      if (priv->pending_relayout_roots != NULL)
+        {
+          GSList *roots, *l;
+
+          roots = g_slist_reverse (priv->pending_relayout_roots);
+          priv->pending_relayout_roots = NULL;
+
+          for (l = roots; l != NULL; l = l->next)
+            {
+              _clutter_actor_allocate_relayout_root (l->data);
+              g_object_unref (l->data);
+            }
+
+          g_slist_free (roots);
+        }
+
       CLUTTER_UNSET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
       CLUTTER_TIMER_STOP (_clutter_uprof_context, relayout_timer);
     }
 }
 
+/*< private >
+ * _clutter_stage_queue_relayout_root:
+ * @stage: a #ClutterStage
+ * @actor: a relayout boundary inside @stage
+ *
+ * Queues a relayout of @stage that only allocates @actor again, using
+ * its current allocation, instead of going through all its ancestors.
+ */
+void
+_clutter_stage_queue_relayout_root (ClutterStage *stage,
+                                    ClutterActor *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  priv->pending_relayout_roots =
+    g_slist_prepend (priv->pending_relayout_roots, g_object_ref (actor));
+
+  priv->relayout_pending = TRUE;
+}
+
 static gboolean
 _clutter_stage_get_pick_buffer_valid (ClutterStage *stage, ClutterPickMode mode)
 {
@@ -1188,6 +1384,45 @@ clutter_stage_do_redraw (ClutterStage *stage)
                 stage);
 }
 
+/*< private >
+ * _clutter_stage_begin_frame:
+ * @stage: a #ClutterStage
+ * @frame_time: the time of the master clock for the frame, in usecs
+ * @timelines_duration: the time spent advancing the timelines, in usecs
+ *
+ * Called by the master clock before updating @stage, to fill out the
+ * timings of the frame that are not measured by the stage itself.
+ */
+void
+_clutter_stage_begin_frame (ClutterStage *stage,
+                            gint64        frame_time,
+                            gint64        timelines_duration)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  priv->current_frame.frame_time = frame_time;
+  priv->current_frame.timelines_duration = timelines_duration;
+}
+
+static void
+clutter_stage_commit_frame (ClutterStage *stage,
+                            gint64        swap_time,
+                            gboolean      awaiting_presentation)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  FrameRecord *record;
+
+  record = &priv->frames[priv->frame_index];
+  record->stats = priv->current_frame;
+  record->swap_time = swap_time;
+  record->awaiting_presentation = awaiting_presentation;
+
+  priv->frame_index = (priv->frame_index + 1) % N_FRAME_STATS;
+  priv->n_frames = MIN (priv->n_frames + 1, N_FRAME_STATS);
+
+  memset (&priv->current_frame, 0, sizeof (ClutterFrameStats));
+}
+
 /**
  * _clutter_stage_do_update:
  * @stage: A #ClutterStage
@@ -1200,6 +1435,8 @@ gboolean
 _clutter_stage_do_update (ClutterStage *stage)
 {
   ClutterStagePrivate *priv = stage->priv;
+  gint64 start, end;
+  int pending_swaps;
 
   /* if the stage is being destroyed, or if the destruction already
    * happened and we don't have an StageWindow any more, then we
@@ -1215,15 +1452,29 @@ _clutter_stage_do_update (ClutterStage *stage)
    * check or clear the pending redraws flag since a relayout may
    * queue a redraw.
    */
+  start = g_get_monotonic_time ();
   _clutter_stage_maybe_relayout (CLUTTER_ACTOR (stage));
+  priv->current_frame.relayout_duration += g_get_monotonic_time () - start;
 
   if (!priv->redraw_pending)
     return FALSE;
 
+  pending_swaps = _clutter_stage_get_pending_swaps (stage);
+  start = g_get_monotonic_time ();
+
   _clutter_stage_maybe_finish_queue_redraws (stage);
 
   clutter_stage_do_redraw (stage);
 
+  end = g_get_monotonic_time ();
+  priv->current_frame.paint_duration = end - start;
+
+  /* if the swap of the frame is still in progress, then its
+   * presentation time will be filled out once it completes
+   */
+  clutter_stage_commit_frame (stage, end,
+                              _clutter_stage_get_pending_swaps (stage) > pending_swaps);
+
   /* reset the guard, so that new redraws are possible */
   priv->redraw_pending = FALSE;
 
@@ -1400,6 +1651,296 @@ read_pixels_to_file (char *filename_stem,
   read_count++;
 }
 
+static void
+clutter_stage_clear_pick_stack (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  g_array_set_size (priv->pick_records, 0);
+  g_array_set_size (priv->pick_clip_records, 0);
+  g_array_set_size (priv->pick_vertices, 0);
+  priv->pick_clip_top = -1;
+}
+
+static guint
+clutter_stage_append_pick_vertices (ClutterStage        *stage,
+                                    const ClutterVertex *vertices,
+                                    guint                n_vertices)
+{
+  GArray *pick_vertices = stage->priv->pick_vertices;
+  guint first_vertex = pick_vertices->len;
+
+  g_array_append_vals (pick_vertices, vertices, n_vertices);
+
+  return first_vertex;
+}
+
+/*< private >
+ * _clutter_stage_log_pick:
+ * @stage: a #ClutterStage
+ * @vertices: the vertices of a polygon, in stage window coordinates
+ * @n_vertices: the number of @vertices
+ * @actor: the #ClutterActor owning the polygon
+ *
+ * Records the outline of @actor while performing a geometric pick,
+ * together with the clip currently in effect.
+ */
+void
+_clutter_stage_log_pick (ClutterStage        *stage,
+                         const ClutterVertex *vertices,
+                         guint                n_vertices,
+                         ClutterActor        *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  PickRecord rec;
+
+  g_assert (n_vertices >= 3);
+
+  rec.pick_id = _clutter_actor_get_pick_id (actor);
+  rec.clip_index = priv->pick_clip_top;
+  rec.n_vertices = n_vertices;
+  rec.first_vertex =
+    clutter_stage_append_pick_vertices (stage, vertices, n_vertices);
+
+  g_array_append_val (priv->pick_records, rec);
+}
+
+/*< private >
+ * _clutter_stage_push_pick_clip:
+ * @stage: a #ClutterStage
+ * @vertices: the vertices of the clip polygon, in stage window coordinates
+ * @n_vertices: the number of @vertices
+ *
+ * Pushes a clip polygon while performing a geometric pick; every
+ * shape logged with _clutter_stage_log_pick() until the matching call
+ * to _clutter_stage_pop_pick_clip() will be limited by it.
+ */
+void
+_clutter_stage_push_pick_clip (ClutterStage        *stage,
+                               const ClutterVertex *vertices,
+                               guint                n_vertices)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  PickClipRecord clip;
+
+  g_assert (n_vertices >= 3);
+
+  clip.prev = priv->pick_clip_top;
+  clip.n_vertices = n_vertices;
+  clip.first_vertex =
+    clutter_stage_append_pick_vertices (stage, vertices, n_vertices);
+
+  g_array_append_val (priv->pick_clip_records, clip);
+  priv->pick_clip_top = priv->pick_clip_records->len - 1;
+}
+
+void
+_clutter_stage_pop_pick_clip (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  const PickClipRecord *clip;
+
+  g_assert (priv->pick_clip_top >= 0);
+
+  clip = &g_array_index (priv->pick_clip_records,
+                         PickClipRecord,
+                         priv->pick_clip_top);
+
+  /* the clip records are kept around, since the pick records logged
+   * while the clip was active still reference it
+   */
+  priv->pick_clip_top = clip->prev;
+}
+
+/* even-odd crossing test; works for both convex and concave polygons,
+ * regardless of their winding
+ */
+static gboolean
+pick_polygon_contains_point (const ClutterVertex *vertices,
+                             guint                n_vertices,
+                             float                x,
+                             float                y)
+{
+  gboolean inside = FALSE;
+  guint i, j;
+
+  for (i = 0, j = n_vertices - 1; i < n_vertices; j = i++)
+    {
+      const ClutterVertex *a = &vertices[i];
+      const ClutterVertex *b = &vertices[j];
+
+      if (((a->y > y) != (b->y > y)) &&
+          (x < (b->x - a->x) * (y - a->y) / (b->y - a->y) + a->x))
+        inside = !inside;
+    }
+
+  return inside;
+}
+
+static gboolean
+pick_record_contains_point (ClutterStage     *stage,
+                            const PickRecord *rec,
+                            float             x,
+                            float             y)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  const ClutterVertex *vertices;
+  gint clip_index;
+
+  vertices = &g_array_index (priv->pick_vertices,
+                             ClutterVertex,
+                             rec->first_vertex);
+
+  if (!pick_polygon_contains_point (vertices, rec->n_vertices, x, y))
+    return FALSE;
+
+  clip_index = rec->clip_index;
+  while (clip_index >= 0)
+    {
+      const PickClipRecord *clip;
+
+      clip = &g_array_index (priv->pick_clip_records,
+                             PickClipRecord,
+                             clip_index);
+      vertices = &g_array_index (priv->pick_vertices,
+                                 ClutterVertex,
+                                 clip->first_vertex);
+
+      if (!pick_polygon_contains_point (vertices, clip->n_vertices, x, y))
+        return FALSE;
+
+      clip_index = clip->prev;
+    }
+
+  return TRUE;
+}
+
+/* Restricts the next pick paint to the actors whose paint box,
+ * according to the spatial index, might contain the given pixel
+ */
+static void
+clutter_stage_set_pick_region (ClutterStage *stage,
+                               gint          x,
+                               gint          y)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  priv->pick_region.x1 = x;
+  priv->pick_region.y1 = y;
+  priv->pick_region.x2 = x + 1;
+  priv->pick_region.y2 = y + 1;
+  priv->has_pick_region = TRUE;
+}
+
+/* Picks using the shapes logged by the pick() implementations of
+ * each actor instead of rendering them and reading back the result;
+ * this avoids any GPU round-trip.
+ */
+static ClutterActor *
+clutter_stage_do_geometric_pick (ClutterStage    *stage,
+                                 gint             x,
+                                 gint             y,
+                                 ClutterPickMode  mode)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterMainContext *context;
+  float pick_x, pick_y;
+  gint i;
+  CLUTTER_STATIC_TIMER (pick_log,
+                        "Picking", /* parent */
+                        "Logging actors (geometric pick)",
+                        "The time spent collecting the pick geometry",
+                        0 /* no application private data */);
+  CLUTTER_STATIC_TIMER (pick_hit_test,
+                        "Picking", /* parent */
+                        "Hit testing (geometric pick)",
+                        "The time spent hit testing the pick geometry",
+                        0 /* no application private data */);
+
+  context = _clutter_context_get_default ();
+
+  /* the geometry of a full traversal remains valid until the scene
+   * changes, just like a full pick buffer
+   */
+  if (!_clutter_stage_get_pick_buffer_valid (stage, mode))
+    {
+      gboolean is_restricted;
+
+      priv->picks_per_frame++;
+
+      /* like the clipped pick, the first pick after a change only
+       * logs the actors around the pixel, using the spatial index
+       */
+      is_restricted = priv->picks_per_frame < 2;
+
+      CLUTTER_NOTE (PICK, "Performing %s geometric pick at %i,%i",
+                    is_restricted ? "restricted" : "full",
+                    x, y);
+
+      _clutter_backend_ensure_context (context->backend, stage);
+
+      /* needed for when a context switch happens */
+      _clutter_stage_maybe_setup_viewport (stage);
+
+      clutter_stage_clear_pick_stack (stage);
+
+      if (is_restricted)
+        clutter_stage_set_pick_region (stage, x, y);
+
+      CLUTTER_TIMER_START (_clutter_uprof_context, pick_log);
+      context->pick_mode = mode;
+      context->geometric_pick = TRUE;
+      _clutter_stage_do_paint (stage, NULL);
+      context->geometric_pick = FALSE;
+      context->pick_mode = CLUTTER_PICK_NONE;
+      CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_log);
+
+      priv->has_pick_region = FALSE;
+
+      if (is_restricted)
+        _clutter_stage_set_pick_buffer_valid (stage, FALSE, -1);
+      else
+        _clutter_stage_set_pick_buffer_valid (stage, TRUE, mode);
+    }
+  else
+    CLUTTER_NOTE (PICK, "Reusing pick geometry from previous pick to fetch "
+                  "actor at %i,%i", x, y);
+
+  /* sample at the center of the pixel */
+  pick_x = x + 0.5f;
+  pick_y = y + 0.5f;
+
+  CLUTTER_TIMER_START (_clutter_uprof_context, pick_hit_test);
+
+  /* the records are logged in paint order, so the topmost shape
+   * is the last one
+   */
+  for (i = (gint) priv->pick_records->len - 1; i >= 0; i--)
+    {
+      const PickRecord *rec;
+      ClutterActor *actor;
+
+      rec = &g_array_index (priv->pick_records, PickRecord, i);
+
+      if (!pick_record_contains_point (stage, rec, pick_x, pick_y))
+        continue;
+
+      /* the actor might have been destroyed since the pick geometry
+       * was collected; keep looking underneath it, in that case
+       */
+      actor = _clutter_stage_get_actor_by_pick_id (stage, rec->pick_id);
+      if (actor != NULL)
+        {
+          CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_hit_test);
+          return actor;
+        }
+    }
+
+  CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_hit_test);
+
+  return CLUTTER_ACTOR (stage);
+}
+
 ClutterActor *
 _clutter_stage_do_pick (ClutterStage   *stage,
                         gint            x,
@@ -1414,6 +1955,7 @@ _clutter_stage_do_pick (ClutterStage   *stage,
   CoglFramebuffer *fb;
   ClutterActor *actor;
   gboolean is_clipped;
+  gint64 start;
   CLUTTER_STATIC_COUNTER (do_pick_counter,
                           "_clutter_stage_do_pick counter",
                           "Increments for each full pick run",
@@ -1454,9 +1996,17 @@ _clutter_stage_do_pick (ClutterStage   *stage,
   CLUTTER_COUNTER_INC (_clutter_uprof_context, do_pick_counter);
   CLUTTER_TIMER_START (_clutter_uprof_context, pick_timer);
 
+  start = g_get_monotonic_time ();
+
   context = _clutter_context_get_default ();
   clutter_stage_ensure_current (stage);
 
+  if (priv->use_geometric_picking)
+    {
+      actor = clutter_stage_do_geometric_pick (stage, x, y, mode);
+      goto done;
+    }
+
   /* It's possible that we currently have a static scene and have renderered a
    * full, unclipped pick buffer. If so we can simply continue to read from
    * this cached buffer until the scene next changes. */
@@ -1505,6 +2055,10 @@ _clutter_stage_do_pick (ClutterStage   *stage,
 	      COGL_BUFFER_BIT_DEPTH);
   CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_clear);
 
+  /* the pick colours will stay in the back buffer until the next
+   * redraw paints over them */
+  _clutter_stage_window_dirty_back_buffer (priv->impl);
+
   /* Disable dithering (if any) when doing the painting in pick mode */
   fb = cogl_get_draw_framebuffer ();
   dither_enabled_save = cogl_framebuffer_get_dither_enabled (fb);
@@ -1514,9 +2068,12 @@ _clutter_stage_do_pick (ClutterStage   *stage,
    * are drawn offscreen (as we never swap buffers)
   */
   CLUTTER_TIMER_START (_clutter_uprof_context, pick_paint);
+  if (is_clipped)
+    clutter_stage_set_pick_region (stage, x, y);
   context->pick_mode = mode;
   _clutter_stage_do_paint (stage, NULL);
   context->pick_mode = CLUTTER_PICK_NONE;
+  priv->has_pick_region = FALSE;
   CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_paint);
 
   if (is_clipped)
@@ -1573,6 +2130,10 @@ check_pixel:
       actor = _clutter_get_actor_by_id (stage, id_);
     }
 
+done:
+  priv->current_frame.pick_duration += g_get_monotonic_time () - start;
+  priv->current_frame.n_picks += 1;
+
   CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_timer);
 
 #ifdef CLUTTER_ENABLE_PROFILE
@@ -1705,6 +2266,10 @@ clutter_stage_set_property (GObject      *object,
       clutter_stage_set_accept_focus (stage, g_value_get_boolean (value));
       break;
 
+    case PROP_GEOMETRIC_PICKING:
+      clutter_stage_set_geometric_picking (stage, g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1784,6 +2349,10 @@ clutter_stage_get_property (GObject    *gobject,
       g_value_set_boolean (value, priv->accept_focus);
       break;
 
+    case PROP_GEOMETRIC_PICKING:
+      g_value_set_boolean (value, priv->use_geometric_picking);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -1821,6 +2390,21 @@ clutter_stage_dispose (GObject *object)
 
   clutter_actor_remove_all_children (CLUTTER_ACTOR (object));
 
+  /* the boundaries are not inside the stage any more, so this will
+   * only reset their state
+   */
+  while (priv->pending_relayout_roots != NULL)
+    {
+      ClutterActor *root = priv->pending_relayout_roots->data;
+
+      priv->pending_relayout_roots =
+        g_slist_delete_link (priv->pending_relayout_roots,
+                             priv->pending_relayout_roots);
+
+      _clutter_actor_allocate_relayout_root (root);
+      g_object_unref (root);
+    }
+
   G_OBJECT_CLASS (clutter_stage_parent_class)->dispose (object);
 }
 
@@ -1837,6 +2421,12 @@ clutter_stage_finalize (GObject *object)
 
   g_array_free (priv->paint_volume_stack, TRUE);
 
+  g_array_free (priv->pick_records, TRUE);
+  g_array_free (priv->pick_clip_records, TRUE);
+  g_array_free (priv->pick_vertices, TRUE);
+
+  _clutter_spatial_index_free (priv->spatial_index);
+
   g_hash_table_destroy (priv->devices);
 
   _clutter_id_pool_free (priv->pick_id_pool);
@@ -1875,6 +2465,7 @@ clutter_stage_class_init (ClutterStageClass *klass)
   actor_class->queue_relayout = clutter_stage_real_queue_relayout;
   actor_class->queue_redraw = clutter_stage_real_queue_redraw;
   actor_class->apply_transform = clutter_stage_real_apply_transform;
+  _clutter_actor_class_set_cacheable_transform (actor_class);
 
   /**
    * ClutterStage:fullscreen:
@@ -2087,6 +2678,24 @@ clutter_stage_class_init (ClutterStageClass *klass)
                                 CLUTTER_PARAM_READWRITE);
   g_object_class_install_property (gobject_class, PROP_ACCEPT_FOCUS, pspec);
 
+  /**
+   * ClutterStage:geometric-picking:
+   *
+   * Whether the #ClutterStage should pick actors by hit testing the
+   * shapes they log in their #ClutterActorClass.pick() implementation,
+   * instead of rendering them and reading back the result.
+   *
+   * See clutter_stage_set_geometric_picking() for further information.
+   *
+   * Since: 1.12
+   */
+  pspec = g_param_spec_boolean ("geometric-picking",
+                                P_("Geometric Picking"),
+                                P_("Whether the stage should pick actors without reading back from the GPU"),
+                                FALSE,
+                                CLUTTER_PARAM_READWRITE);
+  g_object_class_install_property (gobject_class, PROP_GEOMETRIC_PICKING, pspec);
+
   /**
    * ClutterStage::fullscreen:
    * @stage: the stage which was fullscreened
@@ -2303,6 +2912,13 @@ clutter_stage_init (ClutterStage *self)
   priv->paint_volume_stack =
     g_array_new (FALSE, FALSE, sizeof (ClutterPaintVolume));
 
+  priv->pick_records = g_array_new (FALSE, FALSE, sizeof (PickRecord));
+  priv->pick_clip_records = g_array_new (FALSE, FALSE, sizeof (PickClipRecord));
+  priv->pick_vertices = g_array_new (FALSE, FALSE, sizeof (ClutterVertex));
+  priv->pick_clip_top = -1;
+
+  priv->spatial_index = _clutter_spatial_index_new ();
+
   priv->devices = g_hash_table_new (NULL, NULL);
 
   priv->pick_id_pool = _clutter_id_pool_new (256);
@@ -3522,6 +4138,9 @@ _clutter_stage_maybe_setup_viewport (ClutterStage *stage)
                                           priv->viewport[2],
                                           priv->viewport[3]);
 
+      /* the view matrix is part of the stage transformation */
+      _clutter_actor_invalidate_transform (CLUTTER_ACTOR (stage));
+
       priv->dirty_viewport = FALSE;
     }
 
@@ -3837,6 +4456,69 @@ _clutter_stage_get_pending_swaps (ClutterStage *stage)
   return _clutter_stage_window_get_pending_swaps (stage_window);
 }
 
+/*< private >
+ * _clutter_stage_get_max_pending_swaps:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the number of frames of @stage that can be waiting for
+ * a swap to complete before the stage should stop drawing; a swap
+ * chain of N buffers can hold N - 1 frames in flight.
+ *
+ * Return value: the maximum number of pending swaps, at least 1
+ */
+int
+_clutter_stage_get_max_pending_swaps (ClutterStage *stage)
+{
+  ClutterStageWindow *stage_window;
+
+  stage_window = _clutter_stage_get_window (stage);
+  if (stage_window == NULL)
+    return 1;
+
+  return MAX (_clutter_stage_window_get_swap_chain_length (stage_window) - 1, 1);
+}
+
+/*< private >
+ * _clutter_stage_presented:
+ * @stage: a #ClutterStage
+ * @presentation_time: the monotonic time at which the frame was
+ *   presented, in usecs
+ *
+ * Called by the stage implementation when the swap of a frame of
+ * @stage has been completed.
+ */
+void
+_clutter_stage_presented (ClutterStage *stage,
+                          gint64        presentation_time)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterMasterClock *master_clock;
+  guint i;
+
+  /* swaps complete in order, so the oldest frame still waiting is
+   * the one that has been presented
+   */
+  for (i = priv->n_frames; i > 0; i--)
+    {
+      FrameRecord *record;
+
+      record = &priv->frames[(priv->frame_index + N_FRAME_STATS - i)
+                             % N_FRAME_STATS];
+
+      if (record->awaiting_presentation)
+        {
+          record->stats.presentation_time = presentation_time;
+          record->stats.swap_wait_duration =
+            presentation_time - record->swap_time;
+          record->awaiting_presentation = FALSE;
+          break;
+        }
+    }
+
+  master_clock = _clutter_master_clock_get_default ();
+  _clutter_master_clock_presented (master_clock, presentation_time);
+}
+
 /**
  * clutter_stage_set_no_clear_hint:
  * @stage: a #ClutterStage
@@ -4155,6 +4837,114 @@ clutter_stage_get_accept_focus (ClutterStage *stage)
   return stage->priv->accept_focus;
 }
 
+/**
+ * clutter_stage_set_geometric_picking:
+ * @stage: a #ClutterStage
+ * @geometric_picking: %TRUE to pick without reading back from the GPU
+ *
+ * Sets whether @stage should use geometric picking.
+ *
+ * By default, picking renders every actor using a unique color and
+ * then reads back the color of the pixel under the pointer; this
+ * requires waiting for the GPU to finish rendering.
+ *
+ * When geometric picking is enabled, the actors log the shapes that
+ * they would otherwise paint in pick mode, and the stage hit tests
+ * them in software. The default #ClutterActorClass.pick()
+ * implementation logs the allocation of the actor; actors overriding
+ * the pick() virtual function should use clutter_actor_pick_box() or
+ * clutter_actor_pick_polygon() instead of drawing, otherwise they
+ * will not be pickable while geometric picking is enabled.
+ *
+ * Since: 1.12
+ */
+void
+clutter_stage_set_geometric_picking (ClutterStage *stage,
+                                     gboolean      geometric_picking)
+{
+  ClutterStagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  geometric_picking = !!geometric_picking;
+
+  priv = stage->priv;
+
+  if (priv->use_geometric_picking != geometric_picking)
+    {
+      priv->use_geometric_picking = geometric_picking;
+
+      _clutter_stage_set_pick_buffer_valid (stage, FALSE, -1);
+      clutter_stage_clear_pick_stack (stage);
+
+      g_object_notify (G_OBJECT (stage), "geometric-picking");
+    }
+}
+
+/**
+ * clutter_stage_get_geometric_picking:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the value set with clutter_stage_set_geometric_picking().
+ *
+ * Return value: %TRUE if the #ClutterStage uses geometric picking
+ *
+ * Since: 1.12
+ */
+gboolean
+clutter_stage_get_geometric_picking (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+
+  return stage->priv->use_geometric_picking;
+}
+
+/**
+ * clutter_stage_get_frame_stats:
+ * @stage: a #ClutterStage
+ * @stats: (out caller-allocates) (array length=n_stats): an array of
+ *   #ClutterFrameStats
+ * @n_stats: the number of elements of @stats
+ *
+ * Retrieves the timings of the last frames drawn by @stage, starting
+ * from the most recent one.
+ *
+ * The stage remembers the timings of a limited number of frames, so
+ * this function should be called periodically, for instance from a
+ * repaint function added with clutter_threads_add_repaint_func_full()
+ * and the %CLUTTER_REPAINT_FLAGS_POST_PAINT flag. The presentation
+ * time of the most recent frames might not be known yet.
+ *
+ * Return value: the number of elements of @stats that were filled
+ *
+ * Since: 1.12
+ */
+guint
+clutter_stage_get_frame_stats (ClutterStage      *stage,
+                               ClutterFrameStats *stats,
+                               guint              n_stats)
+{
+  ClutterStagePrivate *priv;
+  guint i;
+
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), 0);
+  g_return_val_if_fail (stats != NULL || n_stats == 0, 0);
+
+  priv = stage->priv;
+
+  n_stats = MIN (n_stats, priv->n_frames);
+
+  for (i = 0; i < n_stats; i++)
+    {
+      guint index_ = (priv->frame_index + N_FRAME_STATS - 1 - i)
+                   % N_FRAME_STATS;
+
+      stats[i] = priv->frames[index_].stats;
+    }
+
+  return n_stats;
+}
+
 void
 _clutter_stage_add_device (ClutterStage       *stage,
                            ClutterInputDevice *device)
@@ -4298,6 +5088,12 @@ _clutter_stage_get_actor_by_pick_id (ClutterStage *stage,
   return _clutter_id_pool_lookup (priv->pick_id_pool, pick_id);
 }
 
+ClutterSpatialIndex *
+_clutter_stage_get_spatial_index (ClutterStage *stage)
+{
+  return stage->priv->spatial_index;
+}
+
 void
 _clutter_stage_add_drag_actor (ClutterStage       *stage,
                                ClutterInputDevice *device,
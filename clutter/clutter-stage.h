@@ -135,6 +135,48 @@ struct _ClutterFog
   gfloat z_far;
 };
 
+/**
+ * ClutterFrameStats:
+ * @frame_time: the time of the master clock at the start of the frame,
+ *   in microseconds
+ * @events_duration: the time spent processing the events of the stage
+ *   since the previous frame, in microseconds
+ * @timelines_duration: the time spent advancing the timelines for the
+ *   frame, in microseconds
+ * @relayout_duration: the time spent in the relayout of the stage, in
+ *   microseconds
+ * @paint_duration: the time spent painting the stage and submitting the
+ *   frame, in microseconds
+ * @pick_duration: the time spent picking since the previous frame, in
+ *   microseconds
+ * @n_picks: the number of picks since the previous frame
+ * @swap_wait_duration: the time between the submission of the frame and
+ *   the completion of its swap, in microseconds, or 0 if unknown
+ * @presentation_time: the monotonic time at which the frame was
+ *   presented, in microseconds, or 0 if unknown
+ *
+ * Timing information about a frame drawn by a #ClutterStage.
+ *
+ * All the times are in the time base of g_get_monotonic_time().
+ *
+ * Since: 1.12
+ */
+struct _ClutterFrameStats
+{
+  gint64 frame_time;
+
+  gint64 events_duration;
+  gint64 timelines_duration;
+  gint64 relayout_duration;
+  gint64 paint_duration;
+
+  gint64 pick_duration;
+  guint n_picks;
+
+  gint64 swap_wait_duration;
+  gint64 presentation_time;
+};
+
 GType clutter_perspective_get_type (void) G_GNUC_CONST;
 GType clutter_fog_get_type (void) G_GNUC_CONST;
 GType clutter_stage_get_type (void) G_GNUC_CONST;
@@ -182,6 +224,15 @@ gboolean        clutter_stage_get_motion_events_enabled         (ClutterStage
 void            clutter_stage_set_accept_focus                  (ClutterStage          *stage,
                                                                  gboolean               accept_focus);
 gboolean        clutter_stage_get_accept_focus                  (ClutterStage          *stage);
+CLUTTER_AVAILABLE_IN_1_12
+void            clutter_stage_set_geometric_picking             (ClutterStage          *stage,
+                                                                 gboolean               geometric_picking);
+CLUTTER_AVAILABLE_IN_1_12
+gboolean        clutter_stage_get_geometric_picking             (ClutterStage          *stage);
+CLUTTER_AVAILABLE_IN_1_12
+guint           clutter_stage_get_frame_stats                   (ClutterStage          *stage,
+                                                                 ClutterFrameStats     *stats,
+                                                                 guint                  n_stats);
 gboolean        clutter_stage_event                             (ClutterStage          *stage,
                                                                  ClutterEvent          *event);
 
@@ -23,7 +23,7 @@
 #include "config.h"
 #endif
 
-#include "clutter-text-buffer.h"
+#include "clutter-text-buffer-private.h"
 #include "clutter-marshal.h"
 #include "clutter-private.h"
 
@@ -52,6 +52,9 @@
 /* Initial size of buffer, in bytes */
 #define MIN_SIZE 16
 
+/* Distance, in characters, between the entries of the offset index */
+#define INDEX_STEP 1024
+
 enum {
   PROP_0,
   PROP_TEXT,
@@ -75,10 +78,29 @@ struct _ClutterTextBufferPrivate
   gint  max_length;
 
   /* Only valid if this class is not derived */
+
+  /* the text is stored in a gap buffer, laid out as:
+   *
+   *   [text before the gap][gap][text after the gap]['\0']
+   *
+   * the gap is moved where the text is edited, so that insertions and
+   * deletions only move the bytes between the previous edit and the
+   * new one; the gap is always filled with zeros
+   */
   gchar *normal_text;
   gsize  normal_text_size;
   gsize  normal_text_bytes;
   guint  normal_text_chars;
+
+  gsize  normal_gap_start;
+  gsize  normal_gap_end;
+  guint  normal_gap_chars;
+
+  /* the byte offset, ignoring the gap, of every INDEX_STEP-th character;
+   * the entries are dropped when the text before them changes, and are
+   * rebuilt lazily
+   */
+  GArray *normal_index;
 };
 
 G_DEFINE_TYPE (ClutterTextBuffer, clutter_text_buffer, G_TYPE_OBJECT);
@@ -101,15 +123,234 @@ trash_area (gchar *area,
     *varea++ = 0;
 }
 
+/* Moves the gap to the byte offset @at, which is @position characters
+ * from the start of the text; only the bytes between the current gap
+ * and @at are moved, and their old copies are trashed.
+ */
+static void
+clutter_text_buffer_normal_move_gap (ClutterTextBufferPrivate *pv,
+                                     gsize                     at,
+                                     guint                     position)
+{
+  gchar *text = pv->normal_text;
+  gsize gap_size = pv->normal_gap_end - pv->normal_gap_start;
+  gsize len;
+
+  if (at < pv->normal_gap_start)
+    {
+      /* move the text between @at and the gap after the gap */
+      len = pv->normal_gap_start - at;
+
+      g_memmove (text + pv->normal_gap_end - len, text + at, len);
+      trash_area (text + at, MIN (len, gap_size));
+    }
+  else if (at > pv->normal_gap_start)
+    {
+      /* move the text between the gap and @at before the gap */
+      len = at - pv->normal_gap_start;
+
+      g_memmove (text + pv->normal_gap_start, text + pv->normal_gap_end, len);
+      trash_area (text + MAX (pv->normal_gap_end, at), MIN (len, gap_size));
+    }
+
+  pv->normal_gap_start = at;
+  pv->normal_gap_end = at + gap_size;
+  pv->normal_gap_chars = position;
+}
+
+/* Resizes the buffer to @size bytes, placing the gap at @at. */
+static void
+clutter_text_buffer_normal_resize (ClutterTextBufferPrivate *pv,
+                                   gsize                     size,
+                                   gsize                     at,
+                                   guint                     position)
+{
+  gsize after;
+  gchar *et_new;
+
+  et_new = g_malloc0 (size);
+
+  if (pv->normal_text != NULL)
+    {
+      /* close the gap at the end, so that the text is contiguous */
+      clutter_text_buffer_normal_move_gap (pv, pv->normal_text_bytes,
+                                           pv->normal_text_chars);
+
+      after = pv->normal_text_bytes - at;
+
+      memcpy (et_new, pv->normal_text, at);
+      memcpy (et_new + size - 1 - after, pv->normal_text + at, after);
+
+      /* Could be a password, so can't leave stuff in memory. */
+      trash_area (pv->normal_text, pv->normal_text_size);
+      g_free (pv->normal_text);
+    }
+  else
+    after = 0;
+
+  pv->normal_text = et_new;
+  pv->normal_text_size = size;
+  pv->normal_gap_start = at;
+  pv->normal_gap_end = size - 1 - after;
+  pv->normal_gap_chars = position;
+}
+
+/* Finds the byte offset, ignoring the gap, of the character at @position
+ * by scanning from the closest known offset on the same side of the gap:
+ * the start or the end of the text, the gap itself, or an index entry.
+ */
+static gsize
+clutter_text_buffer_normal_scan_offset (ClutterTextBufferPrivate *pv,
+                                        guint                     position,
+                                        guint                    *distance)
+{
+  gsize gap_size = pv->normal_gap_end - pv->normal_gap_start;
+  guint gap_chars = pv->normal_gap_chars;
+  gboolean before_gap = position <= gap_chars;
+  guint anchor_char;
+  gsize anchor_byte;
+  const gchar *p;
+  guint k;
+
+  if (before_gap)
+    {
+      if (position < gap_chars - position)
+        {
+          anchor_char = 0;
+          anchor_byte = 0;
+        }
+      else
+        {
+          anchor_char = gap_chars;
+          anchor_byte = pv->normal_gap_start;
+        }
+    }
+  else
+    {
+      if (position - gap_chars <= pv->normal_text_chars - position)
+        {
+          anchor_char = gap_chars;
+          anchor_byte = pv->normal_gap_start;
+        }
+      else
+        {
+          anchor_char = pv->normal_text_chars;
+          anchor_byte = pv->normal_text_bytes;
+        }
+    }
+
+  k = position / INDEX_STEP;
+  if (pv->normal_index != NULL && k < pv->normal_index->len)
+    {
+      guint index_char = k * INDEX_STEP;
+
+      if ((index_char <= gap_chars) == before_gap &&
+          position - index_char < ABS ((gint) position - (gint) anchor_char))
+        {
+          anchor_char = index_char;
+          anchor_byte = g_array_index (pv->normal_index, gsize, k);
+        }
+    }
+
+  *distance = ABS ((gint) position - (gint) anchor_char);
+
+  if (position == anchor_char)
+    return anchor_byte;
+
+  if (before_gap)
+    {
+      p = g_utf8_offset_to_pointer (pv->normal_text + anchor_byte,
+                                    (glong) position - (glong) anchor_char);
+
+      return p - pv->normal_text;
+    }
+  else
+    {
+      p = g_utf8_offset_to_pointer (pv->normal_text + anchor_byte + gap_size,
+                                    (glong) position - (glong) anchor_char);
+
+      return p - pv->normal_text - gap_size;
+    }
+}
+
+/* Converts the character offset @position into a byte offset, ignoring
+ * the gap; if no known offset is close enough to @position, the index is
+ * extended up to it, so that the following conversions are cheap.
+ */
+static gsize
+clutter_text_buffer_normal_get_offset (ClutterTextBufferPrivate *pv,
+                                       guint                     position)
+{
+  guint distance;
+  gsize offset;
+  guint k;
+
+  offset = clutter_text_buffer_normal_scan_offset (pv, position, &distance);
+  if (distance <= INDEX_STEP)
+    return offset;
+
+  if (pv->normal_index == NULL)
+    pv->normal_index = g_array_new (FALSE, FALSE, sizeof (gsize));
+
+  for (k = pv->normal_index->len; k <= position / INDEX_STEP; k++)
+    {
+      gsize index_offset;
+
+      index_offset = clutter_text_buffer_normal_scan_offset (pv,
+                                                             k * INDEX_STEP,
+                                                             &distance);
+      g_array_append_val (pv->normal_index, index_offset);
+    }
+
+  return clutter_text_buffer_normal_scan_offset (pv, position, &distance);
+}
+
+/* Drops the index entries after @position, after an edit. */
+static void
+clutter_text_buffer_normal_truncate_index (ClutterTextBufferPrivate *pv,
+                                           guint                     position)
+{
+  guint len;
+
+  if (pv->normal_index == NULL)
+    return;
+
+  len = position / INDEX_STEP + 1;
+  if (len < pv->normal_index->len)
+    g_array_set_size (pv->normal_index, len);
+}
+
 static const gchar*
 clutter_text_buffer_normal_get_text (ClutterTextBuffer *buffer,
                                   gsize          *n_bytes)
 {
+  ClutterTextBufferPrivate *pv = buffer->priv;
+
   if (n_bytes)
-    *n_bytes = buffer->priv->normal_text_bytes;
-  if (!buffer->priv->normal_text)
+    *n_bytes = pv->normal_text_bytes;
+  if (!pv->normal_text)
       return "";
-  return buffer->priv->normal_text;
+
+  /* the text must be contiguous, so close the gap at the closest end */
+  if (pv->normal_gap_start == 0)
+    return pv->normal_text + pv->normal_gap_end;
+
+  if (pv->normal_gap_start < pv->normal_text_bytes)
+    {
+      if (pv->normal_gap_start < pv->normal_text_bytes - pv->normal_gap_start)
+        clutter_text_buffer_normal_move_gap (pv, 0, 0);
+      else
+        clutter_text_buffer_normal_move_gap (pv, pv->normal_text_bytes,
+                                             pv->normal_text_chars);
+
+      if (pv->normal_gap_start == 0)
+        return pv->normal_text + pv->normal_gap_end;
+    }
+
+  /* the gap is at the end, so it can hold the terminating zero */
+  pv->normal_text[pv->normal_gap_start] = '\0';
+
+  return pv->normal_text;
 }
 
 static guint
@@ -125,34 +366,35 @@ clutter_text_buffer_normal_insert_text (ClutterTextBuffer *buffer,
                                      guint           n_chars)
 {
   ClutterTextBufferPrivate *pv = buffer->priv;
-  gsize prev_size;
   gsize n_bytes;
   gsize at;
 
   n_bytes = g_utf8_offset_to_pointer (chars, n_chars) - chars;
 
+  at = pv->normal_text != NULL
+     ? clutter_text_buffer_normal_get_offset (pv, position)
+     : 0;
+
   /* Need more memory */
   if (n_bytes + pv->normal_text_bytes + 1 > pv->normal_text_size)
     {
-      gchar *et_new;
-
-      prev_size = pv->normal_text_size;
+      gsize size = pv->normal_text_size;
 
       /* Calculate our new buffer size */
-      while (n_bytes + pv->normal_text_bytes + 1 > pv->normal_text_size)
+      while (n_bytes + pv->normal_text_bytes + 1 > size)
         {
-          if (pv->normal_text_size == 0)
-            pv->normal_text_size = MIN_SIZE;
+          if (size == 0)
+            size = MIN_SIZE;
           else
             {
-              if (2 * pv->normal_text_size < CLUTTER_TEXT_BUFFER_MAX_SIZE)
-                pv->normal_text_size *= 2;
+              if (2 * size < CLUTTER_TEXT_BUFFER_MAX_SIZE)
+                size *= 2;
               else
                 {
-                  pv->normal_text_size = CLUTTER_TEXT_BUFFER_MAX_SIZE;
-                  if (n_bytes > pv->normal_text_size - pv->normal_text_bytes - 1)
+                  size = CLUTTER_TEXT_BUFFER_MAX_SIZE;
+                  if (n_bytes > size - pv->normal_text_bytes - 1)
                     {
-                      n_bytes = pv->normal_text_size - pv->normal_text_bytes - 1;
+                      n_bytes = size - pv->normal_text_bytes - 1;
                       n_bytes = g_utf8_find_prev_char (chars, chars + n_bytes + 1) - chars;
                       n_chars = g_utf8_strlen (chars, n_bytes);
                     }
@@ -161,23 +403,21 @@ clutter_text_buffer_normal_insert_text (ClutterTextBuffer *buffer,
             }
         }
 
-      /* Could be a password, so can't leave stuff in memory. */
-      et_new = g_malloc (pv->normal_text_size);
-      memcpy (et_new, pv->normal_text, MIN (prev_size, pv->normal_text_size));
-      trash_area (pv->normal_text, prev_size);
-      g_free (pv->normal_text);
-      pv->normal_text = et_new;
+      if (size != pv->normal_text_size)
+        clutter_text_buffer_normal_resize (pv, size, at, position);
     }
 
   /* Actual text insertion */
-  at = g_utf8_offset_to_pointer (pv->normal_text, position) - pv->normal_text;
-  g_memmove (pv->normal_text + at + n_bytes, pv->normal_text + at, pv->normal_text_bytes - at);
+  clutter_text_buffer_normal_move_gap (pv, at, position);
   memcpy (pv->normal_text + at, chars, n_bytes);
 
   /* Book keeping */
+  pv->normal_gap_start += n_bytes;
+  pv->normal_gap_chars += n_chars;
   pv->normal_text_bytes += n_bytes;
   pv->normal_text_chars += n_chars;
-  pv->normal_text[pv->normal_text_bytes] = '\0';
+
+  clutter_text_buffer_normal_truncate_index (pv, position);
 
   clutter_text_buffer_emit_inserted_text (buffer, position, chars, n_chars);
   return n_chars;
@@ -198,19 +438,23 @@ clutter_text_buffer_normal_delete_text (ClutterTextBuffer *buffer,
 
   if (n_chars > 0)
     {
-      start = g_utf8_offset_to_pointer (pv->normal_text, position) - pv->normal_text;
-      end = g_utf8_offset_to_pointer (pv->normal_text, position + n_chars) - pv->normal_text;
+      start = clutter_text_buffer_normal_get_offset (pv, position);
+      clutter_text_buffer_normal_move_gap (pv, start, position);
 
-      g_memmove (pv->normal_text + start, pv->normal_text + end, pv->normal_text_bytes + 1 - end);
-      pv->normal_text_chars -= n_chars;
-      pv->normal_text_bytes -= (end - start);
+      /* the deleted text now starts right after the gap */
+      end = clutter_text_buffer_normal_get_offset (pv, position + n_chars);
 
       /*
-       * Could be a password, make sure we don't leave anything sensitive after
-       * the terminating zero.  Note, that the terminating zero already trashed
-       * one byte.
+       * Could be a password, make sure we don't leave anything sensitive
+       * inside the gap.
        */
-      trash_area (pv->normal_text + pv->normal_text_bytes + 1, end - start - 1);
+      trash_area (pv->normal_text + pv->normal_gap_end, end - start);
+
+      pv->normal_gap_end += end - start;
+      pv->normal_text_chars -= n_chars;
+      pv->normal_text_bytes -= (end - start);
+
+      clutter_text_buffer_normal_truncate_index (pv, position);
 
       clutter_text_buffer_emit_deleted_text (buffer, position, n_chars);
     }
@@ -256,6 +500,9 @@ clutter_text_buffer_init (ClutterTextBuffer *buffer)
   pv->normal_text_chars = 0;
   pv->normal_text_bytes = 0;
   pv->normal_text_size = 0;
+  pv->normal_gap_start = pv->normal_gap_end = 0;
+  pv->normal_gap_chars = 0;
+  pv->normal_index = NULL;
 }
 
 static void
@@ -273,6 +520,12 @@ clutter_text_buffer_finalize (GObject *obj)
       pv->normal_text_chars = 0;
     }
 
+  if (pv->normal_index)
+    {
+      g_array_free (pv->normal_index, TRUE);
+      pv->normal_index = NULL;
+    }
+
   G_OBJECT_CLASS (clutter_text_buffer_parent_class)->finalize (obj);
 }
 
@@ -515,6 +768,10 @@ clutter_text_buffer_get_bytes (ClutterTextBuffer *buffer)
   klass = CLUTTER_TEXT_BUFFER_GET_CLASS (buffer);
   g_return_val_if_fail (klass->get_text != NULL, 0);
 
+  /* getting the text would close the gap */
+  if (klass->get_text == clutter_text_buffer_normal_get_text)
+    return buffer->priv->normal_text_bytes;
+
   (*klass->get_text) (buffer, &bytes);
   return bytes;
 }
@@ -548,6 +805,77 @@ clutter_text_buffer_get_text (ClutterTextBuffer *buffer)
   return (*klass->get_text) (buffer, NULL);
 }
 
+/*< private >
+ * _clutter_text_buffer_get_text_range:
+ * @buffer: a #ClutterTextBuffer
+ * @byte_start: the offset of the range, in bytes
+ * @n_bytes: the length of the range, in bytes
+ *
+ * Retrieves the contents of @buffer between @byte_start and
+ * @byte_start + @n_bytes.
+ *
+ * Unlike clutter_text_buffer_get_text(), which has to close the gap
+ * of the default implementation, this function only moves the text
+ * between the gap and the closest end of the range, if the range
+ * spans the gap; reading the text around an edit is cheap.
+ *
+ * Return value: a pointer to the contents of the range, which is not
+ *   nul-terminated; the same rules of clutter_text_buffer_get_text()
+ *   apply
+ */
+const gchar *
+_clutter_text_buffer_get_text_range (ClutterTextBuffer *buffer,
+                                     gsize              byte_start,
+                                     gsize              n_bytes)
+{
+  ClutterTextBufferClass *klass;
+  ClutterTextBufferPrivate *pv;
+  gsize gap_size, byte_end;
+  guint position;
+
+  g_return_val_if_fail (CLUTTER_IS_TEXT_BUFFER (buffer), NULL);
+
+  klass = CLUTTER_TEXT_BUFFER_GET_CLASS (buffer);
+  if (klass->get_text != clutter_text_buffer_normal_get_text)
+    return clutter_text_buffer_get_text (buffer) + byte_start;
+
+  pv = buffer->priv;
+
+  g_return_val_if_fail (byte_start + n_bytes <= pv->normal_text_bytes, NULL);
+
+  if (pv->normal_text == NULL)
+    return "";
+
+  gap_size = pv->normal_gap_end - pv->normal_gap_start;
+  byte_end = byte_start + n_bytes;
+
+  if (byte_end <= pv->normal_gap_start)
+    return pv->normal_text + byte_start;
+
+  if (byte_start >= pv->normal_gap_start)
+    return pv->normal_text + gap_size + byte_start;
+
+  /* the range spans the gap, so move it to the closest end */
+  if (pv->normal_gap_start - byte_start <= byte_end - pv->normal_gap_start)
+    {
+      position = pv->normal_gap_chars
+               - g_utf8_strlen (pv->normal_text + byte_start,
+                                pv->normal_gap_start - byte_start);
+      clutter_text_buffer_normal_move_gap (pv, byte_start, position);
+
+      return pv->normal_text + gap_size + byte_start;
+    }
+  else
+    {
+      position = pv->normal_gap_chars
+               + g_utf8_strlen (pv->normal_text + pv->normal_gap_end,
+                                byte_end - pv->normal_gap_start);
+      clutter_text_buffer_normal_move_gap (pv, byte_end, position);
+
+      return pv->normal_text + byte_start;
+    }
+}
+
 /**
  * clutter_text_buffer_set_text:
  * @buffer: a #ClutterTextBuffer
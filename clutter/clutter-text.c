@@ -59,7 +59,7 @@
 #include "clutter-private.h"    /* includes <cogl-pango/cogl-pango.h> */
 #include "clutter-profile.h"
 #include "clutter-property-transition.h"
-#include "clutter-text-buffer.h"
+#include "clutter-text-buffer-private.h"
 #include "clutter-units.h"
 #include "clutter-paint-volume-private.h"
 #include "clutter-scriptable.h"
@@ -79,9 +79,23 @@
  */
 #define N_CACHED_LAYOUTS        6
 
+/* Layouts with more lines than this do not get their glyphs cached
+ * up front, since most of them are likely to be outside of the
+ * visible area when painting
+ */
+#define N_PRECACHED_LINES       256
+
+/* The number of layouts kept in the cache shared by all the
+ * ClutterText actors with the :share-layout property set
+ */
+#define N_SHARED_LAYOUTS        256
+
 #define CLUTTER_TEXT_GET_PRIVATE(obj)   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), CLUTTER_TYPE_TEXT, ClutterTextPrivate))
 
 typedef struct _LayoutCache     LayoutCache;
+typedef struct _Paragraph       Paragraph;
+typedef struct _SharedLayout    SharedLayout;
+typedef struct _ShapingJob      ShapingJob;
 
 static const ClutterColor default_cursor_color    = {   0,   0,   0, 255 };
 static const ClutterColor default_selection_color = {   0,   0,   0, 255 };
@@ -115,6 +129,90 @@ struct _LayoutCache
   guint age;
 };
 
+struct _Paragraph
+{
+  /* The layout of a single paragraph of an editable, multi-line
+   * text, or NULL if the paragraph needs to be shaped again
+   */
+  PangoLayout *layout;
+
+  /* The size of the paragraph inside the buffer, not including
+   * the paragraph separator
+   */
+  gint n_bytes;
+  gint n_chars;
+
+  /* The size of the separator following the paragraph, which can
+   * be any of the delimiters used by Pango; the last paragraph does
+   * not have one
+   */
+  gint sep_bytes;
+  gint sep_chars;
+
+  /* Metrics of the layout, in Pango units; the natural width and
+   * height are the size of the unwrapped paragraph, while the height
+   * and the ink rectangle are computed for the current paragraph width
+   */
+  gint natural_width;
+  gint natural_height;
+  gint height;
+  PangoRectangle ink_rect;
+};
+
+struct _SharedLayout
+{
+  /* The contents and the properties of the layout */
+  gchar *text;
+  PangoFontDescription *font_desc;
+  gint width;
+  gint height;
+  guint ellipsize   : 3;
+  guint wrap_mode   : 3;
+  guint alignment   : 2;
+  guint justify     : 1;
+  guint single_line : 1;
+
+  /* The cached layout, which must not be modified */
+  PangoLayout *layout;
+
+  /* The link inside the LRU queue */
+  GList link;
+};
+
+struct _ShapingJob
+{
+  /* The actor that requested the layout, and the generation of its
+   * cached layouts at the time of the request
+   */
+  ClutterText *text;
+  guint generation;
+
+  /* A snapshot of the contents and the properties of the layout */
+  gchar *contents;
+  PangoAttrList *attrs;
+  PangoFontDescription *font_desc;
+  gint width;
+  gint height;
+  PangoEllipsizeMode ellipsize;
+  PangoWrapMode wrap_mode;
+  PangoAlignment alignment;
+  gboolean justify;
+  gboolean single_line;
+
+  /* A snapshot of the PangoContext of the actor; the font map is not
+   * copied, it is the one shared with the main thread
+   */
+  PangoFontMap *font_map;
+  PangoFontDescription *context_font_desc;
+  cairo_font_options_t *font_options;
+  gdouble resolution;
+  PangoLanguage *language;
+  PangoDirection base_dir;
+
+  /* The layout created by the worker thread */
+  PangoLayout *layout;
+};
+
 struct _ClutterTextPrivate
 {
   PangoFontDescription *font_desc;
@@ -131,6 +229,20 @@ struct _ClutterTextPrivate
   LayoutCache cached_layouts[N_CACHED_LAYOUTS];
   guint cache_age;
 
+  /* The paragraphs of an editable, multi-line text; edits to the
+   * buffer only invalidate the paragraphs they touch
+   */
+  GArray *paragraphs;
+  gint paragraph_width;
+
+  /* The layouts being created in a worker thread; the generation is
+   * increased every time the cached layouts are discarded, and the
+   * fallback layout is used while waiting for a new layout
+   */
+  GSList *shaping_jobs;
+  guint layout_generation;
+  PangoLayout *fallback_layout;
+
   /* These are the attributes set by the attributes property */
   PangoAttrList *attrs;
   /* These are the attributes derived from the text when the
@@ -216,6 +328,8 @@ struct _ClutterTextPrivate
   guint paint_volume_valid      : 1;
   guint show_password_hint      : 1;
   guint password_hint_visible   : 1;
+  guint share_layout            : 1;
+  guint async_layout            : 1;
 };
 
 enum
@@ -250,6 +364,8 @@ enum
   PROP_SINGLE_LINE_MODE,
   PROP_SELECTED_TEXT_COLOR,
   PROP_SELECTED_TEXT_COLOR_SET,
+  PROP_SHARE_LAYOUT,
+  PROP_ASYNC_LAYOUT,
 
   PROP_LAST
 };
@@ -338,13 +454,26 @@ clutter_text_clear_selection (ClutterText *self)
     }
 }
 
-static gchar *
-clutter_text_get_display_text (ClutterText *self)
+/*
+ * clutter_text_get_display_text:
+ * @self: a #ClutterText
+ * @str_p: return location for the string to free
+ *
+ * Retrieves the text to be displayed. Unless a password character
+ * is set, the returned string is owned by the buffer and @str_p will
+ * be set to %NULL; otherwise @str_p will point to the returned
+ * string, which should be freed using g_free().
+ */
+static const gchar *
+clutter_text_get_display_text (ClutterText  *self,
+                               gchar       **str_p)
 {
   ClutterTextPrivate *priv = self->priv;
   ClutterTextBuffer *buffer;
   const gchar *text;
 
+  *str_p = NULL;
+
   buffer = get_buffer (self);
   text = clutter_text_buffer_get_text (buffer);
 
@@ -352,10 +481,10 @@ clutter_text_get_display_text (ClutterText *self)
    * with an empty text and a password char set
    */
   if (text[0] == '\0')
-    return g_strdup ("");
+    return text;
 
   if (G_LIKELY (priv->password_char == 0))
-    return g_strdup (text);
+    return text;
   else
     {
       GString *str;
@@ -391,7 +520,9 @@ clutter_text_get_display_text (ClutterText *self)
             g_string_append_len (str, buf, char_len);
         }
 
-      return g_string_free (str, FALSE);
+      *str_p = g_string_free (str, FALSE);
+
+      return *str_p;
     }
 }
 
@@ -457,7 +588,8 @@ clutter_text_create_layout_no_cache (ClutterText       *text,
 {
   ClutterTextPrivate *priv = text->priv;
   PangoLayout *layout;
-  gchar *contents;
+  const gchar *contents;
+  gchar *str = NULL;
   gsize contents_len;
 
   CLUTTER_STATIC_TIMER (text_layout_timer,
@@ -471,7 +603,7 @@ clutter_text_create_layout_no_cache (ClutterText       *text,
   layout = clutter_actor_create_pango_layout (CLUTTER_ACTOR (text), NULL);
   pango_layout_set_font_description (layout, priv->font_desc);
 
-  contents = clutter_text_get_display_text (text);
+  contents = clutter_text_get_display_text (text, &str);
   contents_len = strlen (contents);
 
   if (priv->editable && priv->preedit_set)
@@ -514,38 +646,1099 @@ clutter_text_create_layout_no_cache (ClutterText       *text,
         pango_layout_set_attributes (layout, priv->effective_attrs);
     }
 
-  pango_layout_set_alignment (layout, priv->alignment);
-  pango_layout_set_single_paragraph_mode (layout, priv->single_line_mode);
-  pango_layout_set_justify (layout, priv->justify);
-  pango_layout_set_wrap (layout, priv->wrap_mode);
-
-  pango_layout_set_ellipsize (layout, ellipsize);
-  pango_layout_set_width (layout, width);
-  pango_layout_set_height (layout, height);
+  pango_layout_set_alignment (layout, priv->alignment);
+  pango_layout_set_single_paragraph_mode (layout, priv->single_line_mode);
+  pango_layout_set_justify (layout, priv->justify);
+  pango_layout_set_wrap (layout, priv->wrap_mode);
+
+  pango_layout_set_ellipsize (layout, ellipsize);
+  pango_layout_set_width (layout, width);
+  pango_layout_set_height (layout, height);
+
+  g_free (str);
+
+  CLUTTER_TIMER_STOP (_clutter_uprof_context, text_layout_timer);
+
+  return layout;
+}
+
+/* The cache of layouts shared between ClutterText actors; the hash
+ * table owns the SharedLayout entries, while the queue keeps them in
+ * least recently used order
+ */
+static GHashTable *shared_layouts = NULL;
+static GQueue shared_layouts_lru = G_QUEUE_INIT;
+
+static guint
+shared_layout_hash (gconstpointer data)
+{
+  const SharedLayout *key = data;
+  guint hash;
+
+  hash = g_str_hash (key->text);
+  hash = hash * 31 + pango_font_description_hash (key->font_desc);
+  hash = hash * 31 + key->width;
+  hash = hash * 31 + key->height;
+  hash = hash * 31 + (key->ellipsize
+                      | (key->wrap_mode << 3)
+                      | (key->alignment << 6)
+                      | (key->justify << 8)
+                      | (key->single_line << 9));
+
+  return hash;
+}
+
+static gboolean
+shared_layout_equal (gconstpointer a,
+                     gconstpointer b)
+{
+  const SharedLayout *key_a = a;
+  const SharedLayout *key_b = b;
+
+  return key_a->width == key_b->width &&
+         key_a->height == key_b->height &&
+         key_a->ellipsize == key_b->ellipsize &&
+         key_a->wrap_mode == key_b->wrap_mode &&
+         key_a->alignment == key_b->alignment &&
+         key_a->justify == key_b->justify &&
+         key_a->single_line == key_b->single_line &&
+         strcmp (key_a->text, key_b->text) == 0 &&
+         pango_font_description_equal (key_a->font_desc, key_b->font_desc);
+}
+
+static void
+shared_layout_free (gpointer data)
+{
+  SharedLayout *entry = data;
+
+  g_queue_unlink (&shared_layouts_lru, &entry->link);
+
+  g_free (entry->text);
+  pango_font_description_free (entry->font_desc);
+  g_object_unref (entry->layout);
+
+  g_slice_free (SharedLayout, entry);
+}
+
+/* Drops all the shared layouts, e.g. when the font settings change */
+static void
+clutter_text_clear_shared_layouts (void)
+{
+  if (shared_layouts != NULL)
+    g_hash_table_remove_all (shared_layouts);
+}
+
+/*
+ * clutter_text_get_shared_layout:
+ * @text: a #ClutterText
+ * @width: the width of the layout, in Pango units
+ * @height: the height of the layout, in Pango units
+ * @ellipsize: the ellipsization mode of the layout
+ *
+ * Retrieves a layout from the cache shared by all the #ClutterText
+ * actors, creating it if needed.
+ *
+ * Return value: (transfer full): the shared layout, or %NULL if
+ *   the layout of @text cannot be shared
+ */
+static PangoLayout *
+clutter_text_get_shared_layout (ClutterText        *text,
+                                gint                width,
+                                gint                height,
+                                PangoEllipsizeMode  ellipsize)
+{
+  ClutterTextPrivate *priv = text->priv;
+  SharedLayout key, *entry;
+  gchar *str = NULL;
+
+  CLUTTER_STATIC_COUNTER (shared_layout_hit_counter,
+                          "Shared text layout cache hit counter",
+                          "Increments for each shared layout cache hit",
+                          0);
+  CLUTTER_STATIC_COUNTER (shared_layout_miss_counter,
+                          "Shared text layout cache miss counter",
+                          "Increments for each shared layout cache miss",
+                          0);
+  CLUTTER_STATIC_COUNTER (shared_layout_eviction_counter,
+                          "Shared text layout cache eviction counter",
+                          "Increments for each layout evicted from the "
+                          "shared layout cache",
+                          0);
+
+  /* layouts using attributes, or that can be edited, are not shared */
+  if (!priv->share_layout || priv->editable)
+    return NULL;
+
+  clutter_text_ensure_effective_attributes (text);
+  if (priv->effective_attrs != NULL)
+    return NULL;
+
+  if (G_UNLIKELY (shared_layouts == NULL))
+    shared_layouts = g_hash_table_new_full (shared_layout_hash,
+                                            shared_layout_equal,
+                                            shared_layout_free,
+                                            NULL);
+
+  key.text = (gchar *) clutter_text_get_display_text (text, &str);
+  key.font_desc = priv->font_desc;
+  key.width = width;
+  key.height = height;
+  key.ellipsize = ellipsize;
+  key.wrap_mode = priv->wrap_mode;
+  key.alignment = priv->alignment;
+  key.justify = priv->justify;
+  key.single_line = priv->single_line_mode;
+
+  entry = g_hash_table_lookup (shared_layouts, &key);
+  if (entry != NULL)
+    {
+      CLUTTER_COUNTER_INC (_clutter_uprof_context, shared_layout_hit_counter);
+
+      /* move the entry to the front of the queue */
+      g_queue_unlink (&shared_layouts_lru, &entry->link);
+      g_queue_push_head_link (&shared_layouts_lru, &entry->link);
+
+      g_free (str);
+
+      return g_object_ref (entry->layout);
+    }
+
+  CLUTTER_COUNTER_INC (_clutter_uprof_context, shared_layout_miss_counter);
+
+  if (g_hash_table_size (shared_layouts) >= N_SHARED_LAYOUTS)
+    {
+      SharedLayout *oldest = g_queue_peek_tail (&shared_layouts_lru);
+
+      CLUTTER_COUNTER_INC (_clutter_uprof_context,
+                           shared_layout_eviction_counter);
+
+      g_hash_table_remove (shared_layouts, oldest);
+    }
+
+  entry = g_slice_new (SharedLayout);
+  *entry = key;
+  entry->text = str != NULL ? str : g_strdup (key.text);
+  entry->font_desc = pango_font_description_copy (priv->font_desc);
+  entry->layout =
+    clutter_text_create_layout_no_cache (text, width, height, ellipsize);
+  entry->link.data = entry;
+  entry->link.prev = entry->link.next = NULL;
+
+  g_queue_push_head_link (&shared_layouts_lru, &entry->link);
+  g_hash_table_insert (shared_layouts, entry, entry);
+
+  return g_object_ref (entry->layout);
+}
+
+/* Pango is only thread-safe since version 1.32.6; from that version,
+ * font maps and fonts can be used from more than one thread at once,
+ * as long as each context and layout is used by one thread at a time
+ */
+static gboolean
+clutter_text_can_shape_async (void)
+{
+  static gint can_shape_async = -1;
+
+  if (G_UNLIKELY (can_shape_async == -1))
+    {
+      can_shape_async = pango_version_check (1, 32, 6) == NULL;
+
+      if (!can_shape_async)
+        CLUTTER_NOTE (ACTOR, "Pango %s is not thread-safe; layouts will "
+                             "be created synchronously",
+                      pango_version_string ());
+    }
+
+  return can_shape_async;
+}
+
+static void
+shaping_job_free (ShapingJob *job)
+{
+  g_object_unref (job->text);
+
+  g_free (job->contents);
+  if (job->attrs != NULL)
+    pango_attr_list_unref (job->attrs);
+  pango_font_description_free (job->font_desc);
+
+  g_object_unref (job->font_map);
+  pango_font_description_free (job->context_font_desc);
+  if (job->font_options != NULL)
+    cairo_font_options_destroy (job->font_options);
+
+  if (job->layout != NULL)
+    g_object_unref (job->layout);
+
+  g_slice_free (ShapingJob, job);
+}
+
+/* Puts @layout in the least recently used slot of the layout cache */
+static void
+clutter_text_add_cached_layout (ClutterText *text,
+                                PangoLayout *layout)
+{
+  ClutterTextPrivate *priv = text->priv;
+  LayoutCache *oldest_cache = priv->cached_layouts;
+  int i;
+
+  for (i = 0; i < N_CACHED_LAYOUTS; i++)
+    {
+      if (priv->cached_layouts[i].layout == NULL)
+        {
+          oldest_cache = priv->cached_layouts + i;
+          break;
+        }
+
+      if (priv->cached_layouts[i].age < oldest_cache->age)
+        oldest_cache = priv->cached_layouts + i;
+    }
+
+  if (oldest_cache->layout != NULL)
+    g_object_unref (oldest_cache->layout);
+
+  oldest_cache->layout = layout;
+  oldest_cache->age = priv->cache_age++;
+}
+
+/* Called in the main thread once a worker thread has created a layout */
+static gboolean
+clutter_text_shaping_job_done (gpointer data)
+{
+  ShapingJob *job = data;
+  ClutterText *text = job->text;
+  ClutterTextPrivate *priv = text->priv;
+
+  /* the profiling timers are not thread-safe, so the layouts created
+   * in the worker thread are counted here instead
+   */
+  CLUTTER_STATIC_COUNTER (text_async_layout_counter,
+                          "Text layouts created asynchronously",
+                          "Number of layouts created in a worker thread",
+                          0);
+
+  CLUTTER_COUNTER_INC (_clutter_uprof_context, text_async_layout_counter);
+
+  priv->shaping_jobs = g_slist_remove (priv->shaping_jobs, job);
+
+  /* the layout is out of date if the text changed in the meantime */
+  if (job->generation == priv->layout_generation &&
+      !CLUTTER_ACTOR_IN_DESTRUCTION (text))
+    {
+      CLUTTER_NOTE (ACTOR, "ClutterText: %p: layout for size %dx%d ready",
+                    text,
+                    job->width,
+                    job->height);
+
+      /* the glyph cache can only be used from the main thread */
+      if (pango_layout_get_line_count (job->layout) <= N_PRECACHED_LINES)
+        cogl_pango_ensure_glyph_cache_for_layout (job->layout);
+
+      clutter_text_add_cached_layout (text, g_object_ref (job->layout));
+
+      clutter_text_dirty_paint_volume (text);
+      clutter_actor_queue_relayout (CLUTTER_ACTOR (text));
+    }
+
+  /* the fallback layout is not needed any more */
+  if (priv->shaping_jobs == NULL && priv->fallback_layout != NULL)
+    {
+      g_object_unref (priv->fallback_layout);
+      priv->fallback_layout = NULL;
+    }
+
+  shaping_job_free (job);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Runs in a worker thread; only the data inside the job is used.
+ *
+ * The context and the layout are created here and are not touched by
+ * the main thread until the job is done, but the font map, and the
+ * fonts it loads, are shared with the main thread: this relies on the
+ * thread-safety of Pango >= 1.32.6, see clutter_text_can_shape_async()
+ */
+static void
+clutter_text_shaping_job_run (gpointer data,
+                              gpointer user_data)
+{
+  ShapingJob *job = data;
+  PangoContext *context;
+  PangoLayout *layout;
+
+  context = pango_font_map_create_context (job->font_map);
+  pango_context_set_base_dir (context, job->base_dir);
+  pango_context_set_language (context, job->language);
+  pango_context_set_font_description (context, job->context_font_desc);
+  if (job->font_options != NULL)
+    pango_cairo_context_set_font_options (context, job->font_options);
+  pango_cairo_context_set_resolution (context, job->resolution);
+
+  layout = pango_layout_new (context);
+  pango_layout_set_font_description (layout, job->font_desc);
+  pango_layout_set_text (layout, job->contents, -1);
+
+  if (job->attrs != NULL)
+    pango_layout_set_attributes (layout, job->attrs);
+
+  pango_layout_set_alignment (layout, job->alignment);
+  pango_layout_set_single_paragraph_mode (layout, job->single_line);
+  pango_layout_set_justify (layout, job->justify);
+  pango_layout_set_wrap (layout, job->wrap_mode);
+
+  pango_layout_set_ellipsize (layout, job->ellipsize);
+  pango_layout_set_width (layout, job->width);
+  pango_layout_set_height (layout, job->height);
+
+  /* force the shaping of the whole text */
+  pango_layout_get_extents (layout, NULL, NULL);
+
+  job->layout = layout;
+
+  g_object_unref (context);
+
+  clutter_threads_add_idle_full (G_PRIORITY_DEFAULT,
+                                 clutter_text_shaping_job_done,
+                                 job,
+                                 NULL);
+}
+
+/*
+ * clutter_text_create_layout_async:
+ * @text: a #ClutterText
+ * @width: the width of the layout, in Pango units
+ * @height: the height of the layout, in Pango units
+ * @ellipsize: the ellipsization mode of the layout
+ *
+ * Queues the creation of a layout in a worker thread, unless one
+ * with the same size is already being created.
+ *
+ * Return value: (transfer none): the layout to use until the new
+ *   one is ready, or %NULL if the layout of @text must be created
+ *   synchronously
+ */
+static PangoLayout *
+clutter_text_create_layout_async (ClutterText        *text,
+                                  gint                width,
+                                  gint                height,
+                                  PangoEllipsizeMode  ellipsize)
+{
+  static GThreadPool *shaping_pool = NULL;
+  ClutterTextPrivate *priv = text->priv;
+  PangoContext *context;
+  ShapingJob *job;
+  gchar *str = NULL;
+  GSList *l;
+
+  if (!priv->async_layout ||
+      priv->share_layout ||
+      priv->editable ||
+      !clutter_text_can_shape_async ())
+    return NULL;
+
+  for (l = priv->shaping_jobs; l != NULL; l = l->next)
+    {
+      job = l->data;
+
+      if (job->generation == priv->layout_generation &&
+          job->width == width &&
+          job->height == height &&
+          job->ellipsize == ellipsize)
+        goto out;
+    }
+
+  if (G_UNLIKELY (shaping_pool == NULL))
+    shaping_pool = g_thread_pool_new (clutter_text_shaping_job_run, NULL,
+                                      1, FALSE,
+                                      NULL);
+
+  clutter_text_ensure_effective_attributes (text);
+  context = clutter_actor_get_pango_context (CLUTTER_ACTOR (text));
+
+  job = g_slice_new0 (ShapingJob);
+  job->text = g_object_ref (text);
+  job->generation = priv->layout_generation;
+
+  job->contents = g_strdup (clutter_text_get_display_text (text, &str));
+  job->attrs = priv->effective_attrs != NULL
+             ? pango_attr_list_copy (priv->effective_attrs)
+             : NULL;
+  job->font_desc = pango_font_description_copy (priv->font_desc);
+  job->width = width;
+  job->height = height;
+  job->ellipsize = ellipsize;
+  job->wrap_mode = priv->wrap_mode;
+  job->alignment = priv->alignment;
+  job->justify = priv->justify;
+  job->single_line = priv->single_line_mode;
+
+  job->font_map = g_object_ref (clutter_context_get_pango_fontmap ());
+  job->context_font_desc =
+    pango_font_description_copy (pango_context_get_font_description (context));
+  if (pango_cairo_context_get_font_options (context) != NULL)
+    job->font_options =
+      cairo_font_options_copy (pango_cairo_context_get_font_options (context));
+  job->resolution = pango_cairo_context_get_resolution (context);
+  job->language = pango_context_get_language (context);
+  job->base_dir = pango_context_get_base_dir (context);
+
+  g_free (str);
+
+  priv->shaping_jobs = g_slist_prepend (priv->shaping_jobs, job);
+  g_thread_pool_push (shaping_pool, job, NULL);
+
+out:
+  /* until the new layout is ready, keep using the old one; if there
+   * is none, use an empty layout with the right font
+   */
+  if (priv->fallback_layout == NULL)
+    {
+      priv->fallback_layout =
+        clutter_actor_create_pango_layout (CLUTTER_ACTOR (text), NULL);
+      pango_layout_set_font_description (priv->fallback_layout,
+                                         priv->font_desc);
+    }
+
+  return priv->fallback_layout;
+}
+
+static void
+clutter_text_dirty_layouts (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+  LayoutCache *newest_cache = NULL;
+  int i;
+
+  /* layouts still being created are out of date as well */
+  priv->layout_generation += 1;
+
+  /* when creating layouts in a worker thread, keep the most recently
+   * used layout around until the new one is ready
+   */
+  if (priv->async_layout)
+    {
+      for (i = 0; i < N_CACHED_LAYOUTS; i++)
+        if (priv->cached_layouts[i].layout != NULL &&
+            (newest_cache == NULL ||
+             priv->cached_layouts[i].age > newest_cache->age))
+          newest_cache = priv->cached_layouts + i;
+
+      if (newest_cache != NULL)
+        {
+          if (priv->fallback_layout != NULL)
+            g_object_unref (priv->fallback_layout);
+
+          priv->fallback_layout = g_object_ref (newest_cache->layout);
+        }
+    }
+
+  /* Delete the cached layouts so they will be recreated the next time
+     they are needed */
+  for (i = 0; i < N_CACHED_LAYOUTS; i++)
+    if (priv->cached_layouts[i].layout)
+      {
+	g_object_unref (priv->cached_layouts[i].layout);
+	priv->cached_layouts[i].layout = NULL;
+      }
+
+  clutter_text_dirty_paint_volume (text);
+}
+
+static void
+clutter_text_clear_paragraphs (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+  guint i;
+
+  if (priv->paragraphs == NULL)
+    return;
+
+  for (i = 0; i < priv->paragraphs->len; i++)
+    {
+      Paragraph *para = &g_array_index (priv->paragraphs, Paragraph, i);
+
+      if (para->layout != NULL)
+        g_object_unref (para->layout);
+    }
+
+  g_array_set_size (priv->paragraphs, 0);
+}
+
+static void
+clutter_text_dirty_cache (ClutterText *text)
+{
+  clutter_text_dirty_layouts (text);
+  clutter_text_clear_paragraphs (text);
+}
+
+/*
+ * clutter_text_use_paragraphs:
+ * @text: a #ClutterText
+ *
+ * Checks whether the contents of @text can be laid out one paragraph
+ * at a time instead of using a single #PangoLayout.
+ *
+ * This is only possible when the layout of each paragraph does not
+ * depend on the rest of the contents: editable texts do not use
+ * attributes or ellipsization, but the pre-edit string and the
+ * password character would change the displayed text.
+ */
+static inline gboolean
+clutter_text_use_paragraphs (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+
+  return priv->editable &&
+         !priv->single_line_mode &&
+         !priv->preedit_set &&
+         priv->password_char == 0 &&
+         priv->ellipsize == PANGO_ELLIPSIZE_NONE;
+}
+
+static inline gint
+clutter_text_paragraph_width (gfloat allocation_width)
+{
+  if (allocation_width < 0)
+    return -1;
+
+  return allocation_width * 1024 + 0.5f;
+}
+
+/*
+ * clutter_text_split_paragraphs:
+ * @text: a #ClutterText
+ * @index_: the index of the first new paragraph
+ * @contents: the text to split
+ * @n_bytes: the length of @contents, in bytes
+ *
+ * Splits @contents into paragraphs, using the same delimiters as
+ * Pango, and inserts them in the list of paragraphs of @text,
+ * starting at @index_. The new paragraphs will be shaped the next
+ * time they are needed.
+ *
+ * Return value: the index of the last new paragraph
+ */
+static guint
+clutter_text_split_paragraphs (ClutterText *text,
+                               guint        index_,
+                               const gchar *contents,
+                               gsize        n_bytes)
+{
+  ClutterTextPrivate *priv = text->priv;
+  const gchar *end = contents + n_bytes;
+  const gchar *p = contents;
+
+  while (TRUE)
+    {
+      Paragraph para = { NULL, };
+      gint delimiter, next;
+
+      pango_find_paragraph_boundary (p, end - p, &delimiter, &next);
+
+      para.n_bytes = delimiter;
+      para.n_chars = g_utf8_strlen (p, para.n_bytes);
+      para.sep_bytes = next - delimiter;
+      para.sep_chars = g_utf8_strlen (p + delimiter, para.sep_bytes);
+
+      g_array_insert_val (priv->paragraphs, index_, para);
+
+      if (para.sep_bytes == 0)
+        break;
+
+      index_ += 1;
+      p += next;
+    }
+
+  return index_;
+}
+
+/* the number of characters and bytes covered by the paragraphs,
+ * including the separators between them
+ */
+static void
+clutter_text_get_paragraphs_size (ClutterText *text,
+                                  gint        *n_chars_p,
+                                  gint        *n_bytes_p)
+{
+  GArray *paragraphs = text->priv->paragraphs;
+  gint n_chars, n_bytes;
+  guint i;
+
+  n_chars = n_bytes = 0;
+
+  for (i = 0; i < paragraphs->len; i++)
+    {
+      const Paragraph *para = &g_array_index (paragraphs, Paragraph, i);
+
+      n_chars += para->n_chars + para->sep_chars;
+      n_bytes += para->n_bytes + para->sep_bytes;
+    }
+
+  *n_chars_p = n_chars;
+  *n_bytes_p = n_bytes;
+}
+
+/*
+ * clutter_text_find_paragraph:
+ * @text: a #ClutterText
+ * @position: a position in characters
+ * @char_start: return location for the position of the paragraph
+ * @byte_start: return location for the byte offset of the paragraph
+ *
+ * Finds the first paragraph containing @position, which may also
+ * be the position right at the end of the paragraph, or a position
+ * inside its separator.
+ *
+ * Return value: the index of the paragraph
+ */
+static guint
+clutter_text_find_paragraph (ClutterText *text,
+                             gint         position,
+                             gint        *char_start,
+                             gint        *byte_start)
+{
+  GArray *paragraphs = text->priv->paragraphs;
+  gint n_chars = 0, n_bytes = 0;
+  guint i;
+
+  for (i = 0; i < paragraphs->len - 1; i++)
+    {
+      const Paragraph *para = &g_array_index (paragraphs, Paragraph, i);
+
+      if (position < n_chars + para->n_chars + para->sep_chars)
+        break;
+
+      n_chars += para->n_chars + para->sep_chars;
+      n_bytes += para->n_bytes + para->sep_bytes;
+    }
+
+  *char_start = n_chars;
+  *byte_start = n_bytes;
+
+  return i;
+}
+
+/*
+ * clutter_text_replace_paragraphs:
+ * @text: a #ClutterText
+ * @first: the index of the first paragraph touched by an edit
+ * @last: the index of the last paragraph touched by an edit
+ * @byte_start: the byte offset of the @first paragraph
+ * @n_bytes: the length, in bytes, of the edited contents of the
+ *   paragraphs between @first and @last
+ *
+ * Replaces the paragraphs between @first and @last with the
+ * paragraphs of the edited buffer text; all the other paragraphs
+ * keep their layout.
+ *
+ * An edit can join a "\r" and a "\n" into a single separator, or
+ * split a "\r\n" separator, so the paragraphs around the edit are
+ * split again as well when their separators involve a "\r".
+ */
+static void
+clutter_text_replace_paragraphs (ClutterText *text,
+                                 guint        first,
+                                 guint        last,
+                                 gint         byte_start,
+                                 gint         n_bytes)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterTextBuffer *buffer = get_buffer (text);
+  const gchar *contents;
+  Paragraph *para;
+  gint sep_bytes, sep_chars;
+  guint i;
+
+  if (first > 0)
+    {
+      para = &g_array_index (priv->paragraphs, Paragraph, first - 1);
+
+      if (para->sep_bytes == 1 &&
+          *_clutter_text_buffer_get_text_range (buffer,
+                                                byte_start - 1,
+                                                1) == '\r')
+        {
+          byte_start -= para->n_bytes + para->sep_bytes;
+          n_bytes += para->n_bytes + para->sep_bytes;
+          first -= 1;
+        }
+    }
+
+  contents = _clutter_text_buffer_get_text_range (buffer,
+                                                  byte_start,
+                                                  n_bytes);
+
+  if (last + 1 < priv->paragraphs->len)
+    {
+      para = &g_array_index (priv->paragraphs, Paragraph, last);
+
+      /* the only two bytes separator is "\r\n" */
+      if (para->sep_bytes == 2 ||
+          (n_bytes > 0 && contents[n_bytes - 1] == '\r'))
+        {
+          n_bytes += para->sep_bytes;
+
+          last += 1;
+
+          para = &g_array_index (priv->paragraphs, Paragraph, last);
+          n_bytes += para->n_bytes;
+
+          contents = _clutter_text_buffer_get_text_range (buffer,
+                                                          byte_start,
+                                                          n_bytes);
+        }
+    }
+
+  for (i = first; i <= last; i++)
+    {
+      para = &g_array_index (priv->paragraphs, Paragraph, i);
+
+      if (para->layout != NULL)
+        g_object_unref (para->layout);
+    }
+
+  /* the separator after the last paragraph is not touched */
+  para = &g_array_index (priv->paragraphs, Paragraph, last);
+  sep_bytes = para->sep_bytes;
+  sep_chars = para->sep_chars;
+
+  g_array_remove_range (priv->paragraphs, first, last - first + 1);
+
+  i = clutter_text_split_paragraphs (text, first, contents, n_bytes);
+
+  para = &g_array_index (priv->paragraphs, Paragraph, i);
+  para->sep_bytes = sep_bytes;
+  para->sep_chars = sep_chars;
+}
+
+static void
+clutter_text_paragraphs_inserted (ClutterText *text,
+                                  gint         position,
+                                  gint         n_chars,
+                                  gint         n_bytes)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterTextBuffer *buffer = get_buffer (text);
+  gint para_chars, para_bytes;
+  gint char_start, byte_start;
+  Paragraph *para;
+  guint i;
+
+  if (priv->paragraphs == NULL || priv->paragraphs->len == 0)
+    return;
+
+  /* the paragraphs might have been created after the buffer
+   * was changed, e.g. by a ClutterText::text-changed handler
+   * querying the size of the actor; in that case they are
+   * already up to date
+   */
+  clutter_text_get_paragraphs_size (text, &para_chars, &para_bytes);
+  if (para_chars == clutter_text_buffer_get_length (buffer))
+    return;
+
+  if (para_chars + n_chars != clutter_text_buffer_get_length (buffer))
+    {
+      clutter_text_clear_paragraphs (text);
+      return;
+    }
+
+  i = clutter_text_find_paragraph (text, position, &char_start, &byte_start);
+  para = &g_array_index (priv->paragraphs, Paragraph, i);
+
+  clutter_text_replace_paragraphs (text, i, i,
+                                   byte_start,
+                                   para->n_bytes + n_bytes);
+}
+
+static void
+clutter_text_paragraphs_deleted (ClutterText *text,
+                                 gint         position,
+                                 gint         n_chars)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterTextBuffer *buffer = get_buffer (text);
+  gint para_chars, para_bytes;
+  gint char_start, byte_start;
+  gint last_char_start, last_byte_start;
+  Paragraph *last_para;
+  guint first, last;
+  gint n_bytes;
+
+  if (priv->paragraphs == NULL || priv->paragraphs->len == 0)
+    return;
+
+  clutter_text_get_paragraphs_size (text, &para_chars, &para_bytes);
+  if (para_chars == clutter_text_buffer_get_length (buffer))
+    return;
+
+  if (para_chars - n_chars != clutter_text_buffer_get_length (buffer))
+    {
+      clutter_text_clear_paragraphs (text);
+      return;
+    }
+
+  first = clutter_text_find_paragraph (text, position,
+                                       &char_start,
+                                       &byte_start);
+  last = clutter_text_find_paragraph (text, position + n_chars,
+                                      &last_char_start,
+                                      &last_byte_start);
+  last_para = &g_array_index (priv->paragraphs, Paragraph, last);
+
+  /* the bytes of the old paragraphs, minus the deleted ones */
+  n_bytes = last_byte_start + last_para->n_bytes - byte_start
+          - (para_bytes - (gint) clutter_text_buffer_get_bytes (buffer));
+
+  clutter_text_replace_paragraphs (text, first, last, byte_start, n_bytes);
+}
+
+static void
+clutter_text_shape_paragraph (ClutterText *text,
+                              Paragraph   *para,
+                              const gchar *contents)
+{
+  ClutterTextPrivate *priv = text->priv;
+  PangoRectangle logical_rect = { 0, };
+  PangoLayout *layout;
+
+  CLUTTER_STATIC_TIMER (paragraph_layout_timer,
+                        "Text Layout",
+                        "Paragraph Layout",
+                        "Paragraph layout creation",
+                        0);
+
+  CLUTTER_TIMER_START (_clutter_uprof_context, paragraph_layout_timer);
+
+  layout = clutter_actor_create_pango_layout (CLUTTER_ACTOR (text), NULL);
+  pango_layout_set_font_description (layout, priv->font_desc);
+  pango_layout_set_text (layout, contents, para->n_bytes);
+
+  pango_layout_set_alignment (layout, priv->alignment);
+  pango_layout_set_justify (layout, priv->justify);
+  pango_layout_set_wrap (layout, priv->wrap_mode);
+
+  /* the unwrapped size is needed for the preferred size */
+  pango_layout_get_extents (layout, NULL, &logical_rect);
+  para->natural_width = logical_rect.x + logical_rect.width;
+  para->natural_height = logical_rect.y + logical_rect.height;
+
+  pango_layout_set_width (layout, priv->paragraph_width);
+  pango_layout_get_extents (layout, &para->ink_rect, &logical_rect);
+  para->height = logical_rect.y + logical_rect.height;
+
+  cogl_pango_ensure_glyph_cache_for_layout (layout);
+
+  para->layout = layout;
+
+  CLUTTER_TIMER_STOP (_clutter_uprof_context, paragraph_layout_timer);
+}
+
+/*
+ * clutter_text_ensure_paragraphs:
+ * @text: a #ClutterText
+ * @width: the width of the paragraphs, in Pango units, or -1
+ *
+ * Ensures that every paragraph of @text has been shaped using
+ * the given @width. Only the paragraphs that have been changed
+ * since the last call, or all the paragraphs if @width changed,
+ * will be laid out again.
+ */
+static void
+clutter_text_ensure_paragraphs (ClutterText *text,
+                                gint         width)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterTextBuffer *buffer = get_buffer (text);
+  const gchar *contents;
+  gint n_chars, n_bytes;
+  guint i;
+
+  CLUTTER_STATIC_COUNTER (paragraph_shaped_counter,
+                          "Text paragraphs shaped",
+                          "Increments for each paragraph layout created",
+                          0);
+
+  if (priv->paragraphs == NULL)
+    priv->paragraphs = g_array_new (FALSE, FALSE, sizeof (Paragraph));
+
+  if (priv->paragraphs->len != 0)
+    {
+      clutter_text_get_paragraphs_size (text, &n_chars, &n_bytes);
+
+      if (n_chars != clutter_text_buffer_get_length (buffer) ||
+          n_bytes != clutter_text_buffer_get_bytes (buffer))
+        clutter_text_clear_paragraphs (text);
+    }
+
+  if (priv->paragraphs->len == 0)
+    clutter_text_split_paragraphs (text, 0,
+                                   clutter_text_buffer_get_text (buffer),
+                                   clutter_text_buffer_get_bytes (buffer));
+
+  if (priv->paragraph_width != width)
+    {
+      priv->paragraph_width = width;
+      clutter_text_dirty_paint_volume (text);
+
+      /* the unwrapped size does not change */
+      for (i = 0; i < priv->paragraphs->len; i++)
+        {
+          Paragraph *para = &g_array_index (priv->paragraphs, Paragraph, i);
+          PangoRectangle logical_rect = { 0, };
+
+          if (para->layout == NULL)
+            continue;
+
+          pango_layout_set_width (para->layout, width);
+          pango_layout_get_extents (para->layout,
+                                    &para->ink_rect,
+                                    &logical_rect);
+          para->height = logical_rect.y + logical_rect.height;
+        }
+    }
+
+  for (i = 0, n_bytes = 0; i < priv->paragraphs->len; i++)
+    {
+      Paragraph *para = &g_array_index (priv->paragraphs, Paragraph, i);
+
+      if (para->layout == NULL)
+        {
+          /* only read the text of the paragraph, to avoid moving
+           * the gap of the buffer away from the last edit
+           */
+          contents = _clutter_text_buffer_get_text_range (buffer,
+                                                          n_bytes,
+                                                          para->n_bytes);
+          clutter_text_shape_paragraph (text, para, contents);
+
+          CLUTTER_COUNTER_INC (_clutter_uprof_context,
+                               paragraph_shaped_counter);
+        }
+
+      n_bytes += para->n_bytes + para->sep_bytes;
+    }
+}
+
+/*
+ * clutter_text_get_paragraphs_extents:
+ * @text: a #ClutterText
+ * @ink_rect: return location for the ink rectangle, or %NULL
+ * @natural_width: return location for the unwrapped width, or %NULL
+ * @natural_height: return location for the unwrapped height, or %NULL
+ * @height: return location for the height, or %NULL
+ *
+ * Retrieves the extents of the paragraphs of @text, in Pango units;
+ * clutter_text_ensure_paragraphs() must have been called first.
+ */
+static void
+clutter_text_get_paragraphs_extents (ClutterText    *text,
+                                     PangoRectangle *ink_rect,
+                                     gint           *natural_width,
+                                     gint           *natural_height,
+                                     gint           *height)
+{
+  GArray *paragraphs = text->priv->paragraphs;
+  gint x_1 = G_MAXINT, y_1 = G_MAXINT;
+  gint x_2 = G_MININT, y_2 = G_MININT;
+  gint max_width = 0;
+  gint unwrapped_height = 0;
+  gint y = 0;
+  guint i;
+
+  for (i = 0; i < paragraphs->len; i++)
+    {
+      const Paragraph *para = &g_array_index (paragraphs, Paragraph, i);
+
+      max_width = MAX (max_width, para->natural_width);
+      unwrapped_height += para->natural_height;
+
+      if (para->ink_rect.width > 0 && para->ink_rect.height > 0)
+        {
+          x_1 = MIN (x_1, para->ink_rect.x);
+          y_1 = MIN (y_1, y + para->ink_rect.y);
+          x_2 = MAX (x_2, para->ink_rect.x + para->ink_rect.width);
+          y_2 = MAX (y_2, y + para->ink_rect.y + para->ink_rect.height);
+        }
+
+      y += para->height;
+    }
+
+  if (ink_rect != NULL)
+    {
+      if (x_1 > x_2)
+        {
+          ink_rect->x = ink_rect->y = 0;
+          ink_rect->width = ink_rect->height = 0;
+        }
+      else
+        {
+          ink_rect->x = x_1;
+          ink_rect->y = y_1;
+          ink_rect->width = x_2 - x_1;
+          ink_rect->height = y_2 - y_1;
+        }
+    }
+
+  if (natural_width != NULL)
+    *natural_width = max_width;
 
-  g_free (contents);
+  if (natural_height != NULL)
+    *natural_height = unwrapped_height;
 
-  CLUTTER_TIMER_STOP (_clutter_uprof_context, text_layout_timer);
-
-  return layout;
+  if (height != NULL)
+    *height = y;
 }
 
+/*
+ * clutter_text_get_paragraph_cursor_pos:
+ * @text: a #ClutterText
+ * @position: a position in characters, or -1
+ * @rect: return location for the cursor rectangle, in Pango units
+ *
+ * Like pango_layout_get_cursor_pos(), but using the paragraphs of
+ * @text instead of a layout of the whole contents.
+ */
 static void
-clutter_text_dirty_cache (ClutterText *text)
+clutter_text_get_paragraph_cursor_pos (ClutterText    *text,
+                                       gint            position,
+                                       PangoRectangle *rect)
 {
   ClutterTextPrivate *priv = text->priv;
-  int i;
+  ClutterTextBuffer *buffer = get_buffer (text);
+  const gchar *contents;
+  const Paragraph *para;
+  gint char_start, byte_start;
+  gfloat width;
+  gint index_, y;
+  guint i, j;
+
+  /* like clutter_text_get_layout(), use the current width */
+  clutter_actor_get_size (CLUTTER_ACTOR (text), &width, NULL);
+  clutter_text_ensure_paragraphs (text, clutter_text_paragraph_width (width));
 
-  /* Delete the cached layouts so they will be recreated the next time
-     they are needed */
-  for (i = 0; i < N_CACHED_LAYOUTS; i++)
-    if (priv->cached_layouts[i].layout)
-      {
-	g_object_unref (priv->cached_layouts[i].layout);
-	priv->cached_layouts[i].layout = NULL;
-      }
+  if (position == -1)
+    position = clutter_text_buffer_get_length (buffer);
 
-  clutter_text_dirty_paint_volume (text);
+  i = clutter_text_find_paragraph (text, position, &char_start, &byte_start);
+  para = &g_array_index (priv->paragraphs, Paragraph, i);
+
+  for (j = 0, y = 0; j < i; j++)
+    y += g_array_index (priv->paragraphs, Paragraph, j).height;
+
+  /* a position inside the separator is at the end of the paragraph,
+   * like it is for the layout of the whole text
+   */
+  contents = _clutter_text_buffer_get_text_range (buffer,
+                                                  byte_start,
+                                                  para->n_bytes);
+  index_ = g_utf8_offset_to_pointer (contents,
+                                     MIN (position - char_start,
+                                          para->n_chars))
+         - contents;
+
+  pango_layout_get_cursor_pos (para->layout, index_, rect, NULL);
+  rect->y += y;
 }
 
 /*
@@ -619,6 +1812,9 @@ clutter_text_settings_changed_cb (ClutterText *text)
       g_free (font_name);
     }
 
+  /* the shared layouts use the old settings as well */
+  clutter_text_clear_shared_layouts ();
+
   clutter_text_dirty_cache (text);
   clutter_actor_queue_relayout (CLUTTER_ACTOR (text));
 }
@@ -650,6 +1846,7 @@ clutter_text_create_layout (ClutterText *text,
 {
   ClutterTextPrivate *priv = text->priv;
   LayoutCache *oldest_cache = priv->cached_layouts;
+  PangoLayout *layout;
   gboolean found_free_cache = FALSE;
   gint width = -1;
   gint height = -1;
@@ -815,15 +2012,28 @@ clutter_text_create_layout (ClutterText *text,
 
   CLUTTER_COUNTER_INC (_clutter_uprof_context, text_cache_miss_counter);
 
+  /* the layout might be created in a worker thread */
+  layout = clutter_text_create_layout_async (text, width, height, ellipsize);
+  if (layout != NULL)
+    return layout;
+
   /* If we make it here then we didn't have a cached version so we
      need to recreate the layout */
   if (oldest_cache->layout)
     g_object_unref (oldest_cache->layout);
 
   oldest_cache->layout =
-    clutter_text_create_layout_no_cache (text, width, height, ellipsize);
+    clutter_text_get_shared_layout (text, width, height, ellipsize);
+
+  if (oldest_cache->layout == NULL)
+    oldest_cache->layout =
+      clutter_text_create_layout_no_cache (text, width, height, ellipsize);
 
-  cogl_pango_ensure_glyph_cache_for_layout (oldest_cache->layout);
+  /* long layouts are only partially visible, so we let the glyphs
+   * of the lines that are actually rendered be cached when painting
+   */
+  if (pango_layout_get_line_count (oldest_cache->layout) <= N_PRECACHED_LINES)
+    cogl_pango_ensure_glyph_cache_for_layout (oldest_cache->layout);
 
   /* Mark the 'time' this cache was created and advance the time */
   oldest_cache->age = priv->cache_age++;
@@ -905,6 +2115,23 @@ clutter_text_position_to_coords (ClutterText *self,
   if (position < -1 || position > n_chars)
     return FALSE;
 
+  /* editable texts are usually laid out one paragraph at a time */
+  if (clutter_text_use_paragraphs (self))
+    {
+      clutter_text_get_paragraph_cursor_pos (self, position, &rect);
+
+      if (x)
+        *x = (gfloat) rect.x / 1024.0f;
+
+      if (y)
+        *y = (gfloat) rect.y / 1024.0f;
+
+      if (line_height)
+        *line_height = (gfloat) rect.height / 1024.0f;
+
+      return TRUE;
+    }
+
   if (priv->password_char != 0)
     password_char_bytes = g_unichar_to_utf8 (priv->password_char, NULL);
 
@@ -927,7 +2154,8 @@ clutter_text_position_to_coords (ClutterText *self,
     }
   else
     {
-      gchar *text = clutter_text_get_display_text (self);
+      gchar *str = NULL;
+      const gchar *text = clutter_text_get_display_text (self, &str);
       GString *tmp = g_string_new (text);
       gint cursor_index;
 
@@ -941,7 +2169,7 @@ clutter_text_position_to_coords (ClutterText *self,
       else
         index_ = position * password_char_bytes;
 
-      g_free (text);
+      g_free (str);
       g_string_free (tmp, TRUE);
     }
 
@@ -1262,6 +2490,14 @@ clutter_text_set_property (GObject      *gobject,
       clutter_text_set_selected_text_color (self, clutter_value_get_color (value));
       break;
 
+    case PROP_SHARE_LAYOUT:
+      clutter_text_set_share_layout (self, g_value_get_boolean (value));
+      break;
+
+    case PROP_ASYNC_LAYOUT:
+      clutter_text_set_async_layout (self, g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -1390,6 +2626,14 @@ clutter_text_get_property (GObject    *gobject,
       g_value_set_boolean (value, priv->selected_text_color_set);
       break;
 
+    case PROP_SHARE_LAYOUT:
+      g_value_set_boolean (value, priv->share_layout);
+      break;
+
+    case PROP_ASYNC_LAYOUT:
+      g_value_set_boolean (value, priv->async_layout);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -1404,6 +2648,12 @@ clutter_text_dispose (GObject *gobject)
   /* get rid of the entire cache */
   clutter_text_dirty_cache (self);
 
+  if (priv->fallback_layout != NULL)
+    {
+      g_object_unref (priv->fallback_layout);
+      priv->fallback_layout = NULL;
+    }
+
   if (priv->direction_changed_id)
     {
       g_signal_handler_disconnect (self, priv->direction_changed_id);
@@ -1437,6 +2687,9 @@ clutter_text_finalize (GObject *gobject)
   if (priv->font_desc)
     pango_font_description_free (priv->font_desc);
 
+  if (priv->paragraphs != NULL)
+    g_array_free (priv->paragraphs, TRUE);
+
   if (priv->attrs)
     pango_attr_list_unref (priv->attrs);
   if (priv->markup_attrs)
@@ -1454,22 +2707,114 @@ clutter_text_finalize (GObject *gobject)
   G_OBJECT_CLASS (clutter_text_parent_class)->finalize (gobject);
 }
 
+/* layouts taller than this many times their visible part are
+ * rendered one line at a time, instead of as a whole
+ */
+#define VISIBLE_LINES_FACTOR    2
+
+/*
+ * clutter_text_render_layout:
+ * @text: a #ClutterText
+ * @layout: the #PangoLayout to render
+ * @x: the X coordinate of the layout, in pixels
+ * @y: the Y coordinate of the layout, in pixels
+ * @color: the color of the text
+ * @clip: (allow-none): the visible box of @text, or %NULL
+ *
+ * Like cogl_pango_render_layout(), but only renders the lines of
+ * @layout intersecting @clip, if the rest of the layout is large
+ * enough that it's worth skipping it.
+ */
+static void
+clutter_text_render_layout (ClutterText           *text,
+                            PangoLayout           *layout,
+                            gint                   x,
+                            gint                   y,
+                            const CoglColor       *color,
+                            const ClutterActorBox *clip)
+{
+  PangoRectangle logical_rect = { 0, };
+  PangoLayoutIter *iter;
+
+  CLUTTER_STATIC_COUNTER (text_lines_skipped_counter,
+                          "Text lines skipped",
+                          "Increments for each line of text not rendered "
+                          "because it was outside the visible box",
+                          0);
+
+  if (clip != NULL)
+    {
+      pango_layout_get_pixel_extents (layout, NULL, &logical_rect);
+
+      if ((clip->y2 - clip->y1) * VISIBLE_LINES_FACTOR >= logical_rect.height)
+        clip = NULL;
+    }
+
+  /* the display list of the whole layout is cached by Cogl */
+  if (clip == NULL)
+    {
+      cogl_pango_render_layout (layout, x, y, color, 0);
+      return;
+    }
+
+  iter = pango_layout_get_iter (layout);
+
+  do
+    {
+      gint y0, y1;
+
+      pango_layout_iter_get_line_yrange (iter, &y0, &y1);
+
+      if (y + y1 / (gfloat) PANGO_SCALE < clip->y1)
+        {
+          CLUTTER_COUNTER_INC (_clutter_uprof_context,
+                               text_lines_skipped_counter);
+          continue;
+        }
+
+      if (y + y0 / (gfloat) PANGO_SCALE > clip->y2)
+        break;
+
+      pango_layout_iter_get_line_extents (iter, NULL, &logical_rect);
+
+      cogl_pango_render_layout_line (pango_layout_iter_get_line_readonly (iter),
+                                     x * PANGO_SCALE + logical_rect.x,
+                                     y * PANGO_SCALE
+                                     + pango_layout_iter_get_baseline (iter),
+                                     color);
+    }
+  while (pango_layout_iter_next_line (iter));
+
+  pango_layout_iter_free (iter);
+}
+
 typedef void (* ClutterTextSelectionFunc) (ClutterText           *text,
                                            const ClutterActorBox *box,
                                            gpointer               user_data);
 
+/*
+ * clutter_text_foreach_selection_rectangle:
+ * @self: a #ClutterText
+ * @clip: (allow-none): the visible box of @self, or %NULL
+ * @func: the function to call for each rectangle of the selection
+ * @user_data: data to pass to @func
+ *
+ * Calls @func for each rectangle of the selection on the lines of
+ * the layout intersecting @clip, or on every line if @clip is %NULL.
+ */
 static void
 clutter_text_foreach_selection_rectangle (ClutterText              *self,
+                                          const ClutterActorBox    *clip,
                                           ClutterTextSelectionFunc  func,
                                           gpointer                  user_data)
 {
   ClutterTextPrivate *priv = self->priv;
   PangoLayout *layout = clutter_text_get_layout (self);
-  gchar *utf8 = clutter_text_get_display_text (self);
-  gint lines;
+  PangoLayoutIter *iter;
+  gchar *str = NULL;
+  const gchar *utf8 = clutter_text_get_display_text (self, &str);
   gint start_index;
   gint end_index;
-  gint line_no;
 
   if (priv->position == 0)
     start_index = 0;
@@ -1488,9 +2833,9 @@ clutter_text_foreach_selection_rectangle (ClutterText              *self,
       end_index = temp;
     }
 
-  lines = pango_layout_get_line_count (layout);
+  iter = pango_layout_get_iter (layout);
 
-  for (line_no = 0; line_no < lines; line_no++)
+  do
     {
       PangoLayoutLine *line;
       gint n_ranges;
@@ -1501,11 +2846,27 @@ clutter_text_foreach_selection_rectangle (ClutterText              *self,
       ClutterActorBox box;
       gfloat y, height;
 
-      line = pango_layout_get_line_readonly (layout, line_no);
+      if (clip != NULL)
+        {
+          gint y0, y1;
+
+          pango_layout_iter_get_line_yrange (iter, &y0, &y1);
+
+          if (priv->text_y + y1 / (gfloat) PANGO_SCALE < clip->y1)
+            continue;
+
+          if (priv->text_y + y0 / (gfloat) PANGO_SCALE > clip->y2)
+            break;
+        }
+
+      line = pango_layout_iter_get_line_readonly (iter);
       pango_layout_line_x_to_index (line, G_MAXINT, &maxindex, NULL);
       if (maxindex < start_index)
         continue;
 
+      if (line->start_index > end_index)
+        break;
+
       pango_layout_line_get_x_ranges (line, start_index, end_index,
                                       &ranges,
                                       &n_ranges);
@@ -1541,8 +2902,11 @@ clutter_text_foreach_selection_rectangle (ClutterText              *self,
 
       g_free (ranges);
     }
+  while (pango_layout_iter_next_line (iter));
+
+  pango_layout_iter_free (iter);
 
-  g_free (utf8);
+  g_free (str);
 }
 
 static void
@@ -1555,7 +2919,8 @@ add_selection_rectangle_to_path (ClutterText           *text,
 
 /* Draws the selected text, its background, and the cursor */
 static void
-selection_paint (ClutterText *self)
+selection_paint (ClutterText           *self,
+                 const ClutterActorBox *clip)
 {
   ClutterTextPrivate *priv = self->priv;
   ClutterActor *actor = CLUTTER_ACTOR (self);
@@ -1611,7 +2976,7 @@ selection_paint (ClutterText *self)
                                     color->blue,
                                     paint_opacity * color->alpha / 255);
 
-          clutter_text_foreach_selection_rectangle (self,
+          clutter_text_foreach_selection_rectangle (self, clip,
                                                     add_selection_rectangle_to_path,
                                                     selection_path);
 
@@ -1633,7 +2998,10 @@ selection_paint (ClutterText *self)
                                     color->blue,
                                     paint_opacity * color->alpha / 255);
 
-          cogl_pango_render_layout (layout, priv->text_x, 0, &cogl_color, 0);
+          clutter_text_render_layout (self, layout,
+                                      priv->text_x, 0,
+                                      &cogl_color,
+                                      clip);
 
           cogl_clip_pop ();
         }
@@ -2004,6 +3372,52 @@ clutter_text_key_press (ClutterActor    *actor,
 
 #define TEXT_PADDING    2
 
+static void
+clutter_text_paint_paragraphs (ClutterText           *text,
+                               gint                   x,
+                               gint                   y,
+                               const CoglColor       *color,
+                               const ClutterActorBox *clip)
+{
+  GArray *paragraphs = text->priv->paragraphs;
+  gfloat para_y = y;
+  guint i;
+
+  for (i = 0; i < paragraphs->len; i++)
+    {
+      const Paragraph *para = &g_array_index (paragraphs, Paragraph, i);
+      gfloat height = para->height / (gfloat) PANGO_SCALE;
+      ClutterActorBox para_clip;
+
+      /* skip the paragraphs outside of the visible box */
+      if (clip != NULL)
+        {
+          if (para_y + height < clip->y1)
+            {
+              para_y += height;
+              continue;
+            }
+
+          if (para_y > clip->y2)
+            break;
+
+          para_clip = *clip;
+          para_clip.y1 -= para_y - y;
+          para_clip.y2 -= para_y - y;
+        }
+
+      cogl_push_matrix ();
+      cogl_translate (0, para_y - y, 0);
+      clutter_text_render_layout (text, para->layout,
+                                  x, y,
+                                  color,
+                                  clip != NULL ? &para_clip : NULL);
+      cogl_pop_matrix ();
+
+      para_y += height;
+    }
+}
+
 static void
 clutter_text_paint (ClutterActor *self)
 {
@@ -2011,6 +3425,8 @@ clutter_text_paint (ClutterActor *self)
   ClutterTextPrivate *priv = text->priv;
   PangoLayout *layout;
   ClutterActorBox alloc = { 0, };
+  ClutterActorBox visible = { 0, };
+  const ClutterActorBox *clip = NULL;
   CoglColor color = { 0, };
   guint8 real_opacity;
   gint text_x = priv->text_x;
@@ -2050,7 +3466,16 @@ clutter_text_paint (ClutterActor *self)
       cogl_rectangle (0, 0, alloc.x2 - alloc.x1, alloc.y2 - alloc.y1);
     }
 
-  if (priv->editable && priv->single_line_mode)
+  if (clutter_text_use_paragraphs (text))
+    {
+      /* editable, multi-line texts are laid out one paragraph
+       * at a time, so that editing them is cheap
+       */
+      clutter_text_ensure_paragraphs (text,
+                                      clutter_text_paragraph_width (alloc.x2 - alloc.x1));
+      layout = NULL;
+    }
+  else if (priv->editable && priv->single_line_mode)
     layout = clutter_text_create_layout (text, -1, -1);
   else
     {
@@ -2172,9 +3597,19 @@ clutter_text_paint (ClutterActor *self)
                             priv->text_color.green,
                             priv->text_color.blue,
                             real_opacity);
-  cogl_pango_render_layout (layout, text_x, priv->text_y, &color, 0);
+  /* only render the lines that can end up on the stage */
+  if (_clutter_actor_get_visible_box (self, &visible))
+    clip = &visible;
+
+  if (layout != NULL)
+    clutter_text_render_layout (text, layout,
+                                text_x, priv->text_y,
+                                &color,
+                                clip);
+  else
+    clutter_text_paint_paragraphs (text, text_x, priv->text_y, &color, clip);
 
-  selection_paint (text);
+  selection_paint (text, clip);
 
   if (clip_set)
     cogl_clip_pop ();
@@ -2223,7 +3658,7 @@ clutter_text_get_paint_volume_for_cursor (ClutterText        *text,
     }
   else
     {
-      clutter_text_foreach_selection_rectangle (text,
+      clutter_text_foreach_selection_rectangle (text, NULL,
                                                 add_selection_to_paint_volume,
                                                 volume);
     }
@@ -2262,8 +3697,22 @@ clutter_text_get_paint_volume (ClutterActor       *self,
 
       _clutter_paint_volume_init_static (&priv->paint_volume, self);
 
-      layout = clutter_text_get_layout (text);
-      pango_layout_get_extents (layout, &ink_rect, NULL);
+      if (clutter_text_use_paragraphs (text))
+        {
+          ClutterActorBox alloc = { 0, };
+
+          clutter_actor_get_allocation_box (self, &alloc);
+
+          clutter_text_ensure_paragraphs (text,
+                                          clutter_text_paragraph_width (alloc.x2 - alloc.x1));
+          clutter_text_get_paragraphs_extents (text, &ink_rect,
+                                               NULL, NULL, NULL);
+        }
+      else
+        {
+          layout = clutter_text_get_layout (text);
+          pango_layout_get_extents (layout, &ink_rect, NULL);
+        }
 
       origin.x = ink_rect.x / (float) PANGO_SCALE;
       origin.y = ink_rect.y / (float) PANGO_SCALE;
@@ -2312,15 +3761,25 @@ clutter_text_get_preferred_width (ClutterActor *self,
   gint logical_width;
   gfloat layout_width;
 
-  layout = clutter_text_create_layout (text, -1, -1);
+  if (clutter_text_use_paragraphs (text))
+    {
+      /* the unwrapped width of each paragraph is cached */
+      clutter_text_ensure_paragraphs (text, priv->paragraph_width);
+      clutter_text_get_paragraphs_extents (text, NULL, &logical_width,
+                                           NULL, NULL);
+    }
+  else
+    {
+      layout = clutter_text_create_layout (text, -1, -1);
 
-  pango_layout_get_extents (layout, NULL, &logical_rect);
+      pango_layout_get_extents (layout, NULL, &logical_rect);
 
-  /* the X coordinate of the logical rectangle might be non-zero
-   * according to the Pango documentation; hence, we need to offset
-   * the width accordingly
-   */
-  logical_width = logical_rect.x + logical_rect.width;
+      /* the X coordinate of the logical rectangle might be non-zero
+       * according to the Pango documentation; hence, we need to offset
+       * the width accordingly
+       */
+      logical_width = logical_rect.x + logical_rect.width;
+    }
 
   layout_width = logical_width > 0
     ? ceilf (logical_width / 1024.0f)
@@ -2369,16 +3828,53 @@ clutter_text_get_preferred_height (ClutterActor *self,
       if (priv->single_line_mode)
         for_width = -1;
 
-      layout = clutter_text_create_layout (CLUTTER_TEXT (self),
-                                           for_width, -1);
+      if (clutter_text_use_paragraphs (CLUTTER_TEXT (self)))
+        {
+          gint width = clutter_text_paragraph_width (for_width);
+          gint natural_width, natural_height;
+
+          clutter_text_ensure_paragraphs (CLUTTER_TEXT (self),
+                                          priv->paragraph_width);
+          clutter_text_get_paragraphs_extents (CLUTTER_TEXT (self),
+                                               NULL,
+                                               &natural_width,
+                                               &natural_height,
+                                               &logical_height);
+
+          /* like clutter_text_create_layout(), measure the height of
+           * a text that does not wrap without any width; otherwise,
+           * the width only matters if we need to wrap, either at the
+           * width we have been given or at the current one
+           */
+          if (!priv->wrap)
+            logical_height = natural_height;
+          else if (width != priv->paragraph_width &&
+                   !((width < 0 || width >= natural_width) &&
+                     (priv->paragraph_width < 0 ||
+                      priv->paragraph_width >= natural_width)))
+            {
+              clutter_text_ensure_paragraphs (CLUTTER_TEXT (self), width);
+              clutter_text_get_paragraphs_extents (CLUTTER_TEXT (self),
+                                                   NULL, NULL, NULL,
+                                                   &logical_height);
+            }
+
+          layout = NULL;
+        }
+      else
+        {
+          layout = clutter_text_create_layout (CLUTTER_TEXT (self),
+                                               for_width, -1);
 
-      pango_layout_get_extents (layout, NULL, &logical_rect);
+          pango_layout_get_extents (layout, NULL, &logical_rect);
+
+          /* the Y coordinate of the logical rectangle might be non-zero
+           * according to the Pango documentation; hence, we need to offset
+           * the height accordingly
+           */
+          logical_height = logical_rect.y + logical_rect.height;
+        }
 
-      /* the Y coordinate of the logical rectangle might be non-zero
-       * according to the Pango documentation; hence, we need to offset
-       * the height accordingly
-       */
-      logical_height = logical_rect.y + logical_rect.height;
       layout_height = ceilf (logical_height / 1024.0f);
 
       if (min_height_p)
@@ -2423,7 +3919,10 @@ clutter_text_allocate (ClutterActor           *self,
    * to have any limit on the layout size, since the paint will clip
    * it to the allocation of the actor
    */
-  if (text->priv->editable && text->priv->single_line_mode)
+  if (clutter_text_use_paragraphs (text))
+    clutter_text_ensure_paragraphs (text,
+                                    clutter_text_paragraph_width (box->x2 - box->x1));
+  else if (text->priv->editable && text->priv->single_line_mode)
     clutter_text_create_layout (text, -1, -1);
   else
     clutter_text_create_layout (text,
@@ -3623,6 +5122,54 @@ clutter_text_class_init (ClutterTextClass *klass)
   obj_props[PROP_SELECTED_TEXT_COLOR_SET] = pspec;
   g_object_class_install_property (gobject_class, PROP_SELECTED_TEXT_COLOR_SET, pspec);
 
+  /**
+   * ClutterText:share-layout:
+   *
+   * Whether the #PangoLayout of the #ClutterText should be shared with
+   * other #ClutterText actors using the same contents, font and layout
+   * properties.
+   *
+   * Sharing layouts saves memory and shaping time in user interfaces
+   * showing the same strings many times, e.g. the cells of a large
+   * table. Only the layouts of non-editable #ClutterText actors that
+   * do not use attributes or markup are shared.
+   *
+   * Since: 1.12
+   */
+  pspec = g_param_spec_boolean ("share-layout",
+                                P_("Share Layout"),
+                                P_("Whether the layout should be shared with other actors"),
+                                FALSE,
+                                CLUTTER_PARAM_READWRITE);
+  obj_props[PROP_SHARE_LAYOUT] = pspec;
+  g_object_class_install_property (gobject_class, PROP_SHARE_LAYOUT, pspec);
+
+  /**
+   * ClutterText:async-layout:
+   *
+   * Whether the #PangoLayout of the #ClutterText should be created
+   * in a worker thread.
+   *
+   * Shaping long strings, or strings using complex scripts, can take
+   * a long time. When this property is set, a #ClutterText will keep
+   * using its previous layout, or an empty one, while the new layout
+   * is created in a separate thread; once the new layout is ready,
+   * the #ClutterText will queue a relayout.
+   *
+   * This property is ignored if the #ClutterText is editable, if
+   * #ClutterText:share-layout is set, or if the version of Pango in
+   * use is not thread-safe.
+   *
+   * Since: 1.12
+   */
+  pspec = g_param_spec_boolean ("async-layout",
+                                P_("Asynchronous Layout"),
+                                P_("Whether the layout should be created in a separate thread"),
+                                FALSE,
+                                CLUTTER_PARAM_READWRITE);
+  obj_props[PROP_ASYNC_LAYOUT] = pspec;
+  g_object_class_install_property (gobject_class, PROP_ASYNC_LAYOUT, pspec);
+
   /**
    * ClutterText::text-changed:
    * @self: the #ClutterText that emitted the signal
@@ -3843,6 +5390,9 @@ clutter_text_init (ClutterText *self)
   for (i = 0; i < N_CACHED_LAYOUTS; i++)
     priv->cached_layouts[i].layout = NULL;
 
+  priv->paragraphs = NULL;
+  priv->paragraph_width = -1;
+
   /* default to "" so that clutter_text_get_text() will
    * return a valid string and we can safely call strlen()
    * or strcmp() on it
@@ -4004,6 +5554,12 @@ buffer_inserted_text (ClutterTextBuffer *buffer,
   gsize n_bytes;
 
   priv = self->priv;
+
+  n_bytes = g_utf8_offset_to_pointer (chars, n_chars) - chars;
+
+  /* only lay out again the paragraph that changed */
+  clutter_text_paragraphs_inserted (self, position, n_chars, n_bytes);
+
   if (priv->position >= 0 || priv->selection_bound >= 0)
     {
       new_position = priv->position;
@@ -4018,7 +5574,6 @@ buffer_inserted_text (ClutterTextBuffer *buffer,
         clutter_text_set_positions (self, new_position, new_selection_bound);
     }
 
-  n_bytes = g_utf8_offset_to_pointer (chars, n_chars) - chars;
   g_signal_emit (self, text_signals[INSERT_TEXT], 0, chars,
                  n_bytes, &position);
 
@@ -4036,6 +5591,9 @@ buffer_deleted_text (ClutterTextBuffer *buffer,
   gint new_selection_bound;
 
   priv = self->priv;
+
+  clutter_text_paragraphs_deleted (self, position, n_chars);
+
   if (priv->position >= 0 || priv->selection_bound >= 0)
     {
       new_position = priv->position;
@@ -4060,7 +5618,10 @@ buffer_notify_text (ClutterTextBuffer *buffer,
 {
   g_object_freeze_notify (G_OBJECT (self));
 
-  clutter_text_dirty_cache (self);
+  /* the paragraphs are updated by the ::inserted-text and
+   * ::deleted-text handlers
+   */
+  clutter_text_dirty_layouts (self);
 
   clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
 
@@ -4172,6 +5733,8 @@ clutter_text_set_buffer (ClutterText       *self,
   if (priv->buffer)
      buffer_connect_signals (self);
 
+  clutter_text_dirty_cache (self);
+
   obj = G_OBJECT (self);
   g_object_freeze_notify (obj);
   g_object_notify (obj, "buffer");
@@ -5426,6 +6989,119 @@ clutter_text_get_justify (ClutterText *self)
   return self->priv->justify;
 }
 
+/**
+ * clutter_text_set_share_layout:
+ * @self: a #ClutterText
+ * @share_layout: whether the layout should be shared
+ *
+ * Sets whether the #PangoLayout of @self should be shared with other
+ * #ClutterText actors with the same contents, font and layout
+ * properties. See #ClutterText:share-layout for details.
+ *
+ * A shared layout, like the one returned by clutter_text_get_layout(),
+ * must not be modified.
+ *
+ * Since: 1.12
+ */
+void
+clutter_text_set_share_layout (ClutterText *self,
+                               gboolean     share_layout)
+{
+  ClutterTextPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_TEXT (self));
+
+  priv = self->priv;
+
+  share_layout = !!share_layout;
+
+  if (priv->share_layout != share_layout)
+    {
+      priv->share_layout = share_layout;
+
+      /* the layout does not change, so there's no need to relayout */
+      clutter_text_dirty_layouts (self);
+
+      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_SHARE_LAYOUT]);
+    }
+}
+
+/**
+ * clutter_text_get_share_layout:
+ * @self: a #ClutterText
+ *
+ * Retrieves whether the layout of @self is shared with other actors.
+ *
+ * Return value: %TRUE if the layout is shared
+ *
+ * Since: 1.12
+ */
+gboolean
+clutter_text_get_share_layout (ClutterText *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_TEXT (self), FALSE);
+
+  return self->priv->share_layout;
+}
+
+/**
+ * clutter_text_set_async_layout:
+ * @self: a #ClutterText
+ * @async_layout: whether the layout should be created in a thread
+ *
+ * Sets whether the #PangoLayout of @self should be created in a
+ * worker thread. See #ClutterText:async-layout for details.
+ *
+ * Since: 1.12
+ */
+void
+clutter_text_set_async_layout (ClutterText *self,
+                               gboolean     async_layout)
+{
+  ClutterTextPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_TEXT (self));
+
+  priv = self->priv;
+
+  async_layout = !!async_layout;
+
+  if (priv->async_layout != async_layout)
+    {
+      priv->async_layout = async_layout;
+
+      if (!async_layout && priv->fallback_layout != NULL)
+        {
+          g_object_unref (priv->fallback_layout);
+          priv->fallback_layout = NULL;
+        }
+
+      clutter_text_dirty_layouts (self);
+
+      clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
+
+      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_ASYNC_LAYOUT]);
+    }
+}
+
+/**
+ * clutter_text_get_async_layout:
+ * @self: a #ClutterText
+ *
+ * Retrieves whether the layout of @self is created in a worker thread.
+ *
+ * Return value: %TRUE if the layout is created asynchronously
+ *
+ * Since: 1.12
+ */
+gboolean
+clutter_text_get_async_layout (ClutterText *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_TEXT (self), FALSE);
+
+  return self->priv->async_layout;
+}
+
 /**
  * clutter_text_get_cursor_position:
  * @self: a #ClutterText
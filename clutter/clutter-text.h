@@ -148,6 +148,16 @@ PangoAlignment        clutter_text_get_line_alignment   (ClutterText          *s
 void                  clutter_text_set_justify          (ClutterText          *self,
                                                          gboolean              justify);
 gboolean              clutter_text_get_justify          (ClutterText          *self);
+CLUTTER_AVAILABLE_IN_1_12
+void                  clutter_text_set_share_layout     (ClutterText          *self,
+                                                         gboolean              share_layout);
+CLUTTER_AVAILABLE_IN_1_12
+gboolean              clutter_text_get_share_layout     (ClutterText          *self);
+CLUTTER_AVAILABLE_IN_1_12
+void                  clutter_text_set_async_layout     (ClutterText          *self,
+                                                         gboolean              async_layout);
+CLUTTER_AVAILABLE_IN_1_12
+gboolean              clutter_text_get_async_layout     (ClutterText          *self);
 
 void                  clutter_text_insert_unichar       (ClutterText          *self,
                                                          gunichar              wc);
@@ -637,7 +637,11 @@ clutter_texture_pick (ClutterActor       *self,
   if (!clutter_actor_should_pick_paint (self))
     return;
 
-  if (G_LIKELY (priv->pick_with_alpha_supported) && priv->pick_with_alpha)
+  /* picking with alpha needs the texture contents, which are not
+   * available to the geometric pick; fall back to the allocation
+   */
+  if (G_LIKELY (priv->pick_with_alpha_supported) && priv->pick_with_alpha &&
+      !_clutter_context_get_geometric_pick ())
     {
       CoglColor pick_color;
 
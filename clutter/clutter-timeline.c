@@ -111,6 +111,10 @@
 #include "deprecated/clutter-timeline.h"
 
 static void clutter_scriptable_iface_init (ClutterScriptableIface *iface);
+static gdouble clutter_timeline_progress_func (ClutterTimeline *timeline,
+                                               gdouble          elapsed,
+                                               gdouble          duration,
+                                               gpointer         user_data);
 
 G_DEFINE_TYPE_WITH_CODE (ClutterTimeline, clutter_timeline, G_TYPE_OBJECT,
                          G_IMPLEMENT_INTERFACE (CLUTTER_TYPE_SCRIPTABLE,
@@ -148,6 +152,14 @@ struct _ClutterTimelinePrivate
   GDestroyNotify progress_notify;
   ClutterAnimationMode progress_mode;
 
+  /* the progress computed by the master clock for the current frame,
+   * and the state it was computed for
+   */
+  gdouble cached_progress;
+  gint64 cached_elapsed;
+  guint cached_duration;
+  ClutterAnimationMode cached_mode;
+
   guint is_playing         : 1;
 
   /* If we've just started playing and haven't yet gotten
@@ -155,6 +167,7 @@ struct _ClutterTimelinePrivate
    */
   guint waiting_first_tick : 1;
   guint auto_reverse       : 1;
+  guint has_cached_progress : 1;
 };
 
 typedef struct {
@@ -1494,6 +1507,12 @@ clutter_timeline_get_progress (ClutterTimeline *timeline)
   /* short-circuit linear progress */
   if (priv->progress_func == NULL)
     return (gdouble) priv->elapsed_time / (gdouble) priv->duration;
+
+  if (priv->has_cached_progress &&
+      priv->cached_elapsed == priv->elapsed_time &&
+      priv->cached_duration == priv->duration &&
+      priv->cached_mode == priv->progress_mode)
+    return priv->cached_progress;
   else
     return priv->progress_func (timeline,
                                 (gdouble) priv->elapsed_time,
@@ -1597,6 +1616,84 @@ _clutter_timeline_advance (ClutterTimeline *timeline,
   g_object_unref (timeline);
 }
 
+/*< private >
+ * _clutter_timeline_get_next_frame:
+ * @timeline: a #ClutterTimeline
+ * @tick_time: time of the next advance
+ * @elapsed: (out): return location for the elapsed time of the frame
+ * @duration: (out): return location for the duration of @timeline
+ * @mode: (out): return location for the progress mode of @timeline
+ *
+ * Predicts the state of @timeline after it is advanced to @tick_time,
+ * so that the master clock can compute the progress of all timelines
+ * at once, using _clutter_timeline_set_cached_progress().
+ *
+ * Return value: %TRUE if @timeline will emit a new frame using one of
+ *   the predefined non-linear progress modes
+ */
+gboolean
+_clutter_timeline_get_next_frame (ClutterTimeline      *timeline,
+                                  gint64                tick_time,
+                                  gint64               *elapsed,
+                                  guint                *duration,
+                                  ClutterAnimationMode *mode)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+  gint64 msecs, next_elapsed;
+
+  if (!priv->is_playing ||
+      priv->progress_func != clutter_timeline_progress_func)
+    return FALSE;
+
+  if (priv->waiting_first_tick)
+    msecs = 0;
+  else
+    {
+      msecs = tick_time - priv->last_frame_time;
+      if (msecs <= 0)
+        return FALSE;
+    }
+
+  if (priv->direction == CLUTTER_TIMELINE_FORWARD)
+    next_elapsed = MIN (priv->elapsed_time + msecs, priv->duration);
+  else
+    next_elapsed = MAX (priv->elapsed_time - msecs, 0);
+
+  *elapsed = next_elapsed;
+  *duration = priv->duration;
+  *mode = priv->progress_mode;
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_timeline_set_cached_progress:
+ * @timeline: a #ClutterTimeline
+ * @elapsed: the elapsed time
+ * @duration: the duration
+ * @mode: the progress mode
+ * @progress: the progress for @elapsed, @duration and @mode
+ *
+ * Stores the progress of @timeline for the next frame; the progress
+ * is only used by clutter_timeline_get_progress() if the state of
+ * @timeline matches.
+ */
+void
+_clutter_timeline_set_cached_progress (ClutterTimeline      *timeline,
+                                       gint64                elapsed,
+                                       guint                 duration,
+                                       ClutterAnimationMode  mode,
+                                       gdouble               progress)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+
+  priv->cached_progress = progress;
+  priv->cached_elapsed = elapsed;
+  priv->cached_duration = duration;
+  priv->cached_mode = mode;
+  priv->has_cached_progress = TRUE;
+}
+
 /*< private >
  * clutter_timeline_do_tick
  * @timeline: a #ClutterTimeline
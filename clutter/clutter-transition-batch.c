@@ -0,0 +1,542 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2012  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTransitionBatch: packed storage for simple transitions.
+ *
+ * Implicit transitions of properties that can be represented as up to
+ * four floating point channels do not need the full machinery of a
+ * ClutterTimeline and a ClutterInterval: the batch stores the state of
+ * all of them in parallel arrays, indexed by slot, and advances them
+ * all at once for each frame of the master clock. Each frame goes
+ * through three passes:
+ *
+ *   1. advance the elapsed time and compute the eased progress of
+ *      each transition;
+ *   2. interpolate every channel of every transition;
+ *   3. apply the new values to the animated objects.
+ *
+ * Only the last pass calls out of the batch, so transitions can be
+ * added or removed by the apply functions.
+ *
+ * The transitions of each animated object are linked together, and
+ * the object owns the index of the first one.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-transition-batch.h"
+
+#include "clutter-debug.h"
+#include "clutter-easing.h"
+
+#define MAX_CHANNELS    CLUTTER_TRANSITION_BATCH_MAX_CHANNELS
+#define NULL_SLOT       (-1)
+
+enum
+{
+  SLOT_FREE = 0,
+
+  /* waiting for the first frame, which does not advance the time */
+  SLOT_STARTING,
+
+  SLOT_RUNNING
+};
+
+struct _ClutterTransitionBatch
+{
+  /* the number of allocated slots */
+  guint size;
+
+  /* all the slots in use are below this index */
+  guint n_slots;
+
+  /* the number of slots in use */
+  guint n_active;
+
+  gint free_list;
+
+  gint64 last_tick;
+
+  /* per slot; for free slots, next is the next free slot */
+  guint8 *state;
+  guint8 *n_channels;
+  guint8 *mode;
+  gint *elapsed;
+  guint *duration;
+  float *progress;
+  gint *next;
+  gint **head;
+  gpointer *target;
+  gpointer *key;
+  ClutterTransitionBatchFunc *func;
+
+  /* per channel; each slot has MAX_CHANNELS channels */
+  float *from;
+  float *to;
+  float *value;
+};
+
+ClutterTransitionBatch *
+_clutter_transition_batch_new (void)
+{
+  ClutterTransitionBatch *batch = g_slice_new0 (ClutterTransitionBatch);
+
+  batch->free_list = NULL_SLOT;
+
+  return batch;
+}
+
+void
+_clutter_transition_batch_free (ClutterTransitionBatch *batch)
+{
+  if (batch == NULL)
+    return;
+
+  g_free (batch->state);
+  g_free (batch->n_channels);
+  g_free (batch->mode);
+  g_free (batch->elapsed);
+  g_free (batch->duration);
+  g_free (batch->progress);
+  g_free (batch->next);
+  g_free (batch->head);
+  g_free (batch->target);
+  g_free (batch->key);
+  g_free (batch->func);
+  g_free (batch->from);
+  g_free (batch->to);
+  g_free (batch->value);
+
+  g_slice_free (ClutterTransitionBatch, batch);
+}
+
+static void
+transition_batch_grow (ClutterTransitionBatch *batch)
+{
+  guint old_size = batch->size;
+  guint size = MAX (old_size * 2, 16);
+
+  batch->state = g_renew (guint8, batch->state, size);
+  batch->n_channels = g_renew (guint8, batch->n_channels, size);
+  batch->mode = g_renew (guint8, batch->mode, size);
+  batch->elapsed = g_renew (gint, batch->elapsed, size);
+  batch->duration = g_renew (guint, batch->duration, size);
+  batch->progress = g_renew (float, batch->progress, size);
+  batch->next = g_renew (gint, batch->next, size);
+  batch->head = g_renew (gint *, batch->head, size);
+  batch->target = g_renew (gpointer, batch->target, size);
+  batch->key = g_renew (gpointer, batch->key, size);
+  batch->func = g_renew (ClutterTransitionBatchFunc, batch->func, size);
+
+  batch->from = g_renew (float, batch->from, size * MAX_CHANNELS);
+  batch->to = g_renew (float, batch->to, size * MAX_CHANNELS);
+  batch->value = g_renew (float, batch->value, size * MAX_CHANNELS);
+
+  memset (batch->state + old_size, SLOT_FREE, size - old_size);
+
+  batch->size = size;
+}
+
+static gint
+transition_batch_allocate_slot (ClutterTransitionBatch *batch)
+{
+  gint slot;
+
+  if (batch->free_list != NULL_SLOT)
+    {
+      slot = batch->free_list;
+      batch->free_list = batch->next[slot];
+    }
+  else
+    {
+      if (batch->n_slots == batch->size)
+        transition_batch_grow (batch);
+
+      slot = batch->n_slots;
+      batch->n_slots += 1;
+    }
+
+  batch->n_active += 1;
+
+  return slot;
+}
+
+static void
+transition_batch_release_slot (ClutterTransitionBatch *batch,
+                               gint                    slot)
+{
+  batch->state[slot] = SLOT_FREE;
+  batch->target[slot] = NULL;
+  batch->key[slot] = NULL;
+  batch->head[slot] = NULL;
+
+  /* free slots still go through the interpolation pass */
+  memset (batch->from + slot * MAX_CHANNELS, 0, sizeof (float) * MAX_CHANNELS);
+  memset (batch->to + slot * MAX_CHANNELS, 0, sizeof (float) * MAX_CHANNELS);
+
+  batch->n_active -= 1;
+
+  /* once the batch is empty we can restart from the first slot,
+   * which keeps the passes over the arrays short
+   */
+  if (batch->n_active == 0)
+    {
+      batch->n_slots = 0;
+      batch->free_list = NULL_SLOT;
+      return;
+    }
+
+  batch->next[slot] = batch->free_list;
+  batch->free_list = slot;
+}
+
+/*< private >
+ * _clutter_transition_batch_add:
+ * @batch: a #ClutterTransitionBatch
+ * @head: the location of the first transition of @target
+ * @target: the animated object
+ * @key: a unique key for the transition of @target
+ * @func: the function used to apply the state of the transition
+ * @n_channels: the number of channels, up to
+ *   %CLUTTER_TRANSITION_BATCH_MAX_CHANNELS
+ * @from: the initial value of the channels
+ * @to: the final value of the channels
+ * @delay: the delay before starting the transition, in milliseconds
+ * @duration: the duration of the transition, in milliseconds
+ * @mode: the easing mode of the transition
+ *
+ * Adds a new transition to @batch; the transition will be started
+ * on the next frame.
+ *
+ * The location pointed by @head must be initialized to -1 before
+ * adding the first transition of @target, and it must not move as
+ * long as @target has transitions in @batch.
+ *
+ * Return value: the slot of the transition
+ */
+gint
+_clutter_transition_batch_add (ClutterTransitionBatch     *batch,
+                               gint                       *head,
+                               gpointer                    target,
+                               gpointer                    key,
+                               ClutterTransitionBatchFunc  func,
+                               guint                       n_channels,
+                               const float                *from,
+                               const float                *to,
+                               guint                       delay,
+                               guint                       duration,
+                               ClutterAnimationMode        mode)
+{
+  gint slot;
+  guint i;
+
+  g_assert (n_channels > 0 && n_channels <= MAX_CHANNELS);
+  g_assert (mode != CLUTTER_CUSTOM_MODE && mode < CLUTTER_ANIMATION_LAST);
+
+  slot = transition_batch_allocate_slot (batch);
+
+  batch->state[slot] = SLOT_STARTING;
+  batch->n_channels[slot] = n_channels;
+  batch->mode[slot] = mode;
+  batch->elapsed[slot] = -((gint) MIN (delay, G_MAXINT));
+  batch->duration[slot] = duration;
+  batch->progress[slot] = 0.f;
+  batch->target[slot] = target;
+  batch->key[slot] = key;
+  batch->func[slot] = func;
+
+  for (i = 0; i < MAX_CHANNELS; i++)
+    {
+      gint channel = slot * MAX_CHANNELS + i;
+
+      batch->from[channel] = i < n_channels ? from[i] : 0.f;
+      batch->to[channel] = i < n_channels ? to[i] : 0.f;
+      batch->value[channel] = batch->from[channel];
+    }
+
+  batch->next[slot] = *head;
+  batch->head[slot] = head;
+  *head = slot;
+
+  return slot;
+}
+
+/*< private >
+ * _clutter_transition_batch_retarget:
+ * @batch: a #ClutterTransitionBatch
+ * @slot: the slot of a transition
+ * @to: the new final value of the channels
+ * @duration: the new duration of the transition, in milliseconds
+ * @mode: the new easing mode
+ *
+ * Restarts the transition in @slot from its current value towards @to.
+ *
+ * If @duration is 0, the transition will be completed on the next
+ * frame.
+ */
+void
+_clutter_transition_batch_retarget (ClutterTransitionBatch *batch,
+                                    gint                    slot,
+                                    const float            *to,
+                                    guint                   duration,
+                                    ClutterAnimationMode    mode)
+{
+  guint i;
+
+  g_assert (slot >= 0 && (guint) slot < batch->n_slots);
+  g_assert (batch->state[slot] != SLOT_FREE);
+  g_assert (mode != CLUTTER_CUSTOM_MODE && mode < CLUTTER_ANIMATION_LAST);
+
+  for (i = 0; i < batch->n_channels[slot]; i++)
+    {
+      gint channel = slot * MAX_CHANNELS + i;
+
+      /* the value of a running transition is the last one applied */
+      if (batch->state[slot] == SLOT_RUNNING)
+        batch->from[channel] = batch->value[channel];
+
+      batch->to[channel] = to[i];
+    }
+
+  /* a pending delay is preserved, unless we have to jump to the end */
+  if (duration == 0 || batch->elapsed[slot] > 0)
+    batch->elapsed[slot] = 0;
+
+  batch->duration[slot] = duration;
+  batch->mode[slot] = mode;
+  batch->state[slot] = SLOT_STARTING;
+}
+
+/*< private >
+ * _clutter_transition_batch_lookup:
+ * @batch: a #ClutterTransitionBatch
+ * @head: the first transition of a target
+ * @key: the key of a transition
+ *
+ * Looks up the transition of a target using its key.
+ *
+ * Return value: the slot of the transition, or -1
+ */
+gint
+_clutter_transition_batch_lookup (ClutterTransitionBatch *batch,
+                                  gint                    head,
+                                  gpointer                key)
+{
+  gint slot;
+
+  for (slot = head; slot != NULL_SLOT; slot = batch->next[slot])
+    {
+      if (batch->key[slot] == key)
+        return slot;
+    }
+
+  return NULL_SLOT;
+}
+
+/*< private >
+ * _clutter_transition_batch_get_state:
+ * @batch: a #ClutterTransitionBatch
+ * @slot: the slot of a transition
+ * @from: (out caller-allocates): the initial value of the channels
+ * @to: (out caller-allocates): the final value of the channels
+ * @elapsed: (out): the elapsed time, in milliseconds; a negative value
+ *   is the remaining delay
+ * @duration: (out): the duration, in milliseconds
+ * @mode: (out): the easing mode
+ *
+ * Retrieves the state of the transition in @slot.
+ */
+void
+_clutter_transition_batch_get_state (ClutterTransitionBatch *batch,
+                                     gint                    slot,
+                                     float                  *from,
+                                     float                  *to,
+                                     gint                   *elapsed,
+                                     guint                  *duration,
+                                     ClutterAnimationMode   *mode)
+{
+  guint n_channels;
+
+  g_assert (slot >= 0 && (guint) slot < batch->n_slots);
+  g_assert (batch->state[slot] != SLOT_FREE);
+
+  n_channels = batch->n_channels[slot];
+
+  memcpy (from, batch->from + slot * MAX_CHANNELS, sizeof (float) * n_channels);
+  memcpy (to, batch->to + slot * MAX_CHANNELS, sizeof (float) * n_channels);
+
+  *elapsed = batch->elapsed[slot];
+  *duration = batch->duration[slot];
+  *mode = batch->mode[slot];
+}
+
+/*< private >
+ * _clutter_transition_batch_remove:
+ * @batch: a #ClutterTransitionBatch
+ * @slot: the slot of a transition
+ *
+ * Removes the transition in @slot, without applying its final state.
+ */
+void
+_clutter_transition_batch_remove (ClutterTransitionBatch *batch,
+                                  gint                    slot)
+{
+  gint *link_p;
+
+  g_assert (slot >= 0 && (guint) slot < batch->n_slots);
+  g_assert (batch->state[slot] != SLOT_FREE);
+
+  link_p = batch->head[slot];
+  while (*link_p != slot)
+    link_p = &batch->next[*link_p];
+
+  *link_p = batch->next[slot];
+
+  transition_batch_release_slot (batch, slot);
+}
+
+/*< private >
+ * _clutter_transition_batch_remove_all:
+ * @batch: a #ClutterTransitionBatch
+ * @head: the location of the first transition of a target
+ *
+ * Removes all the transitions of a target.
+ */
+void
+_clutter_transition_batch_remove_all (ClutterTransitionBatch *batch,
+                                      gint                   *head)
+{
+  while (*head != NULL_SLOT)
+    {
+      gint slot = *head;
+
+      *head = batch->next[slot];
+
+      transition_batch_release_slot (batch, slot);
+    }
+}
+
+gboolean
+_clutter_transition_batch_is_running (ClutterTransitionBatch *batch)
+{
+  return batch->n_active > 0;
+}
+
+/*< private >
+ * _clutter_transition_batch_advance:
+ * @batch: a #ClutterTransitionBatch
+ * @tick_time: the time of the frame, in milliseconds
+ *
+ * Advances all the transitions in @batch, and applies their state.
+ */
+void
+_clutter_transition_batch_advance (ClutterTransitionBatch *batch,
+                                   gint64                  tick_time)
+{
+  gint64 delta;
+  guint i, n_slots, n_channels;
+
+  delta = tick_time - batch->last_tick;
+  batch->last_tick = tick_time;
+
+  if (batch->n_active == 0)
+    return;
+
+  /* time going backwards does not rewind the transitions */
+  if (delta < 0)
+    delta = 0;
+
+  n_slots = batch->n_slots;
+
+  /* 1. advance the time and compute the progress */
+  for (i = 0; i < n_slots; i++)
+    {
+      gint64 elapsed;
+
+      switch (batch->state[i])
+        {
+        case SLOT_FREE:
+          batch->progress[i] = 0.f;
+          continue;
+
+        case SLOT_STARTING:
+          batch->state[i] = SLOT_RUNNING;
+          break;
+
+        case SLOT_RUNNING:
+          elapsed = MIN (batch->elapsed[i] + delta, G_MAXINT);
+          batch->elapsed[i] = elapsed;
+          break;
+        }
+
+      if (batch->elapsed[i] <= 0)
+        batch->progress[i] = 0.f;
+      else if ((guint) batch->elapsed[i] >= batch->duration[i])
+        batch->progress[i] = 1.f;
+      else
+        batch->progress[i] = clutter_easing_for_mode (batch->mode[i],
+                                                      batch->elapsed[i],
+                                                      batch->duration[i]);
+    }
+
+  /* 2. interpolate all the channels */
+  n_channels = n_slots * MAX_CHANNELS;
+  for (i = 0; i < n_channels; i++)
+    {
+      float t = batch->progress[i / MAX_CHANNELS];
+
+      batch->value[i] = batch->from[i] + (batch->to[i] - batch->from[i]) * t;
+    }
+
+  /* 3. apply the values; this might add or remove transitions, so we
+   * cannot keep pointers inside the arrays, and transitions added
+   * here are skipped until the next frame
+   */
+  for (i = 0; i < n_slots; i++)
+    {
+      float values[MAX_CHANNELS];
+      ClutterTransitionBatchFunc func;
+      gpointer target, key;
+      gboolean is_complete;
+
+      if (batch->state[i] != SLOT_RUNNING || batch->elapsed[i] < 0)
+        continue;
+
+      is_complete = (guint) batch->elapsed[i] >= batch->duration[i];
+
+      memcpy (values,
+              is_complete ? batch->to + i * MAX_CHANNELS
+                          : batch->value + i * MAX_CHANNELS,
+              sizeof (float) * batch->n_channels[i]);
+
+      func = batch->func[i];
+      target = batch->target[i];
+      key = batch->key[i];
+
+      if (is_complete)
+        _clutter_transition_batch_remove (batch, i);
+
+      func (target, key, values, is_complete);
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2012  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTransitionBatch: packed storage for simple transitions.
+ */
+
+#ifndef __CLUTTER_TRANSITION_BATCH_H__
+#define __CLUTTER_TRANSITION_BATCH_H__
+
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+/* the maximum number of float channels of a transition */
+#define CLUTTER_TRANSITION_BATCH_MAX_CHANNELS   4
+
+typedef struct _ClutterTransitionBatch  ClutterTransitionBatch;
+
+/*< private >
+ * ClutterTransitionBatchFunc:
+ * @target: the object being animated
+ * @key: the key of the transition
+ * @values: the current value of each channel
+ * @is_complete: whether the transition is complete; in that case, the
+ *   transition has already been removed from the batch
+ *
+ * Applies the current state of a transition to its @target.
+ */
+typedef void (* ClutterTransitionBatchFunc) (gpointer     target,
+                                             gpointer     key,
+                                             const float *values,
+                                             gboolean     is_complete);
+
+ClutterTransitionBatch *        _clutter_transition_batch_new           (void);
+void                            _clutter_transition_batch_free          (ClutterTransitionBatch     *batch);
+
+gint                            _clutter_transition_batch_add           (ClutterTransitionBatch     *batch,
+                                                                         gint                       *head,
+                                                                         gpointer                    target,
+                                                                         gpointer                    key,
+                                                                         ClutterTransitionBatchFunc  func,
+                                                                         guint                       n_channels,
+                                                                         const float                *from,
+                                                                         const float                *to,
+                                                                         guint                       delay,
+                                                                         guint                       duration,
+                                                                         ClutterAnimationMode        mode);
+void                            _clutter_transition_batch_retarget      (ClutterTransitionBatch     *batch,
+                                                                         gint                        slot,
+                                                                         const float                *to,
+                                                                         guint                       duration,
+                                                                         ClutterAnimationMode        mode);
+gint                            _clutter_transition_batch_lookup        (ClutterTransitionBatch     *batch,
+                                                                         gint                        head,
+                                                                         gpointer                    key);
+void                            _clutter_transition_batch_get_state     (ClutterTransitionBatch     *batch,
+                                                                         gint                        slot,
+                                                                         float                      *from,
+                                                                         float                      *to,
+                                                                         gint                       *elapsed,
+                                                                         guint                      *duration,
+                                                                         ClutterAnimationMode       *mode);
+void                            _clutter_transition_batch_remove        (ClutterTransitionBatch     *batch,
+                                                                         gint                        slot);
+void                            _clutter_transition_batch_remove_all    (ClutterTransitionBatch     *batch,
+                                                                         gint                       *head);
+
+gboolean                        _clutter_transition_batch_is_running    (ClutterTransitionBatch     *batch);
+void                            _clutter_transition_batch_advance       (ClutterTransitionBatch     *batch,
+                                                                         gint64                      tick_time);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_TRANSITION_BATCH_H__ */
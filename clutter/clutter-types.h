@@ -76,6 +76,7 @@ typedef struct _ClutterPath                     ClutterPath;
 
 typedef struct _ClutterActorBox                 ClutterActorBox;
 typedef struct _ClutterColor                    ClutterColor;
+typedef struct _ClutterFrameStats               ClutterFrameStats;
 typedef struct _ClutterGeometry                 ClutterGeometry;
 typedef struct _ClutterKnot                     ClutterKnot;
 typedef struct _ClutterMargin                   ClutterMargin;
@@ -182,6 +182,42 @@ _clutter_util_rectangle_union (const cairo_rectangle_int_t *src1,
   dest->y = dest_y;
 }
 
+/*< private >
+ * _clutter_util_rectangle_intersection:
+ * @src1: first rectangle to intersect
+ * @src2: second rectangle to intersect
+ * @dest: (out): return location for the intersection
+ *
+ * Calculates the intersection of two rectangles.
+ *
+ * It is allowed for @dest to be the same as either @src1 or @src2.
+ *
+ * Return value: %TRUE if the rectangles intersect; if %FALSE is
+ *   returned, @dest is left untouched
+ */
+gboolean
+_clutter_util_rectangle_intersection (const cairo_rectangle_int_t *src1,
+                                      const cairo_rectangle_int_t *src2,
+                                      cairo_rectangle_int_t       *dest)
+{
+  int x1, y1, x2, y2;
+
+  x1 = MAX (src1->x, src2->x);
+  y1 = MAX (src1->y, src2->y);
+  x2 = MIN (src1->x + src1->width, src2->x + src2->width);
+  y2 = MIN (src1->y + src1->height, src2->y + src2->height);
+
+  if (x1 >= x2 || y1 >= y2)
+    return FALSE;
+
+  dest->x = x1;
+  dest->y = y1;
+  dest->width = x2 - x1;
+  dest->height = y2 - y1;
+
+  return TRUE;
+}
+
 typedef struct
 {
   GType value_type;
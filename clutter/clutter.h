@@ -75,6 +75,7 @@
 #include "clutter-layout-manager.h"
 #include "clutter-layout-meta.h"
 #include "clutter-list-model.h"
+#include "clutter-list-view.h"
 #include "clutter-macros.h"
 #include "clutter-main.h"
 #include "clutter-model.h"
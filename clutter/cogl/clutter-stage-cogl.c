@@ -48,6 +48,12 @@
 #include "clutter-stage-private.h"
 #include "clutter-util.h"
 
+/* The maximum number of rectangles in the redraw region; each of them
+ * requires a separate traversal of the scene graph, so past this point
+ * we merge rectangles even if it means redrawing more pixels
+ */
+#define MAX_REDRAW_RECTS        8
+
 static void clutter_stage_window_iface_init (ClutterStageWindowIface *iface);
 
 G_DEFINE_TYPE_WITH_CODE (ClutterStageCogl,
@@ -93,7 +99,15 @@ handle_swap_complete_cb (CoglFramebuffer *framebuffer,
    * need to care about this bug here.
    */
   if (stage_cogl->pending_swaps > 0)
-    stage_cogl->pending_swaps--;
+    {
+      stage_cogl->pending_swaps--;
+
+      /* Cogl does not tell us when the frame hit the screen, so we
+       * use the time at which the swap completion was notified
+       */
+      _clutter_stage_presented (stage_cogl->wrapper,
+                                g_get_monotonic_time ());
+    }
 }
 
 static gboolean
@@ -154,6 +168,14 @@ clutter_stage_cogl_get_pending_swaps (ClutterStageWindow *stage_window)
   return stage_cogl->pending_swaps;
 }
 
+static int
+clutter_stage_cogl_get_swap_chain_length (ClutterStageWindow *stage_window)
+{
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_window);
+
+  return _clutter_backend_get_swap_chain_length (stage_cogl->backend);
+}
+
 static ClutterActor *
 clutter_stage_cogl_get_wrapper (ClutterStageWindow *stage_window)
 {
@@ -244,6 +266,103 @@ clutter_stage_cogl_ignoring_redraw_clips (ClutterStageWindow *stage_window)
     return FALSE;
 }
 
+static inline int
+rectangle_area (const cairo_rectangle_int_t *rect)
+{
+  return rect->width * rect->height;
+}
+
+/* Decides whether two rectangles of the redraw region should be
+ * merged: overlapping rectangles always are, to keep the region
+ * disjoint, while separate rectangles are only merged if their
+ * union does not cover much more than the rectangles themselves
+ */
+static gboolean
+redraw_rects_should_merge (const cairo_rectangle_int_t *a,
+                           const cairo_rectangle_int_t *b)
+{
+  cairo_rectangle_int_t tmp;
+  int separate_area;
+
+  if (_clutter_util_rectangle_intersection (a, b, &tmp))
+    return TRUE;
+
+  _clutter_util_rectangle_union (a, b, &tmp);
+
+  separate_area = rectangle_area (a) + rectangle_area (b);
+
+  return rectangle_area (&tmp) - separate_area <= separate_area / 4;
+}
+
+/* Adds @rect to @rects, an array of disjoint cairo_rectangle_int_t
+ * holding at most MAX_REDRAW_RECTS rectangles
+ */
+static void
+redraw_rects_add (GArray                      *rects,
+                  const cairo_rectangle_int_t *rect)
+{
+  cairo_rectangle_int_t new_rect = *rect;
+  gboolean merged;
+  guint i;
+
+  do
+    {
+      merged = FALSE;
+
+      for (i = 0; i < rects->len; i++)
+        {
+          cairo_rectangle_int_t *old_rect;
+
+          old_rect = &g_array_index (rects, cairo_rectangle_int_t, i);
+
+          if (redraw_rects_should_merge (old_rect, &new_rect))
+            {
+              _clutter_util_rectangle_union (old_rect, &new_rect, &new_rect);
+              g_array_remove_index_fast (rects, i);
+              merged = TRUE;
+              break;
+            }
+        }
+
+      /* if the region is full, merge the new rectangle with the
+       * one that grows the least by doing so
+       */
+      if (!merged && rects->len == MAX_REDRAW_RECTS)
+        {
+          int best_growth = G_MAXINT;
+          guint best = 0;
+
+          for (i = 0; i < rects->len; i++)
+            {
+              cairo_rectangle_int_t *old_rect, tmp;
+              int growth;
+
+              old_rect = &g_array_index (rects, cairo_rectangle_int_t, i);
+
+              _clutter_util_rectangle_union (old_rect, &new_rect, &tmp);
+              growth = rectangle_area (&tmp) - rectangle_area (old_rect);
+
+              if (growth < best_growth)
+                {
+                  best_growth = growth;
+                  best = i;
+                }
+            }
+
+          _clutter_util_rectangle_union (&g_array_index (rects,
+                                                         cairo_rectangle_int_t,
+                                                         best),
+                                         &new_rect,
+                                         &new_rect);
+          g_array_remove_index_fast (rects, best);
+          merged = TRUE;
+        }
+    }
+  while (merged);
+
+  g_array_append_val (rects, new_rect);
+}
+
 /* A redraw clip represents (in stage coordinates) the bounding box of
  * something that needs to be redraw. Typically they are added to the
  * StageWindow as a result of clutter_actor_queue_clipped_redraw() by
@@ -254,9 +373,11 @@ clutter_stage_cogl_ignoring_redraw_clips (ClutterStageWindow *stage_window)
  *
  * What we do with this information:
  * - we keep track of the bounding box for all redraw clips
- * - when we come to redraw; we scissor the redraw to that box and use
- *   glBlitFramebuffer to present the redraw to the front
- *   buffer.
+ * - we keep a small set of disjoint rectangles covering all the
+ *   redraw clips, merging the rectangles that are close enough
+ * - when we come to redraw; we scissor the redraw to each of those
+ *   rectangles in turn and use glBlitFramebuffer to present all of
+ *   them to the front buffer.
  */
 static void
 clutter_stage_cogl_add_redraw_clip (ClutterStageWindow    *stage_window,
@@ -285,6 +406,7 @@ clutter_stage_cogl_add_redraw_clip (ClutterStageWindow    *stage_window,
   if (!stage_cogl->initialized_redraw_clip)
     {
       stage_cogl->bounding_redraw_clip = *stage_clip;
+      g_array_set_size (stage_cogl->redraw_rects, 0);
     }
   else if (stage_cogl->bounding_redraw_clip.width > 0)
     {
@@ -293,9 +415,19 @@ clutter_stage_cogl_add_redraw_clip (ClutterStageWindow    *stage_window,
                                      &stage_cogl->bounding_redraw_clip);
     }
 
+  redraw_rects_add (stage_cogl->redraw_rects, stage_clip);
+
   stage_cogl->initialized_redraw_clip = TRUE;
 }
 
+static void
+clutter_stage_cogl_dirty_back_buffer (ClutterStageWindow *stage_window)
+{
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_window);
+
+  stage_cogl->dirty_back_buffer = TRUE;
+}
+
 static gboolean
 clutter_stage_cogl_get_redraw_clip_bounds (ClutterStageWindow    *stage_window,
                                            cairo_rectangle_int_t *stage_clip)
@@ -304,7 +436,7 @@ clutter_stage_cogl_get_redraw_clip_bounds (ClutterStageWindow    *stage_window,
 
   if (stage_cogl->using_clipped_redraw)
     {
-      *stage_clip = stage_cogl->bounding_redraw_clip;
+      *stage_clip = stage_cogl->current_redraw_clip;
 
       return TRUE;
     }
@@ -312,15 +444,108 @@ clutter_stage_cogl_get_redraw_clip_bounds (ClutterStageWindow    *stage_window,
   return FALSE;
 }
 
+/* Remembers the region that changed in the frame being painted, so
+ * that it can be repainted in back buffers that still contain an
+ * older frame
+ */
+static void
+clutter_stage_cogl_record_damage (ClutterStageCogl *stage_cogl,
+                                  gboolean          is_clipped)
+{
+  GArray *damage;
+
+  damage = stage_cogl->damage_history[stage_cogl->damage_index];
+  if (damage == NULL)
+    {
+      damage = g_array_sized_new (FALSE, FALSE,
+                                  sizeof (cairo_rectangle_int_t),
+                                  MAX_REDRAW_RECTS);
+      stage_cogl->damage_history[stage_cogl->damage_index] = damage;
+    }
+
+  if (is_clipped)
+    {
+      g_array_set_size (damage, 0);
+      g_array_append_vals (damage,
+                           stage_cogl->redraw_rects->data,
+                           stage_cogl->redraw_rects->len);
+    }
+  else
+    {
+      cairo_rectangle_int_t geom;
+
+      clutter_stage_cogl_get_geometry (CLUTTER_STAGE_WINDOW (stage_cogl),
+                                       &geom);
+
+      g_array_set_size (damage, 1);
+      g_array_index (damage, cairo_rectangle_int_t, 0) = geom;
+    }
+
+  stage_cogl->damage_index =
+    (stage_cogl->damage_index + 1) % DAMAGE_HISTORY_MAX;
+
+  if (stage_cogl->damage_history_len < DAMAGE_HISTORY_MAX)
+    stage_cogl->damage_history_len += 1;
+}
+
+/* Extends the redraw region with the damage of the frames painted
+ * since the back buffer was last used, so that the whole back buffer
+ * is up to date after painting the region; returns %FALSE if the age
+ * of the back buffer is unknown, or older than the damage history,
+ * in which case the whole stage has to be painted
+ *
+ * This must be called after recording the damage of the current
+ * frame, using clutter_stage_cogl_record_damage().
+ */
+static gboolean
+clutter_stage_cogl_add_buffer_damage (ClutterStageCogl *stage_cogl)
+{
+#ifdef HAVE_COGL_BUFFER_AGE
+  int age, i;
+
+  age = cogl_onscreen_get_buffer_age (stage_cogl->onscreen);
+
+  CLUTTER_NOTE (CLIPPING, "Back buffer age: %d", age);
+
+  /* an age of 0 means that the contents of the buffer are undefined;
+   * the damage of the current frame is in the history as well
+   */
+  if (age <= 0 || age > stage_cogl->damage_history_len)
+    return FALSE;
+
+  for (i = 1; i < age; i++)
+    {
+      GArray *damage;
+      guint index_, j;
+
+      index_ = (stage_cogl->damage_index + DAMAGE_HISTORY_MAX - 1 - i)
+             % DAMAGE_HISTORY_MAX;
+      damage = stage_cogl->damage_history[index_];
+
+      for (j = 0; j < damage->len; j++)
+        redraw_rects_add (stage_cogl->redraw_rects,
+                          &g_array_index (damage, cairo_rectangle_int_t, j));
+    }
+
+  return TRUE;
+#else
+  return FALSE;
+#endif /* HAVE_COGL_BUFFER_AGE */
+}
+
 /* XXX: This is basically identical to clutter_stage_glx_redraw */
 static void
 clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
 {
   ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_window);
+  cairo_rectangle_int_t paint_rects[MAX_REDRAW_RECTS];
+  guint n_paint_rects = 0;
   gboolean may_use_clipped_redraw;
   gboolean use_clipped_redraw;
   gboolean can_blit_sub_buffer;
+  gboolean can_use_buffer_age;
   ClutterActor *wrapper;
+  guint i;
 
   CLUTTER_STATIC_TIMER (painting_timer,
                         "Redrawing", /* parent */
@@ -348,9 +573,16 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
   can_blit_sub_buffer =
     cogl_clutter_winsys_has_feature (COGL_WINSYS_FEATURE_SWAP_REGION);
 
+#ifdef HAVE_COGL_BUFFER_AGE
+  can_use_buffer_age =
+    cogl_clutter_winsys_has_feature (COGL_WINSYS_FEATURE_BUFFER_AGE);
+#else
+  can_use_buffer_age = FALSE;
+#endif
+
   may_use_clipped_redraw = FALSE;
   if (_clutter_stage_window_can_clip_redraws (stage_window) &&
-      can_blit_sub_buffer &&
+      (can_blit_sub_buffer || can_use_buffer_age) &&
       /* NB: a zero width redraw clip == full stage redraw */
       stage_cogl->bounding_redraw_clip.width != 0 &&
       /* some drivers struggle to get going and produce some junk
@@ -367,24 +599,72 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
   else
     use_clipped_redraw = FALSE;
 
+  /* a pick might have left its colours in any of the back buffers; if
+   * we copy the redraw region to the front buffer they are never seen,
+   * but if we swap the whole back buffer none of the older frames can
+   * be trusted any more, including the one we are about to paint on */
+  if (stage_cogl->dirty_back_buffer)
+    {
+      if (!can_blit_sub_buffer)
+        {
+          CLUTTER_NOTE (CLIPPING, "Back buffer is dirty, forcing a full redraw");
+
+          stage_cogl->damage_history_len = 0;
+          use_clipped_redraw = FALSE;
+        }
+
+      stage_cogl->dirty_back_buffer = FALSE;
+    }
+
+  clutter_stage_cogl_record_damage (stage_cogl, use_clipped_redraw);
+
+  /* if we cannot copy the region to the front buffer, we need to swap
+   * the whole back buffer, which might still contain an older frame;
+   * in that case, we also repaint whatever changed since that frame
+   */
+  if (use_clipped_redraw && !can_blit_sub_buffer)
+    use_clipped_redraw = clutter_stage_cogl_add_buffer_damage (stage_cogl);
+
   if (use_clipped_redraw)
     {
-      CLUTTER_NOTE (CLIPPING,
-                    "Stage clip pushed: x=%d, y=%d, width=%d, height=%d\n",
-                    stage_cogl->bounding_redraw_clip.x,
-                    stage_cogl->bounding_redraw_clip.y,
-                    stage_cogl->bounding_redraw_clip.width,
-                    stage_cogl->bounding_redraw_clip.height);
+      cairo_rectangle_int_t geom;
+
+      clutter_stage_cogl_get_geometry (stage_window, &geom);
 
       stage_cogl->using_clipped_redraw = TRUE;
 
-      cogl_clip_push_window_rectangle (stage_cogl->bounding_redraw_clip.x,
-                                       stage_cogl->bounding_redraw_clip.y,
-                                       stage_cogl->bounding_redraw_clip.width,
-                                       stage_cogl->bounding_redraw_clip.height);
-      _clutter_stage_do_paint (CLUTTER_STAGE (wrapper),
-                               &stage_cogl->bounding_redraw_clip);
-      cogl_clip_pop ();
+      for (i = 0; i < stage_cogl->redraw_rects->len; i++)
+        {
+          const cairo_rectangle_int_t *rect;
+          cairo_rectangle_int_t *clip;
+
+          rect = &g_array_index (stage_cogl->redraw_rects,
+                                 cairo_rectangle_int_t,
+                                 i);
+          clip = &paint_rects[n_paint_rects];
+
+          /* skip the parts of the region outside of the stage */
+          if (!_clutter_util_rectangle_intersection (rect, &geom, clip))
+            continue;
+
+          CLUTTER_NOTE (CLIPPING,
+                        "Stage clip pushed: x=%d, y=%d, width=%d, height=%d\n",
+                        clip->x,
+                        clip->y,
+                        clip->width,
+                        clip->height);
+
+          stage_cogl->current_redraw_clip = *clip;
+
+          cogl_clip_push_window_rectangle (clip->x,
+                                           clip->y,
+                                           clip->width,
+                                           clip->height);
+          _clutter_stage_do_paint (CLUTTER_STAGE (wrapper), clip);
+          cogl_clip_pop ();
+
+          n_paint_rects += 1;
+        }
 
       stage_cogl->using_clipped_redraw = FALSE;
     }
@@ -411,19 +691,7 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
       CoglFramebuffer *fb = COGL_FRAMEBUFFER (stage_cogl->onscreen);
       CoglContext *ctx = cogl_framebuffer_get_context (fb);
       static CoglPipeline *outline = NULL;
-      cairo_rectangle_int_t *clip = &stage_cogl->bounding_redraw_clip;
       ClutterActor *actor = CLUTTER_ACTOR (wrapper);
-      float x_1 = clip->x;
-      float x_2 = clip->x + clip->width;
-      float y_1 = clip->y;
-      float y_2 = clip->y + clip->height;
-      CoglVertexP2 quad[4] = {
-        { x_1, y_1 },
-        { x_2, y_1 },
-        { x_2, y_2 },
-        { x_1, y_2 }
-      };
-      CoglPrimitive *prim;
       CoglMatrix modelview;
 
       if (outline == NULL)
@@ -432,29 +700,45 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
           cogl_pipeline_set_color4ub (outline, 0xff, 0x00, 0x00, 0xff);
         }
 
-      prim = cogl_primitive_new_p2 (ctx,
-                                    COGL_VERTICES_MODE_LINE_LOOP,
-                                    4, /* n_vertices */
-                                    quad);
-
       cogl_framebuffer_push_matrix (fb);
       cogl_matrix_init_identity (&modelview);
       _clutter_actor_apply_modelview_transform (actor, &modelview);
       cogl_framebuffer_set_modelview_matrix (fb, &modelview);
-      cogl_framebuffer_draw_primitive (COGL_FRAMEBUFFER (stage_cogl->onscreen),
-                                       outline,
-                                       prim);
+
+      for (i = 0; i < stage_cogl->redraw_rects->len; i++)
+        {
+          cairo_rectangle_int_t *clip =
+            &g_array_index (stage_cogl->redraw_rects, cairo_rectangle_int_t, i);
+          float x_1 = clip->x;
+          float x_2 = clip->x + clip->width;
+          float y_1 = clip->y;
+          float y_2 = clip->y + clip->height;
+          CoglVertexP2 quad[4] = {
+            { x_1, y_1 },
+            { x_2, y_1 },
+            { x_2, y_2 },
+            { x_1, y_2 }
+          };
+          CoglPrimitive *prim;
+
+          prim = cogl_primitive_new_p2 (ctx,
+                                        COGL_VERTICES_MODE_LINE_LOOP,
+                                        4, /* n_vertices */
+                                        quad);
+
+          cogl_framebuffer_draw_primitive (fb, outline, prim);
+          cogl_object_unref (prim);
+        }
+
       cogl_framebuffer_pop_matrix (fb);
-      cogl_object_unref (prim);
     }
 
   CLUTTER_TIMER_STOP (_clutter_uprof_context, painting_timer);
 
   /* push on the screen */
-  if (use_clipped_redraw)
+  if (use_clipped_redraw && can_blit_sub_buffer)
     {
-      cairo_rectangle_int_t *clip = &stage_cogl->bounding_redraw_clip;
-      int copy_area[4];
+      int copy_area[MAX_REDRAW_RECTS * 4];
 
       /* XXX: It seems there will be a race here in that the stage
        * window may be resized before the cogl_onscreen_swap_region
@@ -465,24 +749,39 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
        * artefacts.
        */
 
-      copy_area[0] = clip->x;
-      copy_area[1] = clip->y;
-      copy_area[2] = clip->width;
-      copy_area[3] = clip->height;
-
-      CLUTTER_NOTE (BACKEND,
-                    "cogl_onscreen_swap_region (onscreen: %p, "
-                                                "x: %d, y: %d, "
-                                                "width: %d, height: %d)",
-                    stage_cogl->onscreen,
-                    copy_area[0], copy_area[1], copy_area[2], copy_area[3]);
-
+      for (i = 0; i < n_paint_rects; i++)
+        {
+          copy_area[i * 4 + 0] = paint_rects[i].x;
+          copy_area[i * 4 + 1] = paint_rects[i].y;
+          copy_area[i * 4 + 2] = paint_rects[i].width;
+          copy_area[i * 4 + 3] = paint_rects[i].height;
+
+          CLUTTER_NOTE (BACKEND,
+                        "cogl_onscreen_swap_region (onscreen: %p, "
+                                                    "rectangle: %u/%u, "
+                                                    "x: %d, y: %d, "
+                                                    "width: %d, height: %d)",
+                        stage_cogl->onscreen,
+                        i + 1, n_paint_rects,
+                        copy_area[i * 4 + 0],
+                        copy_area[i * 4 + 1],
+                        copy_area[i * 4 + 2],
+                        copy_area[i * 4 + 3]);
+        }
 
-      CLUTTER_TIMER_START (_clutter_uprof_context, blit_sub_buffer_timer);
+      /* the whole region might be outside of the stage, in which
+       * case there is nothing to present
+       */
+      if (n_paint_rects > 0)
+        {
+          CLUTTER_TIMER_START (_clutter_uprof_context, blit_sub_buffer_timer);
 
-      cogl_onscreen_swap_region (stage_cogl->onscreen, copy_area, 1);
+          cogl_onscreen_swap_region (stage_cogl->onscreen,
+                                     copy_area,
+                                     n_paint_rects);
 
-      CLUTTER_TIMER_STOP (_clutter_uprof_context, blit_sub_buffer_timer);
+          CLUTTER_TIMER_STOP (_clutter_uprof_context, blit_sub_buffer_timer);
+        }
     }
   else
     {
@@ -525,12 +824,14 @@ clutter_stage_window_iface_init (ClutterStageWindowIface *iface)
   iface->show = clutter_stage_cogl_show;
   iface->hide = clutter_stage_cogl_hide;
   iface->get_pending_swaps = clutter_stage_cogl_get_pending_swaps;
+  iface->get_swap_chain_length = clutter_stage_cogl_get_swap_chain_length;
   iface->add_redraw_clip = clutter_stage_cogl_add_redraw_clip;
   iface->has_redraw_clips = clutter_stage_cogl_has_redraw_clips;
   iface->ignoring_redraw_clips = clutter_stage_cogl_ignoring_redraw_clips;
   iface->get_redraw_clip_bounds = clutter_stage_cogl_get_redraw_clip_bounds;
   iface->redraw = clutter_stage_cogl_redraw;
   iface->get_active_framebuffer = clutter_stage_cogl_get_active_framebuffer;
+  iface->dirty_back_buffer = clutter_stage_cogl_dirty_back_buffer;
 }
 
 static void
@@ -557,12 +858,31 @@ clutter_stage_cogl_set_property (GObject      *gobject,
     }
 }
 
+static void
+clutter_stage_cogl_finalize (GObject *gobject)
+{
+  ClutterStageCogl *self = CLUTTER_STAGE_COGL (gobject);
+
+  guint i;
+
+  g_array_free (self->redraw_rects, TRUE);
+
+  for (i = 0; i < DAMAGE_HISTORY_MAX; i++)
+    {
+      if (self->damage_history[i] != NULL)
+        g_array_free (self->damage_history[i], TRUE);
+    }
+
+  G_OBJECT_CLASS (_clutter_stage_cogl_parent_class)->finalize (gobject);
+}
+
 static void
 _clutter_stage_cogl_class_init (ClutterStageCoglClass *klass)
 {
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
   gobject_class->set_property = clutter_stage_cogl_set_property;
+  gobject_class->finalize = clutter_stage_cogl_finalize;
 
   g_object_class_override_property (gobject_class, PROP_WRAPPER, "wrapper");
   g_object_class_override_property (gobject_class, PROP_BACKEND, "backend");
@@ -571,4 +891,7 @@ _clutter_stage_cogl_class_init (ClutterStageCoglClass *klass)
 static void
 _clutter_stage_cogl_init (ClutterStageCogl *stage)
 {
+  stage->redraw_rects = g_array_sized_new (FALSE, FALSE,
+                                           sizeof (cairo_rectangle_int_t),
+                                           MAX_REDRAW_RECTS);
 }
@@ -20,6 +20,9 @@ G_BEGIN_DECLS
 #define CLUTTER_IS_STAGE_COGL_CLASS(klass)       (G_TYPE_CHECK_CLASS_TYPE ((klass), CLUTTER_TYPE_STAGE_COGL))
 #define CLUTTER_STAGE_COGL_GET_CLASS(obj)        (G_TYPE_INSTANCE_GET_CLASS ((obj), CLUTTER_TYPE_STAGE_COGL, ClutterStageCoglClass))
 
+/* the number of frames of damage remembered by the stage */
+#define DAMAGE_HISTORY_MAX      16
+
 typedef struct _ClutterStageCogl         ClutterStageCogl;
 typedef struct _ClutterStageCoglClass    ClutterStageCoglClass;
 
@@ -43,12 +46,33 @@ struct _ClutterStageCogl
    * junk frames to start with. */
   unsigned long frame_count;
 
+  /* the bounding box of all the redraw clips; a width of 0 means
+   * that a full stage redraw has been queued */
   cairo_rectangle_int_t bounding_redraw_clip;
 
+  /* the region to redraw, as an array of disjoint
+   * cairo_rectangle_int_t; only valid if bounding_redraw_clip
+   * is not empty */
+  GArray *redraw_rects;
+
+  /* the rectangle of redraw_rects currently being painted */
+  cairo_rectangle_int_t current_redraw_clip;
+
+  /* the region redrawn by each of the last frames, as arrays of
+   * cairo_rectangle_int_t; damage_index is the slot of the next
+   * frame, and damage_history_len the number of valid slots */
+  GArray *damage_history[DAMAGE_HISTORY_MAX];
+  guint damage_index;
+  guint damage_history_len;
+
   guint initialized_redraw_clip : 1;
 
+  /* TRUE if the back buffer was drawn to outside of a redraw, for
+   * instance by a pick, so the next redraw has to be a full one */
+  guint dirty_back_buffer : 1;
+
   /* TRUE if the current paint cycle has a clipped redraw. In that
-     case bounding_redraw_clip specifies the the bounds. */
+     case current_redraw_clip specifies the the bounds. */
   guint using_clipped_redraw : 1;
 };
 
@@ -0,0 +1,186 @@
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+typedef struct _FooContent      FooContent;
+typedef struct _FooContentClass FooContentClass;
+
+struct _FooContentClass
+{
+  GObjectClass parent_class;
+};
+
+struct _FooContent
+{
+  GObject parent;
+
+  ClutterColor color;
+  int paint_count;
+};
+
+typedef struct
+{
+  ClutterActor *stage;
+  ClutterActor *actor;
+  FooContent *content;
+} Data;
+
+GType foo_content_get_type (void) G_GNUC_CONST;
+
+static void clutter_content_iface_init (ClutterContentIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (FooContent, foo_content, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (CLUTTER_TYPE_CONTENT,
+                                                clutter_content_iface_init));
+
+static void
+foo_content_paint_content (ClutterContent   *content,
+                           ClutterActor     *actor,
+                           ClutterPaintNode *root)
+{
+  FooContent *foo_content = (FooContent *) content;
+  ClutterPaintNode *node;
+  ClutterActorBox box;
+  ClutterColor color;
+
+  /* this is only called when the paint nodes of the actor are built */
+  foo_content->paint_count++;
+
+  clutter_actor_get_allocation_box (actor, &box);
+
+  /* Fill the left half of the actor */
+  box.x2 = (box.x2 - box.x1) / 2;
+  box.y2 = box.y2 - box.y1;
+  box.x1 = 0;
+  box.y1 = 0;
+
+  color = foo_content->color;
+  color.alpha = clutter_actor_get_paint_opacity (actor);
+
+  node = clutter_color_node_new (&color);
+  clutter_paint_node_add_rectangle (node, &box);
+  clutter_paint_node_add_child (root, node);
+  clutter_paint_node_unref (node);
+}
+
+static void
+clutter_content_iface_init (ClutterContentIface *iface)
+{
+  iface->paint_content = foo_content_paint_content;
+}
+
+static void
+foo_content_class_init (FooContentClass *klass)
+{
+}
+
+static void
+foo_content_init (FooContent *self)
+{
+}
+
+static void
+verify_results (Data *data,
+                const ClutterColor *expected_background,
+                const ClutterColor *expected_content,
+                int expected_paint_count)
+{
+  guchar *pixel;
+
+  /* Reading the pixels forces a redraw of the stage */
+  pixel = clutter_stage_read_pixels (CLUTTER_STAGE (data->stage),
+                                     75, 50, /* x/y */
+                                     1, 1 /* width/height */);
+
+  g_assert_cmpint (ABS ((int) expected_background->red - (int) pixel[0]), <=, 2);
+  g_assert_cmpint (ABS ((int) expected_background->green - (int) pixel[1]), <=, 2);
+  g_assert_cmpint (ABS ((int) expected_background->blue - (int) pixel[2]), <=, 2);
+
+  g_free (pixel);
+
+  pixel = clutter_stage_read_pixels (CLUTTER_STAGE (data->stage),
+                                     25, 50, /* x/y */
+                                     1, 1 /* width/height */);
+
+  g_assert_cmpint (ABS ((int) expected_content->red - (int) pixel[0]), <=, 2);
+  g_assert_cmpint (ABS ((int) expected_content->green - (int) pixel[1]), <=, 2);
+  g_assert_cmpint (ABS ((int) expected_content->blue - (int) pixel[2]), <=, 2);
+
+  g_free (pixel);
+
+  g_assert_cmpint (data->content->paint_count, ==, expected_paint_count);
+}
+
+static gboolean
+timeout_cb (gpointer user_data)
+{
+  static const ClutterColor red = { 255, 0, 0, 255 };
+  static const ClutterColor green = { 0, 255, 0, 255 };
+  static const ClutterColor blue = { 0, 0, 255, 255 };
+  static const ClutterColor white = { 255, 255, 255, 255 };
+  static const ClutterColor half_blue = { 0, 0, 127, 255 };
+  static const ClutterColor half_white = { 127, 127, 127, 255 };
+  Data *data = user_data;
+
+  /* The nodes of the actor have been built by the first frame, and
+     painting again without any change reuses them */
+  verify_results (data, &red, &green, 1);
+
+  clutter_actor_queue_redraw (data->actor);
+  verify_results (data, &red, &green, 1);
+
+  /* Changing the background color rebuilds them */
+  clutter_actor_set_background_color (data->actor, &blue);
+  verify_results (data, &blue, &green, 2);
+  verify_results (data, &blue, &green, 2);
+
+  /* Invalidating the content rebuilds them */
+  data->content->color = white;
+  clutter_content_invalidate (CLUTTER_CONTENT (data->content));
+  verify_results (data, &blue, &white, 3);
+  verify_results (data, &blue, &white, 3);
+
+  /* Changing the opacity rebuilds them */
+  clutter_actor_set_opacity (data->actor, 127);
+  verify_results (data, &half_blue, &half_white, 4);
+  verify_results (data, &half_blue, &half_white, 4);
+
+  clutter_main_quit ();
+
+  return G_SOURCE_REMOVE;
+}
+
+void
+actor_paint_node_cache (TestConformSimpleFixture *fixture,
+                        gconstpointer             test_data)
+{
+  static const ClutterColor red = { 255, 0, 0, 255 };
+  static const ClutterColor green = { 0, 255, 0, 255 };
+  Data data;
+
+  data.stage = clutter_stage_new ();
+  clutter_stage_set_color (CLUTTER_STAGE (data.stage), CLUTTER_COLOR_Black);
+
+  data.content = g_object_new (foo_content_get_type (), NULL);
+  data.content->color = green;
+
+  data.actor = clutter_actor_new ();
+  clutter_actor_set_size (data.actor, 100, 100);
+  clutter_actor_set_background_color (data.actor, &red);
+  clutter_actor_set_content (data.actor, CLUTTER_CONTENT (data.content));
+  clutter_actor_add_child (data.stage, data.actor);
+
+  clutter_actor_show (data.stage);
+
+  /* Start the test after a short delay to allow the stage to
+     render its initial frames without affecting the results */
+  g_timeout_add_full (G_PRIORITY_LOW, 250, timeout_cb, &data, NULL);
+
+  clutter_main ();
+
+  clutter_actor_destroy (data.stage);
+  g_object_unref (data.content);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+}
@@ -285,3 +285,216 @@ actor_pick (void)
 
   clutter_actor_destroy (state.stage);
 }
+
+static gboolean
+on_geometric_pick_idle (gpointer data)
+{
+  State *state = data;
+  ClutterActor *over_actor;
+  int y, x;
+
+  over_actor = clutter_actor_new ();
+  clutter_actor_set_size (over_actor, STAGE_WIDTH, STAGE_HEIGHT);
+  clutter_actor_set_clip (over_actor,
+                          state->actor_width * 2,
+                          state->actor_height * 2,
+                          state->actor_width * (ACTORS_X - 4),
+                          state->actor_height * (ACTORS_Y - 4));
+  clutter_actor_add_child (state->stage, over_actor);
+
+  for (y = 0; y < ACTORS_Y; y++)
+    {
+      for (x = 0; x < ACTORS_X; x++)
+        {
+          ClutterActor *actor, *expected;
+
+          actor =
+            clutter_stage_get_actor_at_pos (CLUTTER_STAGE (state->stage),
+                                            CLUTTER_PICK_ALL,
+                                            x * state->actor_width
+                                            + state->actor_width / 2,
+                                            y * state->actor_height
+                                            + state->actor_height / 2);
+
+          if (x >= 2 && x < ACTORS_X - 2 &&
+              y >= 2 && y < ACTORS_Y - 2)
+            expected = over_actor;
+          else
+            expected = state->actors[y * ACTORS_X + x];
+
+          if (g_test_verbose ())
+            g_print ("% 3i,% 3i / %p -> %p: %s\n",
+                     x, y, expected, actor,
+                     actor == expected ? "pass" : "FAIL");
+
+          if (actor != expected)
+            state->pass = FALSE;
+        }
+    }
+
+  /* the covering actor is not reactive, so it must not be picked
+   * when only looking for reactive actors
+   */
+  if (clutter_stage_get_actor_at_pos (CLUTTER_STAGE (state->stage),
+                                      CLUTTER_PICK_REACTIVE,
+                                      STAGE_WIDTH / 2,
+                                      STAGE_HEIGHT / 2) == over_actor)
+    state->pass = FALSE;
+
+  clutter_main_quit ();
+
+  return G_SOURCE_REMOVE;
+}
+
+void
+actor_geometric_pick (void)
+{
+  int y, x;
+  State state;
+
+  state.pass = TRUE;
+
+  state.stage = clutter_stage_new ();
+  clutter_stage_set_geometric_picking (CLUTTER_STAGE (state.stage), TRUE);
+  g_assert (clutter_stage_get_geometric_picking (CLUTTER_STAGE (state.stage)));
+
+  state.actor_width = STAGE_WIDTH / ACTORS_X;
+  state.actor_height = STAGE_HEIGHT / ACTORS_Y;
+
+  for (y = 0; y < ACTORS_Y; y++)
+    for (x = 0; x < ACTORS_X; x++)
+      {
+        ClutterActor *actor = clutter_actor_new ();
+
+        clutter_actor_set_position (actor,
+                                    x * state.actor_width,
+                                    y * state.actor_height);
+        clutter_actor_set_size (actor,
+                                state.actor_width,
+                                state.actor_height);
+        clutter_actor_set_reactive (actor, TRUE);
+        clutter_actor_add_child (state.stage, actor);
+
+        state.actors[y * ACTORS_X + x] = actor;
+      }
+
+  clutter_actor_show (state.stage);
+
+  clutter_threads_add_idle (on_geometric_pick_idle, &state);
+
+  clutter_main ();
+
+  if (g_test_verbose ())
+    g_print ("end result: %s\n", state.pass ? "pass" : "FAIL");
+
+  g_assert (state.pass);
+
+  clutter_actor_destroy (state.stage);
+}
+
+static gboolean
+on_pick_moved_idle (gpointer data)
+{
+  State *state = data;
+  ClutterActor *moved, *actor;
+  gfloat old_x, old_y;
+
+  /* after the first paint, the stage knows where every actor is; move
+   * the first actor on top of the last one, and check that the picks
+   * do not rely on stale positions
+   */
+  moved = state->actors[0];
+  old_x = state->actor_width / 2;
+  old_y = state->actor_height / 2;
+
+  clutter_actor_set_position (moved,
+                              (ACTORS_X - 1) * state->actor_width,
+                              (ACTORS_Y - 1) * state->actor_height);
+  clutter_actor_set_child_above_sibling (state->stage, moved, NULL);
+
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (state->stage),
+                                          CLUTTER_PICK_ALL,
+                                          STAGE_WIDTH - state->actor_width / 2,
+                                          STAGE_HEIGHT - state->actor_height / 2);
+  if (g_test_verbose ())
+    g_print ("new position: %p -> %p\n", moved, actor);
+
+  if (actor != moved)
+    state->pass = FALSE;
+
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (state->stage),
+                                          CLUTTER_PICK_ALL,
+                                          old_x, old_y);
+  if (g_test_verbose ())
+    g_print ("old position: %p -> %p\n", state->stage, actor);
+
+  if (actor != state->stage)
+    state->pass = FALSE;
+
+  clutter_main_quit ();
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+on_pick_moved_paint (ClutterActor *stage,
+                     State        *state)
+{
+  g_signal_handlers_disconnect_by_func (stage, on_pick_moved_paint, state);
+
+  clutter_threads_add_idle (on_pick_moved_idle, state);
+}
+
+void
+actor_pick_moved (void)
+{
+  gboolean geometric_picking;
+
+  for (geometric_picking = FALSE; geometric_picking <= TRUE; geometric_picking++)
+    {
+      int y, x;
+      State state;
+
+      state.pass = TRUE;
+
+      state.stage = clutter_stage_new ();
+      clutter_stage_set_geometric_picking (CLUTTER_STAGE (state.stage),
+                                           geometric_picking);
+
+      state.actor_width = STAGE_WIDTH / ACTORS_X;
+      state.actor_height = STAGE_HEIGHT / ACTORS_Y;
+
+      for (y = 0; y < ACTORS_Y; y++)
+        for (x = 0; x < ACTORS_X; x++)
+          {
+            ClutterActor *actor = clutter_actor_new ();
+
+            clutter_actor_set_position (actor,
+                                        x * state.actor_width,
+                                        y * state.actor_height);
+            clutter_actor_set_size (actor,
+                                    state.actor_width,
+                                    state.actor_height);
+            clutter_actor_add_child (state.stage, actor);
+
+            state.actors[y * ACTORS_X + x] = actor;
+          }
+
+      g_signal_connect_after (state.stage, "paint",
+                              G_CALLBACK (on_pick_moved_paint),
+                              &state);
+
+      clutter_actor_show (state.stage);
+
+      clutter_main ();
+
+      if (g_test_verbose ())
+        g_print ("end result (%s picking): %s\n",
+                 geometric_picking ? "geometric" : "render",
+                 state.pass ? "pass" : "FAIL");
+
+      g_assert (state.pass);
+
+      clutter_actor_destroy (state.stage);
+    }
+}
@@ -138,6 +138,135 @@ actor_preferred_size (void)
   clutter_actor_destroy (test);
 }
 
+static gboolean
+width_request_is_cached (ClutterActor *test,
+                         gfloat        for_height)
+{
+  TestActor *self = (TestActor *) test;
+
+  self->preferred_width_called = FALSE;
+  clutter_actor_get_preferred_width (test, for_height, NULL, NULL);
+
+  return !self->preferred_width_called;
+}
+
+void
+actor_size_request_cache (void)
+{
+  ClutterActor *test, *source, *parent;
+
+  parent = clutter_actor_new ();
+  g_object_ref_sink (parent);
+
+  test = g_object_new (TEST_TYPE_ACTOR, NULL);
+  clutter_actor_add_child (parent, test);
+
+  if (g_test_verbose ())
+    g_print ("Cached request with margins\n");
+  clutter_actor_set_margin_top (test, 5);
+  g_assert (!width_request_is_cached (test, 20));
+  g_assert (width_request_is_cached (test, 20));
+
+  if (g_test_verbose ())
+    g_print ("Least recently used entry is evicted\n");
+  g_assert (!width_request_is_cached (test, 30));
+  g_assert (!width_request_is_cached (test, 40));
+  g_assert (!width_request_is_cached (test, 50));
+  g_assert (width_request_is_cached (test, 20));
+  g_assert (!width_request_is_cached (test, 60));
+  g_assert (width_request_is_cached (test, 20));
+  g_assert (!width_request_is_cached (test, 30));
+
+  if (g_test_verbose ())
+    g_print ("Constraint sources do not invalidate the cache\n");
+  source = clutter_actor_new ();
+  clutter_actor_add_child (parent, source);
+  clutter_actor_add_constraint (test,
+                                clutter_bind_constraint_new (source,
+                                                             CLUTTER_BIND_X,
+                                                             0.f));
+
+  g_assert (width_request_is_cached (test, 20));
+  clutter_actor_queue_relayout (source);
+  g_assert (width_request_is_cached (test, 20));
+
+  clutter_actor_queue_relayout (test);
+  g_assert (!width_request_is_cached (test, 20));
+
+  clutter_actor_destroy (parent);
+  g_object_unref (parent);
+}
+
+static void
+on_queue_relayout (ClutterActor *actor,
+                   guint        *n_relayouts)
+{
+  *n_relayouts += 1;
+}
+
+static gfloat
+get_allocated_width (ClutterActor *actor)
+{
+  ClutterActorBox box;
+
+  /* this forces a relayout of the stage */
+  clutter_actor_get_allocation_box (actor, &box);
+
+  return clutter_actor_box_get_width (&box);
+}
+
+void
+actor_relayout_boundary (void)
+{
+  ClutterActor *stage, *container, *boundary, *child;
+  guint n_relayouts = 0;
+
+  stage = clutter_stage_new ();
+
+  container = clutter_actor_new ();
+  clutter_actor_add_child (stage, container);
+
+  boundary = clutter_actor_new ();
+  clutter_actor_set_size (boundary, 100, 100);
+  clutter_actor_add_child (container, boundary);
+
+  child = clutter_actor_new ();
+  clutter_actor_set_size (child, 10, 10);
+  clutter_actor_add_child (boundary, child);
+
+  g_assert_cmpfloat (get_allocated_width (child), ==, 10);
+
+  g_signal_connect (container, "queue-relayout",
+                    G_CALLBACK (on_queue_relayout),
+                    &n_relayouts);
+
+  if (g_test_verbose ())
+    g_print ("Fixed size actors stop the relayout\n");
+  clutter_actor_set_size (child, 20, 20);
+  g_assert_cmpuint (n_relayouts, ==, 0);
+  g_assert_cmpfloat (get_allocated_width (child), ==, 20);
+
+  if (g_test_verbose ())
+    g_print ("The boundary flag stops the relayout\n");
+  clutter_actor_set_size (boundary, -1, -1);
+  g_assert_cmpuint (n_relayouts, ==, 1);
+  g_assert_cmpfloat (get_allocated_width (boundary), ==, 20);
+
+  clutter_actor_set_flags (boundary, CLUTTER_ACTOR_LAYOUT_BOUNDARY);
+  clutter_actor_set_size (child, 30, 30);
+  g_assert_cmpuint (n_relayouts, ==, 1);
+  g_assert_cmpfloat (get_allocated_width (child), ==, 30);
+
+  if (g_test_verbose ())
+    g_print ("Other actors propagate the relayout\n");
+  clutter_actor_unset_flags (boundary, CLUTTER_ACTOR_LAYOUT_BOUNDARY);
+  clutter_actor_set_size (child, 40, 40);
+  g_assert_cmpuint (n_relayouts, ==, 2);
+  g_assert_cmpfloat (get_allocated_width (boundary), ==, 40);
+
+  clutter_actor_destroy (stage);
+}
+
 void
 actor_fixed_size (void)
 {
@@ -0,0 +1,230 @@
+#include <stdlib.h>
+#include <math.h>
+
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+#define N_LEVELS        10
+#define LEVEL_OFFSET_X  10.f
+#define LEVEL_OFFSET_Y  5.f
+
+/* Allow the transformed position to be off by a certain number of
+   pixels */
+#define POSITION_TOLERANCE     2
+
+typedef struct _TestState
+{
+  ClutterActor *stage;
+  ClutterActor *levels[N_LEVELS];
+} TestState;
+
+/* private, but exported by the library */
+gboolean clutter_actor_has_cached_absolute_transform (ClutterActor *self);
+
+static void
+assert_transformed_position (ClutterActor *actor,
+                             gfloat        x,
+                             gfloat        y)
+{
+  gfloat transformed_x, transformed_y;
+
+  clutter_actor_get_transformed_position (actor,
+                                          &transformed_x,
+                                          &transformed_y);
+
+  if (g_test_verbose ())
+    g_print ("%s: expected (%.2f, %.2f), got (%.2f, %.2f)\n",
+             clutter_actor_get_name (actor),
+             x, y,
+             transformed_x, transformed_y);
+
+  g_assert_cmpfloat (fabsf (transformed_x - x), <=, POSITION_TOLERANCE);
+  g_assert_cmpfloat (fabsf (transformed_y - y), <=, POSITION_TOLERANCE);
+}
+
+static void
+ensure_allocation (TestState *state)
+{
+  ClutterActorBox box;
+
+  /* this forces a relayout of the stage */
+  clutter_actor_get_allocation_box (state->levels[N_LEVELS - 1], &box);
+}
+
+static gboolean
+idle_cb (gpointer data)
+{
+  TestState *state = data;
+  ClutterActor *leaf = state->levels[N_LEVELS - 1];
+
+  ensure_allocation (state);
+  assert_transformed_position (leaf,
+                               LEVEL_OFFSET_X * N_LEVELS,
+                               LEVEL_OFFSET_Y * N_LEVELS);
+
+  /* querying the position again uses the cached transformations */
+  assert_transformed_position (leaf,
+                               LEVEL_OFFSET_X * N_LEVELS,
+                               LEVEL_OFFSET_Y * N_LEVELS);
+
+  /* moving an ancestor moves all its descendants */
+  clutter_actor_set_x (state->levels[0], LEVEL_OFFSET_X * 3);
+  ensure_allocation (state);
+  assert_transformed_position (leaf,
+                               LEVEL_OFFSET_X * (N_LEVELS + 2),
+                               LEVEL_OFFSET_Y * N_LEVELS);
+  assert_transformed_position (state->levels[N_LEVELS / 2],
+                               LEVEL_OFFSET_X * (N_LEVELS / 2 + 3),
+                               LEVEL_OFFSET_Y * (N_LEVELS / 2 + 1));
+
+  /* changing the transformation of an ancestor without changing its
+   * allocation invalidates its descendants as well
+   */
+  clutter_actor_set_scale (state->levels[1], 2.0, 2.0);
+  assert_transformed_position (leaf,
+                               LEVEL_OFFSET_X * 4
+                               + LEVEL_OFFSET_X * (N_LEVELS - 2) * 2,
+                               LEVEL_OFFSET_Y * 2
+                               + LEVEL_OFFSET_Y * (N_LEVELS - 2) * 2);
+  clutter_actor_set_scale (state->levels[1], 1.0, 1.0);
+
+  /* the transformation depends on the parent */
+  g_object_ref (leaf);
+  clutter_actor_remove_child (state->levels[N_LEVELS - 2], leaf);
+  clutter_actor_add_child (state->stage, leaf);
+  g_object_unref (leaf);
+
+  ensure_allocation (state);
+  assert_transformed_position (leaf, LEVEL_OFFSET_X, LEVEL_OFFSET_Y);
+
+  clutter_main_quit ();
+
+  return G_SOURCE_REMOVE;
+}
+
+void
+actor_transforms_nested (void)
+{
+  ClutterActor *parent;
+  TestState state;
+  int i;
+
+  state.stage = clutter_stage_new ();
+
+  parent = state.stage;
+  for (i = 0; i < N_LEVELS; i++)
+    {
+      gchar *name = g_strdup_printf ("level-%d", i);
+
+      state.levels[i] = clutter_actor_new ();
+      clutter_actor_set_name (state.levels[i], name);
+      clutter_actor_set_position (state.levels[i],
+                                  LEVEL_OFFSET_X,
+                                  LEVEL_OFFSET_Y);
+      clutter_actor_set_size (state.levels[i], 10, 10);
+      clutter_actor_add_child (parent, state.levels[i]);
+
+      parent = state.levels[i];
+
+      g_free (name);
+    }
+
+  /* Run the tests in a low priority idle function so that we can be
+     sure the stage is correctly setup */
+  clutter_threads_add_idle_full (G_PRIORITY_LOW, idle_cb, &state, NULL);
+
+  clutter_actor_show (state.stage);
+
+  clutter_main ();
+
+  g_idle_remove_by_data (&state);
+
+  clutter_actor_destroy (state.stage);
+}
+
+static gboolean
+siblings_idle_cb (gpointer data)
+{
+  TestState *state = data;
+  ClutterActor *moving = state->levels[0];
+  ClutterActor *sibling = state->levels[1];
+  ClutterActor *child = state->levels[2];
+
+  ensure_allocation (state);
+  assert_transformed_position (moving, LEVEL_OFFSET_X, LEVEL_OFFSET_Y);
+  assert_transformed_position (child,
+                               LEVEL_OFFSET_X * 2,
+                               LEVEL_OFFSET_Y * 2);
+
+  g_assert (clutter_actor_has_cached_absolute_transform (moving));
+  g_assert (clutter_actor_has_cached_absolute_transform (sibling));
+  g_assert (clutter_actor_has_cached_absolute_transform (child));
+
+  /* changing the transformation of an actor does not invalidate the
+   * cached transformations outside of its own sub-tree
+   */
+  clutter_actor_set_scale (moving, 2.0, 2.0);
+  g_assert (!clutter_actor_has_cached_absolute_transform (moving));
+  g_assert (clutter_actor_has_cached_absolute_transform (state->stage));
+  g_assert (clutter_actor_has_cached_absolute_transform (sibling));
+  g_assert (clutter_actor_has_cached_absolute_transform (child));
+
+  /* and neither does changing its allocation */
+  clutter_actor_set_x (moving, LEVEL_OFFSET_X * 3);
+  ensure_allocation (state);
+  g_assert (clutter_actor_has_cached_absolute_transform (sibling));
+  g_assert (clutter_actor_has_cached_absolute_transform (child));
+
+  assert_transformed_position (moving, LEVEL_OFFSET_X * 3, LEVEL_OFFSET_Y);
+  assert_transformed_position (child,
+                               LEVEL_OFFSET_X * 2,
+                               LEVEL_OFFSET_Y * 2);
+
+  /* changing the transformation of the parent invalidates the child */
+  clutter_actor_set_scale (sibling, 2.0, 2.0);
+  g_assert (!clutter_actor_has_cached_absolute_transform (child));
+  assert_transformed_position (child,
+                               LEVEL_OFFSET_X * 3,
+                               LEVEL_OFFSET_Y * 3);
+
+  clutter_main_quit ();
+
+  return G_SOURCE_REMOVE;
+}
+
+void
+actor_transforms_siblings (void)
+{
+  TestState state;
+  int i;
+
+  state.stage = clutter_stage_new ();
+
+  /* two siblings, the second one with a child of its own */
+  for (i = 0; i < 3; i++)
+    {
+      state.levels[i] = clutter_actor_new ();
+      clutter_actor_set_position (state.levels[i],
+                                  LEVEL_OFFSET_X,
+                                  LEVEL_OFFSET_Y);
+      clutter_actor_set_size (state.levels[i], 10, 10);
+    }
+
+  clutter_actor_add_child (state.stage, state.levels[0]);
+  clutter_actor_add_child (state.stage, state.levels[1]);
+  clutter_actor_add_child (state.levels[1], state.levels[2]);
+
+  /* ensure_allocation() uses the last level */
+  state.levels[N_LEVELS - 1] = state.levels[2];
+
+  clutter_threads_add_idle_full (G_PRIORITY_LOW, siblings_idle_cb, &state, NULL);
+
+  clutter_actor_show (state.stage);
+
+  clutter_main ();
+
+  g_idle_remove_by_data (&state);
+
+  clutter_actor_destroy (state.stage);
+}
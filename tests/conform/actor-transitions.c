@@ -0,0 +1,189 @@
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+#define TEST_DURATION           250
+#define TEST_WATCHDOG_SECONDS   10
+
+typedef struct _TestState
+{
+  ClutterActor *stage;
+  ClutterActor *actor;
+
+  guint watchdog_id;
+
+  guint n_frames;
+  guint n_completed;
+
+  gfloat last_x;
+  gboolean pass;
+} TestState;
+
+static gboolean
+watchdog_timeout (gpointer data)
+{
+  g_test_message ("Watchdog timer kicking in");
+  g_test_message ("Failed (the transitions never completed)");
+  exit (EXIT_FAILURE);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+on_x_changed (ClutterActor *actor,
+              GParamSpec   *pspec,
+              TestState    *state)
+{
+  gfloat x = clutter_actor_get_x (actor);
+
+  /* the transition never goes backwards */
+  if (x < state->last_x)
+    state->pass = FALSE;
+
+  state->last_x = x;
+  state->n_frames += 1;
+}
+
+static void
+on_transitions_completed (ClutterActor *actor,
+                          TestState    *state)
+{
+  state->n_completed += 1;
+
+  clutter_main_quit ();
+}
+
+static void
+test_state_init (TestState *state)
+{
+  state->stage = clutter_stage_new ();
+  state->actor = clutter_actor_new ();
+  clutter_actor_add_child (state->stage, state->actor);
+
+  state->n_frames = 0;
+  state->n_completed = 0;
+  state->last_x = 0.f;
+  state->pass = TRUE;
+
+  g_signal_connect (state->actor, "notify::x",
+                    G_CALLBACK (on_x_changed),
+                    state);
+  g_signal_connect (state->actor, "transitions-completed",
+                    G_CALLBACK (on_transitions_completed),
+                    state);
+
+  state->watchdog_id =
+    clutter_threads_add_timeout (TEST_WATCHDOG_SECONDS * 1000,
+                                 watchdog_timeout,
+                                 state);
+
+  clutter_actor_show (state->stage);
+}
+
+static void
+test_state_clear (TestState *state)
+{
+  g_source_remove (state->watchdog_id);
+
+  clutter_actor_destroy (state->stage);
+}
+
+void
+actor_implicit_transitions (void)
+{
+  ClutterColor color = { 255, 0, 0, 255 };
+  ClutterColor result;
+  TestState state;
+
+  test_state_init (&state);
+
+  clutter_actor_save_easing_state (state.actor);
+  clutter_actor_set_easing_duration (state.actor, TEST_DURATION);
+  clutter_actor_set_easing_mode (state.actor, CLUTTER_LINEAR);
+  clutter_actor_set_x (state.actor, 100.f);
+  clutter_actor_set_opacity (state.actor, 0);
+  clutter_actor_set_background_color (state.actor, &color);
+  clutter_actor_restore_easing_state (state.actor);
+
+  /* nothing changes until the first frame */
+  g_assert_cmpfloat (clutter_actor_get_x (state.actor), ==, 0.f);
+
+  clutter_main ();
+
+  if (g_test_verbose ())
+    g_print ("frames: %u, completed: %u\n", state.n_frames, state.n_completed);
+
+  g_assert (state.pass);
+  g_assert_cmpuint (state.n_frames, >, 1);
+  g_assert_cmpuint (state.n_completed, ==, 1);
+
+  g_assert_cmpfloat (clutter_actor_get_x (state.actor), ==, 100.f);
+  g_assert_cmpuint (clutter_actor_get_opacity (state.actor), ==, 0);
+
+  clutter_actor_get_background_color (state.actor, &result);
+  g_assert (clutter_color_equal (&color, &result));
+
+  test_state_clear (&state);
+}
+
+void
+actor_implicit_transition_get (void)
+{
+  ClutterTransition *transition;
+  TestState state;
+
+  test_state_init (&state);
+
+  clutter_actor_save_easing_state (state.actor);
+  clutter_actor_set_easing_duration (state.actor, TEST_DURATION);
+  clutter_actor_set_x (state.actor, 100.f);
+  clutter_actor_restore_easing_state (state.actor);
+
+  /* implicit transitions can still be retrieved and controlled */
+  transition = clutter_actor_get_transition (state.actor, "x");
+  g_assert (CLUTTER_IS_PROPERTY_TRANSITION (transition));
+  g_assert_cmpuint (clutter_timeline_get_duration (CLUTTER_TIMELINE (transition)),
+                    ==,
+                    TEST_DURATION);
+  g_assert (clutter_actor_get_transition (state.actor, "x") == transition);
+
+  clutter_main ();
+
+  g_assert (state.pass);
+  g_assert_cmpuint (state.n_completed, ==, 1);
+  g_assert_cmpfloat (clutter_actor_get_x (state.actor), ==, 100.f);
+  g_assert (clutter_actor_get_transition (state.actor, "x") == NULL);
+
+  test_state_clear (&state);
+}
+
+void
+actor_implicit_transition_retarget (void)
+{
+  TestState state;
+
+  test_state_init (&state);
+
+  clutter_actor_save_easing_state (state.actor);
+  clutter_actor_set_easing_duration (state.actor, TEST_DURATION);
+  clutter_actor_set_x (state.actor, 50.f);
+  clutter_actor_set_x (state.actor, 100.f);
+  clutter_actor_restore_easing_state (state.actor);
+
+  /* removing a transition does not emit ::transitions-completed */
+  clutter_actor_save_easing_state (state.actor);
+  clutter_actor_set_easing_duration (state.actor, TEST_DURATION);
+  clutter_actor_set_y (state.actor, 100.f);
+  clutter_actor_restore_easing_state (state.actor);
+  clutter_actor_remove_transition (state.actor, "y");
+
+  clutter_main ();
+
+  g_assert (state.pass);
+  g_assert_cmpuint (state.n_completed, ==, 1);
+  g_assert_cmpfloat (clutter_actor_get_x (state.actor), ==, 100.f);
+  g_assert_cmpfloat (clutter_actor_get_y (state.actor), ==, 0.f);
+
+  test_state_clear (&state);
+}
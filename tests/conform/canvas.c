@@ -0,0 +1,489 @@
+#include <clutter/clutter.h>
+#include <cogl/cogl.h>
+
+#include "test-conform-common.h"
+
+#define BLOCK_SIZE 16
+
+/* Number of pixels at the border of a block to skip when verifying */
+#define TEST_INSET 1
+
+static const ClutterColor stage_color = { 0x00, 0x00, 0x00, 0xff };
+static const ClutterColor red = { 0xff, 0x00, 0x00, 0xff };
+static const ClutterColor green = { 0x00, 0xff, 0x00, 0xff };
+static const ClutterColor blue = { 0x00, 0x00, 0xff, 0xff };
+
+typedef enum
+{
+  /* The first frame draws the whole canvas in red; the second frame
+     invalidates only the right block of the canvas, and draws it in
+     blue. The drawing is done in the idle callback and the validation
+     is done during paint */
+  TEST_BEFORE_DRAW_FIRST_FRAME,
+  TEST_BEFORE_VALIDATE_FIRST_FRAME,
+  TEST_BEFORE_DRAW_SECOND_FRAME,
+  TEST_BEFORE_VALIDATE_SECOND_FRAME,
+  TEST_DONE
+} TestProgress;
+
+typedef enum
+{
+  /* The asynchronous canvas is first drawn in red; while the canvas
+     is being drawn in green at a new size, the red contents must
+     still be painted. Then the right block is invalidated, and only
+     its left half is drawn in blue: the right half must keep the
+     green contents, like it would when drawing synchronously */
+  ASYNC_BEFORE_DRAW_FIRST_FRAME,
+  ASYNC_WAIT_FIRST_FRAME,
+  ASYNC_BEFORE_RESIZE,
+  ASYNC_VALIDATE_RESIZING,
+  ASYNC_BEFORE_UNBLOCK_RESIZE,
+  ASYNC_WAIT_RESIZE,
+  ASYNC_BEFORE_DRAW_PARTIAL,
+  ASYNC_WAIT_PARTIAL,
+  ASYNC_DONE
+} AsyncProgress;
+
+typedef struct _TestState
+{
+  ClutterActor *stage;
+  ClutterContent *canvas;
+  guint frame;
+  TestProgress progress;
+  AsyncProgress async_progress;
+  guint n_resizing_frames;
+
+  /* the colour used by the ::draw handler, and the area it fills;
+     the whole clip is filled if the area is empty */
+  const ClutterColor *color;
+  cairo_rectangle_int_t fill_area;
+
+  /* held by the main thread to stop an asynchronous ::draw */
+  GMutex draw_block;
+
+  /* the clip extents of the last ::draw emission */
+  cairo_rectangle_int_t clip;
+  volatile gint n_draws;
+} TestState;
+
+static void
+validate_area (int x_0, int y_0,
+               int width, int height,
+               const ClutterColor *color)
+{
+  guint8 *data = g_malloc (width * height * 4);
+  int x, y;
+
+  cogl_read_pixels (x_0, y_0,
+                    width, height,
+                    COGL_READ_PIXELS_COLOR_BUFFER,
+                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                    data);
+
+  for (x = 0; x < width - TEST_INSET * 2; x++)
+    for (y = 0; y < height - TEST_INSET * 2; y++)
+      {
+        const guint8 *p = data + ((x + TEST_INSET) * 4 +
+                                  (y + TEST_INSET) * width * 4);
+
+        g_assert_cmpint (p[0], ==, color->red);
+        g_assert_cmpint (p[1], ==, color->green);
+        g_assert_cmpint (p[2], ==, color->blue);
+      }
+
+  g_free (data);
+}
+
+static void
+validate_part (int block_x, int block_y, const ClutterColor *color)
+{
+  validate_area (block_x * BLOCK_SIZE, block_y * BLOCK_SIZE,
+                 BLOCK_SIZE, BLOCK_SIZE,
+                 color);
+}
+
+static gboolean
+pixel_has_color (int x, int y, const ClutterColor *color)
+{
+  guint8 data[4];
+
+  cogl_read_pixels (x, y, 1, 1,
+                    COGL_READ_PIXELS_COLOR_BUFFER,
+                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                    data);
+
+  return data[0] == color->red &&
+         data[1] == color->green &&
+         data[2] == color->blue;
+}
+
+static gboolean
+draw_cb (ClutterCanvas *canvas,
+         cairo_t       *cr,
+         int            width,
+         int            height,
+         TestState     *state)
+{
+  double x1, y1, x2, y2;
+
+  /* this is a no-op unless the test is blocking asynchronous draws */
+  g_mutex_lock (&state->draw_block);
+  g_mutex_unlock (&state->draw_block);
+
+  cairo_clip_extents (cr, &x1, &y1, &x2, &y2);
+
+  state->clip.x = x1;
+  state->clip.y = y1;
+  state->clip.width = x2 - x1;
+  state->clip.height = y2 - y1;
+
+  cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
+  cairo_set_source_rgb (cr,
+                        state->color->red / 255.0,
+                        state->color->green / 255.0,
+                        state->color->blue / 255.0);
+
+  if (state->fill_area.width > 0 && state->fill_area.height > 0)
+    {
+      cairo_rectangle (cr,
+                       state->fill_area.x, state->fill_area.y,
+                       state->fill_area.width, state->fill_area.height);
+      cairo_fill (cr);
+    }
+  else
+    cairo_paint (cr);
+
+  g_atomic_int_inc (&state->n_draws);
+
+  return TRUE;
+}
+
+static void
+paint_cb (ClutterActor *actor, TestState *state)
+{
+  if (state->frame++ < 2)
+    return;
+
+  switch (state->progress)
+    {
+    case TEST_BEFORE_DRAW_FIRST_FRAME:
+    case TEST_BEFORE_DRAW_SECOND_FRAME:
+    case TEST_DONE:
+      /* Handled by the idle callback */
+      break;
+
+    case TEST_BEFORE_VALIDATE_FIRST_FRAME:
+      validate_part (0, 0, &red);
+      validate_part (1, 0, &red);
+
+      state->progress = TEST_BEFORE_DRAW_SECOND_FRAME;
+      break;
+
+    case TEST_BEFORE_VALIDATE_SECOND_FRAME:
+      /* the left block must have been preserved */
+      validate_part (0, 0, &red);
+      validate_part (1, 0, &blue);
+
+      state->progress = TEST_DONE;
+      break;
+    }
+}
+
+static gboolean
+idle_cb (gpointer data)
+{
+  TestState *state = data;
+  cairo_rectangle_int_t rect;
+
+  if (state->frame < 2)
+    clutter_actor_queue_redraw (CLUTTER_ACTOR (state->stage));
+  else
+    switch (state->progress)
+      {
+      case TEST_BEFORE_DRAW_FIRST_FRAME:
+        state->color = &red;
+        clutter_content_invalidate (state->canvas);
+
+        g_assert_cmpuint (state->n_draws, ==, 1);
+        g_assert_cmpint (state->clip.x, ==, 0);
+        g_assert_cmpint (state->clip.y, ==, 0);
+        g_assert_cmpint (state->clip.width, ==, BLOCK_SIZE * 2);
+        g_assert_cmpint (state->clip.height, ==, BLOCK_SIZE);
+
+        state->progress = TEST_BEFORE_VALIDATE_FIRST_FRAME;
+        break;
+
+      case TEST_BEFORE_DRAW_SECOND_FRAME:
+        rect.x = BLOCK_SIZE;
+        rect.y = 0;
+        rect.width = BLOCK_SIZE;
+        rect.height = BLOCK_SIZE;
+
+        state->color = &blue;
+        clutter_canvas_invalidate_rect (CLUTTER_CANVAS (state->canvas), &rect);
+
+        /* the ::draw signal is clipped to the invalidated area */
+        g_assert_cmpuint (state->n_draws, ==, 2);
+        g_assert_cmpint (state->clip.x, ==, rect.x);
+        g_assert_cmpint (state->clip.y, ==, rect.y);
+        g_assert_cmpint (state->clip.width, ==, rect.width);
+        g_assert_cmpint (state->clip.height, ==, rect.height);
+
+        state->progress = TEST_BEFORE_VALIDATE_SECOND_FRAME;
+        break;
+
+      case TEST_BEFORE_VALIDATE_FIRST_FRAME:
+      case TEST_BEFORE_VALIDATE_SECOND_FRAME:
+        /* Handled by the paint callback */
+        clutter_actor_queue_redraw (CLUTTER_ACTOR (state->stage));
+        break;
+
+      case TEST_DONE:
+        clutter_main_quit ();
+        break;
+      }
+
+  return G_SOURCE_CONTINUE;
+}
+
+void
+canvas_invalidate_rect (TestConformSimpleFixture *fixture,
+                        gconstpointer             data)
+{
+  TestState state = { NULL, };
+  ClutterActor *actor;
+  unsigned int idle_source;
+  unsigned int paint_handler;
+
+  state.stage = clutter_stage_new ();
+  state.progress = TEST_BEFORE_DRAW_FIRST_FRAME;
+  g_mutex_init (&state.draw_block);
+
+  state.canvas = clutter_canvas_new ();
+  clutter_canvas_set_size (CLUTTER_CANVAS (state.canvas),
+                           BLOCK_SIZE * 2,
+                           BLOCK_SIZE);
+  g_signal_connect (state.canvas, "draw", G_CALLBACK (draw_cb), &state);
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_size (actor, BLOCK_SIZE * 2, BLOCK_SIZE);
+  clutter_actor_set_content (actor, state.canvas);
+  clutter_actor_add_child (state.stage, actor);
+
+  clutter_stage_set_color (CLUTTER_STAGE (state.stage), &stage_color);
+
+  /* We force continuous redrawing of the stage, since we need to skip
+   * the first few frames */
+  idle_source = clutter_threads_add_idle (idle_cb, &state);
+  paint_handler = g_signal_connect_after (state.stage, "paint",
+                                          G_CALLBACK (paint_cb), &state);
+
+  clutter_actor_show (state.stage);
+  clutter_main ();
+
+  g_signal_handler_disconnect (state.stage, paint_handler);
+  g_source_remove (idle_source);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+
+  clutter_actor_destroy (state.stage);
+  g_object_unref (state.canvas);
+
+  g_mutex_clear (&state.draw_block);
+}
+
+static void
+async_paint_cb (ClutterActor *actor, TestState *state)
+{
+  if (state->frame++ < 2)
+    return;
+
+  switch (state->async_progress)
+    {
+    case ASYNC_BEFORE_DRAW_FIRST_FRAME:
+    case ASYNC_BEFORE_RESIZE:
+    case ASYNC_BEFORE_UNBLOCK_RESIZE:
+    case ASYNC_BEFORE_DRAW_PARTIAL:
+    case ASYNC_DONE:
+      /* Handled by the idle callback */
+      break;
+
+    case ASYNC_WAIT_FIRST_FRAME:
+      if (!pixel_has_color (BLOCK_SIZE / 2, BLOCK_SIZE / 2, &red))
+        break;
+
+      validate_part (0, 0, &red);
+      validate_part (1, 0, &red);
+      validate_part (0, 1, &red);
+      validate_part (1, 1, &red);
+
+      state->async_progress = ASYNC_BEFORE_RESIZE;
+      break;
+
+    case ASYNC_VALIDATE_RESIZING:
+      /* the new contents are not available yet, so the previous
+         ones must still be painted */
+      validate_part (0, 0, &red);
+      validate_part (1, 0, &red);
+      validate_part (0, 1, &red);
+      validate_part (1, 1, &red);
+
+      if (++state->n_resizing_frames == 3)
+        state->async_progress = ASYNC_BEFORE_UNBLOCK_RESIZE;
+      break;
+
+    case ASYNC_WAIT_RESIZE:
+      if (!pixel_has_color (BLOCK_SIZE / 2, BLOCK_SIZE / 2, &green))
+        break;
+
+      validate_part (0, 0, &green);
+      validate_part (1, 0, &green);
+      validate_part (0, 1, &green);
+      validate_part (1, 1, &green);
+
+      state->async_progress = ASYNC_BEFORE_DRAW_PARTIAL;
+      break;
+
+    case ASYNC_WAIT_PARTIAL:
+      if (!pixel_has_color (BLOCK_SIZE + BLOCK_SIZE / 4, BLOCK_SIZE / 2,
+                            &blue))
+        break;
+
+      g_assert_cmpint (g_atomic_int_get (&state->n_draws), ==, 3);
+      g_assert_cmpint (state->clip.x, ==, BLOCK_SIZE);
+      g_assert_cmpint (state->clip.y, ==, 0);
+      g_assert_cmpint (state->clip.width, ==, BLOCK_SIZE);
+      g_assert_cmpint (state->clip.height, ==, BLOCK_SIZE);
+
+      /* the part of the clip that was not drawn must be preserved */
+      validate_area (BLOCK_SIZE, 0, BLOCK_SIZE / 2, BLOCK_SIZE, &blue);
+      validate_area (BLOCK_SIZE + BLOCK_SIZE / 2, 0,
+                     BLOCK_SIZE / 2, BLOCK_SIZE,
+                     &green);
+      validate_part (0, 0, &green);
+      validate_part (0, 1, &green);
+      validate_part (1, 1, &green);
+
+      state->async_progress = ASYNC_DONE;
+      break;
+    }
+}
+
+static gboolean
+async_idle_cb (gpointer data)
+{
+  TestState *state = data;
+  cairo_rectangle_int_t rect;
+
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (state->stage));
+
+  if (state->frame < 2)
+    return G_SOURCE_CONTINUE;
+
+  switch (state->async_progress)
+    {
+    case ASYNC_BEFORE_DRAW_FIRST_FRAME:
+      state->color = &red;
+      clutter_content_invalidate (state->canvas);
+
+      state->async_progress = ASYNC_WAIT_FIRST_FRAME;
+      break;
+
+    case ASYNC_BEFORE_RESIZE:
+      g_mutex_lock (&state->draw_block);
+
+      state->color = &green;
+      clutter_canvas_set_size (CLUTTER_CANVAS (state->canvas),
+                               BLOCK_SIZE * 2,
+                               BLOCK_SIZE * 2);
+
+      state->async_progress = ASYNC_VALIDATE_RESIZING;
+      break;
+
+    case ASYNC_BEFORE_UNBLOCK_RESIZE:
+      g_mutex_unlock (&state->draw_block);
+
+      state->async_progress = ASYNC_WAIT_RESIZE;
+      break;
+
+    case ASYNC_BEFORE_DRAW_PARTIAL:
+      rect.x = BLOCK_SIZE;
+      rect.y = 0;
+      rect.width = BLOCK_SIZE;
+      rect.height = BLOCK_SIZE;
+
+      state->color = &blue;
+      state->fill_area.x = BLOCK_SIZE;
+      state->fill_area.y = 0;
+      state->fill_area.width = BLOCK_SIZE / 2;
+      state->fill_area.height = BLOCK_SIZE;
+      clutter_canvas_invalidate_rect (CLUTTER_CANVAS (state->canvas), &rect);
+
+      state->async_progress = ASYNC_WAIT_PARTIAL;
+      break;
+
+    case ASYNC_WAIT_FIRST_FRAME:
+    case ASYNC_VALIDATE_RESIZING:
+    case ASYNC_WAIT_RESIZE:
+    case ASYNC_WAIT_PARTIAL:
+      /* Handled by the paint callback */
+      break;
+
+    case ASYNC_DONE:
+      clutter_main_quit ();
+      break;
+    }
+
+  return G_SOURCE_CONTINUE;
+}
+
+void
+canvas_draw_async (TestConformSimpleFixture *fixture,
+                   gconstpointer             data)
+{
+  TestState state = { NULL, };
+  ClutterActor *actor;
+  unsigned int idle_source;
+  unsigned int paint_handler;
+
+  state.stage = clutter_stage_new ();
+  state.async_progress = ASYNC_BEFORE_DRAW_FIRST_FRAME;
+  g_mutex_init (&state.draw_block);
+
+  state.canvas = clutter_canvas_new ();
+  clutter_canvas_set_draw_async (CLUTTER_CANVAS (state.canvas), TRUE);
+  g_assert (clutter_canvas_get_draw_async (CLUTTER_CANVAS (state.canvas)));
+
+  /* the canvas is stretched vertically until it is resized */
+  clutter_canvas_set_size (CLUTTER_CANVAS (state.canvas),
+                           BLOCK_SIZE * 2,
+                           BLOCK_SIZE);
+  g_signal_connect (state.canvas, "draw", G_CALLBACK (draw_cb), &state);
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_size (actor, BLOCK_SIZE * 2, BLOCK_SIZE * 2);
+  clutter_actor_set_content (actor, state.canvas);
+  clutter_actor_add_child (state.stage, actor);
+
+  clutter_stage_set_color (CLUTTER_STAGE (state.stage), &stage_color);
+
+  idle_source = clutter_threads_add_idle (async_idle_cb, &state);
+  paint_handler = g_signal_connect_after (state.stage, "paint",
+                                          G_CALLBACK (async_paint_cb),
+                                          &state);
+
+  clutter_actor_show (state.stage);
+  clutter_main ();
+
+  g_signal_handler_disconnect (state.stage, paint_handler);
+  g_source_remove (idle_source);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+
+  clutter_actor_destroy (state.stage);
+  g_object_unref (state.canvas);
+
+  g_mutex_clear (&state.draw_block);
+}
@@ -0,0 +1,192 @@
+#include <clutter/clutter.h>
+#include "test-conform-common.h"
+
+#define N_ROWS          100
+#define ITEM_HEIGHT     10.f
+#define VIEW_SIZE       100.f
+
+typedef struct _TestState       TestState;
+
+struct _TestState
+{
+  ClutterActor *stage;
+  ClutterActor *view;
+  ClutterModel *model;
+
+  guint n_created;
+
+  guint frame;
+  guint step;
+};
+
+static ClutterActor *
+create_item (ClutterListView *view,
+             gpointer         data)
+{
+  TestState *state = data;
+  ClutterActor *item;
+
+  item = clutter_actor_new ();
+  clutter_actor_set_size (item, VIEW_SIZE, ITEM_HEIGHT);
+
+  state->n_created += 1;
+
+  return item;
+}
+
+static void
+bind_item (ClutterListView  *view,
+           ClutterActor     *item,
+           ClutterModelIter *iter,
+           gpointer          data)
+{
+  gchar *text = NULL;
+
+  clutter_model_iter_get (iter, 0, &text, -1);
+  clutter_actor_set_name (item, text);
+
+  g_free (text);
+}
+
+static void
+assert_item_name (TestState   *state,
+                  guint        row,
+                  const gchar *name)
+{
+  ClutterActor *item;
+
+  item = clutter_list_view_get_item_for_row (CLUTTER_LIST_VIEW (state->view),
+                                             row);
+
+  if (name == NULL)
+    {
+      g_assert (item == NULL);
+      return;
+    }
+
+  g_assert (item != NULL);
+  g_assert (CLUTTER_ACTOR_IS_VISIBLE (item));
+  g_assert_cmpstr (clutter_actor_get_name (item), ==, name);
+}
+
+static void
+on_paint (ClutterActor *stage,
+          TestState    *state)
+{
+  ClutterModelIter *iter;
+  ClutterPoint point;
+
+  /* give the view a couple of frames to update its items */
+  if (++state->frame < 3)
+    return;
+
+  state->frame = 0;
+
+  switch (state->step++)
+    {
+    case 0:
+      if (g_test_verbose ())
+        g_print ("Created %d items\n", state->n_created);
+
+      assert_item_name (state, 0, "row 0");
+      assert_item_name (state, 9, "row 9");
+      assert_item_name (state, 10, NULL);
+
+      /* only the visible rows have an actor */
+      g_assert_cmpint (state->n_created, ==, 10);
+      g_assert_cmpint (clutter_actor_get_n_children (state->view), ==, 10);
+
+      clutter_point_init (&point, 0.f, 50 * ITEM_HEIGHT);
+      clutter_scroll_actor_scroll_to_point (CLUTTER_SCROLL_ACTOR (state->view),
+                                            &point);
+      break;
+
+    case 1:
+      assert_item_name (state, 0, NULL);
+      assert_item_name (state, 50, "row 50");
+      assert_item_name (state, 59, "row 59");
+
+      /* scrolling recycles the existing items */
+      g_assert_cmpint (state->n_created, ==, 10);
+
+      /* changes are applied to the bound items right away */
+      iter = clutter_model_get_iter_at_row (state->model, 55);
+      clutter_model_iter_set (iter, 0, "changed", -1);
+      g_object_unref (iter);
+
+      assert_item_name (state, 55, "changed");
+
+      clutter_model_remove (state->model, 50);
+      break;
+
+    case 2:
+      assert_item_name (state, 50, "row 51");
+      assert_item_name (state, 54, "changed");
+      assert_item_name (state, 59, "row 60");
+
+      g_assert_cmpint (state->n_created, ==, 10);
+      g_assert_cmpint (clutter_actor_get_n_children (state->view), ==, 10);
+
+      clutter_main_quit ();
+      break;
+    }
+}
+
+static gboolean
+queue_redraw (gpointer data)
+{
+  TestState *state = data;
+
+  clutter_actor_queue_redraw (state->stage);
+
+  return TRUE;
+}
+
+void
+list_view_recycle (TestConformSimpleFixture *fixture,
+                   gconstpointer             data)
+{
+  TestState state = { NULL, };
+  gfloat height;
+  guint id;
+  gint i;
+
+  state.model = clutter_list_model_new (1, G_TYPE_STRING, "text");
+
+  for (i = 0; i < N_ROWS; i++)
+    {
+      gchar *text = g_strdup_printf ("row %d", i);
+
+      clutter_model_append (state.model, 0, text, -1);
+
+      g_free (text);
+    }
+
+  state.stage = clutter_stage_new ();
+
+  state.view = clutter_list_view_new ();
+  clutter_list_view_set_model (CLUTTER_LIST_VIEW (state.view), state.model);
+  clutter_list_view_set_item_factory (CLUTTER_LIST_VIEW (state.view),
+                                      create_item,
+                                      bind_item,
+                                      &state,
+                                      NULL);
+  clutter_actor_set_size (state.view, VIEW_SIZE, VIEW_SIZE);
+  clutter_actor_add_child (state.stage, state.view);
+
+  g_signal_connect_after (state.stage, "paint", G_CALLBACK (on_paint), &state);
+  id = clutter_threads_add_idle (queue_redraw, &state);
+
+  clutter_actor_show (state.stage);
+
+  clutter_main ();
+
+  /* the extent is estimated from the height of the items */
+  clutter_actor_get_preferred_height (state.view, VIEW_SIZE, NULL, &height);
+  g_assert_cmpfloat (height, ==, (N_ROWS - 1) * ITEM_HEIGHT);
+
+  g_source_remove (id);
+
+  clutter_actor_destroy (state.stage);
+  g_object_unref (state.model);
+}
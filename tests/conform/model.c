@@ -524,3 +524,228 @@ list_model_row_changed (TestConformSimpleFixture *fixture,
   g_object_unref (test_data.iter);
   g_object_unref (test_data.model);
 }
+
+static void
+on_bulk_row_added (ClutterModel     *model,
+                   ClutterModelIter *iter,
+                   gpointer          data)
+{
+  g_assert_not_reached ();
+}
+
+static void
+on_rows_added (ClutterModel *model,
+               guint         first_row,
+               guint         n_rows,
+               ModelData    *model_data)
+{
+  g_assert_cmpint (first_row, ==, 0);
+
+  model_data->n_row += n_rows;
+}
+
+void
+list_model_append_rows (TestConformSimpleFixture *fixture,
+                        gconstpointer             data)
+{
+  static const gchar *foo[] = {
+    "String 1", "String 2", "String 3",
+    "String 4", "String 5", "String 6",
+    "String 7", "String 8", "String 9",
+  };
+  static const gint bar[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+  const guint columns[] = { COLUMN_FOO, COLUMN_BAR };
+  gconstpointer column_data[] = { foo, bar };
+  ModelData test_data = { NULL, 0 };
+  ClutterModelIter *iter;
+  gint i;
+
+  test_data.model = clutter_list_model_new (N_COLUMNS,
+                                            G_TYPE_STRING, "Foo",
+                                            G_TYPE_INT,    "Bar");
+
+  g_signal_connect (test_data.model, "row-added",
+                    G_CALLBACK (on_bulk_row_added),
+                    NULL);
+  g_signal_connect (test_data.model, "rows-added",
+                    G_CALLBACK (on_rows_added),
+                    &test_data);
+
+  /* the row-added signal is not emitted for bulk insertions */
+  clutter_list_model_append_rows (CLUTTER_LIST_MODEL (test_data.model),
+                                  G_N_ELEMENTS (bar),
+                                  G_N_ELEMENTS (columns),
+                                  columns,
+                                  column_data);
+
+  g_assert_cmpint (test_data.n_row, ==, G_N_ELEMENTS (bar));
+  g_assert_cmpint (clutter_model_get_n_rows (test_data.model), ==, G_N_ELEMENTS (bar));
+
+  for (i = 0; i < G_N_ELEMENTS (bar); i++)
+    {
+      gchar *str;
+      gint value;
+
+      iter = clutter_model_get_iter_at_row (test_data.model, i);
+      clutter_model_iter_get (iter,
+                              COLUMN_FOO, &str,
+                              COLUMN_BAR, &value,
+                              -1);
+
+      g_assert_cmpstr (str, ==, foo[i]);
+      g_assert_cmpint (value, ==, bar[i]);
+
+      g_free (str);
+      g_object_unref (iter);
+    }
+
+  /* the slots of removed rows are reused and cleared */
+  clutter_model_remove (test_data.model, 0);
+  clutter_model_remove (test_data.model, 0);
+
+  g_signal_handlers_disconnect_by_func (test_data.model,
+                                        on_rows_added,
+                                        &test_data);
+
+  clutter_list_model_append_rows (CLUTTER_LIST_MODEL (test_data.model),
+                                  G_N_ELEMENTS (bar),
+                                  1,
+                                  columns + 1,
+                                  column_data + 1);
+
+  g_assert_cmpint (clutter_model_get_n_rows (test_data.model), ==, 2 * G_N_ELEMENTS (bar) - 2);
+
+  iter = clutter_model_get_last_iter (test_data.model);
+  compare_iter (iter, 2 * G_N_ELEMENTS (bar) - 3, NULL, 9);
+  g_object_unref (iter);
+
+  g_object_unref (test_data.model);
+}
+
+void
+list_model_filter_update (TestConformSimpleFixture *fixture,
+                          gconstpointer             data)
+{
+  ClutterModel *model;
+  ClutterModelIter *iter;
+  gint i;
+
+  model = clutter_list_model_new (N_COLUMNS,
+                                  G_TYPE_STRING, "Foo",
+                                  G_TYPE_INT,    "Bar");
+
+  for (i = 1; i < 10; i++)
+    {
+      gchar *foo = g_strdup_printf ("String %d", i);
+
+      clutter_model_append (model, COLUMN_FOO, foo, COLUMN_BAR, i, -1);
+
+      g_free (foo);
+    }
+
+  clutter_model_set_filter (model, filter_odd_rows, NULL, NULL);
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 5);
+
+  /* rows added after the filter was set are filtered as well */
+  clutter_model_append (model, COLUMN_FOO, "String 11", COLUMN_BAR, 11, -1);
+  clutter_model_append (model, COLUMN_FOO, "String 12", COLUMN_BAR, 12, -1);
+  clutter_model_prepend (model, COLUMN_FOO, "String -1", COLUMN_BAR, -1, -1);
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 7);
+
+  iter = clutter_model_get_iter_at_row (model, 0);
+  compare_iter (iter, 0, "String -1", -1);
+  g_object_unref (iter);
+
+  iter = clutter_model_get_iter_at_row (model, 6);
+  compare_iter (iter, 6, "String 11", 11);
+  g_object_unref (iter);
+
+  /* changing a row can hide it... */
+  iter = clutter_model_get_iter_at_row (model, 1);
+  clutter_model_iter_set (iter, COLUMN_BAR, 2, -1);
+  g_object_unref (iter);
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 6);
+
+  iter = clutter_model_get_iter_at_row (model, 1);
+  compare_iter (iter, 1, "String 3", 3);
+  g_object_unref (iter);
+
+  /* ... and removing a row shifts the following ones */
+  clutter_model_remove (model, 1);
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 5);
+
+  iter = clutter_model_get_iter_at_row (model, 1);
+  compare_iter (iter, 1, "String 5", 5);
+  g_object_unref (iter);
+
+  /* removing the filter shows every row again */
+  clutter_model_set_filter (model, NULL, NULL, NULL);
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 11);
+
+  g_object_unref (model);
+}
+
+void
+list_model_cursor (TestConformSimpleFixture *fixture,
+                   gconstpointer             data)
+{
+  ClutterModelCursor cursor;
+  ClutterModel *model;
+  gint i;
+
+  model = clutter_list_model_new (N_COLUMNS,
+                                  G_TYPE_STRING, "Foo",
+                                  G_TYPE_INT,    "Bar");
+
+  for (i = 1; i < 10; i++)
+    {
+      gchar *foo = g_strdup_printf ("String %d", i);
+
+      clutter_model_append (model, COLUMN_FOO, foo, COLUMN_BAR, i, -1);
+
+      g_free (foo);
+    }
+
+  i = 0;
+  clutter_model_cursor_init (&cursor, model);
+  while (clutter_model_cursor_next (&cursor))
+    {
+      const gchar * const *foo;
+      const gint *bar;
+
+      foo = clutter_model_cursor_peek_column (&cursor, COLUMN_FOO);
+      bar = clutter_model_cursor_peek_column (&cursor, COLUMN_BAR);
+
+      g_assert_cmpint (clutter_model_cursor_get_row (&cursor), ==, i);
+      g_assert_cmpstr (*foo, ==, base_model[i].expected_foo);
+      g_assert_cmpint (*bar, ==, base_model[i].expected_bar);
+
+      i += 1;
+    }
+
+  /* the cursor stays at the end */
+  g_assert (!clutter_model_cursor_next (&cursor));
+  clutter_model_cursor_clear (&cursor);
+
+  g_assert_cmpint (i, ==, G_N_ELEMENTS (base_model));
+
+  /* cursors skip the filtered rows */
+  clutter_model_set_filter (model, filter_odd_rows, NULL, NULL);
+
+  i = 0;
+  clutter_model_cursor_init (&cursor, model);
+  while (clutter_model_cursor_next (&cursor))
+    {
+      const gint *bar = clutter_model_cursor_peek_column (&cursor, COLUMN_BAR);
+
+      g_assert_cmpint (clutter_model_cursor_get_row (&cursor), ==, i);
+      g_assert_cmpint (*bar, ==, filter_odd[i].expected_bar);
+
+      i += 1;
+    }
+  clutter_model_cursor_clear (&cursor);
+
+  g_assert_cmpint (i, ==, G_N_ELEMENTS (filter_odd));
+
+  g_object_unref (model);
+}
@@ -0,0 +1,89 @@
+#include <clutter/clutter.h>
+#include "test-conform-common.h"
+
+#define N_FRAMES        4
+
+typedef struct _TestState       TestState;
+
+struct _TestState
+{
+  ClutterActor *stage;
+
+  guint n_frames;
+};
+
+static gboolean
+check_frame_stats (gpointer data)
+{
+  TestState *state = data;
+  ClutterFrameStats stats[N_FRAMES + 1];
+  guint n_stats, i;
+
+  n_stats = clutter_stage_get_frame_stats (CLUTTER_STAGE (state->stage),
+                                           stats,
+                                           G_N_ELEMENTS (stats));
+
+  /* the master clock might have run without drawing the stage */
+  if (n_stats == state->n_frames)
+    return TRUE;
+
+  /* the post-paint functions run after each frame is committed */
+  g_assert_cmpuint (n_stats, ==, state->n_frames + 1);
+  state->n_frames = n_stats;
+
+  if (g_test_verbose ())
+    g_print ("Frame %u: paint %" G_GINT64_FORMAT " usecs\n",
+             state->n_frames,
+             stats[0].paint_duration);
+
+  /* the most recent frame comes first */
+  for (i = 1; i < n_stats; i++)
+    g_assert_cmpint (stats[i - 1].frame_time, >=, stats[i].frame_time);
+
+  if (state->n_frames == 1)
+    {
+      /* the pick is accounted to the next frame */
+      clutter_stage_get_actor_at_pos (CLUTTER_STAGE (state->stage),
+                                      CLUTTER_PICK_REACTIVE,
+                                      10, 10);
+    }
+  else if (state->n_frames == 2)
+    g_assert_cmpuint (stats[0].n_picks, >=, 1);
+
+  if (state->n_frames == N_FRAMES)
+    {
+      clutter_main_quit ();
+      return FALSE;
+    }
+
+  clutter_actor_queue_redraw (state->stage);
+
+  return TRUE;
+}
+
+void
+stage_frame_stats (TestConformSimpleFixture *fixture,
+                   gconstpointer             data)
+{
+  TestState state = { NULL, };
+  ClutterFrameStats stats;
+
+  state.stage = clutter_stage_new ();
+
+  /* nothing has been drawn yet */
+  g_assert_cmpuint (clutter_stage_get_frame_stats (CLUTTER_STAGE (state.stage),
+                                                   &stats, 1), ==, 0);
+
+  clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_POST_PAINT,
+                                         check_frame_stats,
+                                         &state,
+                                         NULL);
+
+  clutter_actor_show (state.stage);
+
+  clutter_main ();
+
+  g_assert_cmpuint (state.n_frames, ==, N_FRAMES);
+
+  clutter_actor_destroy (state.stage);
+}
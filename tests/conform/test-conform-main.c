@@ -140,12 +140,22 @@ main (int argc, char **argv)
   TEST_CONFORM_SIMPLE ("/actor", actor_destruction);
   TEST_CONFORM_SIMPLE ("/actor", actor_anchors);
   TEST_CONFORM_SIMPLE ("/actor", actor_pick);
+  TEST_CONFORM_SIMPLE ("/actor", actor_geometric_pick);
+  TEST_CONFORM_SIMPLE ("/actor", actor_pick_moved);
   TEST_CONFORM_SIMPLE ("/actor", actor_fixed_size);
   TEST_CONFORM_SIMPLE ("/actor", actor_preferred_size);
+  TEST_CONFORM_SIMPLE ("/actor", actor_size_request_cache);
+  TEST_CONFORM_SIMPLE ("/actor", actor_relayout_boundary);
   TEST_CONFORM_SIMPLE ("/actor", actor_basic_layout);
   TEST_CONFORM_SIMPLE ("/actor", actor_margin_layout);
   TEST_CONFORM_SIMPLE ("/actor", actor_offscreen_redirect);
+  TEST_CONFORM_SIMPLE ("/actor", actor_paint_node_cache);
   TEST_CONFORM_SIMPLE ("/actor", actor_shader_effect);
+  TEST_CONFORM_SIMPLE ("/actor", actor_implicit_transitions);
+  TEST_CONFORM_SIMPLE ("/actor", actor_implicit_transition_get);
+  TEST_CONFORM_SIMPLE ("/actor", actor_implicit_transition_retarget);
+  TEST_CONFORM_SIMPLE ("/actor", actor_transforms_nested);
+  TEST_CONFORM_SIMPLE ("/actor", actor_transforms_siblings);
 
   TEST_CONFORM_SIMPLE ("/actor/iter", actor_iter_traverse_children);
   TEST_CONFORM_SIMPLE ("/actor/iter", actor_iter_traverse_remove);
@@ -162,6 +172,8 @@ main (int argc, char **argv)
   TEST_CONFORM_SIMPLE ("/actor/invariants", actor_contains);
   TEST_CONFORM_SIMPLE ("/actor/invariants", default_stage);
 
+  TEST_CONFORM_SIMPLE ("/stage", stage_frame_stats);
+
   TEST_CONFORM_SIMPLE ("/actor/opacity", opacity_label);
   TEST_CONFORM_SIMPLE ("/actor/opacity", opacity_rectangle);
   TEST_CONFORM_SIMPLE ("/actor/opacity", opacity_paint);
@@ -180,6 +192,10 @@ main (int argc, char **argv)
   TEST_CONFORM_SIMPLE ("/text", text_cache);
   TEST_CONFORM_SIMPLE ("/text", text_password_char);
   TEST_CONFORM_SIMPLE ("/text", text_idempotent_use_markup);
+  TEST_CONFORM_SIMPLE ("/text", text_buffer_edits);
+  TEST_CONFORM_SIMPLE ("/text", text_paragraph_edits);
+  TEST_CONFORM_SIMPLE ("/text", text_share_layout);
+  TEST_CONFORM_SIMPLE ("/text", text_async_layout);
 
   TEST_CONFORM_SIMPLE ("/rectangle", rectangle_set_size);
   TEST_CONFORM_SIMPLE ("/rectangle", rectangle_set_color);
@@ -188,15 +204,23 @@ main (int argc, char **argv)
   TEST_CONFORM_SIMPLE ("/texture", texture_fbo);
   TEST_CONFORM_SIMPLE ("/texture/cairo", texture_cairo);
 
+  TEST_CONFORM_SIMPLE ("/canvas", canvas_invalidate_rect);
+  TEST_CONFORM_SIMPLE ("/canvas", canvas_draw_async);
+
   TEST_CONFORM_SIMPLE ("/path", path_base);
 
   TEST_CONFORM_SIMPLE ("/binding-pool", binding_pool);
 
   TEST_CONFORM_SIMPLE ("/model", list_model_populate);
   TEST_CONFORM_SIMPLE ("/model", list_model_iterate);
+  TEST_CONFORM_SIMPLE ("/model", list_model_cursor);
   TEST_CONFORM_SIMPLE ("/model", list_model_filter);
+  TEST_CONFORM_SIMPLE ("/model", list_model_filter_update);
   TEST_CONFORM_SIMPLE ("/model", list_model_from_script);
   TEST_CONFORM_SIMPLE ("/model", list_model_row_changed);
+  TEST_CONFORM_SIMPLE ("/model", list_model_append_rows);
+
+  TEST_CONFORM_SIMPLE ("/list-view", list_view_recycle);
 
   TEST_CONFORM_SIMPLE ("/color", color_from_string_valid);
   TEST_CONFORM_SIMPLE ("/color", color_from_string_invalid);
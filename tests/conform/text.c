@@ -502,3 +502,298 @@ text_idempotent_use_markup (void)
 
   clutter_actor_destroy (CLUTTER_ACTOR (text));
 }
+
+void
+text_buffer_edits (void)
+{
+  ClutterTextBuffer *buffer = clutter_text_buffer_new ();
+  GString *expected = g_string_new (NULL);
+  ClutterText *text, *reference;
+  gfloat height, ref_height;
+  guint n_chars = 0;
+  int i;
+
+  /* edit a text long enough to need the offset index, at positions
+   * moving back and forth across it
+   */
+  for (i = 0; i < 2000; i++)
+    {
+      const TestData *t = &test_text_data[i % G_N_ELEMENTS (test_text_data)];
+      guint position = (i * 7919) % (n_chars + 1);
+      const char *at;
+
+      at = g_utf8_offset_to_pointer (expected->str, position);
+      g_string_insert_len (expected, at - expected->str, t->bytes, t->nbytes);
+      n_chars += 1;
+
+      clutter_text_buffer_insert_text (buffer, position, t->bytes, 1);
+
+      if (i % 3 == 0)
+        {
+          const char *end;
+
+          position = (i * 104729) % n_chars;
+          at = g_utf8_offset_to_pointer (expected->str, position);
+          end = g_utf8_offset_to_pointer (at, 1);
+          g_string_erase (expected, at - expected->str, end - at);
+          n_chars -= 1;
+
+          clutter_text_buffer_delete_text (buffer, position, 1);
+        }
+
+      if (i % 100 == 0)
+        g_assert_cmpstr (clutter_text_buffer_get_text (buffer), ==, expected->str);
+    }
+
+  g_assert_cmpuint (clutter_text_buffer_get_length (buffer), ==, n_chars);
+  g_assert_cmpuint (clutter_text_buffer_get_bytes (buffer), ==, expected->len);
+  g_assert_cmpstr (clutter_text_buffer_get_text (buffer), ==, expected->str);
+
+  /* an editable text reads the paragraphs around each edit without
+   * closing the gap; keep editing the middle of the text, interleaving
+   * the reads done by the text with reads of the whole buffer
+   */
+  text = CLUTTER_TEXT (clutter_text_new_with_buffer (buffer));
+  clutter_text_set_editable (text, TRUE);
+  clutter_text_set_line_wrap (text, TRUE);
+
+  for (i = 0; i < 500; i++)
+    {
+      const TestData *t = &test_text_data[i % G_N_ELEMENTS (test_text_data)];
+      guint position = n_chars / 2 + (i % 5);
+      const char *bytes = i % 7 == 0 ? "\n" : t->bytes;
+      gsize n_bytes = i % 7 == 0 ? 1 : t->nbytes;
+      const char *at;
+
+      at = g_utf8_offset_to_pointer (expected->str, position);
+      g_string_insert_len (expected, at - expected->str, bytes, n_bytes);
+      n_chars += 1;
+
+      clutter_text_buffer_insert_text (buffer, position, bytes, 1);
+
+      /* lays out the edited paragraph */
+      clutter_actor_get_preferred_height (CLUTTER_ACTOR (text), 200,
+                                          NULL, &height);
+      clutter_text_position_to_coords (text, position, NULL, NULL, NULL);
+
+      g_assert_cmpuint (clutter_text_buffer_get_bytes (buffer), ==, expected->len);
+
+      if (i % 2 == 0)
+        {
+          const char *end;
+
+          position = n_chars / 2 - (i % 3);
+          at = g_utf8_offset_to_pointer (expected->str, position);
+          end = g_utf8_offset_to_pointer (at, 1);
+          g_string_erase (expected, at - expected->str, end - at);
+          n_chars -= 1;
+
+          clutter_text_buffer_delete_text (buffer, position, 1);
+
+          clutter_actor_get_preferred_height (CLUTTER_ACTOR (text), 200,
+                                              NULL, &height);
+        }
+
+      if (i % 10 == 0)
+        g_assert_cmpstr (clutter_text_buffer_get_text (buffer), ==, expected->str);
+    }
+
+  g_assert_cmpuint (clutter_text_buffer_get_length (buffer), ==, n_chars);
+  g_assert_cmpstr (clutter_text_buffer_get_text (buffer), ==, expected->str);
+  g_assert_cmpstr (clutter_text_get_text (text), ==, expected->str);
+
+  /* the paragraphs must match the layout of the whole text */
+  reference = CLUTTER_TEXT (clutter_text_new_with_text (NULL, expected->str));
+  clutter_text_set_line_wrap (reference, TRUE);
+
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (text), 200,
+                                      NULL, &height);
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (reference), 200,
+                                      NULL, &ref_height);
+  g_assert_cmpfloat (height, ==, ref_height);
+
+  clutter_actor_destroy (CLUTTER_ACTOR (reference));
+  clutter_actor_destroy (CLUTTER_ACTOR (text));
+  g_string_free (expected, TRUE);
+  g_object_unref (buffer);
+}
+
+static void
+assert_same_cursor_positions (ClutterText *text,
+                              ClutterText *reference)
+{
+  gint i, n_chars;
+
+  n_chars = g_utf8_strlen (clutter_text_get_text (text), -1);
+  for (i = 0; i <= n_chars; i++)
+    {
+      gfloat x, y, ref_x, ref_y;
+
+      clutter_text_position_to_coords (text, i, &x, &y, NULL);
+      clutter_text_position_to_coords (reference, i, &ref_x, &ref_y, NULL);
+
+      if (g_test_verbose ())
+        g_print ("position %d: (%.2f, %.2f), expected (%.2f, %.2f)\n",
+                 i, x, y, ref_x, ref_y);
+
+      g_assert_cmpfloat (x, ==, ref_x);
+      g_assert_cmpfloat (y, ==, ref_y);
+    }
+}
+
+void
+text_paragraph_edits (void)
+{
+  ClutterText *text = CLUTTER_TEXT (clutter_text_new ());
+  ClutterText *reference = CLUTTER_TEXT (clutter_text_new ());
+  gfloat width, ref_width, height, ref_height;
+
+  /* editable, multi-line texts are laid out one paragraph at a time,
+   * and must match the layout of the whole text
+   */
+  clutter_text_set_editable (text, TRUE);
+  clutter_text_set_line_wrap (text, TRUE);
+  clutter_text_set_line_wrap (reference, TRUE);
+
+  clutter_text_set_text (text, "foo\nbar\n\nbaz");
+
+  clutter_text_insert_text (text, "one\ntwo", 2);
+  clutter_text_insert_text (text, "a much longer paragraph", 8);
+  clutter_text_insert_unichar (text, 0x2665);
+  clutter_text_delete_text (text, 3, 12);
+  clutter_text_insert_text (text, "\n", -1);
+
+  clutter_text_set_text (reference, clutter_text_get_text (text));
+
+  clutter_actor_get_preferred_width (CLUTTER_ACTOR (text), -1,
+                                     NULL, &width);
+  clutter_actor_get_preferred_width (CLUTTER_ACTOR (reference), -1,
+                                     NULL, &ref_width);
+  g_assert_cmpfloat (width, ==, ref_width);
+
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (text), width / 2,
+                                      NULL, &height);
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (reference), width / 2,
+                                      NULL, &ref_height);
+  g_assert_cmpfloat (height, ==, ref_height);
+
+  assert_same_cursor_positions (text, reference);
+
+  /* paragraphs are delimited like Pango does, and edits can join or
+   * split a "\r\n" separator
+   */
+  clutter_text_set_text (text, "foo\r\nbar\rbaz\xe2\x80\xa9qux\n");
+
+  clutter_text_insert_text (text, "\n", 9);
+  clutter_text_insert_text (text, "one", 4);
+  clutter_text_insert_text (text, "\r", 19);
+  clutter_text_delete_text (text, 4, 7);
+  clutter_text_delete_text (text, 8, 9);
+
+  clutter_text_set_text (reference, clutter_text_get_text (text));
+
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (text), width / 2,
+                                      NULL, &height);
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (reference), width / 2,
+                                      NULL, &ref_height);
+  g_assert_cmpfloat (height, ==, ref_height);
+
+  assert_same_cursor_positions (text, reference);
+
+  /* texts that do not wrap are measured without any width, even
+   * after being laid out at a narrower one
+   */
+  clutter_text_set_line_wrap (text, FALSE);
+  clutter_text_set_line_wrap (reference, FALSE);
+
+  clutter_text_set_text (text, "a paragraph long enough to wrap\nand another");
+  clutter_text_set_text (reference, clutter_text_get_text (text));
+
+  clutter_actor_get_preferred_width (CLUTTER_ACTOR (text), -1,
+                                     NULL, &width);
+
+  clutter_actor_set_width (CLUTTER_ACTOR (text), width / 4);
+  clutter_actor_set_width (CLUTTER_ACTOR (reference), width / 4);
+
+  clutter_text_position_to_coords (text, 0, NULL, NULL, NULL);
+
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (text), -1,
+                                      NULL, &height);
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (reference), -1,
+                                      NULL, &ref_height);
+  g_assert_cmpfloat (height, ==, ref_height);
+
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (text), width / 4,
+                                      NULL, &height);
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (reference), width / 4,
+                                      NULL, &ref_height);
+  g_assert_cmpfloat (height, ==, ref_height);
+
+  clutter_actor_destroy (CLUTTER_ACTOR (text));
+  clutter_actor_destroy (CLUTTER_ACTOR (reference));
+}
+
+void
+text_share_layout (void)
+{
+  ClutterText *a = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 12", "N/A"));
+  ClutterText *b = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 12", "N/A"));
+  ClutterText *c = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 12", "N/A"));
+
+  clutter_text_set_share_layout (a, TRUE);
+  clutter_text_set_share_layout (b, TRUE);
+
+  /* identical texts share their layout */
+  g_assert (clutter_text_get_layout (a) == clutter_text_get_layout (b));
+
+  /* but only if they opt in */
+  g_assert (clutter_text_get_layout (a) != clutter_text_get_layout (c));
+
+  /* changing the contents of one does not affect the other */
+  clutter_text_set_text (b, "OK");
+  g_assert (clutter_text_get_layout (a) != clutter_text_get_layout (b));
+  g_assert_cmpstr (pango_layout_get_text (clutter_text_get_layout (a)), ==, "N/A");
+  g_assert_cmpstr (pango_layout_get_text (clutter_text_get_layout (b)), ==, "OK");
+
+  /* the layouts of texts using attributes are not shared */
+  clutter_text_set_markup (b, "<b>N/A</b>");
+  g_assert (clutter_text_get_layout (a) != clutter_text_get_layout (b));
+
+  clutter_actor_destroy (CLUTTER_ACTOR (a));
+  clutter_actor_destroy (CLUTTER_ACTOR (b));
+  clutter_actor_destroy (CLUTTER_ACTOR (c));
+}
+
+void
+text_async_layout (void)
+{
+  ClutterText *text = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 12", "N/A"));
+  PangoLayout *layout;
+  gint64 deadline;
+
+  clutter_text_set_async_layout (text, TRUE);
+  g_assert (clutter_text_get_async_layout (text));
+
+  layout = clutter_text_get_layout (text);
+  g_assert (layout != NULL);
+
+  clutter_text_set_text (text, "OK");
+
+  /* the layout is either shaped in a thread, in which case the text
+   * keeps showing the previous contents until the new layout has been
+   * adopted, or synchronously if Pango is not thread-safe
+   */
+  deadline = g_get_monotonic_time () + 5 * G_USEC_PER_SEC;
+  while (g_strcmp0 (pango_layout_get_text (clutter_text_get_layout (text)), "OK") != 0)
+    {
+      g_assert (g_get_monotonic_time () < deadline);
+      g_main_context_iteration (NULL, FALSE);
+    }
+
+  /* turning the asynchronous layout off shapes synchronously */
+  clutter_text_set_async_layout (text, FALSE);
+  clutter_text_set_text (text, "N/A");
+  g_assert_cmpstr (pango_layout_get_text (clutter_text_get_layout (text)), ==, "N/A");
+
+  clutter_actor_destroy (CLUTTER_ACTOR (text));
+}
@@ -0,0 +1,144 @@
+#include <clutter/clutter.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+
+/* private, but exported by the library; see clutter-easing.h */
+const char *clutter_get_easing_name_for_mode (ClutterAnimationMode mode);
+double clutter_easing_for_mode (ClutterAnimationMode mode,
+                                double               t,
+                                double               d);
+void clutter_easing_for_mode_batch (ClutterAnimationMode  mode,
+                                    const double         *t,
+                                    const double         *d,
+                                    double               *res,
+                                    guint                 n_values);
+void clutter_easing_for_modes (const ClutterAnimationMode *modes,
+                               const double               *t,
+                               const double               *d,
+                               double                     *res,
+                               guint                       n_values);
+
+#define N_VALUES        4096
+#define N_ITERATIONS    2000
+
+static double t[N_VALUES];
+static double d[N_VALUES];
+static double res[N_VALUES];
+
+static ClutterAnimationMode modes[N_VALUES];
+
+static double
+run_scalar (ClutterAnimationMode mode)
+{
+  gint64 start;
+  int i, j;
+
+  start = g_get_monotonic_time ();
+
+  for (j = 0; j < N_ITERATIONS; j++)
+    for (i = 0; i < N_VALUES; i++)
+      res[i] = clutter_easing_for_mode (mode, t[i], d[i]);
+
+  return (double) (g_get_monotonic_time () - start) * 1000.0
+       / ((double) N_ITERATIONS * N_VALUES);
+}
+
+static double
+run_batch (ClutterAnimationMode mode)
+{
+  gint64 start;
+  int j;
+
+  start = g_get_monotonic_time ();
+
+  for (j = 0; j < N_ITERATIONS; j++)
+    clutter_easing_for_mode_batch (mode, t, d, res, N_VALUES);
+
+  return (double) (g_get_monotonic_time () - start) * 1000.0
+       / ((double) N_ITERATIONS * N_VALUES);
+}
+
+static double
+run_mixed_scalar (void)
+{
+  gint64 start;
+  int i, j;
+
+  start = g_get_monotonic_time ();
+
+  for (j = 0; j < N_ITERATIONS; j++)
+    for (i = 0; i < N_VALUES; i++)
+      res[i] = clutter_easing_for_mode (modes[i], t[i], d[i]);
+
+  return (double) (g_get_monotonic_time () - start) * 1000.0
+       / ((double) N_ITERATIONS * N_VALUES);
+}
+
+static double
+run_mixed_batch (void)
+{
+  gint64 start;
+  int j;
+
+  start = g_get_monotonic_time ();
+
+  for (j = 0; j < N_ITERATIONS; j++)
+    clutter_easing_for_modes (modes, t, d, res, N_VALUES);
+
+  return (double) (g_get_monotonic_time () - start) * 1000.0
+       / ((double) N_ITERATIONS * N_VALUES);
+}
+
+static int
+compare_modes (const void *a,
+               const void *b)
+{
+  return (int) *(const ClutterAnimationMode *) a
+       - (int) *(const ClutterAnimationMode *) b;
+}
+
+int
+main (int argc, char *argv[])
+{
+  ClutterAnimationMode mode;
+  int i;
+
+  for (i = 0; i < N_VALUES; i++)
+    {
+      d[i] = 250 + (i % 7) * 125;
+      t[i] = g_random_double_range (0, d[i]);
+      modes[i] = g_random_int_range (CLUTTER_LINEAR, CLUTTER_ANIMATION_LAST);
+    }
+
+  /* the master clock sorts the timelines by mode */
+  qsort (modes, N_VALUES, sizeof (ClutterAnimationMode), compare_modes);
+
+  printf ("Easing performance test with %d values, %d iterations\n"
+          "(nanoseconds per value)\n\n",
+          N_VALUES, N_ITERATIONS);
+
+  printf ("%-20s %10s %10s %10s\n", "mode", "scalar", "batch", "speedup");
+
+  for (mode = CLUTTER_LINEAR; mode < CLUTTER_ANIMATION_LAST; mode++)
+    {
+      double scalar = run_scalar (mode);
+      double batch = run_batch (mode);
+
+      printf ("%-20s %10.2f %10.2f %9.2fx\n",
+              clutter_get_easing_name_for_mode (mode),
+              scalar,
+              batch,
+              scalar / batch);
+    }
+
+  {
+    double scalar = run_mixed_scalar ();
+    double batch = run_mixed_batch ();
+
+    printf ("\n%-20s %10.2f %10.2f %9.2fx\n",
+            "mixed", scalar, batch, scalar / batch);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,200 @@
+#include <clutter/clutter.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#define N_ROWS          100000
+#define N_ITERATIONS    10
+
+enum
+{
+  COLUMN_ID,
+  COLUMN_SCORE,
+  COLUMN_NAME,
+
+  N_COLUMNS
+};
+
+static gint ids[N_ROWS];
+static gdouble scores[N_ROWS];
+static const gchar *names[N_ROWS];
+
+static gboolean
+filter_even_ids (ClutterModel     *model,
+                 ClutterModelIter *iter,
+                 gpointer          dummy)
+{
+  gint id;
+
+  clutter_model_iter_get (iter, COLUMN_ID, &id, -1);
+
+  return (id % 2) == 0;
+}
+
+static double
+run_iter (ClutterModel *model,
+          gdouble      *sum)
+{
+  gint64 start;
+  guint n_rows = 0;
+  int j;
+
+  start = g_get_monotonic_time ();
+
+  for (j = 0; j < N_ITERATIONS; j++)
+    {
+      ClutterModelIter *iter;
+
+      iter = clutter_model_get_first_iter (model);
+      while (!clutter_model_iter_is_last (iter))
+        {
+          gchar *name;
+          gdouble score;
+          gint id;
+
+          clutter_model_iter_get (iter,
+                                  COLUMN_ID, &id,
+                                  COLUMN_SCORE, &score,
+                                  COLUMN_NAME, &name,
+                                  -1);
+
+          *sum += id + score + name[0];
+          g_free (name);
+
+          n_rows += 1;
+          iter = clutter_model_iter_next (iter);
+        }
+
+      g_object_unref (iter);
+    }
+
+  return (double) (g_get_monotonic_time () - start) * 1000.0 / n_rows;
+}
+
+static double
+run_random_access (ClutterModel *model,
+                   gdouble      *sum)
+{
+  guint i, n_rows = clutter_model_get_n_rows (model);
+  gint64 start;
+
+  start = g_get_monotonic_time ();
+
+  for (i = 0; i < n_rows; i++)
+    {
+      ClutterModelIter *iter;
+      gdouble score;
+
+      iter = clutter_model_get_iter_at_row (model, (i * 7919) % n_rows);
+      clutter_model_iter_get (iter, COLUMN_SCORE, &score, -1);
+      *sum += score;
+      g_object_unref (iter);
+    }
+
+  return (double) (g_get_monotonic_time () - start) * 1000.0 / n_rows;
+}
+
+static double
+run_cursor (ClutterModel *model,
+            gdouble      *sum)
+{
+  gint64 start;
+  guint n_rows = 0;
+  int j;
+
+  start = g_get_monotonic_time ();
+
+  for (j = 0; j < N_ITERATIONS; j++)
+    {
+      ClutterModelCursor cursor;
+
+      clutter_model_cursor_init (&cursor, model);
+      while (clutter_model_cursor_next (&cursor))
+        {
+          const gint *id;
+          const gdouble *score;
+          const gchar * const *name;
+
+          id = clutter_model_cursor_peek_column (&cursor, COLUMN_ID);
+          score = clutter_model_cursor_peek_column (&cursor, COLUMN_SCORE);
+          name = clutter_model_cursor_peek_column (&cursor, COLUMN_NAME);
+
+          *sum += *id + *score + (*name)[0];
+
+          n_rows += 1;
+        }
+      clutter_model_cursor_clear (&cursor);
+    }
+
+  return (double) (g_get_monotonic_time () - start) * 1000.0 / n_rows;
+}
+
+static void
+run_all (ClutterModel *model,
+         const gchar  *label)
+{
+  gdouble sum_iter = 0, sum_cursor = 0, sum_random = 0;
+  double iter, cursor, random_access;
+
+  iter = run_iter (model, &sum_iter);
+  cursor = run_cursor (model, &sum_cursor);
+  random_access = run_random_access (model, &sum_random);
+
+  /* both paths must see the same rows */
+  g_assert (sum_iter == sum_cursor);
+
+  printf ("%-20s %10.2f %10.2f %9.2fx %12.2f\n",
+          label,
+          iter,
+          cursor,
+          iter / cursor,
+          random_access);
+}
+
+int
+main (int argc, char *argv[])
+{
+  const guint columns[] = { COLUMN_ID, COLUMN_SCORE, COLUMN_NAME };
+  gconstpointer column_data[] = { ids, scores, names };
+  ClutterModel *model;
+  gint64 start;
+  int i;
+
+  g_type_init ();
+
+  for (i = 0; i < N_ROWS; i++)
+    {
+      ids[i] = i;
+      scores[i] = g_random_double ();
+      names[i] = g_strdup_printf ("Row %d", i);
+    }
+
+  model = clutter_list_model_new (N_COLUMNS,
+                                  G_TYPE_INT, "Id",
+                                  G_TYPE_DOUBLE, "Score",
+                                  G_TYPE_STRING, "Name");
+
+  start = g_get_monotonic_time ();
+  clutter_list_model_append_rows (CLUTTER_LIST_MODEL (model),
+                                  N_ROWS,
+                                  G_N_ELEMENTS (columns),
+                                  columns,
+                                  column_data);
+
+  printf ("Model performance test with %d rows, %d iterations\n"
+          "(loaded in %.2f ms; nanoseconds per row)\n\n",
+          N_ROWS, N_ITERATIONS,
+          (double) (g_get_monotonic_time () - start) / 1000.0);
+
+  printf ("%-20s %10s %10s %10s %12s\n",
+          "model", "iter", "cursor", "speedup", "random-iter");
+
+  run_all (model, "unfiltered");
+
+  clutter_model_set_filter (model, filter_even_ids, NULL, NULL);
+  run_all (model, "filtered");
+
+  g_object_unref (model);
+
+  return EXIT_SUCCESS;
+}